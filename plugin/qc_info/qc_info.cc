@@ -47,7 +47,9 @@ class Accessible_Query_Cache : public Query_cache {
   {
     return &this->queries;
   }
-} *qc;
+};
+
+static Partitioned_query_cache *qc;
 
 bool schema_table_store_record(THD *thd, TABLE *table);
 
@@ -109,22 +111,18 @@ static ST_FIELD_INFO qc_info_fields[]=
 
 static const char unknown[]= "#UNKNOWN#";
 
-static int qc_info_fill_table(THD *thd, TABLE_LIST *tables,
-                                              COND *cond)
+static int qc_info_fill_partition(THD *thd, TABLE_LIST *tables,
+                                  Accessible_Query_Cache *partition)
 {
   int status= 1;
   CHARSET_INFO *scs= system_charset_info;
   TABLE *table= tables->table;
-  HASH *queries = qc->get_queries();
-
-  /* one must have PROCESS privilege to see others' queries */
-  if (check_global_access(thd, PROCESS_ACL, true))
-    return 0;
+  HASH *queries = partition->get_queries();
 
-  if (qc->try_lock(thd))
+  if (partition->try_lock(thd))
     return 0; // QC is or is being disabled
 
-  /* loop through all queries in the query cache */
+  /* loop through all queries in the query cache partition */
   for (uint i= 0; i < queries->records; i++)
   {
     const uchar *query_cache_block_raw;
@@ -264,10 +262,27 @@ static int qc_info_fill_table(THD *thd, TABLE_LIST *tables,
   status = 0;
 
 cleanup:
-  qc->unlock();
+  partition->unlock();
   return status;
 }
 
+static int qc_info_fill_table(THD *thd, TABLE_LIST *tables,
+                                              COND *cond)
+{
+  /* one must have PROCESS privilege to see others' queries */
+  if (check_global_access(thd, PROCESS_ACL, true))
+    return 0;
+
+  /* loop through all partitions of the query cache */
+  for (uint p= 0; p < qc->partition_count(); p++)
+  {
+    if (qc_info_fill_partition(thd, tables,
+                               (Accessible_Query_Cache *) qc->partition(p)))
+      return 1;
+  }
+  return 0;
+}
+
 static int qc_info_plugin_init(void *p)
 {
   ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE *)p;
@@ -276,10 +291,11 @@ static int qc_info_plugin_init(void *p)
   schema->fill_table= qc_info_fill_table;
 
 #ifdef _WIN32
-  qc = (Accessible_Query_Cache *)
-    GetProcAddress(GetModuleHandle(NULL), "?query_cache@@3VQuery_cache@@A");
+  qc = (Partitioned_query_cache *)
+    GetProcAddress(GetModuleHandle(NULL),
+                   "?query_cache@@3VPartitioned_query_cache@@A");
 #else
-  qc = (Accessible_Query_Cache *)&query_cache;
+  qc = &query_cache;
 #endif
 
   return qc == 0;
@@ -0,0 +1,9 @@
+package My::Suite::Thread_pool_info;
+
+@ISA = qw(My::Suite);
+
+return "No thread_pool_info plugin" unless $ENV{THREAD_POOL_INFO_SO};
+
+sub is_default { 1 }
+
+bless { };
@@ -0,0 +1,113 @@
+/* Copyright (C) 2017 MariaDB Corporation
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  INFORMATION_SCHEMA tables describing the thread pool.
+
+  THREAD_POOL_QUEUE_WAITS is a histogram of the time requests spent in
+  thread group queues, before a worker thread picked them up, for each
+  priority class (see thread_pool_priority).
+*/
+
+#define MYSQL_SERVER 1
+#include <my_config.h>
+#include <mysql_version.h>
+#include <mysql/plugin.h>
+#include <sql_class.h>
+#include <sql_show.h>
+#include <threadpool.h>
+
+static const LEX_STRING priority_class_name[]=
+{
+  { C_STRING_WITH_LEN("high") },
+  { C_STRING_WITH_LEN("low") }
+};
+
+static ST_FIELD_INFO queue_waits_fields_info[]=
+{
+  {"PRIORITY", 8, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"WAIT_MICROSECONDS_LESS_THAN", 21, MYSQL_TYPE_LONGLONG, 0,
+    MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL, 0, SKIP_OPEN_TABLE},
+  {"COUNT", 21, MYSQL_TYPE_LONGLONG, 0, MY_I_S_UNSIGNED, 0, SKIP_OPEN_TABLE},
+  {"TOTAL_MICROSECONDS", 21, MYSQL_TYPE_LONGLONG, 0, MY_I_S_UNSIGNED, 0,
+    SKIP_OPEN_TABLE},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, 0}
+};
+
+
+static int queue_waits_fill_table(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  TABLE *table= tables->table;
+  TP_QUEUE_WAIT_STATISTICS stats;
+  DBUG_ENTER("queue_waits_fill_table");
+
+  compile_time_assert(array_elements(priority_class_name) ==
+                      TP_PRIORITY_CLASSES);
+
+  tp_get_queue_wait_statistics(&stats);
+  for (uint prio= 0; prio < TP_PRIORITY_CLASSES; prio++)
+  {
+    for (uint bucket= 0; bucket < TP_WAIT_HISTOGRAM_BUCKETS; bucket++)
+    {
+      restore_record(table, s->default_values);
+      table->field[0]->store(priority_class_name[prio].str,
+                             priority_class_name[prio].length,
+                             system_charset_info);
+      if (bucket < TP_WAIT_HISTOGRAM_BUCKETS - 1)
+      {
+        table->field[1]->set_notnull();
+        table->field[1]->store(1ULL << bucket, TRUE);
+      }
+      else
+        table->field[1]->set_null();
+      table->field[2]->store(stats.count[prio][bucket], TRUE);
+      table->field[3]->store(stats.total[prio][bucket], TRUE);
+      if (schema_table_store_record(thd, table))
+        DBUG_RETURN(1);
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
+static int queue_waits_init(void *p)
+{
+  ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE *) p;
+  schema->fields_info= queue_waits_fields_info;
+  schema->fill_table= queue_waits_fill_table;
+  return 0;
+}
+
+
+static struct st_mysql_information_schema thread_pool_info=
+{ MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
+
+maria_declare_plugin(thread_pool_info)
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &thread_pool_info,
+  "THREAD_POOL_QUEUE_WAITS",
+  "MariaDB Corporation",
+  "Thread pool queue wait time histogram",
+  PLUGIN_LICENSE_GPL,
+  queue_waits_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_EXPERIMENTAL
+}
+maria_declare_plugin_end;
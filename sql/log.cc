@@ -96,6 +96,7 @@ ulong opt_binlog_dbug_fsync_sleep= 0;
 
 mysql_mutex_t LOCK_prepare_ordered;
 mysql_cond_t COND_prepare_ordered;
+mysql_mutex_t LOCK_binlog_sync_stage;
 mysql_mutex_t LOCK_after_binlog_sync;
 mysql_mutex_t LOCK_commit_ordered;
 
@@ -104,6 +105,9 @@ static ulonglong binlog_status_var_num_group_commits;
 static ulonglong binlog_status_group_commit_trigger_count;
 static ulonglong binlog_status_group_commit_trigger_lock_wait;
 static ulonglong binlog_status_group_commit_trigger_timeout;
+static ulonglong binlog_status_group_commit_write_usec;
+static ulonglong binlog_status_group_commit_sync_usec;
+static ulonglong binlog_status_group_commit_commit_usec;
 static char binlog_snapshot_file[FN_REFLEN];
 static ulonglong binlog_snapshot_position;
 
@@ -119,6 +123,12 @@ static SHOW_VAR binlog_status_vars_detail[]=
     (char *)&binlog_status_group_commit_trigger_lock_wait, SHOW_LONGLONG},
   {"group_commit_trigger_timeout",
     (char *)&binlog_status_group_commit_trigger_timeout, SHOW_LONGLONG},
+  {"group_commit_write_usec",
+    (char *)&binlog_status_group_commit_write_usec, SHOW_LONGLONG},
+  {"group_commit_sync_usec",
+    (char *)&binlog_status_group_commit_sync_usec, SHOW_LONGLONG},
+  {"group_commit_commit_usec",
+    (char *)&binlog_status_group_commit_commit_usec, SHOW_LONGLONG},
   {"snapshot_file",
     (char *)&binlog_snapshot_file, SHOW_CHAR},
   {"snapshot_position",
@@ -3165,6 +3175,8 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period)
    num_commits(0), num_group_commits(0),
    group_commit_trigger_count(0), group_commit_trigger_timeout(0),
    group_commit_trigger_lock_wait(0),
+   group_commit_write_usec(0), group_commit_sync_usec(0),
+   group_commit_commit_usec(0),
    sync_period_ptr(sync_period), sync_counter(0),
    state_file_deleted(false), binlog_state_recover_done(false),
    is_relay_log(0), signal_cnt(0),
@@ -4078,8 +4090,8 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
       Without binlog, we cannot XA recover prepared-but-not-committed
       transactions in engines. So force a commit checkpoint first.
 
-      Note that we take and immediately
-      release LOCK_after_binlog_sync/LOCK_commit_ordered. This has
+      Note that we take and immediately release LOCK_binlog_sync_stage/
+      LOCK_after_binlog_sync/LOCK_commit_ordered. This has
       the effect to ensure that any on-going group commit (in
       trx_group_commit_leader()) has completed before we request the checkpoint,
       due to the chaining of LOCK_log and LOCK_commit_ordered in that function.
@@ -4091,7 +4103,9 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
       later would leave such transaction not recoverable.
     */
 
+    mysql_mutex_lock(&LOCK_binlog_sync_stage);
     mysql_mutex_lock(&LOCK_after_binlog_sync);
+    mysql_mutex_unlock(&LOCK_binlog_sync_stage);
     mysql_mutex_lock(&LOCK_commit_ordered);
     mysql_mutex_unlock(&LOCK_after_binlog_sync);
     mysql_mutex_unlock(&LOCK_commit_ordered);
@@ -5308,6 +5322,11 @@ bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
   mysql_mutex_assert_owner(&LOCK_log);
   if (flush_io_cache(&log_file))
     return 1;
+  /*
+    Let an earlier pipelined group commit finish its sync stage first; the
+    caller will run hooks and publish the new end position after us.
+  */
+  wait_for_binlog_sync_stage();
   uint sync_period= get_sync_period();
   if (sync_period && ++sync_counter >= sync_period)
   {
@@ -7494,6 +7513,92 @@ MYSQL_BIN_LOG::write_transaction_to_binlog_events(group_commit_entry *entry)
   return 1;
 }
 
+
+/*
+  Mark every transaction in a group commit queue that has not already failed
+  as failed to write to the binlog.
+*/
+
+void
+MYSQL_BIN_LOG::set_group_commit_write_error(group_commit_entry *queue)
+{
+  for (group_commit_entry *current= queue; current; current= current->next)
+  {
+    if (!current->error)
+    {
+      current->error= ER_ERROR_ON_WRITE;
+      current->commit_errno= errno;
+      current->error_cache= NULL;
+    }
+  }
+}
+
+
+/*
+  Run the after_flush hook for every transaction of a group commit.
+
+  This is done under LOCK_log, or in the sync stage of a pipelined group
+  commit under LOCK_binlog_sync_stage; either way one group at a time and in
+  binlog order.
+
+  @retval TRUE   all transactions of the group failed
+  @retval FALSE  at least one transaction succeeded
+*/
+
+bool
+MYSQL_BIN_LOG::run_after_flush_hooks(group_commit_entry *queue, bool synced)
+{
+  bool any_error= false;
+  bool all_error= true;
+  bool first= true, last;
+
+  mysql_mutex_assert_not_owner(&LOCK_prepare_ordered);
+  mysql_mutex_assert_not_owner(&LOCK_after_binlog_sync);
+  mysql_mutex_assert_not_owner(&LOCK_commit_ordered);
+  for (group_commit_entry *current= queue; current; current= current->next)
+  {
+    last= current->next == NULL;
+    if (!current->error &&
+        RUN_HOOK(binlog_storage, after_flush,
+            (current->thd,
+             current->cache_mngr->last_commit_pos_file,
+             current->cache_mngr->last_commit_pos_offset, synced,
+             first, last)))
+    {
+      current->error= ER_ERROR_ON_WRITE;
+      current->commit_errno= -1;
+      current->error_cache= NULL;
+      any_error= true;
+    }
+    else
+      all_error= false;
+    first= false;
+  }
+
+  if (any_error)
+    sql_print_error("Failed to run 'after_flush' hooks");
+  return all_error;
+}
+
+
+/*
+  Wait until no pipelined group commit is in its sync stage.
+
+  Called with LOCK_log held, so that no new group can enter the sync stage,
+  before anything that must not overtake the sync stage of an earlier group:
+  running after_flush hooks, publishing a new binlog_end_pos, or closing the
+  binlog file.
+*/
+
+void
+MYSQL_BIN_LOG::wait_for_binlog_sync_stage()
+{
+  if (is_relay_log)
+    return;
+  mysql_mutex_lock(&LOCK_binlog_sync_stage);
+  mysql_mutex_unlock(&LOCK_binlog_sync_stage);
+}
+
 /*
   Do binlog group commit as the lead thread.
 
@@ -7514,6 +7619,10 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
   bool check_purge= false;
   ulong UNINIT_VAR(binlog_id);
   uint64 commit_id;
+  bool pipelined= false, need_sync= false, write_error= false;
+  File UNINIT_VAR(sync_fd);
+  ulonglong write_start, stage_start;
+  ulonglong write_usec, sync_usec= 0;
   DBUG_ENTER("MYSQL_BIN_LOG::trx_group_commit_leader");
 
   {
@@ -7540,6 +7649,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     group_commit_queue= NULL;
     mysql_mutex_unlock(&LOCK_prepare_ordered);
     binlog_id= current_binlog_id;
+    write_start= microsecond_interval_timer();
 
     /* As the queue is in reverse order of entering, reverse it. */
     last_in_queue= current;
@@ -7621,61 +7731,53 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
       }
     }
 
-    bool synced= 0;
-    if (flush_and_sync(&synced))
+    /*
+      With binlog_commit_pipeline=ON the fsync is done in a separate stage,
+      after LOCK_log has been released, so that the next group commit can
+      write its transactions while this one is syncing. A group that will
+      rotate the binlog syncs under LOCK_log as before, since the rotation
+      closes the file.
+    */
+    pipelined= opt_binlog_commit_pipeline &&
+               my_b_tell(&log_file) < (my_off_t) max_size;
+    if (pipelined)
     {
-      for (current= queue; current != NULL; current= current->next)
+      uint sync_period= get_sync_period();
+      if (flush_io_cache(&log_file))
       {
-        if (!current->error)
-        {
-          current->error= ER_ERROR_ON_WRITE;
-          current->commit_errno= errno;
-          current->error_cache= NULL;
-        }
+        set_group_commit_write_error(queue);
+        write_error= true;
       }
+      else if (sync_period && ++sync_counter >= sync_period)
+      {
+        sync_counter= 0;
+        need_sync= true;
+      }
+      sync_fd= log_file.file;
     }
     else
     {
-      bool any_error= false;
-      bool all_error= true;
-
-      mysql_mutex_assert_not_owner(&LOCK_prepare_ordered);
-      mysql_mutex_assert_owner(&LOCK_log);
-      mysql_mutex_assert_not_owner(&LOCK_after_binlog_sync);
-      mysql_mutex_assert_not_owner(&LOCK_commit_ordered);
-      bool first= true, last;
-      for (current= queue; current != NULL; current= current->next)
+      bool synced= 0;
+      stage_start= microsecond_interval_timer();
+      if (flush_and_sync(&synced))
+        set_group_commit_write_error(queue);
+      else
       {
-        last= current->next == NULL;
-        if (!current->error &&
-            RUN_HOOK(binlog_storage, after_flush,
-                (current->thd,
-                 current->cache_mngr->last_commit_pos_file,
-                 current->cache_mngr->last_commit_pos_offset, synced,
-                 first, last)))
-        {
-          current->error= ER_ERROR_ON_WRITE;
-          current->commit_errno= -1;
-          current->error_cache= NULL;
-          any_error= true;
-        }
-        else
-          all_error= false;
-        first= false;
+        mysql_mutex_assert_owner(&LOCK_log);
+        bool all_error= run_after_flush_hooks(queue, synced);
+
+        /* update binlog_end_pos so it can be read by dump thread
+         *
+         * note: must be _after_ the RUN_HOOK(after_flush) or else
+         * semi-sync-plugin might not have put the transaction into
+         * it's list before dump-thread tries to send it
+         */
+        update_binlog_end_pos(commit_offset);
+
+        if (!all_error)
+          signal_update();
       }
-
-      /* update binlog_end_pos so it can be read by dump thread
-       *
-       * note: must be _after_ the RUN_HOOK(after_flush) or else
-       * semi-sync-plugin might not have put the transaction into
-       * it's list before dump-thread tries to send it
-       */
-      update_binlog_end_pos(commit_offset);
-
-      if (any_error)
-        sql_print_error("Failed to run 'after_flush' hooks");
-      if (!all_error)
-        signal_update();
+      sync_usec= microsecond_interval_timer() - stage_start;
     }
 
     /*
@@ -7689,7 +7791,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
       mark_xids_active(binlog_id, xid_count);
     }
 
-    if (rotate(false, &check_purge))
+    if (!pipelined && rotate(false, &check_purge))
     {
       /*
         If we fail to rotate, which thread should get the error?
@@ -7712,17 +7814,62 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     commit_offset= my_b_write_tell(&log_file);
   }
 
-  DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_after_binlog_sync");
-  mysql_mutex_lock(&LOCK_after_binlog_sync);
-  /*
-    We cannot unlock LOCK_log until we have locked LOCK_after_binlog_sync;
-    otherwise scheduling could allow the next group commit to run ahead of us,
-    messing up the order of commit_ordered() calls. But as soon as
-    LOCK_after_binlog_sync is obtained, we can let the next group commit start.
-  */
-  mysql_mutex_unlock(&LOCK_log);
+  if (pipelined)
+  {
+    /*
+      The sync stage. As with the stages below, LOCK_binlog_sync_stage is
+      obtained before LOCK_log is released, so groups enter it one at a time
+      and in binlog order; the next group commit can then start writing
+      while we wait for the fsync.
+    */
+    stage_start= microsecond_interval_timer();
+    write_usec= stage_start - write_start;
+    DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_binlog_sync_stage");
+    mysql_mutex_lock(&LOCK_binlog_sync_stage);
+    mysql_mutex_unlock(&LOCK_log);
+
+    DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_log");
 
-  DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_log");
+    if (need_sync)
+    {
+      if (mysql_file_sync(sync_fd, MYF(MY_WME|MY_SYNC_FILESIZE)))
+      {
+        set_group_commit_write_error(queue);
+        write_error= true;
+      }
+#ifndef DBUG_OFF
+      if (opt_binlog_dbug_fsync_sleep > 0)
+        my_sleep(opt_binlog_dbug_fsync_sleep);
+#endif
+    }
+    if (!write_error)
+    {
+      run_after_flush_hooks(queue, need_sync);
+      update_binlog_end_pos_after_sync(commit_offset);
+    }
+
+    DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_after_binlog_sync");
+    mysql_mutex_lock(&LOCK_after_binlog_sync);
+    mysql_mutex_unlock(&LOCK_binlog_sync_stage);
+    sync_usec= microsecond_interval_timer() - stage_start;
+  }
+  else
+  {
+    DEBUG_SYNC(leader->thd, "commit_before_get_LOCK_after_binlog_sync");
+    mysql_mutex_lock(&LOCK_after_binlog_sync);
+    /*
+      We cannot unlock LOCK_log until we have locked LOCK_after_binlog_sync;
+      otherwise scheduling could allow the next group commit to run ahead of
+      us, messing up the order of commit_ordered() calls. But as soon as
+      LOCK_after_binlog_sync is obtained, we can let the next group commit
+      start.
+    */
+    mysql_mutex_unlock(&LOCK_log);
+    write_usec= microsecond_interval_timer() - write_start - sync_usec;
+
+    DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_log");
+  }
+  stage_start= microsecond_interval_timer();
 
   /*
     Loop through threads and run the binlog_sync hook
@@ -7761,6 +7908,8 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
   mysql_mutex_unlock(&LOCK_after_binlog_sync);
   DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_after_binlog_sync");
   ++num_group_commits;
+  group_commit_write_usec+= write_usec;
+  group_commit_sync_usec+= sync_usec;
 
   if (!opt_optimize_thread_scheduling)
   {
@@ -7784,6 +7933,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     */
     last_in_queue->check_purge= check_purge;
     last_in_queue->binlog_id= binlog_id;
+    group_commit_commit_usec+= microsecond_interval_timer() - stage_start;
 
     /* Note that we return with LOCK_commit_ordered locked! */
     DBUG_VOID_RETURN;
@@ -7820,6 +7970,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     current= next;
   }
   DEBUG_SYNC(leader->thd, "commit_after_group_run_commit_ordered");
+  group_commit_commit_usec+= microsecond_interval_timer() - stage_start;
   mysql_mutex_unlock(&LOCK_commit_ordered);
   DEBUG_SYNC(leader->thd, "commit_after_group_release_commit_ordered");
 
@@ -8191,6 +8342,9 @@ void MYSQL_BIN_LOG::close(uint exiting)
       mysql_file_seek(log_file.file, org_position, MY_SEEK_SET, MYF(0));
     }
 
+    /* Do not close the file under a pipelined group commit still syncing it */
+    wait_for_binlog_sync_stage();
+
     /* this will cleanup IO_CACHE, sync and close the file */
     MYSQL_LOG::close(exiting);
   }
@@ -10184,6 +10338,9 @@ TC_LOG_BINLOG::set_status_variables(THD *thd)
   mysql_mutex_lock(&LOCK_commit_ordered);
   binlog_status_var_num_commits= this->num_commits;
   binlog_status_var_num_group_commits= this->num_group_commits;
+  binlog_status_group_commit_write_usec= this->group_commit_write_usec;
+  binlog_status_group_commit_sync_usec= this->group_commit_sync_usec;
+  binlog_status_group_commit_commit_usec= this->group_commit_commit_usec;
   if (!have_snapshot)
   {
     set_binlog_snapshot_file(last_commit_pos_file);
@@ -88,11 +88,12 @@ class TC_LOG
 */
 extern mysql_mutex_t LOCK_prepare_ordered;
 extern mysql_cond_t COND_prepare_ordered;
+extern mysql_mutex_t LOCK_binlog_sync_stage;
 extern mysql_mutex_t LOCK_after_binlog_sync;
 extern mysql_mutex_t LOCK_commit_ordered;
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key key_LOCK_prepare_ordered, key_LOCK_commit_ordered;
-extern PSI_mutex_key key_LOCK_after_binlog_sync;
+extern PSI_mutex_key key_LOCK_binlog_sync_stage, key_LOCK_after_binlog_sync;
 extern PSI_cond_key key_COND_prepare_ordered;
 #endif
 
@@ -526,6 +527,9 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   /* The reason why the group commit was grouped */
   ulonglong group_commit_trigger_count, group_commit_trigger_timeout;
   ulonglong group_commit_trigger_lock_wait;
+  /* Time, in microseconds, spent by group commits in each pipeline stage */
+  ulonglong group_commit_write_usec, group_commit_sync_usec;
+  ulonglong group_commit_commit_usec;
 
   /* binlog encryption data */
   struct Binlog_crypt_data crypto;
@@ -558,6 +562,9 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   int queue_for_group_commit(group_commit_entry *entry);
   bool write_transaction_to_binlog_events(group_commit_entry *entry);
   void trx_group_commit_leader(group_commit_entry *leader);
+  static void set_group_commit_write_error(group_commit_entry *queue);
+  bool run_after_flush_hooks(group_commit_entry *queue, bool synced);
+  void wait_for_binlog_sync_stage();
   bool is_xidlist_idle_nolock();
 
 public:
@@ -831,6 +838,28 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   void update_binlog_end_pos(my_off_t pos)
   {
     mysql_mutex_assert_owner(&LOCK_log);
+    /*
+      A pipelined group commit may still be syncing (and will then publish)
+      an earlier position; wait for it so that binlog_end_pos never moves
+      backwards.
+    */
+    wait_for_binlog_sync_stage();
+    set_binlog_end_pos(pos);
+  }
+
+  /*
+    Same as update_binlog_end_pos(), for the sync stage of a pipelined group
+    commit which runs without LOCK_log.
+  */
+  void update_binlog_end_pos_after_sync(my_off_t pos)
+  {
+    mysql_mutex_assert_not_owner(&LOCK_log);
+    mysql_mutex_assert_owner(&LOCK_binlog_sync_stage);
+    set_binlog_end_pos(pos);
+  }
+
+  void set_binlog_end_pos(my_off_t pos)
+  {
     mysql_mutex_assert_not_owner(&LOCK_binlog_end_pos);
     lock_binlog_end_pos();
     /**
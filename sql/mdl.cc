@@ -28,19 +28,24 @@
 
 #ifdef HAVE_PSI_INTERFACE
 static PSI_mutex_key key_MDL_wait_LOCK_wait_status;
+static PSI_mutex_key key_MDL_context_LOCK_fast_path;
 
 static PSI_mutex_info all_mdl_mutexes[]=
 {
-  { &key_MDL_wait_LOCK_wait_status, "MDL_wait::LOCK_wait_status", 0}
+  { &key_MDL_wait_LOCK_wait_status, "MDL_wait::LOCK_wait_status", 0},
+  { &key_MDL_context_LOCK_fast_path, "MDL_context::LOCK_fast_path", 0}
 };
 
 static PSI_rwlock_key key_MDL_lock_rwlock;
 static PSI_rwlock_key key_MDL_context_LOCK_waiting_for;
+static PSI_rwlock_key key_MDL_map_LOCK_fast_path_contexts;
 
 static PSI_rwlock_info all_mdl_rwlocks[]=
 {
   { &key_MDL_lock_rwlock, "MDL_lock::rwlock", 0},
-  { &key_MDL_context_LOCK_waiting_for, "MDL_context::LOCK_waiting_for", 0}
+  { &key_MDL_context_LOCK_waiting_for, "MDL_context::LOCK_waiting_for", 0},
+  { &key_MDL_map_LOCK_fast_path_contexts,
+    "MDL_map::LOCK_fast_path_contexts", 0}
 };
 
 static PSI_cond_key key_MDL_wait_COND_wait_status;
@@ -110,9 +115,24 @@ void MDL_key::init_psi_keys()
 static bool mdl_initialized= 0;
 
 
+/**
+  Number of partitions the key space of the lock map is split into
+  for the purpose of the fast path (see MDL_map::m_obtrusive_locks).
+*/
+#define MDL_MAP_PARTITIONS 256
+
+struct mdl_iterate_arg;
+
 /**
   A collection of all MDL locks. A singleton,
   there is only one instance of the map in the server.
+
+  Unobtrusive locks are normally not registered in the map at all, but
+  recorded in the owning MDL_context (see MDL_context::m_fast_path).
+  The key space is split into partitions by hash value, and each
+  partition counts the obtrusive locks granted or pending for its keys.
+  Unobtrusive requests use the fast path only while their partition
+  has no obtrusive locks.
 */
 
 class MDL_map
@@ -124,12 +144,41 @@ class MDL_map
   unsigned long get_lock_owner(LF_PINS *pins, const MDL_key *key);
   void remove(LF_PINS *pins, MDL_lock *lock);
   LF_PINS *get_pins() { return lf_hash_get_pins(&m_locks); }
+
+  uint get_partition(const MDL_key *key) const
+  { return key->hash_value() % MDL_MAP_PARTITIONS; }
+  bool has_obtrusive_locks(uint partition)
+  { return my_atomic_load32(&m_obtrusive_locks[partition]) != 0; }
+  void add_obtrusive_lock(uint partition)
+  { my_atomic_add32(&m_obtrusive_locks[partition], 1); }
+  void remove_obtrusive_lock(uint partition)
+  { my_atomic_add32(&m_obtrusive_locks[partition], -1); }
+
+  void add_fast_path_context(MDL_context *ctx);
+  void remove_fast_path_context(MDL_context *ctx);
+  bool materialize_fast_path_locks(LF_PINS *pins, const MDL_key *key);
+  int iterate_fast_path_locks(mdl_iterate_arg *arg);
 private:
   LF_HASH m_locks; /**< All acquired locks in the server. */
   /** Pre-allocated MDL_lock object for GLOBAL namespace. */
   MDL_lock *m_global_lock;
   /** Pre-allocated MDL_lock object for COMMIT namespace. */
   MDL_lock *m_commit_lock;
+  /**
+    Number of granted and pending obtrusive locks for keys in each
+    partition. While it is non-zero, unobtrusive requests for keys of
+    the partition go to MDL_lock objects, like all other requests.
+  */
+  int32 m_obtrusive_locks[MDL_MAP_PARTITIONS];
+
+  typedef I_P_List<MDL_context,
+                   I_P_List_adapter<MDL_context,
+                                    &MDL_context::next_fast_path_context,
+                                    &MDL_context::prev_fast_path_context> >
+          Context_list;
+  /** Contexts which have acquired locks through the fast path. */
+  Context_list m_fast_path_contexts;
+  mysql_rwlock_t m_LOCK_fast_path_contexts;
   friend int mdl_iterate(int (*)(MDL_ticket *, void *), void *);
 };
 
@@ -337,6 +386,16 @@ class MDL_lock
     virtual bool needs_notification(const MDL_ticket *ticket) const = 0;
     virtual bool conflicting_locks(const MDL_ticket *ticket) const = 0;
     virtual bitmap_t hog_lock_types_bitmap() const = 0;
+    /**
+      Unobtrusive lock types, which are compatible with each other and
+      may be acquired through the fast path.
+    */
+    virtual bitmap_t fast_path_types_bitmap() const = 0;
+    /**
+      Obtrusive lock types, which are incompatible with some of the
+      unobtrusive lock types when granted or pending.
+    */
+    virtual bitmap_t obtrusive_types_bitmap() const = 0;
     virtual ~MDL_lock_strategy() {}
   };
 
@@ -373,6 +432,11 @@ class MDL_lock
     */
     virtual bitmap_t hog_lock_types_bitmap() const
     { return 0; }
+
+    virtual bitmap_t fast_path_types_bitmap() const
+    { return MDL_BIT(MDL_INTENTION_EXCLUSIVE); }
+    virtual bitmap_t obtrusive_types_bitmap() const
+    { return MDL_BIT(MDL_SHARED) | MDL_BIT(MDL_EXCLUSIVE); }
   private:
     static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
     static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
@@ -416,6 +480,22 @@ class MDL_lock
               MDL_BIT(MDL_EXCLUSIVE));
     }
 
+    /*
+      SU is not obtrusive: it conflicts only with itself and with
+      stronger locks, none of which can be acquired through the fast path.
+    */
+    virtual bitmap_t fast_path_types_bitmap() const
+    {
+      return (MDL_BIT(MDL_SHARED) | MDL_BIT(MDL_SHARED_HIGH_PRIO) |
+              MDL_BIT(MDL_SHARED_READ) | MDL_BIT(MDL_SHARED_WRITE));
+    }
+    virtual bitmap_t obtrusive_types_bitmap() const
+    {
+      return (MDL_BIT(MDL_SHARED_NO_WRITE) |
+              MDL_BIT(MDL_SHARED_NO_READ_WRITE) |
+              MDL_BIT(MDL_EXCLUSIVE));
+    }
+
   private:
     static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
     static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
@@ -554,10 +634,31 @@ class MDL_lock
     DBUG_ASSERT(key_arg->mdl_namespace() != MDL_key::GLOBAL &&
                 key_arg->mdl_namespace() != MDL_key::COMMIT);
     new (&lock->key) MDL_key(key_arg);
-    if (key_arg->mdl_namespace() == MDL_key::SCHEMA)
-      lock->m_strategy= &m_scoped_lock_strategy;
-    else
-      lock->m_strategy= &m_object_lock_strategy;
+    lock->m_strategy= get_strategy(key_arg);
+  }
+
+  /** Strategy to be used for locks with the given key. */
+  static const MDL_lock_strategy *get_strategy(const MDL_key *key_arg)
+  {
+    switch (key_arg->mdl_namespace())
+    {
+    case MDL_key::GLOBAL:
+    case MDL_key::SCHEMA:
+    case MDL_key::COMMIT:
+      return &m_scoped_lock_strategy;
+    default:
+      return &m_object_lock_strategy;
+    }
+  }
+
+  static bool is_fast_path_type(const MDL_key *key_arg, enum_mdl_type type)
+  {
+    return MDL_BIT(type) & get_strategy(key_arg)->fast_path_types_bitmap();
+  }
+
+  static bool is_obtrusive_type(const MDL_key *key_arg, enum_mdl_type type)
+  {
+    return MDL_BIT(type) & get_strategy(key_arg)->obtrusive_types_bitmap();
   }
 
   const MDL_lock_strategy *m_strategy;
@@ -664,7 +765,8 @@ int mdl_iterate(int (*callback)(MDL_ticket *ticket, void *arg), void *arg)
     res= mdl_iterate_lock(mdl_locks.m_global_lock, &argument) ||
          mdl_iterate_lock(mdl_locks.m_commit_lock, &argument) ||
          lf_hash_iterate(&mdl_locks.m_locks, pins,
-                         (my_hash_walk_action) mdl_iterate_lock, &argument);
+                         (my_hash_walk_action) mdl_iterate_lock, &argument) ||
+         mdl_locks.iterate_fast_path_locks(&argument);
     lf_hash_put_pins(pins);
   }
   DBUG_RETURN(res);
@@ -695,6 +797,11 @@ void MDL_map::init()
   m_locks.alloc.destructor= MDL_lock::lf_alloc_destructor;
   m_locks.initializer= (lf_hash_initializer) MDL_lock::lf_hash_initializer;
   m_locks.hash_function= mdl_hash_function;
+
+  bzero(m_obtrusive_locks, sizeof(m_obtrusive_locks));
+  m_fast_path_contexts.empty();
+  mysql_rwlock_init(key_MDL_map_LOCK_fast_path_contexts,
+                    &m_LOCK_fast_path_contexts);
 }
 
 
@@ -710,6 +817,9 @@ void MDL_map::destroy()
 
   DBUG_ASSERT(!my_atomic_load32(&m_locks.count));
   lf_hash_destroy(&m_locks);
+
+  DBUG_ASSERT(m_fast_path_contexts.is_empty());
+  mysql_rwlock_destroy(&m_LOCK_fast_path_contexts);
 }
 
 
@@ -831,6 +941,101 @@ void MDL_map::remove(LF_PINS *pins, MDL_lock *lock)
 }
 
 
+/**
+  Make fast path locks of the context visible to obtrusive requests.
+  Must be called before the context acquires its first fast path lock.
+*/
+
+void MDL_map::add_fast_path_context(MDL_context *ctx)
+{
+  mysql_rwlock_wrlock(&m_LOCK_fast_path_contexts);
+  m_fast_path_contexts.push_front(ctx);
+  mysql_rwlock_unlock(&m_LOCK_fast_path_contexts);
+}
+
+
+void MDL_map::remove_fast_path_context(MDL_context *ctx)
+{
+  mysql_rwlock_wrlock(&m_LOCK_fast_path_contexts);
+  m_fast_path_contexts.remove(ctx);
+  mysql_rwlock_unlock(&m_LOCK_fast_path_contexts);
+}
+
+
+/**
+  Move all locks on the key which were acquired through the fast path
+  to the MDL_lock object for the key, so that an obtrusive request can
+  see them in MDL_lock::m_granted.
+
+  @pre The caller has already counted its request in the partition
+       of the key, so no new fast path locks on the key can appear.
+
+  This is safe against a concurrent fast path acquisition since the
+  acquiring context checks the counter of obtrusive locks while
+  holding its MDL_context::m_LOCK_fast_path: either it sees the
+  counter incremented and takes the slow path, or it has published
+  its ticket before we lock its m_LOCK_fast_path here.
+
+  @retval FALSE  Success.
+  @retval TRUE   Failure (OOM).
+*/
+
+bool MDL_map::materialize_fast_path_locks(LF_PINS *pins, const MDL_key *key)
+{
+  MDL_context *ctx;
+  bool res= FALSE;
+
+  mysql_rwlock_rdlock(&m_LOCK_fast_path_contexts);
+  /* Must be initialized after taking a read lock. */
+  Context_list::Iterator it(m_fast_path_contexts);
+  while (!res && (ctx= it++))
+  {
+    mysql_mutex_lock(&ctx->m_LOCK_fast_path);
+    for (uint i= 0; ctx->m_fast_path_count && i < MDL_FAST_PATH_SLOTS; i++)
+    {
+      MDL_ticket *ticket= ctx->m_fast_path[i];
+      if (ticket && ticket->m_key.is_equal(key) &&
+          (res= ctx->materialize_fast_path_lock(pins, i)))
+        break;
+    }
+    mysql_mutex_unlock(&ctx->m_LOCK_fast_path);
+  }
+  mysql_rwlock_unlock(&m_LOCK_fast_path_contexts);
+  return res;
+}
+
+
+/**
+  Apply mdl_iterate() callback to all locks held through the fast path.
+
+  @note Since locks are iterated without any global lock, a ticket
+        which is materialized concurrently can be seen twice or not
+        at all.
+*/
+
+int MDL_map::iterate_fast_path_locks(mdl_iterate_arg *arg)
+{
+  MDL_context *ctx;
+  int res= 0;
+
+  mysql_rwlock_rdlock(&m_LOCK_fast_path_contexts);
+  /* Must be initialized after taking a read lock. */
+  Context_list::Iterator it(m_fast_path_contexts);
+  while (!res && (ctx= it++))
+  {
+    mysql_mutex_lock(&ctx->m_LOCK_fast_path);
+    for (uint i= 0; !res && i < MDL_FAST_PATH_SLOTS; i++)
+    {
+      if (ctx->m_fast_path[i])
+        res= arg->callback(ctx->m_fast_path[i], arg->argument);
+    }
+    mysql_mutex_unlock(&ctx->m_LOCK_fast_path);
+  }
+  mysql_rwlock_unlock(&m_LOCK_fast_path_contexts);
+  return MY_TEST(res);
+}
+
+
 /**
   Initialize a metadata locking context.
 
@@ -842,9 +1047,14 @@ MDL_context::MDL_context()
   m_owner(NULL),
   m_needs_thr_lock_abort(FALSE),
   m_waiting_for(NULL),
-  m_pins(NULL)
+  m_pins(NULL),
+  m_fast_path_count(0),
+  m_fast_path_registered(FALSE),
+  m_acquire_tracker(NULL)
 {
   mysql_prlock_init(key_MDL_context_LOCK_waiting_for, &m_LOCK_waiting_for);
+  mysql_mutex_init(key_MDL_context_LOCK_fast_path, &m_LOCK_fast_path, NULL);
+  bzero(m_fast_path, sizeof(m_fast_path));
 }
 
 
@@ -865,7 +1075,11 @@ void MDL_context::destroy()
   DBUG_ASSERT(m_tickets[MDL_STATEMENT].is_empty());
   DBUG_ASSERT(m_tickets[MDL_TRANSACTION].is_empty());
   DBUG_ASSERT(m_tickets[MDL_EXPLICIT].is_empty());
+  DBUG_ASSERT(m_fast_path_count == 0);
 
+  if (m_fast_path_registered)
+    mdl_locks.remove_fast_path_context(this);
+  mysql_mutex_destroy(&m_LOCK_fast_path);
   mysql_prlock_destroy(&m_LOCK_waiting_for);
   if (m_pins)
     lf_hash_put_pins(m_pins);
@@ -969,7 +1183,7 @@ void MDL_ticket::destroy(MDL_ticket *ticket)
 
 uint MDL_ticket::get_deadlock_weight() const
 {
-  return (m_lock->key.mdl_namespace() == MDL_key::GLOBAL ||
+  return (get_key()->mdl_namespace() == MDL_key::GLOBAL ||
           m_type >= MDL_SHARED_UPGRADABLE ?
           DEADLOCK_WEIGHT_DDL : DEADLOCK_WEIGHT_DML);
 }
@@ -1703,8 +1917,8 @@ MDL_wait_for_subgraph::~MDL_wait_for_subgraph()
 
 bool MDL_ticket::has_stronger_or_equal_type(enum_mdl_type type) const
 {
-  const MDL_lock::bitmap_t *
-    granted_incompat_map= m_lock->incompatible_granted_types_bitmap();
+  const MDL_lock::bitmap_t *granted_incompat_map=
+    MDL_lock::get_strategy(get_key())->incompatible_granted_types_bitmap();
 
   return ! (granted_incompat_map[type] & ~(granted_incompat_map[m_type]));
 }
@@ -1713,14 +1927,16 @@ bool MDL_ticket::has_stronger_or_equal_type(enum_mdl_type type) const
 bool MDL_ticket::is_incompatible_when_granted(enum_mdl_type type) const
 {
   return (MDL_BIT(m_type) &
-          m_lock->incompatible_granted_types_bitmap()[type]);
+          MDL_lock::get_strategy(get_key())->
+            incompatible_granted_types_bitmap()[type]);
 }
 
 
 bool MDL_ticket::is_incompatible_when_waiting(enum_mdl_type type) const
 {
   return (MDL_BIT(m_type) &
-          m_lock->incompatible_waiting_types_bitmap()[type]);
+          MDL_lock::get_strategy(get_key())->
+            incompatible_waiting_types_bitmap()[type]);
 }
 
 
@@ -1754,7 +1970,7 @@ MDL_context::find_ticket(MDL_request *mdl_request,
 
     while ((ticket= it++))
     {
-      if (mdl_request->key.is_equal(&ticket->m_lock->key) &&
+      if (mdl_request->key.is_equal(ticket->get_key()) &&
           ticket->has_stronger_or_equal_type(mdl_request->type))
       {
         DBUG_PRINT("info", ("Adding mdl lock %d to %d",
@@ -1798,11 +2014,14 @@ bool
 MDL_context::try_acquire_lock(MDL_request *mdl_request)
 {
   MDL_ticket *ticket;
+  bool res= FALSE;
 
-  if (try_acquire_lock_impl(mdl_request, &ticket))
-    return TRUE;
+  if (unlikely(m_acquire_tracker))
+    m_acquire_tracker->start_tracking();
 
-  if (! mdl_request->ticket)
+  if (try_acquire_lock_impl(mdl_request, &ticket))
+    res= TRUE;
+  else if (! mdl_request->ticket)
   {
     /*
       Our attempt to acquire lock without waiting has failed.
@@ -1812,10 +2031,15 @@ MDL_context::try_acquire_lock(MDL_request *mdl_request)
     */
     DBUG_ASSERT(! ticket->m_lock->is_empty());
     mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
+    if (MDL_lock::is_obtrusive_type(&mdl_request->key, mdl_request->type))
+      mdl_locks.remove_obtrusive_lock(
+        mdl_locks.get_partition(&mdl_request->key));
     MDL_ticket::destroy(ticket);
   }
 
-  return FALSE;
+  if (unlikely(m_acquire_tracker))
+    m_acquire_tracker->stop_tracking();
+  return res;
 }
 
 
@@ -1857,7 +2081,6 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
   */
   if ((ticket= find_ticket(mdl_request, &found_duration)))
   {
-    DBUG_ASSERT(ticket->m_lock);
     DBUG_ASSERT(ticket->has_stronger_or_equal_type(mdl_request->type));
     /*
       If the request is for a transactional lock, and we found
@@ -1898,9 +2121,37 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
                                    )))
     return TRUE;
 
+  if (MDL_lock::is_fast_path_type(key, mdl_request->type))
+  {
+    if (try_acquire_lock_fast_path(ticket, key))
+    {
+      m_tickets[mdl_request->duration].push_front(ticket);
+      mdl_request->ticket= ticket;
+      return FALSE;
+    }
+  }
+  else if (MDL_lock::is_obtrusive_type(key, mdl_request->type))
+  {
+    /*
+      Stop new fast path acquisitions for the key and make the existing
+      ones visible to MDL_lock::can_grant_lock() and to the deadlock
+      detector. The counter is decremented when the ticket is released,
+      or destroyed without having been granted.
+    */
+    mdl_locks.add_obtrusive_lock(mdl_locks.get_partition(key));
+    if (mdl_locks.materialize_fast_path_locks(m_pins, key))
+    {
+      mdl_locks.remove_obtrusive_lock(mdl_locks.get_partition(key));
+      MDL_ticket::destroy(ticket);
+      return TRUE;
+    }
+  }
+
   /* The below call implicitly locks MDL_lock::m_rwlock on success. */
   if (!(lock= mdl_locks.find_or_insert(m_pins, key)))
   {
+    if (MDL_lock::is_obtrusive_type(key, mdl_request->type))
+      mdl_locks.remove_obtrusive_lock(mdl_locks.get_partition(key));
     MDL_ticket::destroy(ticket);
     return TRUE;
   }
@@ -1924,6 +2175,117 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
 }
 
 
+/**
+  Try to acquire an unobtrusive lock through the fast path, i.e. by
+  recording the ticket in the context instead of the MDL_lock object.
+
+  @param ticket  Ticket for the request, not yet granted.
+  @param key     Key of the object to be locked.
+
+  @retval TRUE   The lock was acquired.
+  @retval FALSE  There are obtrusive locks in the partition of the key
+                 or no free fast path slots, the lock must be acquired
+                 through MDL_lock.
+*/
+
+bool MDL_context::try_acquire_lock_fast_path(MDL_ticket *ticket,
+                                             const MDL_key *key)
+{
+  uint partition= mdl_locks.get_partition(key);
+  uint i;
+
+  /* Cheap checks first, they are repeated under the mutex below. */
+  if (m_fast_path_count == MDL_FAST_PATH_SLOTS ||
+      mdl_locks.has_obtrusive_locks(partition))
+    return FALSE;
+
+  if (!m_fast_path_registered)
+  {
+    mdl_locks.add_fast_path_context(this);
+    m_fast_path_registered= TRUE;
+  }
+
+  ticket->m_key.mdl_key_init(key);
+
+  mysql_mutex_lock(&m_LOCK_fast_path);
+  /* See MDL_map::materialize_fast_path_locks(). */
+  if (m_fast_path_count == MDL_FAST_PATH_SLOTS ||
+      mdl_locks.has_obtrusive_locks(partition))
+  {
+    mysql_mutex_unlock(&m_LOCK_fast_path);
+    return FALSE;
+  }
+  for (i= 0; m_fast_path[i]; i++)
+    /* no-op */;
+  m_fast_path[i]= ticket;
+  m_fast_path_count++;
+  mysql_mutex_unlock(&m_LOCK_fast_path);
+  return TRUE;
+}
+
+
+/**
+  Release a lock acquired through the fast path.
+
+  @retval TRUE   The lock was released.
+  @retval FALSE  The ticket was moved to the MDL_lock object by some
+                 obtrusive request, it must be released from there.
+*/
+
+bool MDL_context::release_lock_fast_path(MDL_ticket *ticket)
+{
+  bool found= FALSE;
+
+  mysql_mutex_lock(&m_LOCK_fast_path);
+  for (uint i= 0; i < MDL_FAST_PATH_SLOTS; i++)
+  {
+    if (m_fast_path[i] == ticket)
+    {
+      m_fast_path[i]= NULL;
+      m_fast_path_count--;
+      found= TRUE;
+      break;
+    }
+  }
+  mysql_mutex_unlock(&m_LOCK_fast_path);
+  return found;
+}
+
+
+/**
+  Move a fast path ticket of this context to the MDL_lock object for
+  its key. Can be called by any thread.
+
+  @pre m_LOCK_fast_path is locked.
+
+  @param pins  Pins of the calling context.
+  @param slot  Fast path slot of the ticket.
+
+  @retval FALSE  Success.
+  @retval TRUE   Failure (OOM).
+*/
+
+bool MDL_context::materialize_fast_path_lock(LF_PINS *pins, uint slot)
+{
+  MDL_ticket *ticket= m_fast_path[slot];
+  MDL_lock *lock;
+
+  mysql_mutex_assert_owner(&m_LOCK_fast_path);
+
+  /* The below call implicitly locks MDL_lock::m_rwlock on success. */
+  if (!(lock= mdl_locks.find_or_insert(pins, &ticket->m_key)))
+    return TRUE;
+
+  my_atomic_storeptr((void**) &ticket->m_lock, lock);
+  lock->m_granted.add_ticket(ticket);
+  mysql_prlock_unlock(&lock->m_rwlock);
+
+  m_fast_path[slot]= NULL;
+  m_fast_path_count--;
+  return FALSE;
+}
+
+
 /**
   Create a copy of a granted ticket.
   This is used to make sure that HANDLER ticket
@@ -1940,7 +2302,9 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
 bool
 MDL_context::clone_ticket(MDL_request *mdl_request)
 {
-  MDL_ticket *ticket;
+  MDL_ticket *ticket, *src_ticket;
+  MDL_context *src_ctx;
+  MDL_lock *lock;
 
 
   /*
@@ -1968,12 +2332,50 @@ MDL_context::clone_ticket(MDL_request *mdl_request)
   /* clone() is not supposed to be used to get a stronger lock. */
   DBUG_ASSERT(mdl_request->ticket->has_stronger_or_equal_type(ticket->m_type));
 
-  ticket->m_lock= mdl_request->ticket->m_lock;
+  src_ticket= mdl_request->ticket;
+  src_ctx= src_ticket->get_ctx();
+
+  if (!my_atomic_loadptr((void**) &src_ticket->m_lock))
+  {
+    /*
+      The source ticket was acquired through the fast path, so has
+      an unobtrusive type, and so does the copy.
+    */
+    if (try_acquire_lock_fast_path(ticket, &src_ticket->m_key))
+    {
+      mdl_request->ticket= ticket;
+      m_tickets[mdl_request->duration].push_front(ticket);
+      return FALSE;
+    }
+
+    /*
+      Obtrusive locks have appeared in the partition, or we are out of
+      fast path slots. Move the source ticket to its MDL_lock object
+      unless a concurrent obtrusive request has already done that.
+    */
+    mysql_mutex_lock(&src_ctx->m_LOCK_fast_path);
+    for (uint i= 0; i < MDL_FAST_PATH_SLOTS; i++)
+    {
+      if (src_ctx->m_fast_path[i] == src_ticket &&
+          src_ctx->materialize_fast_path_lock(m_pins, i))
+      {
+        mysql_mutex_unlock(&src_ctx->m_LOCK_fast_path);
+        MDL_ticket::destroy(ticket);
+        return TRUE;
+      }
+    }
+    mysql_mutex_unlock(&src_ctx->m_LOCK_fast_path);
+  }
+
+  lock= ticket->m_lock= src_ticket->m_lock;
   mdl_request->ticket= ticket;
 
-  mysql_prlock_wrlock(&ticket->m_lock->m_rwlock);
-  ticket->m_lock->m_granted.add_ticket(ticket);
-  mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
+  if (MDL_lock::is_obtrusive_type(&lock->key, ticket->m_type))
+    mdl_locks.add_obtrusive_lock(mdl_locks.get_partition(&lock->key));
+
+  mysql_prlock_wrlock(&lock->m_rwlock);
+  lock->m_granted.add_ticket(ticket);
+  mysql_prlock_unlock(&lock->m_rwlock);
 
   m_tickets[mdl_request->duration].push_front(ticket);
 
@@ -2044,11 +2446,27 @@ bool MDL_lock::check_if_conflicting_replication_locks(MDL_context *ctx)
 
 bool
 MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
+{
+  bool res;
+
+  if (likely(!m_acquire_tracker))
+    return acquire_lock_impl(mdl_request, lock_wait_timeout);
+
+  m_acquire_tracker->start_tracking();
+  res= acquire_lock_impl(mdl_request, lock_wait_timeout);
+  m_acquire_tracker->stop_tracking();
+  return res;
+}
+
+
+bool
+MDL_context::acquire_lock_impl(MDL_request *mdl_request,
+                               double lock_wait_timeout)
 {
   MDL_lock *lock;
   MDL_ticket *ticket;
   MDL_wait::enum_wait_status wait_status;
-  DBUG_ENTER("MDL_context::acquire_lock");
+  DBUG_ENTER("MDL_context::acquire_lock_impl");
   DBUG_PRINT("enter", ("lock_type: %d", mdl_request->type));
 
   if (try_acquire_lock_impl(mdl_request, &ticket))
@@ -2152,7 +2570,12 @@ MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
 
   if (wait_status != MDL_wait::GRANTED)
   {
+    bool is_obtrusive= MDL_lock::is_obtrusive_type(&mdl_request->key,
+                                                   mdl_request->type);
     lock->remove_ticket(m_pins, &MDL_lock::m_waiting, ticket);
+    if (is_obtrusive)
+      mdl_locks.remove_obtrusive_lock(
+        mdl_locks.get_partition(&mdl_request->key));
     MDL_ticket::destroy(ticket);
     switch (wait_status)
     {
@@ -2295,6 +2718,7 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
   MDL_request mdl_xlock_request;
   MDL_savepoint mdl_svp= mdl_savepoint();
   bool is_new_ticket;
+  bool was_obtrusive;
   DBUG_ENTER("MDL_context::upgrade_shared_lock");
   DBUG_PRINT("enter",("new_type: %d  lock_wait_timeout: %f", new_type,
                       lock_wait_timeout));
@@ -2314,6 +2738,8 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
 
   mdl_xlock_request.init(&mdl_ticket->m_lock->key, new_type,
                          MDL_TRANSACTION);
+  was_obtrusive= MDL_lock::is_obtrusive_type(&mdl_xlock_request.key,
+                                             mdl_ticket->m_type);
 
   if (acquire_lock(&mdl_xlock_request, lock_wait_timeout))
     DBUG_RETURN(TRUE);
@@ -2341,6 +2767,20 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
     MDL_ticket::destroy(mdl_xlock_request.ticket);
   }
 
+  /*
+    The original ticket now accounts for the obtrusive lock, if any,
+    that the new ticket was counted for.
+  */
+  if (MDL_lock::is_obtrusive_type(&mdl_xlock_request.key, new_type))
+  {
+    if (is_new_ticket && was_obtrusive)
+      mdl_locks.remove_obtrusive_lock(
+        mdl_locks.get_partition(&mdl_xlock_request.key));
+    else if (!is_new_ticket && !was_obtrusive)
+      mdl_locks.add_obtrusive_lock(
+        mdl_locks.get_partition(&mdl_xlock_request.key));
+  }
+
   DBUG_RETURN(FALSE);
 }
 
@@ -2602,14 +3042,36 @@ void MDL_context::find_deadlock()
 
 void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
 {
-  MDL_lock *lock= ticket->m_lock;
+  MDL_lock *lock;
   DBUG_ENTER("MDL_context::release_lock");
   DBUG_PRINT("enter", ("db: '%s' name: '%s'",
-                       lock->key.db_name(), lock->key.name()));
+                       ticket->get_key()->db_name(),
+                       ticket->get_key()->name()));
 
   DBUG_ASSERT(this == ticket->get_ctx());
 
-  lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
+  /*
+    m_lock of a fast path ticket can only change under m_LOCK_fast_path,
+    so if it is already set here, it can be used without the mutex.
+  */
+  if (!(lock= (MDL_lock*) my_atomic_loadptr((void**) &ticket->m_lock)) &&
+      release_lock_fast_path(ticket))
+  {
+    m_tickets[duration].remove(ticket);
+    MDL_ticket::destroy(ticket);
+    DBUG_VOID_RETURN;
+  }
+  lock= ticket->m_lock;
+
+  if (MDL_lock::is_obtrusive_type(&lock->key, ticket->m_type))
+  {
+    /* The lock object may be gone after remove_ticket(). */
+    uint partition= mdl_locks.get_partition(&lock->key);
+    lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
+    mdl_locks.remove_obtrusive_lock(partition);
+  }
+  else
+    lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
 
   m_tickets[duration].remove(ticket);
   MDL_ticket::destroy(ticket);
@@ -2676,8 +3138,12 @@ void MDL_context::release_locks_stored_before(enum_mdl_duration duration,
 
 void MDL_context::release_all_locks_for_name(MDL_ticket *name)
 {
-  /* Use MDL_ticket::m_lock to identify other locks for the same object. */
-  MDL_lock *lock= name->m_lock;
+  /*
+    Use the key to identify other locks for the same object, as locks
+    acquired through the fast path have no MDL_lock object.
+    The key is copied since 'name' itself is among the released tickets.
+  */
+  MDL_key key(name->get_key());
 
   /* Remove matching lock tickets from the context. */
   MDL_ticket *ticket;
@@ -2685,8 +3151,7 @@ void MDL_context::release_all_locks_for_name(MDL_ticket *name)
 
   while ((ticket= it_ticket++))
   {
-    DBUG_ASSERT(ticket->m_lock);
-    if (ticket->m_lock == lock)
+    if (ticket->get_key()->is_equal(&key))
       release_lock(MDL_EXPLICIT, ticket);
   }
 }
@@ -2714,6 +3179,8 @@ void MDL_ticket::downgrade_lock(enum_mdl_type type)
   DBUG_ASSERT(m_type == MDL_EXCLUSIVE ||
               m_type == MDL_SHARED_NO_WRITE);
 
+  bool was_obtrusive= MDL_lock::is_obtrusive_type(&m_lock->key, m_type);
+
   mysql_prlock_wrlock(&m_lock->m_rwlock);
   /*
     To update state of MDL_lock object correctly we need to temporarily
@@ -2724,6 +3191,9 @@ void MDL_ticket::downgrade_lock(enum_mdl_type type)
   m_lock->m_granted.add_ticket(this);
   m_lock->reschedule_waiters();
   mysql_prlock_unlock(&m_lock->m_rwlock);
+
+  if (was_obtrusive && !MDL_lock::is_obtrusive_type(&m_lock->key, type))
+    mdl_locks.remove_obtrusive_lock(mdl_locks.get_partition(&m_lock->key));
 }
 
 
@@ -2752,8 +3222,6 @@ MDL_context::is_lock_owner(MDL_key::enum_mdl_namespace mdl_namespace,
   mdl_request.init(mdl_namespace, db, name, mdl_type, MDL_TRANSACTION);
   MDL_ticket *ticket= find_ticket(&mdl_request, &not_unused);
 
-  DBUG_ASSERT(ticket == NULL || ticket->m_lock);
-
   return ticket;
 }
 
@@ -2770,6 +3238,8 @@ MDL_context::is_lock_owner(MDL_key::enum_mdl_namespace mdl_namespace,
 unsigned long
 MDL_context::get_lock_owner(MDL_key *key)
 {
+  /* Owners of fast path locks would not be seen. */
+  DBUG_ASSERT(key->mdl_namespace() == MDL_key::USER_LOCK);
   fix_pins();
   return mdl_locks.get_lock_owner(m_pins, key);
 }
@@ -2785,13 +3255,20 @@ MDL_context::get_lock_owner(MDL_key *key)
 
 bool MDL_ticket::has_pending_conflicting_lock() const
 {
-  return m_lock->has_pending_conflicting_lock(m_type);
+  MDL_lock *lock= (MDL_lock*) my_atomic_loadptr((void**) &m_lock);
+
+  /*
+    A fast path ticket is moved to MDL_lock before any conflicting
+    request starts waiting for it.
+  */
+  return lock && lock->has_pending_conflicting_lock(m_type);
 }
 
 /** Return a key identifying this lock. */
 MDL_key *MDL_ticket::get_key() const
 {
-        return &m_lock->key;
+  MDL_lock *lock= (MDL_lock*) my_atomic_loadptr((void**) &m_lock);
+  return lock ? &lock->key : const_cast<MDL_key*>(&m_key);
 }
 
 /**
@@ -3001,7 +3478,8 @@ void MDL_ticket::wsrep_report(bool debug)
 {
   if (debug)
   {
-      const PSI_stage_info *psi_stage = m_lock->key.get_wait_state_name();
+      const MDL_key *key= get_key();
+      const PSI_stage_info *psi_stage = key->get_wait_state_name();
 
       WSREP_DEBUG("MDL ticket: type: %s space: %s db: %s name: %s (%s)",
        	 (get_type()  == MDL_INTENTION_EXCLUSIVE)  ? "intention exclusive"  :
@@ -3013,17 +3491,17 @@ void MDL_ticket::wsrep_report(bool debug)
          ((get_type() == MDL_SHARED_NO_READ_WRITE) ? "shared no read write" :
        	 ((get_type() == MDL_EXCLUSIVE)            ? "exclusive"            :
           "UNKNOWN")))))))),
-         (m_lock->key.mdl_namespace()  == MDL_key::GLOBAL) ? "GLOBAL"       :
-         ((m_lock->key.mdl_namespace() == MDL_key::SCHEMA) ? "SCHEMA"       :
-         ((m_lock->key.mdl_namespace() == MDL_key::TABLE)  ? "TABLE"        :
-         ((m_lock->key.mdl_namespace() == MDL_key::TABLE)  ? "FUNCTION"     :
-         ((m_lock->key.mdl_namespace() == MDL_key::TABLE)  ? "PROCEDURE"    :
-         ((m_lock->key.mdl_namespace() == MDL_key::TABLE)  ? "TRIGGER"      :
-         ((m_lock->key.mdl_namespace() == MDL_key::TABLE)  ? "EVENT"        :
-         ((m_lock->key.mdl_namespace() == MDL_key::COMMIT) ? "COMMIT"       :
+         (key->mdl_namespace()  == MDL_key::GLOBAL) ? "GLOBAL"       :
+         ((key->mdl_namespace() == MDL_key::SCHEMA) ? "SCHEMA"       :
+         ((key->mdl_namespace() == MDL_key::TABLE)  ? "TABLE"        :
+         ((key->mdl_namespace() == MDL_key::TABLE)  ? "FUNCTION"     :
+         ((key->mdl_namespace() == MDL_key::TABLE)  ? "PROCEDURE"    :
+         ((key->mdl_namespace() == MDL_key::TABLE)  ? "TRIGGER"      :
+         ((key->mdl_namespace() == MDL_key::TABLE)  ? "EVENT"        :
+         ((key->mdl_namespace() == MDL_key::COMMIT) ? "COMMIT"       :
          (char *)"UNKNOWN"))))))),
-         m_lock->key.db_name(),
-       	 m_lock->key.name(),
+         key->db_name(),
+       	 key->name(),
          psi_stage->m_name);
     }
 }
@@ -37,6 +37,7 @@ class THD;
 class MDL_context;
 class MDL_lock;
 class MDL_ticket;
+class Exec_time_tracker;
 bool  ok_for_lower_case_names(const char *name);
 
 /**
@@ -616,6 +617,7 @@ class MDL_ticket : public MDL_wait_for_subgraph
   virtual uint get_deadlock_weight() const;
 private:
   friend class MDL_context;
+  friend class MDL_map;
 
   MDL_ticket(MDL_context *ctx_arg, enum_mdl_type type_arg
 #ifndef DBUG_OFF
@@ -653,9 +655,19 @@ class MDL_ticket : public MDL_wait_for_subgraph
 
   /**
     Pointer to the lock object for this lock ticket. Externally accessible.
+    NULL for locks acquired through the fast path, until some obtrusive
+    request moves the ticket to the MDL_lock object (see
+    MDL_context::m_fast_path). Such a change is done under protection
+    of MDL_context::m_LOCK_fast_path of the ticket owner.
   */
   MDL_lock *m_lock;
 
+  /**
+    Copy of the key for locks acquired through the fast path, which
+    are not associated with any MDL_lock object. Externally accessible.
+  */
+  MDL_key m_key;
+
 private:
   MDL_ticket(const MDL_ticket &);               /* not implemented */
   MDL_ticket &operator=(const MDL_ticket &);    /* not implemented */
@@ -734,6 +746,12 @@ typedef I_P_List<MDL_request, I_P_List_adapter<MDL_request,
                  I_P_List_counter>
         MDL_request_list;
 
+/**
+  Maximal number of locks a context can hold through the fast path
+  at the same time. Further unobtrusive locks use the MDL_lock object.
+*/
+#define MDL_FAST_PATH_SLOTS 16
+
 /**
   Context of the owner of metadata locks. I.e. each server
   connection has such a context.
@@ -813,6 +831,13 @@ class MDL_context
   */
   void init(MDL_context_owner *arg) { m_owner= arg; }
 
+  /**
+    Start or stop measuring the time spent in acquire_lock() and
+    try_acquire_lock(). Used by ANALYZE statements.
+  */
+  void set_acquire_tracker(Exec_time_tracker *tracker)
+  { m_acquire_tracker= tracker; }
+
   void set_needs_thr_lock_abort(bool needs_thr_lock_abort)
   {
     /*
@@ -920,13 +945,45 @@ class MDL_context
    */
   MDL_wait_for_subgraph *m_waiting_for;
   LF_PINS *m_pins;
+  /**
+    Unobtrusive locks (e.g. SR and SW table locks or the global IX lock)
+    which were acquired through the fast path. Such locks are recorded
+    only here and not in MDL_lock::m_granted, so acquiring and releasing
+    them touches neither the lock hash nor MDL_lock::m_rwlock.
+
+    A context which requests an obtrusive lock (one conflicting with
+    unobtrusive lock types, e.g. X) first disables the fast path for
+    the partition of the lock map the key belongs to and then moves
+    all matching fast path tickets of all contexts to their MDL_lock
+    objects, see MDL_map::materialize_fast_path_locks().
+
+    Protected by m_LOCK_fast_path.
+  */
+  MDL_ticket *m_fast_path[MDL_FAST_PATH_SLOTS];
+  uint m_fast_path_count;
+  mysql_mutex_t m_LOCK_fast_path;
+  /** TRUE if the context is in the list of contexts using the fast path. */
+  bool m_fast_path_registered;
+  /** Time spent acquiring locks, if requested by ANALYZE. */
+  Exec_time_tracker *m_acquire_tracker;
+public:
+  /**
+    Pointers for participating in the list of contexts which can hold
+    locks acquired through the fast path. Protected by the list lock.
+  */
+  MDL_context *next_fast_path_context;
+  MDL_context **prev_fast_path_context;
 private:
   MDL_ticket *find_ticket(MDL_request *mdl_req,
                           enum_mdl_duration *duration);
   void release_locks_stored_before(enum_mdl_duration duration, MDL_ticket *sentinel);
   void release_lock(enum_mdl_duration duration, MDL_ticket *ticket);
+  bool acquire_lock_impl(MDL_request *mdl_request, double lock_wait_timeout);
   bool try_acquire_lock_impl(MDL_request *mdl_request,
                              MDL_ticket **out_ticket);
+  bool try_acquire_lock_fast_path(MDL_ticket *ticket, const MDL_key *key);
+  bool release_lock_fast_path(MDL_ticket *ticket);
+  bool materialize_fast_path_lock(LF_PINS *pins, uint slot);
   bool fix_pins();
 
 public:
@@ -967,6 +1024,7 @@ class MDL_context
 
   /* metadata_lock_info plugin */
   friend int i_s_metadata_lock_info_fill_row(MDL_ticket*, void*);
+  friend class MDL_map;
 };
 
 
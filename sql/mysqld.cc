@@ -568,6 +568,7 @@ ulong opt_slave_domain_parallel_threads= 0;
 ulong opt_slave_parallel_mode= SLAVE_PARALLEL_CONSERVATIVE;
 ulong opt_binlog_commit_wait_count= 0;
 ulong opt_binlog_commit_wait_usec= 0;
+my_bool opt_binlog_commit_pipeline= FALSE;
 ulong opt_slave_parallel_max_queued= 131072;
 my_bool opt_gtid_ignore_duplicates= FALSE;
 
@@ -895,7 +896,7 @@ PSI_mutex_key key_LOCK_stats,
   key_LOCK_wakeup_ready, key_LOCK_wait_commit;
 PSI_mutex_key key_LOCK_gtid_waiting;
 
-PSI_mutex_key key_LOCK_after_binlog_sync;
+PSI_mutex_key key_LOCK_binlog_sync_stage, key_LOCK_after_binlog_sync;
 PSI_mutex_key key_LOCK_prepare_ordered, key_LOCK_commit_ordered,
   key_LOCK_slave_background;
 PSI_mutex_key key_TABLE_SHARE_LOCK_share;
@@ -961,6 +962,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_TABLE_SHARE_LOCK_share, "TABLE_SHARE::LOCK_share", 0},
   { &key_LOCK_error_messages, "LOCK_error_messages", PSI_FLAG_GLOBAL},
   { &key_LOCK_prepare_ordered, "LOCK_prepare_ordered", PSI_FLAG_GLOBAL},
+  { &key_LOCK_binlog_sync_stage, "LOCK_binlog_sync_stage", PSI_FLAG_GLOBAL},
   { &key_LOCK_after_binlog_sync, "LOCK_after_binlog_sync", PSI_FLAG_GLOBAL},
   { &key_LOCK_commit_ordered, "LOCK_commit_ordered", PSI_FLAG_GLOBAL},
   { &key_LOCK_slave_background, "LOCK_slave_background", PSI_FLAG_GLOBAL},
@@ -1431,7 +1433,8 @@ int deny_severity = LOG_WARNING;
 #endif
 #ifdef HAVE_QUERY_CACHE
 ulong query_cache_min_res_unit= QUERY_CACHE_MIN_RESULT_DATA_SIZE;
-Query_cache query_cache;
+uint query_cache_partitions= 1;
+Partitioned_query_cache query_cache;
 #endif
 #ifdef HAVE_SMEM
 char *shared_memory_base_name= default_shared_memory_base_name;
@@ -2261,6 +2264,7 @@ static void clean_up_mutexes()
   mysql_cond_destroy(&COND_server_started);
   mysql_mutex_destroy(&LOCK_prepare_ordered);
   mysql_cond_destroy(&COND_prepare_ordered);
+  mysql_mutex_destroy(&LOCK_binlog_sync_stage);
   mysql_mutex_destroy(&LOCK_after_binlog_sync);
   mysql_mutex_destroy(&LOCK_commit_ordered);
   mysql_mutex_destroy(&LOCK_slave_background);
@@ -4588,6 +4592,8 @@ static int init_thread_environment()
   mysql_mutex_init(key_LOCK_prepare_ordered, &LOCK_prepare_ordered,
                    MY_MUTEX_INIT_SLOW);
   mysql_cond_init(key_COND_prepare_ordered, &COND_prepare_ordered, NULL);
+  mysql_mutex_init(key_LOCK_binlog_sync_stage, &LOCK_binlog_sync_stage,
+                   MY_MUTEX_INIT_SLOW);
   mysql_mutex_init(key_LOCK_after_binlog_sync, &LOCK_after_binlog_sync,
                    MY_MUTEX_INIT_SLOW);
   mysql_mutex_init(key_LOCK_commit_ordered, &LOCK_commit_ordered,
@@ -4851,7 +4857,7 @@ static int init_server_components()
   {
     global_system_variables.query_cache_type= 1;
   }
-  query_cache_init();
+  query_cache_init(query_cache_partitions);
   query_cache_resize(query_cache_size);
   my_rnd_init(&sql_rand,(ulong) server_start_time,(ulong) server_start_time/2);
   setup_fpu();
@@ -8295,8 +8301,93 @@ int show_threadpool_idle_threads(THD *thd, SHOW_VAR *var, char *buff,
   *(int *)buff= tp_get_idle_thread_count(); 
   return 0;
 }
+
+
+/**
+  Per NUMA node threadpool statistics, as
+  Threadpool_numa_node<N>_<name> status variables.
+*/
+
+int show_threadpool_numa_nodes(THD *thd, SHOW_VAR *var, char *buff,
+                               enum enum_var_type scope)
+{
+  struct st_data {
+    TP_NUMA_NODE_STATISTICS stats;
+    SHOW_VAR var[7];
+    char name[16];
+  } *data;
+  static SHOW_VAR empty[]= {{NullS, NullS, SHOW_LONG}};
+  uint count= tp_get_numa_node_count();
+  SHOW_VAR *nodes;
+
+  var->type= SHOW_ARRAY;
+  var->value= empty;
+
+  if (!count ||
+      !(nodes= (SHOW_VAR *) thd->alloc(sizeof(SHOW_VAR) * (count + 1) +
+                                       sizeof(st_data) * count)))
+    return 0;
+  data= (st_data *) (nodes + count + 1);
+
+#define set_one_node_var(X,Y)           \
+  v->name= X;                           \
+  v->type= SHOW_LONGLONG;               \
+  v->value= (char*) &data[i].stats.Y;   \
+  v++;
+
+  for (uint i= 0; i < count; i++)
+  {
+    SHOW_VAR *v= data[i].var;
+    tp_get_numa_node_statistics(i, &data[i].stats);
+    my_snprintf(data[i].name, sizeof(data[i].name), "node%u", i);
+    nodes[i].name= data[i].name;
+    nodes[i].type= SHOW_ARRAY;
+    nodes[i].value= (char*) data[i].var;
+
+    set_one_node_var("active_threads", active_threads);
+    set_one_node_var("connections",    connections);
+    set_one_node_var("groups",         groups);
+    set_one_node_var("queue_length",   queue_length);
+    set_one_node_var("stalls",         stalls);
+    set_one_node_var("threads",        threads);
+    v->name= 0;
+  }
+  nodes[count].name= 0;
+
+#undef set_one_node_var
+
+  var->value= nodes;
+  return 0;
+}
 #endif
 
+#ifdef HAVE_QUERY_CACHE
+/*
+  The query cache counters are kept per partition; the status variables
+  show their sums.
+*/
+#define show_qcache_func(X)                                             \
+static int show_qcache_ ## X(THD *thd, SHOW_VAR *var, char *buff,       \
+                             enum enum_var_type scope)                  \
+{                                                                       \
+  var->type= SHOW_LONG;                                                 \
+  var->value= buff;                                                     \
+  *((ulong *) buff)= query_cache.statistic(&Query_cache::X);            \
+  return 0;                                                             \
+}
+
+show_qcache_func(free_memory_blocks)
+show_qcache_func(free_memory)
+show_qcache_func(hits)
+show_qcache_func(inserts)
+show_qcache_func(lowmem_prunes)
+show_qcache_func(refused)
+show_qcache_func(queries_in_cache)
+show_qcache_func(total_blocks)
+
+#undef show_qcache_func
+#endif /*HAVE_QUERY_CACHE*/
+
 /*
   Variables shown by SHOW STATUS in alphabetical order
 */
@@ -8396,14 +8487,14 @@ SHOW_VAR status_vars[]= {
   {"Rows_read",                (char*) offsetof(STATUS_VAR, rows_read), SHOW_LONGLONG_STATUS},
   {"Rows_tmp_read",            (char*) offsetof(STATUS_VAR, rows_tmp_read), SHOW_LONGLONG_STATUS},
 #ifdef HAVE_QUERY_CACHE
-  {"Qcache_free_blocks",       (char*) &query_cache.free_memory_blocks, SHOW_LONG_NOFLUSH},
-  {"Qcache_free_memory",       (char*) &query_cache.free_memory, SHOW_LONG_NOFLUSH},
-  {"Qcache_hits",              (char*) &query_cache.hits,       SHOW_LONG},
-  {"Qcache_inserts",           (char*) &query_cache.inserts,    SHOW_LONG},
-  {"Qcache_lowmem_prunes",     (char*) &query_cache.lowmem_prunes, SHOW_LONG},
-  {"Qcache_not_cached",        (char*) &query_cache.refused,    SHOW_LONG},
-  {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache, SHOW_LONG_NOFLUSH},
-  {"Qcache_total_blocks",      (char*) &query_cache.total_blocks, SHOW_LONG_NOFLUSH},
+  {"Qcache_free_blocks",       (char*) &show_qcache_free_memory_blocks, SHOW_SIMPLE_FUNC},
+  {"Qcache_free_memory",       (char*) &show_qcache_free_memory, SHOW_SIMPLE_FUNC},
+  {"Qcache_hits",              (char*) &show_qcache_hits,       SHOW_SIMPLE_FUNC},
+  {"Qcache_inserts",           (char*) &show_qcache_inserts,    SHOW_SIMPLE_FUNC},
+  {"Qcache_lowmem_prunes",     (char*) &show_qcache_lowmem_prunes, SHOW_SIMPLE_FUNC},
+  {"Qcache_not_cached",        (char*) &show_qcache_refused,    SHOW_SIMPLE_FUNC},
+  {"Qcache_queries_in_cache",  (char*) &show_qcache_queries_in_cache, SHOW_SIMPLE_FUNC},
+  {"Qcache_total_blocks",      (char*) &show_qcache_total_blocks, SHOW_SIMPLE_FUNC},
 #endif /*HAVE_QUERY_CACHE*/
   {"Queries",                  (char*) &show_queries,            SHOW_SIMPLE_FUNC},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions), SHOW_LONG_STATUS},
@@ -8478,6 +8569,8 @@ SHOW_VAR status_vars[]= {
 #endif
 #ifdef HAVE_POOL_OF_THREADS
   {"Threadpool_idle_threads",  (char *) &show_threadpool_idle_threads, SHOW_SIMPLE_FUNC},
+  {"Threadpool_numa",          (char *) &show_threadpool_numa_nodes, SHOW_FUNC},
+  {"Threadpool_steals",        (char *) &tp_stats.steals,       SHOW_LONGLONG},
   {"Threadpool_threads",       (char *) &tp_stats.num_worker_threads, SHOW_INT},
 #endif
   {"Threads_cached",           (char*) &cached_thread_count,    SHOW_LONG_NOFLUSH},
@@ -9937,6 +10030,9 @@ void refresh_status(THD *thd)
 
   /* Reset the counters of all key caches (default and named). */
   process_key_caches(reset_key_cache_counters, 0);
+#ifdef HAVE_QUERY_CACHE
+  query_cache.reset_statistics();
+#endif
   flush_status_time= time((time_t*) 0);
   mysql_mutex_unlock(&LOCK_status);
 
@@ -1111,8 +1111,8 @@ Query_cache::insert(THD *thd, Query_cache_tls *query_cache_tls,
     header->result(result);
     DBUG_PRINT("qcache", ("free query 0x%lx", (ulong) query_block));
     // The following call will remove the lock on query_block
-    query_cache.free_query(query_block);
-    query_cache.refused++;
+    free_query(query_block);
+    refused++;
     // append_result_data no success => we need unlock
     unlock();
     DBUG_VOID_RETURN;
@@ -1177,7 +1177,7 @@ void Query_cache::end_of_result(THD *thd)
 
   if (thd->killed)
   {
-    query_cache_abort(thd, &thd->query_cache_tls);
+    abort(thd, &thd->query_cache_tls);
     DBUG_VOID_RETURN;
   }
 
@@ -1221,9 +1221,9 @@ void Query_cache::end_of_result(THD *thd)
     }
     last_result_block= header->result()->prev;
     allign_size= ALIGN_SIZE(last_result_block->used);
-    len= MY_MAX(query_cache.min_allocation_unit, allign_size);
-    if (last_result_block->length >= query_cache.min_allocation_unit + len)
-      query_cache.split_block(last_result_block,len);
+    len= MY_MAX(min_allocation_unit, allign_size);
+    if (last_result_block->length >= min_allocation_unit + len)
+      split_block(last_result_block,len);
 
     header->found_rows(limit_found_rows);
     header->set_results_ready(); // signal for plugin
@@ -1259,6 +1259,261 @@ void mysql_query_cache_invalidate4(THD *thd,
 }
 
 
+/*****************************************************************************
+   Partitioned_query_cache methods
+*****************************************************************************/
+
+/**
+  Find the partition a statement is stored in.
+
+  The partition is chosen by the statement text as received from the
+  client, so that Query_cache::send_result_to_client() and
+  Query_cache::store_query() of the same statement use the same
+  partition.
+*/
+
+Query_cache *Partitioned_query_cache::partition_for(THD *thd)
+{
+  ulong nr1= 1, nr2= 4;
+  if (n_partitions == 1)
+    return partitions;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, (uchar*) thd->query(),
+                                 thd->query_length(), &nr1, &nr2);
+  return partitions + nr1 % n_partitions;
+}
+
+
+bool Partitioned_query_cache::is_disable_in_progress(void)
+{
+  for (uint i= 0; i < n_partitions; i++)
+  {
+    if (partitions[i].is_disable_in_progress())
+      return true;
+  }
+  return false;
+}
+
+
+void Partitioned_query_cache::init(uint partition_count_arg)
+{
+  DBUG_ENTER("Partitioned_query_cache::init");
+  DBUG_ASSERT(partition_count_arg > 0 &&
+              partition_count_arg <= QUERY_CACHE_MAX_PARTITIONS);
+  n_partitions= partition_count_arg;
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].init();
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Resize the cache, splitting the memory evenly between the partitions.
+
+  @return total size of the partitions, 0 if the cache is disabled
+*/
+
+ulong Partitioned_query_cache::resize(ulong query_cache_size_arg)
+{
+  ulong new_query_cache_size= 0;
+  DBUG_ENTER("Partitioned_query_cache::resize");
+  for (uint i= 0; i < n_partitions; i++)
+    new_query_cache_size+=
+      partitions[i].resize(query_cache_size_arg / n_partitions);
+  query_cache_size= new_query_cache_size;
+  DBUG_RETURN(new_query_cache_size);
+}
+
+
+/*
+  The limits can be set before init(), so they are applied to all
+  partitions, not only to the ones in use.
+*/
+
+void Partitioned_query_cache::result_size_limit(ulong limit)
+{
+  for (uint i= 0; i < QUERY_CACHE_MAX_PARTITIONS; i++)
+    partitions[i].result_size_limit(limit);
+}
+
+
+ulong Partitioned_query_cache::set_min_res_unit(ulong size)
+{
+  ulong res= 0;
+  for (uint i= 0; i < QUERY_CACHE_MAX_PARTITIONS; i++)
+    res= partitions[i].set_min_res_unit(size);
+  return res;
+}
+
+
+void Partitioned_query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
+{
+  partition_for(thd)->store_query(thd, tables_used);
+}
+
+
+int Partitioned_query_cache::send_result_to_client(THD *thd, char *query,
+                                                   uint query_length)
+{
+  return partition_for(thd)->send_result_to_client(thd, query, query_length);
+}
+
+
+/*
+  The statement being cached is always stored in the partition recorded
+  in its Query_cache_tls. See the comment on double-check locking usage
+  above.
+*/
+
+void Partitioned_query_cache::insert(THD *thd,
+                                     Query_cache_tls *query_cache_tls,
+                                     const char *packet, ulong length,
+                                     unsigned pkt_nr)
+{
+  if (query_cache_tls->first_query_block)
+    query_cache_tls->partition->insert(thd, query_cache_tls, packet, length,
+                                       pkt_nr);
+}
+
+
+void Partitioned_query_cache::end_of_result(THD *thd)
+{
+  if (thd->query_cache_tls.first_query_block)
+    thd->query_cache_tls.partition->end_of_result(thd);
+}
+
+
+void Partitioned_query_cache::abort(THD *thd,
+                                    Query_cache_tls *query_cache_tls)
+{
+  if (query_cache_tls->first_query_block)
+    query_cache_tls->partition->abort(thd, query_cache_tls);
+}
+
+
+/*
+  Invalidation has to visit every partition, as queries using a table
+  can be stored in any of them. Each partition is locked separately.
+
+  When the invalidation is postponed to the end of the transaction,
+  every partition adds the table to the same list of changed tables of
+  the transaction; THD::add_changed_table() ignores duplicates.
+*/
+
+void Partitioned_query_cache::invalidate(THD *thd, TABLE_LIST *tables_used,
+                                         my_bool using_transactions)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate(thd, tables_used, using_transactions);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd,
+                                         CHANGED_TABLE_LIST *tables_used)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate(thd, tables_used);
+}
+
+
+void
+Partitioned_query_cache::invalidate_locked_for_write(THD *thd,
+                                                     TABLE_LIST *tables_used)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate_locked_for_write(thd, tables_used);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, TABLE *table,
+                                         my_bool using_transactions)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate(thd, table, using_transactions);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, const char *key,
+                                         uint32 key_length,
+                                         my_bool using_transactions)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate(thd, key, key_length, using_transactions);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, char *db)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate(thd, db);
+}
+
+
+void
+Partitioned_query_cache::invalidate_by_MyISAM_filename(const char *filename)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].invalidate_by_MyISAM_filename(filename);
+}
+
+
+void Partitioned_query_cache::flush()
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].flush();
+}
+
+
+void Partitioned_query_cache::pack(THD *thd, ulong join_limit,
+                                   uint iteration_limit)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].pack(thd, join_limit, iteration_limit);
+}
+
+
+void Partitioned_query_cache::destroy()
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].destroy();
+}
+
+
+void Partitioned_query_cache::disable_query_cache(THD *thd)
+{
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].disable_query_cache(thd);
+}
+
+
+/*
+  The counters are read without locking the partitions, like the
+  status variables of a single cache always were.
+*/
+
+ulong Partitioned_query_cache::statistic(ulong Query_cache::*counter)
+{
+  ulong total= 0;
+  for (uint i= 0; i < n_partitions; i++)
+    total+= partitions[i].*counter;
+  return total;
+}
+
+
+/**
+  Reset the counters which FLUSH STATUS resets.
+*/
+
+void Partitioned_query_cache::reset_statistics()
+{
+  for (uint i= 0; i < n_partitions; i++)
+  {
+    Query_cache *partition= partitions + i;
+    partition->hits= partition->inserts= partition->refused=
+      partition->lowmem_prunes= 0;
+  }
+}
+
+
 /*****************************************************************************
    Query_cache methods
 *****************************************************************************/
@@ -1547,6 +1802,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
 	inserts++;
 	queries_in_cache++;
 	thd->query_cache_tls.first_query_block= query_block;
+	thd->query_cache_tls.partition= this;
 	header->writer(&thd->query_cache_tls);
 	header->tables_type(tables_type);
 
@@ -2414,7 +2670,7 @@ void Query_cache::flush()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
   unlock();
   DBUG_VOID_RETURN;
 }
@@ -4180,7 +4436,7 @@ void Query_cache::pack_cache()
 {
   DBUG_ENTER("Query_cache::pack_cache");
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
 
   uchar *border = 0;
   Query_cache_block *before = 0;
@@ -4212,7 +4468,7 @@ void Query_cache::pack_cache()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
   DBUG_VOID_RETURN;
 }
 
@@ -4623,6 +4879,23 @@ void Query_cache::wreck(uint line, const char *message)
 }
 
 
+void Partitioned_query_cache::wreck(uint line, const char *message)
+{
+  query_cache_size= 0;
+  for (uint i= 0; i < n_partitions; i++)
+    partitions[i].wreck(line, message);
+}
+
+
+my_bool Partitioned_query_cache::check_integrity(bool locked)
+{
+  my_bool result= 0;
+  for (uint i= 0; i < n_partitions; i++)
+    result|= partitions[i].check_integrity(locked);
+  return result;
+}
+
+
 void Query_cache::bins_dump()
 {
   uint i;
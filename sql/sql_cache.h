@@ -66,6 +66,9 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
 #define QUERY_CACHE_PACK_ITERATION		2
 #define QUERY_CACHE_PACK_LIMIT			(512*1024L)
 
+/* maximal number of partitions (see Partitioned_query_cache) */
+#define QUERY_CACHE_MAX_PARTITIONS		64
+
 #define TABLE_COUNTER_TYPE uint
 
 struct Query_cache_block;
@@ -540,6 +543,82 @@ class Query_cache
   void disable_query_cache(THD *thd);
 };
 
+
+/**
+  Query cache split into independent partitions.
+
+  Every partition is a complete Query_cache with its own
+  structure_guard_mutex, cache memory, free block bins and hashes, so
+  the memory of one partition is managed without touching the others.
+  A statement is stored in and served from the partition selected by a
+  hash of its text; lookups and stores of different statements thus
+  mostly lock different mutexes.
+
+  A table can have cached queries in every partition. Invalidation
+  visits the partitions one after another, locking each of them on its
+  own; there is no lock covering the whole cache.
+
+  With one partition (the default) the cache behaves as a single
+  Query_cache.
+*/
+
+class Partitioned_query_cache
+{
+  Query_cache partitions[QUERY_CACHE_MAX_PARTITIONS];
+  uint n_partitions;
+
+  Query_cache *partition_for(THD *thd);
+public:
+  /* Sum of the sizes of all partitions */
+  ulong query_cache_size;
+
+  Partitioned_query_cache() :n_partitions(1), query_cache_size(0) {}
+
+  inline uint partition_count() { return n_partitions; }
+  inline Query_cache *partition(uint i) { return partitions + i; }
+
+  inline bool is_disabled(void) { return partitions[0].is_disabled(); }
+  bool is_disable_in_progress(void);
+
+  void init(uint partition_count_arg);
+  ulong resize(ulong query_cache_size_arg);
+  void result_size_limit(ulong limit);
+  ulong set_min_res_unit(ulong size);
+
+  void store_query(THD *thd, TABLE_LIST *used_tables);
+  int send_result_to_client(THD *thd, char *query, uint query_length);
+
+  void invalidate(THD *thd, TABLE_LIST *tables_used,
+                  my_bool using_transactions);
+  void invalidate(THD *thd, CHANGED_TABLE_LIST *tables_used);
+  void invalidate_locked_for_write(THD *thd, TABLE_LIST *tables_used);
+  void invalidate(THD *thd, TABLE *table, my_bool using_transactions);
+  void invalidate(THD *thd, const char *key, uint32  key_length,
+                  my_bool using_transactions);
+  void invalidate(THD *thd, char *db);
+  void invalidate_by_MyISAM_filename(const char *filename);
+
+  void flush();
+  void pack(THD *thd,
+            ulong join_limit = QUERY_CACHE_PACK_LIMIT,
+            uint iteration_limit = QUERY_CACHE_PACK_ITERATION);
+  void destroy();
+
+  void insert(THD *thd, Query_cache_tls *query_cache_tls,
+              const char *packet, ulong length, unsigned pkt_nr);
+  void end_of_result(THD *thd);
+  void abort(THD *thd, Query_cache_tls *query_cache_tls);
+
+  void disable_query_cache(THD *thd);
+
+  /* Sum of a statistic counter over all partitions */
+  ulong statistic(ulong Query_cache::*counter);
+  void reset_statistics();
+
+  void wreck(uint line, const char *message);
+  my_bool check_integrity(bool not_locked);
+};
+
 #ifdef HAVE_QUERY_CACHE
 struct Query_cache_query_flags
 {
@@ -570,7 +649,7 @@ struct Query_cache_query_flags
 #define query_cache_store_query(A, B) query_cache.store_query(A, B)
 #define query_cache_destroy() query_cache.destroy()
 #define query_cache_result_size_limit(A) query_cache.result_size_limit(A)
-#define query_cache_init() query_cache.init()
+#define query_cache_init(A) query_cache.init(A)
 #define query_cache_resize(A) query_cache.resize(A)
 #define query_cache_set_min_res_unit(A) query_cache.set_min_res_unit(A)
 #define query_cache_invalidate3(A, B, C) query_cache.invalidate(A, B, C)
@@ -589,7 +668,7 @@ struct Query_cache_query_flags
 #define query_cache_store_query(A, B)     do { } while(0)
 #define query_cache_destroy()             do { } while(0)
 #define query_cache_result_size_limit(A)  do { } while(0)
-#define query_cache_init()                do { } while(0)
+#define query_cache_init(A)               do { } while(0)
 #define query_cache_resize(A)             do { } while(0)
 #define query_cache_set_min_res_unit(A)   do { } while(0)
 #define query_cache_invalidate3(A, B, C)  do { } while(0)
@@ -603,5 +682,5 @@ struct Query_cache_query_flags
 #define query_cache_is_cacheable_query(L) 0
 #endif /*HAVE_QUERY_CACHE*/
 
-extern Query_cache query_cache;
+extern Partitioned_query_cache query_cache;
 #endif
@@ -397,6 +397,7 @@ class MY_LOCALE;
 */
 
 struct Query_cache_block;
+class Query_cache;
 
 struct Query_cache_tls
 {
@@ -405,12 +406,14 @@ struct Query_cache_tls
     functions and methods to maintain proper locking.
   */
   Query_cache_block *first_query_block;
+  /* Query cache partition 'first_query_block' belongs to */
+  Query_cache *partition;
   void set_first_query_block(Query_cache_block *first_query_block_arg)
   {
     first_query_block= first_query_block_arg;
   }
 
-  Query_cache_tls() :first_query_block(NULL) {}
+  Query_cache_tls() :first_query_block(NULL), partition(NULL) {}
 };
 
 /* SIGNAL / RESIGNAL / GET DIAGNOSTICS */
@@ -681,6 +684,9 @@ typedef struct system_variables
 
   my_bool pseudo_slave_mode;
 
+  /* Thread pool scheduling, see threadpool_unix.cc */
+  ulong threadpool_priority;
+  uint threadpool_fair_queuing_weight;
 } SV;
 
 /**
@@ -1912,6 +1918,8 @@ class THD :public Statement,
 
 public:
   MDL_context mdl_context;
+  /* Time spent acquiring metadata locks by an ANALYZE statement */
+  Exec_time_tracker mdl_acquire_tracker;
 
   /* Used to execute base64 coded binlog events in MySQL server */
   Relay_log_info* rli_fake;
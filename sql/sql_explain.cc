@@ -223,6 +223,15 @@ void Explain_query::print_explain_json(select_result_sink *output,
     node->print_explain_json(this, &writer, is_analyze);
   }
 
+  if (is_analyze && thd->mdl_acquire_tracker.get_loops())
+  {
+    Exec_time_tracker *tracker= &thd->mdl_acquire_tracker;
+    writer.add_member("metadata_locks").start_object();
+    writer.add_member("r_loops").add_ll(tracker->get_loops());
+    writer.add_member("r_total_time_ms").add_double(tracker->get_time_ms());
+    writer.end_object();
+  }
+
   writer.end_object();
 
   CHARSET_INFO *cs= system_charset_info;
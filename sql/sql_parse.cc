@@ -2477,6 +2477,13 @@ mysql_execute_command(THD *thd)
     already.
   */
   DBUG_ASSERT(! thd->transaction_rollback_request || thd->in_sub_stmt);
+
+  if (lex->analyze_stmt)
+  {
+    thd->mdl_acquire_tracker= Exec_time_tracker();
+    thd->mdl_context.set_acquire_tracker(&thd->mdl_acquire_tracker);
+  }
+
   /*
     In many cases first table of main SELECT_LEX have special meaning =>
     check that it is first table in global list and relink it first in 
@@ -5696,6 +5703,8 @@ mysql_execute_command(THD *thd)
 
 finish:
 
+  if (lex->analyze_stmt)
+    thd->mdl_context.set_acquire_tracker(NULL);
   thd->reset_query_timer();
   DBUG_ASSERT(!thd->in_active_multi_stmt_transaction() ||
                thd->in_multi_stmt_transaction_mode());
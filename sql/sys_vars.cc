@@ -2100,6 +2100,16 @@ static Sys_var_ulong Sys_binlog_commit_wait_usec(
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
 
+static Sys_var_mybool Sys_binlog_commit_pipeline(
+       "binlog_commit_pipeline",
+       "If set, binlog group commit syncs the binlog in a separate pipeline "
+       "stage after releasing the binlog lock, so that the next group commit "
+       "can write to the binlog while the previous one is waiting for the "
+       "sync to complete",
+       GLOBAL_VAR(opt_binlog_commit_pipeline), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
+
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
   SV *sv= type == OPT_GLOBAL ? &global_system_variables : &thd->variables;
@@ -2789,6 +2799,15 @@ static Sys_var_ulong Sys_query_cache_min_res_unit(
        BLOCK_SIZE(8), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_qcache_min_res_unit));
 
+static Sys_var_uint Sys_query_cache_partitions(
+       "query_cache_partitions",
+       "Number of independent partitions of the query cache. Queries are "
+       "distributed between the partitions by a hash of the query text, "
+       "and each partition gets an equal part of query_cache_size. More "
+       "partitions mean less contention on the query cache mutex",
+       READ_ONLY GLOBAL_VAR(query_cache_partitions), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, QUERY_CACHE_MAX_PARTITIONS), DEFAULT(1), BLOCK_SIZE(1));
+
 static const char *query_cache_type_names[]= { "OFF", "ON", "DEMAND", 0 };
 
 static bool check_query_cache_type(sys_var *self, THD *thd, set_var *var)
@@ -3320,6 +3339,58 @@ static Sys_var_uint Sys_threadpool_stall_limit(
   NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0), 
   ON_UPDATE(fix_threadpool_stall_limit)
 );
+static Sys_var_mybool Sys_threadpool_numa_aware(
+ "thread_pool_numa_aware",
+ "Bind thread groups to NUMA nodes. Worker threads of a group run only "
+ "on the CPUs of its node, and every connection is served by the groups "
+ "of one node. Has no effect on machines with a single NUMA node.",
+  READ_ONLY GLOBAL_VAR(threadpool_numa_aware), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE)
+);
+static Sys_var_mybool Sys_threadpool_work_stealing(
+ "thread_pool_work_stealing",
+ "Let idle worker threads handle requests queued in other thread groups, "
+ "instead of creating new threads in groups that cannot keep up with "
+ "their queue. In NUMA aware mode, work is only taken within a node.",
+  GLOBAL_VAR(threadpool_work_stealing), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE)
+);
+static const char *threadpool_priority_names[]=
+{ "high", "low", "auto", 0 };
+static Sys_var_enum Sys_threadpool_priority(
+ "thread_pool_priority",
+ "Threadpool priority of the connection. High priority connections are "
+ "served before low priority ones. With 'auto', a connection has high "
+ "priority while it has an open transaction.",
+  SESSION_VAR(threadpool_priority), CMD_LINE(REQUIRED_ARG),
+  threadpool_priority_names, DEFAULT(TP_PRIORITY_AUTO)
+);
+static Sys_var_uint Sys_threadpool_prio_kickup_timer(
+ "thread_pool_prio_kickup_timer",
+ "Time in milliseconds, after which a queued low priority request is "
+ "served before high priority ones.",
+  GLOBAL_VAR(threadpool_prio_kickup_timer), CMD_LINE(REQUIRED_ARG),
+  VALID_RANGE(0, UINT_MAX), DEFAULT(1000), BLOCK_SIZE(1)
+);
+static const char *threadpool_fair_queuing_names[]=
+{ "none", "user", "database", 0 };
+static Sys_var_enum Sys_threadpool_fair_queuing(
+ "thread_pool_fair_queuing",
+ "Share the threadpool fairly between users or current databases of "
+ "the connections. With 'none', low priority requests are served in "
+ "arrival order.",
+  GLOBAL_VAR(threadpool_fair_queuing), CMD_LINE(REQUIRED_ARG),
+  threadpool_fair_queuing_names, DEFAULT(TP_FAIR_QUEUING_NONE)
+);
+static Sys_var_uint Sys_threadpool_fair_queuing_weight(
+ "thread_pool_fair_queuing_weight",
+ "Relative share of the threadpool the connection gets, when requests of "
+ "several users or databases are queued. "
+ "See thread_pool_fair_queuing",
+  SESSION_VAR(threadpool_fair_queuing_weight), CMD_LINE(REQUIRED_ARG),
+  VALID_RANGE(1, 100), DEFAULT(1), BLOCK_SIZE(1),
+  NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(check_has_super)
+);
 #endif /* !WIN32 */
 static Sys_var_uint Sys_threadpool_max_threads(
   "thread_pool_max_threads",
@@ -23,6 +23,10 @@ extern uint threadpool_max_size;
 extern uint threadpool_stall_limit;  /* time interval in 10 ms units for stall checks*/
 extern uint threadpool_max_threads;  /* Maximum threads in pool */
 extern uint threadpool_oversubscribe;  /* Maximum active threads in group */
+extern my_bool threadpool_numa_aware; /* Bind thread groups to NUMA nodes */
+extern my_bool threadpool_work_stealing; /* Idle workers help other groups */
+extern uint threadpool_prio_kickup_timer; /* ms before low prio is served */
+extern ulong threadpool_fair_queuing; /* Fairness key for low prio queue */
 
 
 
@@ -54,11 +58,74 @@ struct TP_STATISTICS
 {
   /* Current number of worker thread. */
   volatile int32 num_worker_threads;
+  /* Number of connections handled by a worker of another group. */
+  volatile int64 steals;
 };
 
 extern TP_STATISTICS tp_stats;
 
 
+/* Values of thread_pool_priority */
+enum TP_PRIORITY
+{
+  TP_PRIORITY_HIGH,
+  TP_PRIORITY_LOW,
+  TP_PRIORITY_AUTO
+};
+
+/* Number of queues a connection can wait in, high and low priority */
+#define TP_PRIORITY_CLASSES 2
+
+/* Values of thread_pool_fair_queuing */
+enum TP_FAIR_QUEUING
+{
+  TP_FAIR_QUEUING_NONE,
+  TP_FAIR_QUEUING_USER,
+  TP_FAIR_QUEUING_DATABASE
+};
+
+/*
+  Queue wait time histogram. Bucket 0 counts waits shorter than
+  1 microsecond, bucket i waits of [2^(i-1), 2^i) microseconds, the
+  last bucket all longer waits.
+*/
+#define TP_WAIT_HISTOGRAM_BUCKETS 26
+
+struct TP_QUEUE_WAIT_STATISTICS
+{
+  ulonglong count[TP_PRIORITY_CLASSES][TP_WAIT_HISTOGRAM_BUCKETS];
+  /* Sum of waits, in microseconds */
+  ulonglong total[TP_PRIORITY_CLASSES][TP_WAIT_HISTOGRAM_BUCKETS];
+};
+
+extern void tp_get_queue_wait_statistics(TP_QUEUE_WAIT_STATISTICS *stats);
+
+
+/*
+  Per NUMA node statistics, only maintained if thread_pool_numa_aware is
+  set and the machine has more than one node.
+*/
+struct TP_NUMA_NODE_STATISTICS
+{
+  /* Connections placed on the node */
+  longlong connections;
+  /* Thread groups bound to the node */
+  longlong groups;
+  /* Worker threads in the node's groups */
+  longlong threads;
+  /* Worker threads currently executing requests */
+  longlong active_threads;
+  /* Connections waiting in the node's work queues */
+  longlong queue_length;
+  /* Number of stalls detected by the timer in the node's groups */
+  longlong stalls;
+};
+
+extern uint tp_get_numa_node_count();
+extern void tp_get_numa_node_statistics(uint node,
+                                        TP_NUMA_NODE_STATISTICS *stats);
+
+
 /* Functions to set threadpool parameters */
 extern void tp_set_min_threads(uint val);
 extern void tp_set_max_threads(uint val);
@@ -70,3 +137,5 @@ extern void tp_scheduler(void);
 
 extern int show_threadpool_idle_threads(THD *thd, SHOW_VAR *var, char *buff,
                                         enum enum_var_type scope);
+extern int show_threadpool_numa_nodes(THD *thd, SHOW_VAR *var, char *buff,
+                                      enum enum_var_type scope);
@@ -34,6 +34,10 @@ uint threadpool_max_size;
 uint threadpool_stall_limit;
 uint threadpool_max_threads;
 uint threadpool_oversubscribe;
+my_bool threadpool_numa_aware;
+my_bool threadpool_work_stealing;
+uint threadpool_prio_kickup_timer;
+ulong threadpool_fair_queuing;
 
 /* Stats */
 TP_STATISTICS tp_stats;
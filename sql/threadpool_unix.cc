@@ -28,6 +28,8 @@
 #include <time.h>
 #include <sql_plist.h>
 #include <threadpool.h>
+#include <queues.h>
+#include <my_bit.h>
 #include <time.h>
 #ifdef __linux__
 #include <sys/epoll.h>
@@ -42,9 +44,23 @@ typedef port_event_t native_event;
 #error threadpool is not available on this platform
 #endif
 
+#ifdef __linux__
+/* NUMA topology is read from sysfs, workers are pinned with CPU affinity */
+#define HAVE_TP_NUMA 1
+#endif
+
 /** Maximum number of native events a listener can read in one go */
 #define MAX_EVENTS 1024
 
+/**
+  Number of fair queuing classes per group. Users (or databases) are hashed
+  into class slots, users sharing a slot share their fair share.
+*/
+#define FAIR_QUEUE_SLOTS 128
+
+/** Virtual time a request of a class with weight 1 costs */
+#define FAIR_QUEUE_COST 1000
+
 /** Indicates that threadpool was initialized*/
 static bool threadpool_started= false; 
 
@@ -95,6 +111,8 @@ struct worker_thread_t
 {
   ulonglong  event_count; /* number of request handled by this thread */
   thread_group_t* thread_group;   
+  /* Group whose connection the thread currently handles, if not its own */
+  thread_group_t* foreign_group;
   worker_thread_t *next_in_list;
   worker_thread_t **prev_in_list;
   
@@ -116,6 +134,10 @@ struct connection_t
   connection_t *next_in_queue;
   connection_t **prev_in_queue;
   ulonglong abs_wait_timeout;
+  /* When connection was put into a queue, and its fair queuing start tag */
+  ulonglong enqueue_time;
+  ulonglong queue_tag;
+  uint numa_node;
   bool logged_in;
   bool bound_to_poll_descriptor;
   bool waiting;
@@ -125,24 +147,38 @@ typedef I_P_List<connection_t,
                      I_P_List_adapter<connection_t,
                                       &connection_t::next_in_queue,
                                       &connection_t::prev_in_queue>,
-                     I_P_List_null_counter,
+                     I_P_List_counter,
                      I_P_List_fast_push_back<connection_t> >
 connection_queue_t;
 
 struct thread_group_t 
 {
   mysql_mutex_t mutex;
-  connection_queue_t queue;
+  /* Connections with an open transaction, or thread_pool_priority=high */
+  connection_queue_t high_prio_queue;
+  /* Other connections, ordered by fair queuing start tag */
+  QUEUE queue;
+  /* Fair queuing virtual time, and finish tags of class slots */
+  ulonglong queue_vtime;
+  ulonglong class_finish_tag[FAIR_QUEUE_SLOTS];
+  /* Queue wait histograms, per priority */
+  ulonglong wait_count[TP_PRIORITY_CLASSES][TP_WAIT_HISTOGRAM_BUCKETS];
+  ulonglong wait_time[TP_PRIORITY_CLASSES][TP_WAIT_HISTOGRAM_BUCKETS];
   worker_list_t waiting_threads; 
   worker_thread_t *listener;
   pthread_attr_t *pthread_attr;
   int  pollfd;
   int  thread_count;
   int  active_thread_count;
+  /* Workers of other groups, handling connections stolen from this group */
+  int  borrowed_thread_count;
   int  connection_count;
+  /* NUMA node this group is bound to, see thread_pool_numa_aware */
+  uint numa_node;
   /* Stats for the deadlock detection timer routine.*/
   int io_event_count;
   int queue_event_count;
+  ulonglong stall_count;
   ulonglong last_thread_creation_time;
   int  shutdown_pipe[2];
   bool shutdown;
@@ -154,6 +190,28 @@ static thread_group_t *all_groups;
 static uint group_count;
 static int32 shutdown_group_count;
 
+/*
+  NUMA node, as seen by the threadpool.
+
+  With thread_pool_numa_aware, thread group i is bound to node
+  i % numa_node_count, its workers are created with an attribute that
+  pins them to the node's CPUs, and every connection is placed on a node
+  once, when it is created. Nodes without CPUs (memory only) are skipped.
+*/
+struct numa_node_t
+{
+  uint id;                       /* node number used by the OS */
+  int32 connection_count;        /* connections placed on the node */
+  pthread_attr_t thread_attr;    /* worker attributes, with CPU affinity */
+#ifdef HAVE_TP_NUMA
+  cpu_set_t cpus;
+#endif
+};
+
+static numa_node_t *numa_nodes;
+/* Number of nodes in use, 0 if threadpool is not NUMA aware */
+static uint numa_node_count;
+
 /**
  Used for printing "pool blocked" message, see
  print_pool_blocked_message();
@@ -181,10 +239,12 @@ static int  wake_or_create_thread(thread_group_t *thread_group);
 static int  create_worker(thread_group_t *thread_group);
 static void *worker_main(void *param);
 static void check_stall(thread_group_t *thread_group);
+static bool wake_thief(thread_group_t *thread_group);
 static void connection_abort(connection_t *connection);
 static void set_wait_timeout(connection_t *connection);
 static void set_next_timeout_check(ulonglong abstime);
 static void print_pool_blocked_message(bool);
+static void numa_end();
 
 /**
  Asynchronous network IO.
@@ -412,17 +472,152 @@ static void* native_event_get_userdata(native_event *event)
 #endif
 
 
+/*
+  Work queues.
+
+  Each group has two queues. Connections that have an open transaction
+  (or have thread_pool_priority=high) go to the high priority queue, so
+  they can finish and release their locks quickly. All other connections go
+  to the low priority queue, which is served when the high priority one is
+  empty, or when its head has waited for longer than
+  thread_pool_prio_kickup_timer milliseconds.
+
+  The low priority queue is ordered with start-time fair queuing: every
+  class (user or database, depending on thread_pool_fair_queuing) has a
+  finish tag, and a request gets start tag max(virtual time, finish tag of
+  its class), its class' finish tag advances by FAIR_QUEUE_COST divided by
+  the connection's thread_pool_fair_queuing_weight. Requests are served
+  in start tag order and virtual time is the tag of the last served
+  request. Thus a class with many queued requests can't push requests of
+  other classes behind all of its own. Without fair queuing, all
+  connections are in one class, and the queue is FIFO.
+*/
+
+static inline bool queue_is_empty(thread_group_t *thread_group)
+{
+  return (thread_group->high_prio_queue.is_empty() &&
+          queue_empty(&thread_group->queue));
+}
+
+
+static inline uint queue_length(thread_group_t *thread_group)
+{
+  return thread_group->high_prio_queue.elements() +
+    thread_group->queue.elements;
+}
+
+
+static int compare_queue_tags(void *, uchar *a, uchar *b)
+{
+  ulonglong tag_a= *(ulonglong *) a;
+  ulonglong tag_b= *(ulonglong *) b;
+  return tag_a < tag_b ? -1 : (tag_a > tag_b ? 1 : 0);
+}
+
+
+static TP_PRIORITY get_priority(connection_t *connection)
+{
+  THD *thd= connection->thd;
+  TP_PRIORITY prio= (TP_PRIORITY) thd->variables.threadpool_priority;
+  if (prio == TP_PRIORITY_AUTO)
+    prio= thd->transaction.is_active() ? TP_PRIORITY_HIGH : TP_PRIORITY_LOW;
+  return prio;
+}
+
+
+/**
+  Find fair queuing class slot of a connection.
+  Connection is idle when queued, so it is safe to look at its THD.
+*/
+
+static uint fair_queue_slot(connection_t *connection)
+{
+  THD *thd= connection->thd;
+  const char *key= NULL;
+  ulong nr1= 1, nr2= 4;
+
+  switch (threadpool_fair_queuing) {
+  case TP_FAIR_QUEUING_USER:
+    key= thd->main_security_ctx.user;
+    break;
+  case TP_FAIR_QUEUING_DATABASE:
+    key= thd->db;
+    break;
+  default:
+    return 0;
+  }
+  if (!key)
+    return 0;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, (const uchar *) key,
+                                 strlen(key), &nr1, &nr2);
+  return (uint) (nr1 % FAIR_QUEUE_SLOTS);
+}
+
+
+/* Add element to a workqueue. Group mutex must be held. */
+
+static void queue_push(thread_group_t *thread_group, connection_t *connection,
+                       ulonglong now)
+{
+  connection->enqueue_time= now;
+  if (!connection->logged_in || get_priority(connection) == TP_PRIORITY_LOW)
+  {
+    uint slot= fair_queue_slot(connection);
+    uint weight= connection->thd->variables.threadpool_fair_queuing_weight;
+    ulonglong *finish= &thread_group->class_finish_tag[slot];
+
+    connection->queue_tag= MY_MAX(thread_group->queue_vtime, *finish);
+    if (!queue_insert_safe(&thread_group->queue, (uchar *) connection))
+    {
+      *finish= connection->queue_tag + FAIR_QUEUE_COST / MY_MAX(weight, 1);
+      return;
+    }
+    /* Out of memory when extending the queue, do not lose the event. */
+  }
+  thread_group->high_prio_queue.push_back(connection);
+}
+
+
+static void record_queue_wait(thread_group_t *thread_group, uint prio,
+                              ulonglong now, connection_t *connection)
+{
+  ulonglong wait= now > connection->enqueue_time ?
+    now - connection->enqueue_time : 0;
+  uint bucket= wait ? my_bit_log2((ulong) MY_MIN(wait, UINT_MAX32)) + 1 : 0;
+
+  set_if_smaller(bucket, TP_WAIT_HISTOGRAM_BUCKETS - 1);
+  thread_group->wait_count[prio][bucket]++;
+  thread_group->wait_time[prio][bucket]+= wait;
+}
+
+
 /* Dequeue element from a workqueue */
 
 static connection_t *queue_get(thread_group_t *thread_group)
 {
   DBUG_ENTER("queue_get");
   thread_group->queue_event_count++;
-  connection_t *c= thread_group->queue.front();
-  if (c)
+  connection_t *c= thread_group->high_prio_queue.front();
+  ulonglong now;
+
+  if (!c && queue_empty(&thread_group->queue))
+    DBUG_RETURN(NULL);
+
+  now= microsecond_interval_timer();
+  if (!queue_empty(&thread_group->queue))
   {
-    thread_group->queue.remove(c);
+    connection_t *low= (connection_t *) queue_top(&thread_group->queue);
+    if (!c || now >= low->enqueue_time +
+                     1000ULL * threadpool_prio_kickup_timer)
+    {
+      queue_remove_top(&thread_group->queue);
+      thread_group->queue_vtime= low->queue_tag;
+      record_queue_wait(thread_group, TP_PRIORITY_LOW, now, low);
+      DBUG_RETURN(low);
+    }
   }
+  thread_group->high_prio_queue.remove(c);
+  record_queue_wait(thread_group, TP_PRIORITY_HIGH, now, c);
   DBUG_RETURN(c);  
 }
 
@@ -592,10 +787,16 @@ void check_stall(thread_group_t *thread_group)
     do wait and indicate that via thd_wait_begin/end callbacks, thread creation
     will be faster.
   */
-  if (!thread_group->queue.is_empty() && !thread_group->queue_event_count)
+  if (!queue_is_empty(thread_group) && !thread_group->queue_event_count)
   {
     thread_group->stalled= true;
-    wake_or_create_thread(thread_group);
+    thread_group->stall_count++;
+    /*
+      With work stealing, prefer an idle worker of another group
+      over creating a new thread in this one.
+    */
+    if (!threadpool_work_stealing || !wake_thief(thread_group))
+      wake_or_create_thread(thread_group);
   }
   
   /* Reset queue event count */
@@ -711,17 +912,18 @@ static connection_t * listener(worker_thread_t *current_thread,
      more workers.
     */
     
-    bool listener_picks_event= thread_group->queue.is_empty();
+    bool listener_picks_event= queue_is_empty(thread_group);
     
     /* 
       If listener_picks_event is set, listener thread will handle first event, 
       and put the rest into the queue. If listener_pick_event is not set, all 
       events go to the queue.
     */
+    ulonglong now= microsecond_interval_timer();
     for(int i=(listener_picks_event)?1:0; i < cnt ; i++)
     {
       connection_t *c= (connection_t *)native_event_get_userdata(&ev[i]);
-      thread_group->queue.push_back(c);
+      queue_push(thread_group, c, now);
     }
     
     if (listener_picks_event)
@@ -913,7 +1115,11 @@ int thread_group_init(thread_group_t *thread_group, pthread_attr_t* thread_attr)
   thread_group->pollfd= -1;
   thread_group->shutdown_pipe[0]= -1;
   thread_group->shutdown_pipe[1]= -1;
-  thread_group->queue.empty();
+  thread_group->high_prio_queue.empty();
+  if (init_queue(&thread_group->queue, 16,
+                 offsetof(connection_t, queue_tag), 0, compare_queue_tags,
+                 NULL, 0, 16))
+    DBUG_RETURN(1);
   DBUG_RETURN(0);
 }
 
@@ -921,6 +1127,7 @@ int thread_group_init(thread_group_t *thread_group, pthread_attr_t* thread_attr)
 void thread_group_destroy(thread_group_t *thread_group)
 {
   mysql_mutex_destroy(&thread_group->mutex);
+  delete_queue(&thread_group->queue);
   if (thread_group->pollfd != -1)
   {
     close(thread_group->pollfd);
@@ -935,7 +1142,10 @@ void thread_group_destroy(thread_group_t *thread_group)
     }
   }
   if (my_atomic_add32(&shutdown_group_count, -1) == 1)
+  {
     my_free(all_groups);
+    numa_end();
+  }
 }
 
 /**
@@ -970,7 +1180,8 @@ static void thread_group_close(thread_group_t *thread_group)
   DBUG_ENTER("thread_group_close");
 
   mysql_mutex_lock(&thread_group->mutex);
-  if (thread_group->thread_count == 0) 
+  if (thread_group->thread_count == 0 &&
+      thread_group->borrowed_thread_count == 0)
   {
     mysql_mutex_unlock(&thread_group->mutex);
     thread_group_destroy(thread_group);
@@ -1019,7 +1230,7 @@ static void queue_put(thread_group_t *thread_group, connection_t *connection)
   DBUG_ENTER("queue_put");
 
   mysql_mutex_lock(&thread_group->mutex);
-  thread_group->queue.push_back(connection);
+  queue_push(thread_group, connection, microsecond_interval_timer());
 
   if (thread_group->active_thread_count == 0)
     wake_or_create_thread(thread_group);
@@ -1042,6 +1253,151 @@ static bool too_many_threads(thread_group_t *thread_group)
 }
 
 
+/**
+  Check whether group has queued work nobody is going to pick up soon:
+  the queue is not empty and there are no idle workers to wake.
+  Can be called without holding the group's mutex, as a hint.
+*/
+
+static bool group_overloaded(thread_group_t *thread_group)
+{
+  return (!thread_group->shutdown &&
+          !queue_is_empty(thread_group) &&
+          thread_group->waiting_threads.is_empty());
+}
+
+
+/**
+  Take a queued connection from an overloaded group.
+
+  Used by idle workers before they go to sleep, if thread_pool_work_stealing
+  is set. Groups are inspected without locking, and a victim's mutex is
+  only try-locked, so the thief never waits for a busy group.
+  In NUMA mode, work is only stolen within the node.
+
+  On success, the current thread is accounted as active in the victim
+  group, until leave_foreign_group() is called. Thus, thd_wait_begin()
+  and thd_wait_end() callbacks from the stolen connection, that use
+  connection->thread_group, keep counters of both groups consistent.
+
+  @param current_thread - current worker thread
+  @param thread_group - current thread's group, its mutex must be held
+
+  @return stolen connection, or NULL
+*/
+
+static connection_t *steal_event(worker_thread_t *current_thread,
+                                 thread_group_t *thread_group)
+{
+  DBUG_ENTER("steal_event");
+  uint count= group_count;
+  uint self= (uint)(thread_group - all_groups);
+
+  mysql_mutex_assert_owner(&thread_group->mutex);
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *victim= &all_groups[(self + i) % count];
+    connection_t *connection= NULL;
+
+    if (victim->numa_node != thread_group->numa_node ||
+        !group_overloaded(victim))
+      continue;
+
+    if (mysql_mutex_trylock(&victim->mutex))
+      continue;
+    if (group_overloaded(victim))
+    {
+      connection= queue_get(victim);
+      if (connection)
+      {
+        victim->stalled= false;
+        victim->borrowed_thread_count++;
+        victim->active_thread_count++;
+      }
+    }
+    mysql_mutex_unlock(&victim->mutex);
+
+    if (connection)
+    {
+      thread_group->active_thread_count--;
+      current_thread->foreign_group= victim;
+      my_atomic_add64(&tp_stats.steals, 1);
+      DBUG_RETURN(connection);
+    }
+  }
+  DBUG_RETURN(NULL);
+}
+
+
+/**
+  Return to own group, after handling a connection stolen from
+  another group, see steal_event().
+*/
+
+static void leave_foreign_group(worker_thread_t *current_thread)
+{
+  thread_group_t *victim= current_thread->foreign_group;
+  thread_group_t *thread_group= current_thread->thread_group;
+  bool last_thread;
+
+  mysql_mutex_lock(&victim->mutex);
+  victim->borrowed_thread_count--;
+  victim->active_thread_count--;
+  last_thread= (victim->shutdown && victim->thread_count == 0 &&
+                victim->borrowed_thread_count == 0);
+  mysql_mutex_unlock(&victim->mutex);
+  current_thread->foreign_group= NULL;
+
+  /* Last thread leaves a group, that is shutting down. */
+  if (last_thread)
+    thread_group_destroy(victim);
+
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->active_thread_count++;
+  mysql_mutex_unlock(&thread_group->mutex);
+}
+
+
+/**
+  Wake an idle worker in another group, that would steal work from
+  the stalled thread_group.
+
+  Only groups that have a listener are considered, since an idle worker of
+  a group without listener would become the listener, rather than steal.
+  The caller holds thread_group's mutex, other groups are only try-locked.
+
+  @return true if a worker was woken
+*/
+
+static bool wake_thief(thread_group_t *thread_group)
+{
+  uint count= group_count;
+  uint self= (uint)(thread_group - all_groups);
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *group= &all_groups[(self + i) % count];
+    bool woken= false;
+
+    if (group->numa_node != thread_group->numa_node || group->shutdown ||
+        !group->listener || group->waiting_threads.is_empty() ||
+        !queue_is_empty(group))
+      continue;
+
+    if (mysql_mutex_trylock(&group->mutex))
+      continue;
+    if (group->listener && queue_is_empty(group))
+      woken= (wake_thread(group) == 0);
+    mysql_mutex_unlock(&group->mutex);
+
+    if (woken)
+      return true;
+  }
+  return false;
+}
+
+
 /**
   Retrieve a connection with pending event.
   
@@ -1115,6 +1471,14 @@ connection_t *get_event(worker_thread_t *current_thread,
       }
     }
 
+    /* Before sleeping, help a group that can't keep up with its queue. */
+    if (!oversubscribed && threadpool_work_stealing)
+    {
+      connection= steal_event(current_thread, thread_group);
+      if (connection)
+        break;
+    }
+
     /* And now, finally sleep */ 
     current_thread->woken = false; /* wake() sets this to true */
 
@@ -1174,7 +1538,7 @@ void wait_begin(thread_group_t *thread_group)
   DBUG_ASSERT(thread_group->connection_count > 0);
  
   if ((thread_group->active_thread_count == 0) && 
-     (thread_group->queue.is_empty() || !thread_group->listener))
+     (queue_is_empty(thread_group) || !thread_group->listener))
   {
     /* 
       Group might stall while this thread waits, thus wake 
@@ -1201,6 +1565,55 @@ void wait_end(thread_group_t *thread_group)
 }
 
 
+/**
+  Choose NUMA node for a new connection.
+
+  The connection goes to the node with fewest connections. The scan starts
+  at a node derived from thread_id, so that ties do not all end up on the
+  first node.
+*/
+
+static uint numa_pick_node(THD *thd)
+{
+  uint best= thd->thread_id % numa_node_count;
+  int32 best_count= numa_nodes[best].connection_count;
+  for (uint i= 1; i < numa_node_count; i++)
+  {
+    uint node= (uint)((thd->thread_id + i) % numa_node_count);
+    if (numa_nodes[node].connection_count < best_count)
+    {
+      best= node;
+      best_count= numa_nodes[node].connection_count;
+    }
+  }
+  return best;
+}
+
+
+/**
+  Find the thread group a connection belongs to.
+
+  Without NUMA, connections are spread over groups by thread_id.
+  In NUMA mode, connection is spread over the groups bound to its node
+  (groups numa_node, numa_node + numa_node_count, ...). If there are fewer
+  groups than nodes, NUMA placement is ignored.
+*/
+
+static thread_group_t *connection_thread_group(connection_t *connection)
+{
+  uint count= group_count;
+  ulong id= connection->thd->thread_id;
+
+  if (numa_node_count && count >= numa_node_count)
+  {
+    uint node= connection->numa_node;
+    uint groups_in_node= (count - node + numa_node_count - 1)/numa_node_count;
+    return &all_groups[node + (id % groups_in_node) * numa_node_count];
+  }
+  return &all_groups[id % count];
+}
+
+
 /**
   Allocate/initialize a new connection structure.
 */
@@ -1217,6 +1630,12 @@ connection_t *alloc_connection(THD *thd)
     connection->logged_in= false;
     connection->bound_to_poll_descriptor= false;
     connection->abs_wait_timeout= ULONGLONG_MAX;
+    connection->numa_node= 0;
+    if (numa_node_count)
+    {
+      connection->numa_node= numa_pick_node(thd);
+      my_atomic_add32(&numa_nodes[connection->numa_node].connection_count, 1);
+    }
   }
   DBUG_RETURN(connection);
 }
@@ -1239,8 +1658,7 @@ void tp_add_connection(THD *thd)
     thd->event_scheduler.data= connection;
       
     /* Assign connection to a group. */
-    thread_group_t *group= 
-      &all_groups[thd->thread_id%group_count];
+    thread_group_t *group= connection_thread_group(connection);
     
     connection->thread_group=group;
       
@@ -1277,6 +1695,9 @@ static void connection_abort(connection_t *connection)
   mysql_mutex_lock(&group->mutex);
   group->connection_count--;
   mysql_mutex_unlock(&group->mutex);
+
+  if (numa_node_count)
+    my_atomic_add32(&numa_nodes[connection->numa_node].connection_count, -1);
   
   my_free(connection);
   DBUG_VOID_RETURN;
@@ -1411,8 +1832,7 @@ static int start_io(connection_t *connection)
     So we recalculate in which group the connection should be, based
     on thread_id and current group count, and migrate if necessary.
   */ 
-  thread_group_t *group = 
-    &all_groups[connection->thd->thread_id%group_count];
+  thread_group_t *group= connection_thread_group(connection);
 
   if (group != connection->thread_group)
   {
@@ -1483,6 +1903,7 @@ static void *worker_main(void *param)
   /* Init per-thread structure */
   mysql_cond_init(key_worker_cond, &this_thread.cond, NULL);
   this_thread.thread_group= thread_group;
+  this_thread.foreign_group= NULL;
   this_thread.event_count=0;
 
   /* Run event loop */
@@ -1496,6 +1917,8 @@ static void *worker_main(void *param)
       break;
     this_thread.event_count++;
     handle_event(connection);
+    if (this_thread.foreign_group)
+      leave_foreign_group(&this_thread);
   }
 
   /* Thread shutdown: cleanup per-worker-thread structure. */
@@ -1504,7 +1927,9 @@ static void *worker_main(void *param)
   bool last_thread;                    /* last thread in group exits */
   mysql_mutex_lock(&thread_group->mutex);
   add_thread_count(thread_group, -1);
-  last_thread= ((thread_group->thread_count == 0) && thread_group->shutdown);
+  last_thread= ((thread_group->thread_count == 0) &&
+                 (thread_group->borrowed_thread_count == 0) &&
+                 thread_group->shutdown);
   mysql_mutex_unlock(&thread_group->mutex);
 
   /* Last thread in group exits and pool is terminating, destroy group.*/
@@ -1516,6 +1941,146 @@ static void *worker_main(void *param)
 }
 
 
+#ifdef HAVE_TP_NUMA
+/**
+  Read a sysfs list file (e.g "0-3,8-11") into a cpu set.
+  The set is used for node numbers, too.
+
+  @return false on success, true if the file could not be read or parsed.
+*/
+
+static bool read_sysfs_list(const char *path, cpu_set_t *set)
+{
+  char buf[4096];
+  char *p;
+  FILE *file;
+
+  CPU_ZERO(set);
+  if (!(file= my_fopen(path, O_RDONLY, MYF(0))))
+    return true;
+  p= fgets(buf, sizeof(buf), file);
+  my_fclose(file, MYF(0));
+  if (!p)
+    return true;
+
+  while (*p && *p != '\n')
+  {
+    char *end;
+    ulong first, last;
+
+    first= last= strtoul(p, &end, 10);
+    if (end == p)
+      return true;
+    if (*end == '-')
+    {
+      p= end + 1;
+      last= strtoul(p, &end, 10);
+      if (end == p)
+        return true;
+    }
+    for (ulong i= first; i <= last && i < CPU_SETSIZE; i++)
+      CPU_SET(i, set);
+    p= (*end == ',') ? end + 1 : end;
+  }
+  return false;
+}
+#endif
+
+
+/**
+  Detect NUMA topology, if thread_pool_numa_aware is set.
+
+  Creates per-node thread attributes that pin workers to the CPUs
+  of the node. If the machine has fewer than 2 nodes with CPUs, the
+  setting has no effect.
+*/
+
+static void numa_init()
+{
+  DBUG_ENTER("numa_init");
+  numa_node_count= 0;
+  if (!threadpool_numa_aware)
+    DBUG_VOID_RETURN;
+
+#ifdef HAVE_TP_NUMA
+  cpu_set_t online;
+  uint max_nodes, count= 0;
+  size_t stacksize= 0;
+  int detach_state= PTHREAD_CREATE_JOINABLE;
+
+  if (read_sysfs_list("/sys/devices/system/node/online", &online))
+  {
+    sql_print_warning("Threadpool: could not read NUMA topology, "
+                      "thread_pool_numa_aware is ignored");
+    DBUG_VOID_RETURN;
+  }
+
+  max_nodes= CPU_COUNT(&online);
+  if (max_nodes < 2 ||
+      !(numa_nodes= (numa_node_t *) my_malloc(sizeof(numa_node_t) * max_nodes,
+                                              MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_VOID_RETURN;
+
+  pthread_attr_getstacksize(get_connection_attrib(), &stacksize);
+  pthread_attr_getdetachstate(get_connection_attrib(), &detach_state);
+
+  for (uint id= 0; id < CPU_SETSIZE && count < max_nodes; id++)
+  {
+    char path[FN_REFLEN];
+    numa_node_t *node= &numa_nodes[count];
+
+    if (!CPU_ISSET(id, &online))
+      continue;
+    my_snprintf(path, sizeof(path),
+                "/sys/devices/system/node/node%u/cpulist", id);
+    if (read_sysfs_list(path, &node->cpus) || !CPU_COUNT(&node->cpus))
+      continue;
+
+    node->id= id;
+    pthread_attr_init(&node->thread_attr);
+    pthread_attr_setdetachstate(&node->thread_attr, detach_state);
+    pthread_attr_setscope(&node->thread_attr, PTHREAD_SCOPE_SYSTEM);
+    if (stacksize)
+      pthread_attr_setstacksize(&node->thread_attr, stacksize);
+    if (pthread_attr_setaffinity_np(&node->thread_attr, sizeof(cpu_set_t),
+                                    &node->cpus))
+    {
+      pthread_attr_destroy(&node->thread_attr);
+      continue;
+    }
+    count++;
+  }
+
+  if (count < 2)
+  {
+    for (uint i= 0; i < count; i++)
+      pthread_attr_destroy(&numa_nodes[i].thread_attr);
+    my_free(numa_nodes);
+    numa_nodes= NULL;
+    DBUG_VOID_RETURN;
+  }
+
+  numa_node_count= count;
+  sql_print_information("Threadpool: thread groups are bound to %u NUMA nodes",
+                        numa_node_count);
+#else
+  sql_print_warning("Threadpool: thread_pool_numa_aware is not supported "
+                    "on this platform");
+#endif
+  DBUG_VOID_RETURN;
+}
+
+
+static void numa_end()
+{
+  for (uint i= 0; i < numa_node_count; i++)
+    pthread_attr_destroy(&numa_nodes[i].thread_attr);
+  my_free(numa_nodes);
+  numa_nodes= NULL;
+  numa_node_count= 0;
+}
+
+
 bool tp_init()
 {
   DBUG_ENTER("tp_init");
@@ -1529,10 +2094,21 @@ bool tp_init()
   }
   threadpool_started= true;
   scheduler_init();
+  numa_init();
 
   for (uint i= 0; i < threadpool_max_size; i++)
   {
-    thread_group_init(&all_groups[i], get_connection_attrib());  
+    pthread_attr_t *attr= get_connection_attrib();
+    if (numa_node_count)
+    {
+      all_groups[i].numa_node= i % numa_node_count;
+      attr= &numa_nodes[all_groups[i].numa_node].thread_attr;
+    }
+    if (thread_group_init(&all_groups[i], attr))
+    {
+      sql_print_error("Can't initialize threadpool groups");
+      DBUG_RETURN(1);
+    }
   }
   tp_set_threadpool_size(threadpool_size);
   if(group_count == 0)
@@ -1630,6 +2206,58 @@ int tp_get_idle_thread_count()
 }
 
 
+/**
+  Sum queue wait histograms over all groups. No locking is done.
+*/
+
+void tp_get_queue_wait_statistics(TP_QUEUE_WAIT_STATISTICS *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  for (uint i= 0; i < threadpool_max_size && all_groups[i].pollfd >= 0; i++)
+  {
+    for (uint prio= 0; prio < TP_PRIORITY_CLASSES; prio++)
+    {
+      for (uint bucket= 0; bucket < TP_WAIT_HISTOGRAM_BUCKETS; bucket++)
+      {
+        stats->count[prio][bucket]+= all_groups[i].wait_count[prio][bucket];
+        stats->total[prio][bucket]+= all_groups[i].wait_time[prio][bucket];
+      }
+    }
+  }
+}
+
+
+uint tp_get_numa_node_count()
+{
+  return numa_node_count;
+}
+
+
+/**
+ Calculate statistics for a NUMA node, summing over the groups bound to it.
+ As for idle thread count, no locking is done.
+*/
+
+void tp_get_numa_node_statistics(uint node, TP_NUMA_NODE_STATISTICS *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  if (node >= numa_node_count)
+    return;
+
+  stats->connections= numa_nodes[node].connection_count;
+  for (uint i= node; i < threadpool_max_size && all_groups[i].pollfd >= 0;
+       i+= numa_node_count)
+  {
+    thread_group_t *group= &all_groups[i];
+    stats->groups++;
+    stats->threads+= group->thread_count;
+    stats->active_threads+= group->active_thread_count;
+    stats->queue_length+= queue_length(group);
+    stats->stalls+= group->stall_count;
+  }
+}
+
+
 /* Report threadpool problems */
 
 /** 
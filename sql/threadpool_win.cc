@@ -745,3 +745,23 @@ int tp_get_idle_thread_count()
   return 0;
 }
 
+
+/* NUMA placement is left to the OS threadpool on Windows. */
+uint tp_get_numa_node_count()
+{
+  return 0;
+}
+
+
+void tp_get_numa_node_statistics(uint, TP_NUMA_NODE_STATISTICS *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+}
+
+
+/* Work items are queued by the OS threadpool, waits are not measured. */
+void tp_get_queue_wait_statistics(TP_QUEUE_WAIT_STATISTICS *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+}
+
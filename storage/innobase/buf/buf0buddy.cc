@@ -324,6 +324,16 @@ buf_buddy_alloc_zip(
 
 	buf = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
 
+	if (buf_pool->withdraw_target) {
+		/* Do not hand out memory from a chunk that
+		buf_pool_resize() is going to free. */
+		while (buf != NULL
+		       && buf_frame_will_withdrawn(
+			       buf_pool, reinterpret_cast<byte*>(buf))) {
+			buf = UT_LIST_GET_NEXT(list, buf);
+		}
+	}
+
 	if (buf) {
 		buf_buddy_remove_from_free(buf_pool, buf, i);
 	} else if (i + 1 < BUF_BUDDY_SIZES) {
@@ -662,8 +672,11 @@ buf_buddy_free_low(
 
 	/* Do not recombine blocks if there are few free blocks.
 	We may waste up to 15360*max_len bytes to free blocks
-	(1024 + 2048 + 4096 + 8192 = 15360) */
-	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16) {
+	(1024 + 2048 + 4096 + 8192 = 15360). While the buffer pool
+	is being shrunk, always recombine, so that whole frames
+	can be withdrawn. */
+	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16
+	    && !buf_pool->withdraw_target) {
 		goto func_exit;
 	}
 
@@ -719,3 +732,126 @@ buf_buddy_free_low(
 			      reinterpret_cast<buf_buddy_free_t*>(buf),
 			      i);
 }
+
+/**********************************************************************//**
+Try to reallocate a block, so that the memory that it occupies can be
+withdrawn by buf_pool_resize().
+@return true if there was enough free memory for trying */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	void*		buf,		/*!< in: block to be reallocated,
+					must be pointed to by the
+					buffer pool */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+{
+	buf_block_t*	block = NULL;
+	ulint		i = buf_buddy_get_slot(size);
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(!mutex_own(&buf_pool->zip_mutex));
+	ut_ad(i <= BUF_BUDDY_SIZES);
+	ut_ad(i >= buf_buddy_get_slot(UNIV_ZIP_SIZE_MIN));
+
+	if (i < BUF_BUDDY_SIZES) {
+		/* Try to allocate from the buddy system. */
+		block = (buf_block_t*) buf_buddy_alloc_zip(buf_pool, i);
+	}
+
+	if (block == NULL) {
+		/* Try allocating from the buf_pool->free list. */
+		block = buf_LRU_get_free_only(buf_pool);
+
+		if (block == NULL) {
+			/* The free list was not enough. */
+			return(false);
+		}
+
+		buf_buddy_block_register(block);
+
+		block = (buf_block_t*) buf_buddy_alloc_from(
+			buf_pool, block->frame, i, BUF_BUDDY_SIZES);
+	}
+
+	buf_pool->buddy_stat[i].used++;
+
+	/* Try to relocate the block to the newly allocated memory,
+	and free whichever of the two ended up unused. */
+	if (buf_buddy_relocate(buf_pool, buf, block, i)) {
+		buf_buddy_free_low(buf_pool, buf, i);
+	} else {
+		buf_buddy_free_low(buf_pool, block, i);
+	}
+
+	return(true);
+}
+
+/**********************************************************************//**
+Combine all pairs of free buddies that are located in the chunks to be
+withdrawn by buf_pool_resize(). */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool->withdraw_target);
+
+	for (ulint i = 0; i < UT_ARR_SIZE(buf_pool->zip_free); ++i) {
+		buf_buddy_free_t* buf =
+			UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
+
+		/* Seek to the first block to be withdrawn. */
+		while (buf != NULL
+		       && !buf_frame_will_withdrawn(
+			       buf_pool, reinterpret_cast<byte*>(buf))) {
+			buf = UT_LIST_GET_NEXT(list, buf);
+		}
+
+		while (buf != NULL) {
+			buf_buddy_free_t* next =
+				UT_LIST_GET_NEXT(list, buf);
+
+			buf_buddy_free_t* buddy =
+				reinterpret_cast<buf_buddy_free_t*>(
+					buf_buddy_get(
+						reinterpret_cast<byte*>(buf),
+						BUF_BUDDY_LOW << i));
+
+			/* Seek to the next block to be withdrawn,
+			skipping the buddy, which may be combined
+			with buf below. */
+			for (;;) {
+				while (next != NULL
+				       && !buf_frame_will_withdrawn(
+					       buf_pool,
+					       reinterpret_cast<byte*>(
+						       next))) {
+					next = UT_LIST_GET_NEXT(list, next);
+				}
+
+				if (buddy != next) {
+					break;
+				}
+
+				next = UT_LIST_GET_NEXT(list, next);
+			}
+
+			if (buf_buddy_is_free(buddy, i)
+			    == BUF_BUDDY_STATE_FREE) {
+				/* Both buf and buddy are free.
+				Try to combine them. */
+				buf_buddy_remove_from_free(buf_pool, buf, i);
+				buf_pool->buddy_stat[i].used++;
+
+				buf_buddy_free_low(buf_pool, buf, i);
+			}
+
+			buf = next;
+		}
+	}
+}
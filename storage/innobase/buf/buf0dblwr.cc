@@ -52,8 +52,99 @@ UNIV_INTERN buf_dblwr_t*	buf_dblwr = NULL;
 /** Set to TRUE when the doublewrite buffer is being created */
 UNIV_INTERN ibool	buf_dblwr_being_created = FALSE;
 
+/** Doublewrite files that are used instead of the doublewrite buffer in
+the system tablespace when innodb_doublewrite_files > 0, or NULL */
+UNIV_INTERN buf_dblwr_t*	buf_dblwr_files = NULL;
+
+/** Number of elements in buf_dblwr_files */
+UNIV_INTERN ulint		buf_dblwr_n_files = 0;
+
+/** Number of doublewrite files that were left by a configuration with
+more files. Their pages are considered by buf_dblwr_process(), which
+then removes the files. */
+static ulint			buf_dblwr_n_stale = 0;
+
+/** Pages of the doublewrite files that were left by an earlier
+configuration, allocated with ut_malloc(), or NULL */
+static byte*			buf_dblwr_stale_buf = NULL;
+
 #define TRX_SYS_DOUBLEWRITE_BLOCKS 2
 
+/** Number of pages in a doublewrite buffer, and in a doublewrite file */
+#define BUF_DBLWR_N_PAGES	\
+	(TRX_SYS_DOUBLEWRITE_BLOCKS * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+
+/** Name prefix of the doublewrite files in the data home directory */
+#define BUF_DBLWR_FILE_PREFIX	"ib_doublewrite_"
+
+/****************************************************************//**
+Returns the doublewrite buffer that a page is written through.
+@return the doublewrite buffer in the system tablespace, or the
+doublewrite file of the buffer pool instance of the page */
+UNIV_INLINE
+buf_dblwr_t*
+buf_dblwr_get_for_page(
+/*===================*/
+	const buf_page_t*	bpage)	/*!< in: buffer page */
+{
+	if (buf_dblwr_n_files == 0) {
+		return(buf_dblwr);
+	}
+
+	return(&buf_dblwr_files[bpage->buf_pool_index % buf_dblwr_n_files]);
+}
+
+/****************************************************************//**
+Returns the path of a doublewrite file.
+@return path in the data home directory; free with mem_free() */
+static
+char*
+buf_dblwr_file_name(
+/*================*/
+	ulint	n)	/*!< in: number of the file */
+{
+	ulint	dirnamelen = strlen(srv_data_home);
+	ulint	len = dirnamelen + sizeof BUF_DBLWR_FILE_PREFIX + 22;
+	char*	name = static_cast<char*>(mem_alloc(len));
+
+	memcpy(name, srv_data_home, dirnamelen);
+
+	/* Add a path separator if needed. */
+	if (dirnamelen && name[dirnamelen - 1] != SRV_PATH_SEPARATOR) {
+		name[dirnamelen++] = SRV_PATH_SEPARATOR;
+	}
+
+	ut_snprintf(name + dirnamelen, len - dirnamelen,
+		    BUF_DBLWR_FILE_PREFIX ULINTPF, n);
+
+	return(name);
+}
+
+/****************************************************************//**
+Writes slots of a doublewrite file. The file must be flushed by the
+caller. */
+static
+void
+buf_dblwr_file_write(
+/*=================*/
+	const buf_dblwr_t*	dblwr,	/*!< in: doublewrite file */
+	ulint			slot,	/*!< in: first slot to write */
+	ulint			n_slots,/*!< in: number of slots to write */
+	const byte*		buf)	/*!< in: contents of the slots,
+					aligned to UNIV_PAGE_SIZE */
+{
+	ut_ad(dblwr->name != NULL);
+	ut_ad(slot + n_slots <= BUF_DBLWR_N_PAGES);
+
+	if (!os_file_write(dblwr->name, dblwr->file, buf,
+			   (os_offset_t) slot << UNIV_PAGE_SIZE_SHIFT,
+			   n_slots * UNIV_PAGE_SIZE)) {
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Cannot write to the doublewrite file %s",
+			dblwr->name);
+	}
+}
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -125,22 +216,18 @@ buf_dblwr_sync_datafiles()
 }
 
 /****************************************************************//**
-Creates or initialializes the doublewrite buffer at a database start. */
+Initializes the memory structure of a doublewrite buffer. */
 static
 void
-buf_dblwr_init(
-/*===========*/
-	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
-				header on trx sys page */
+buf_dblwr_init_low(
+/*===============*/
+	buf_dblwr_t*	dblwr)	/*!< out: zero-filled doublewrite buffer */
 {
 	ulint	buf_size;
 
-	buf_dblwr = static_cast<buf_dblwr_t*>(
-		mem_zalloc(sizeof(buf_dblwr_t)));
-
 	/* There are two blocks of same size in the doublewrite
 	buffer. */
-	buf_size = TRX_SYS_DOUBLEWRITE_BLOCKS * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+	buf_size = BUF_DBLWR_N_PAGES;
 
 	/* There must be atleast one buffer for single page writes
 	and one buffer for batch writes. */
@@ -148,33 +235,235 @@ buf_dblwr_init(
 	     && srv_doublewrite_batch_size < buf_size);
 
 	mutex_create(buf_dblwr_mutex_key,
-		     &buf_dblwr->mutex, SYNC_DOUBLEWRITE);
+		     &dblwr->mutex, SYNC_DOUBLEWRITE);
 
-	buf_dblwr->b_event = os_event_create();
-	buf_dblwr->s_event = os_event_create();
-	buf_dblwr->first_free = 0;
-	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
-
-	buf_dblwr->block1 = mach_read_from_4(
-		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
-	buf_dblwr->block2 = mach_read_from_4(
-		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+	dblwr->b_event = os_event_create();
+	dblwr->s_event = os_event_create();
+	dblwr->first_free = 0;
+	dblwr->s_reserved = 0;
+	dblwr->b_reserved = 0;
 
-	buf_dblwr->in_use = static_cast<bool*>(
+	dblwr->in_use = static_cast<bool*>(
 		mem_zalloc(buf_size * sizeof(bool)));
 
-	buf_dblwr->write_buf_unaligned = static_cast<byte*>(
+	dblwr->write_buf_unaligned = static_cast<byte*>(
 		ut_malloc((1 + buf_size) * UNIV_PAGE_SIZE));
 
-	buf_dblwr->write_buf = static_cast<byte*>(
-		ut_align(buf_dblwr->write_buf_unaligned,
+	dblwr->write_buf = static_cast<byte*>(
+		ut_align(dblwr->write_buf_unaligned,
 			 UNIV_PAGE_SIZE));
 
-	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
+	dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		mem_zalloc(buf_size * sizeof(void*)));
 }
 
+/****************************************************************//**
+Frees the memory structure of a doublewrite buffer. */
+static
+void
+buf_dblwr_free_low(
+/*===============*/
+	buf_dblwr_t*	dblwr)	/*!< in/out: doublewrite buffer */
+{
+	ut_ad(dblwr->s_reserved == 0);
+	ut_ad(dblwr->b_reserved == 0);
+
+	os_event_free(dblwr->b_event);
+	os_event_free(dblwr->s_event);
+	ut_free(dblwr->write_buf_unaligned);
+	dblwr->write_buf_unaligned = NULL;
+
+	mem_free(dblwr->buf_block_arr);
+	dblwr->buf_block_arr = NULL;
+
+	mem_free(dblwr->in_use);
+	dblwr->in_use = NULL;
+
+	mutex_free(&dblwr->mutex);
+}
+
+/****************************************************************//**
+Opens or creates the doublewrite files at a database start, if
+innodb_doublewrite_files > 0. There is no use for more files than
+buffer pool instances. */
+static
+void
+buf_dblwr_files_init(void)
+/*======================*/
+{
+	const os_offset_t	size = (os_offset_t) BUF_DBLWR_N_PAGES
+		<< UNIV_PAGE_SIZE_SHIFT;
+
+	ut_ad(buf_dblwr_files == NULL);
+
+	if (!srv_use_doublewrite_buf || srv_read_only_mode
+	    || srv_doublewrite_files == 0) {
+		return;
+	}
+
+	buf_dblwr_n_files = ut_min(srv_doublewrite_files,
+				   srv_buf_pool_instances);
+
+	buf_dblwr_files = static_cast<buf_dblwr_t*>(
+		mem_zalloc(buf_dblwr_n_files * sizeof *buf_dblwr_files));
+
+	for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+		buf_dblwr_t*	dblwr = &buf_dblwr_files[i];
+		ibool		exists;
+		ibool		success;
+		os_file_type_t	type;
+
+		buf_dblwr_init_low(dblwr);
+
+		dblwr->name = buf_dblwr_file_name(i);
+
+		if (!os_file_status(dblwr->name, &exists, &type)) {
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot check the doublewrite file %s",
+				dblwr->name);
+		}
+
+		dblwr->file = os_file_create(
+			innodb_file_data_key, dblwr->name,
+			exists ? OS_FILE_OPEN : OS_FILE_CREATE,
+			OS_FILE_NORMAL, OS_DATA_FILE, &success, FALSE);
+
+		if (!success) {
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot %s the doublewrite file %s",
+				exists ? "open" : "create", dblwr->name);
+		}
+
+		if ((!exists || os_file_get_size(dblwr->file) != size)
+		    && !os_file_set_size(dblwr->name, dblwr->file, size)) {
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot set the size of the doublewrite"
+				" file %s to " ULINTPF " pages",
+				dblwr->name, ulint(BUF_DBLWR_N_PAGES));
+		}
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Using " ULINTPF " doublewrite files", buf_dblwr_n_files);
+}
+
+/****************************************************************//**
+Reads the pages of the doublewrite files to memory for crash recovery.
+The files that a configuration with more doublewrite files left behind
+are read as well; buf_dblwr_process() removes them. */
+static
+void
+buf_dblwr_files_load(void)
+/*======================*/
+{
+	const ulint	bytes = BUF_DBLWR_N_PAGES * UNIV_PAGE_SIZE;
+	byte*		stale_buf = NULL;
+	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
+
+	ut_ad(buf_dblwr_n_stale == 0);
+
+	for (;;) {
+		char*		name = buf_dblwr_file_name(
+			buf_dblwr_n_files + buf_dblwr_n_stale);
+		ibool		exists;
+		os_file_type_t	type;
+
+		if (!os_file_status(name, &exists, &type) || !exists) {
+			mem_free(name);
+			break;
+		}
+
+		mem_free(name);
+		buf_dblwr_n_stale++;
+	}
+
+	if (buf_dblwr_n_stale > 0) {
+		buf_dblwr_stale_buf = static_cast<byte*>(
+			ut_malloc(buf_dblwr_n_stale * bytes + UNIV_PAGE_SIZE));
+		stale_buf = static_cast<byte*>(
+			ut_align(buf_dblwr_stale_buf, UNIV_PAGE_SIZE));
+	}
+
+	for (ulint i = 0; i < buf_dblwr_n_files + buf_dblwr_n_stale; i++) {
+		byte*		buf;
+		os_file_t	file;
+		char*		name = NULL;
+		os_offset_t	size;
+
+		if (i < buf_dblwr_n_files) {
+			buf = buf_dblwr_files[i].write_buf;
+			file = buf_dblwr_files[i].file;
+		} else {
+			ibool	success;
+
+			buf = stale_buf + (i - buf_dblwr_n_files) * bytes;
+			name = buf_dblwr_file_name(i);
+			file = os_file_create_simple_no_error_handling(
+				innodb_file_data_key, name, OS_FILE_OPEN,
+				OS_FILE_READ_ONLY, &success, FALSE);
+
+			if (!success) {
+				ib_logf(IB_LOG_LEVEL_WARN,
+					"Cannot open the doublewrite file %s",
+					name);
+				memset(buf, 0, bytes);
+				mem_free(name);
+				continue;
+			}
+		}
+
+		/* A file that was not completely created is
+		padded with zeroes. */
+		size = ut_min(os_file_get_size(file), (os_offset_t) bytes);
+		size &= ~((os_offset_t) UNIV_PAGE_SIZE - 1);
+		memset(buf + size, 0, bytes - ulint(size));
+
+		if (size > 0 && !os_file_read(file, buf, 0, ulint(size))) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Cannot read the doublewrite file %s",
+				name ? name : buf_dblwr_files[i].name);
+			memset(buf, 0, bytes);
+		}
+
+		if (name != NULL) {
+			os_file_close(file);
+			mem_free(name);
+		}
+
+		for (byte* page = buf; page < buf + bytes;
+		     page += UNIV_PAGE_SIZE) {
+			/* Each valid page header must contain some
+			nonzero bytes, such as FIL_PAGE_OFFSET
+			or FIL_PAGE_LSN. */
+			if (!buf_page_is_zeroes(page, FIL_PAGE_DATA)) {
+				recv_dblwr.add(page);
+			}
+		}
+	}
+}
+
+/****************************************************************//**
+Creates or initialializes the doublewrite buffer at a database start. */
+static
+void
+buf_dblwr_init(
+/*===========*/
+	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
+				header on trx sys page */
+{
+	buf_dblwr = static_cast<buf_dblwr_t*>(
+		mem_zalloc(sizeof(buf_dblwr_t)));
+
+	buf_dblwr_init_low(buf_dblwr);
+
+	buf_dblwr->block1 = mach_read_from_4(
+		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
+	buf_dblwr->block2 = mach_read_from_4(
+		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+
+	buf_dblwr_files_init();
+}
+
 /****************************************************************//**
 Creates the doublewrite buffer to a new InnoDB installation. The header of the
 doublewrite buffer is placed on the trx system header page. */
@@ -464,6 +753,10 @@ buf_dblwr_init_or_load_pages(
 		os_file_flush(file);
 	}
 
+	if (load_corrupt_pages) {
+		buf_dblwr_files_load();
+	}
+
 leave_func:
 	ut_free(unaligned_read_buf);
 }
@@ -631,6 +924,32 @@ buf_dblwr_process()
 
 		ut_free(unaligned_buf);
         }
+
+	for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+		buf_dblwr_t*	dblwr = &buf_dblwr_files[i];
+
+		memset(dblwr->write_buf, 0, BUF_DBLWR_N_PAGES * UNIV_PAGE_SIZE);
+		buf_dblwr_file_write(dblwr, 0, BUF_DBLWR_N_PAGES,
+				     dblwr->write_buf);
+		os_file_flush(dblwr->file);
+	}
+
+	/* The pages of the doublewrite files of an earlier configuration
+	were restored above. */
+	for (ulint i = buf_dblwr_n_files;
+	     i < buf_dblwr_n_files + buf_dblwr_n_stale; i++) {
+		char*	name = buf_dblwr_file_name(i);
+
+		if (!srv_read_only_mode) {
+			os_file_delete_if_exists(innodb_file_data_key, name);
+		}
+
+		mem_free(name);
+	}
+
+	buf_dblwr_n_stale = 0;
+	ut_free(buf_dblwr_stale_buf);
+	buf_dblwr_stale_buf = NULL;
 }
 
 /****************************************************************//**
@@ -642,21 +961,26 @@ buf_dblwr_free(void)
 {
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
-	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_free(buf_dblwr->b_event);
-	os_event_free(buf_dblwr->s_event);
-	ut_free(buf_dblwr->write_buf_unaligned);
-	buf_dblwr->write_buf_unaligned = NULL;
+	for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+		buf_dblwr_t*	dblwr = &buf_dblwr_files[i];
 
-	mem_free(buf_dblwr->buf_block_arr);
-	buf_dblwr->buf_block_arr = NULL;
+		os_file_close(dblwr->file);
+		mem_free(dblwr->name);
+		buf_dblwr_free_low(dblwr);
+	}
+
+	if (buf_dblwr_files != NULL) {
+		mem_free(buf_dblwr_files);
+		buf_dblwr_files = NULL;
+		buf_dblwr_n_files = 0;
+	}
 
-	mem_free(buf_dblwr->in_use);
-	buf_dblwr->in_use = NULL;
+	ut_free(buf_dblwr_stale_buf);
+	buf_dblwr_stale_buf = NULL;
+	buf_dblwr_n_stale = 0;
 
-	mutex_free(&buf_dblwr->mutex);
+	buf_dblwr_free_low(buf_dblwr);
 	mem_free(buf_dblwr);
 	buf_dblwr = NULL;
 }
@@ -674,42 +998,44 @@ buf_dblwr_update(
 		return;
 	}
 
+	buf_dblwr_t*	dblwr = buf_dblwr_get_for_page(bpage);
+
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		mutex_enter(&dblwr->mutex);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+		ut_ad(dblwr->batch_running);
+		ut_ad(dblwr->b_reserved > 0);
+		ut_ad(dblwr->b_reserved <= dblwr->first_free);
 
-		buf_dblwr->b_reserved--;
+		dblwr->b_reserved--;
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
+		if (dblwr->b_reserved == 0) {
+			mutex_exit(&dblwr->mutex);
 			/* This will finish the batch. Sync data files
 			to the disk. */
 			fil_flush_file_spaces(FIL_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&dblwr->mutex);
 
 			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
+			dblwr->first_free = 0;
+			dblwr->batch_running = false;
+			os_event_set(dblwr->b_event);
 		}
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&dblwr->mutex);
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
 			const ulint size = TRX_SYS_DOUBLEWRITE_BLOCKS * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 			ulint i;
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&dblwr->mutex);
 			for (i = srv_doublewrite_batch_size; i < size; ++i) {
-				if (buf_dblwr->buf_block_arr[i] == bpage) {
-					buf_dblwr->s_reserved--;
-					buf_dblwr->buf_block_arr[i] = NULL;
-					buf_dblwr->in_use[i] = false;
+				if (dblwr->buf_block_arr[i] == bpage) {
+					dblwr->s_reserved--;
+					dblwr->buf_block_arr[i] = NULL;
+					dblwr->in_use[i] = false;
 					break;
 				}
 			}
@@ -718,8 +1044,8 @@ buf_dblwr_update(
 			reserved block. */
 			ut_a(i < size);
 		}
-		os_event_set(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
+		os_event_set(dblwr->s_event);
+		mutex_exit(&dblwr->mutex);
 		break;
 	case BUF_FLUSH_N_TYPES:
 		ut_error;
@@ -877,68 +1203,63 @@ and also wakes up the aio thread if simulated aio is used. It is very
 important to call this function after a batch of writes has been posted,
 and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
-UNIV_INTERN
+static
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_flush_buffered_writes_low(
+/*================================*/
+	buf_dblwr_t*	dblwr)	/*!< in/out: doublewrite buffer */
 {
 	byte*		write_buf;
 	ulint		first_free;
 	ulint		len;
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		return;
-	}
-
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&dblwr->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (dblwr->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&dblwr->mutex);
 
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (dblwr->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		ib_int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		ib_int64_t	sig_count = os_event_reset(dblwr->b_event);
+		mutex_exit(&dblwr->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(dblwr->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!dblwr->batch_running);
+	ut_ad(dblwr->first_free == dblwr->b_reserved);
 
 	/* Disallow anyone else to post to doublewrite buffer or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	dblwr->batch_running = true;
+	first_free = dblwr->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&dblwr->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	write_buf = dblwr->write_buf;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < dblwr->first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) dblwr->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -956,57 +1277,68 @@ buf_dblwr_flush_buffered_writes(void)
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
+	if (dblwr->name != NULL) {
+		/* The slots of a doublewrite file are contiguous.
+		Write the whole batch with one request. */
+		buf_dblwr_file_write(dblwr, 0, dblwr->first_free, write_buf);
+		goto flush;
+	}
+
 	/* Write out the first block of the doublewrite buffer */
 	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
+		     dblwr->first_free) * UNIV_PAGE_SIZE;
 
 	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-	       buf_dblwr->block1, 0, len,
+	       dblwr->block1, 0, len,
 		(void*) write_buf, NULL, 0);
 
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+	if (dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
 		/* No unwritten pages in the second block. */
 		goto flush;
 	}
 
 	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+	len = (dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
 	       * UNIV_PAGE_SIZE;
 
-	write_buf = buf_dblwr->write_buf
+	write_buf = dblwr->write_buf
 		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
 
 	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-	       buf_dblwr->block2, 0, len,
+	       dblwr->block2, 0, len,
 		(void*) write_buf, NULL, 0);
 
 flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(dblwr->first_free);
 	srv_stats.dblwr_writes.inc();
 
 	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	if (dblwr->name != NULL) {
+		os_file_flush(dblwr->file);
+	} else {
+		fil_flush(TRX_SYS_SPACE);
+	}
 
 	/* We know that the writes have been flushed to disk now
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and dblwr->first_free are
+	same because we have set the dblwr->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access dblwr->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting dblwr->first_free to a higher value.
+	If this happens and we are using dblwr->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == dblwr->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			dblwr->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -1016,6 +1348,41 @@ buf_dblwr_flush_buffered_writes(void)
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+UNIV_INTERN
+void
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	const buf_pool_t*	buf_pool)	/*!< in: buffer pool instance
+						whose writes to flush, or NULL
+						to flush the writes of all
+						instances */
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	if (buf_dblwr_n_files == 0) {
+		buf_dblwr_flush_buffered_writes_low(buf_dblwr);
+	} else if (buf_pool != NULL) {
+		buf_dblwr_flush_buffered_writes_low(
+			&buf_dblwr_files[buf_pool_index(buf_pool)
+					 % buf_dblwr_n_files]);
+	} else {
+		for (ulint i = 0; i < buf_dblwr_n_files; i++) {
+			buf_dblwr_flush_buffered_writes_low(
+				&buf_dblwr_files[i]);
+		}
+	}
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -1026,16 +1393,17 @@ buf_dblwr_add_to_batch(
 /*====================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
-	ulint	zip_size;
+	ulint		zip_size;
+	buf_dblwr_t*	dblwr = buf_dblwr_get_for_page(bpage);
 
 	ut_a(buf_page_in_file(bpage));
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&dblwr->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(dblwr->first_free <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->batch_running) {
+	if (dblwr->batch_running) {
 
 		/* This not nearly as bad as it looks. There is only
 		page_cleaner thread which does background flushing
@@ -1043,17 +1411,17 @@ buf_dblwr_add_to_batch(
 		point. The only exception is when a user thread is
 		forced to do a flush batch because of a sync
 		checkpoint. */
-		ib_int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		ib_int64_t	sig_count = os_event_reset(dblwr->b_event);
+		mutex_exit(&dblwr->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(dblwr->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (dblwr->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&dblwr->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes_low(dblwr);
 
 		goto try_again;
 	}
@@ -1064,40 +1432,40 @@ buf_dblwr_add_to_batch(
 	if (zip_size) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
 		/* Copy the compressed page and clear the rest. */
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
+		memcpy(dblwr->write_buf
+		       + UNIV_PAGE_SIZE * dblwr->first_free,
                        frame, zip_size);
-		memset(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free
+		memset(dblwr->write_buf
+		       + UNIV_PAGE_SIZE * dblwr->first_free
 		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 	} else {
 		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
 		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
 				   UNIV_PAGE_SIZE);
 
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
+		memcpy(dblwr->write_buf
+		       + UNIV_PAGE_SIZE * dblwr->first_free,
 		       frame, UNIV_PAGE_SIZE);
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	dblwr->buf_block_arr[dblwr->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	dblwr->first_free++;
+	dblwr->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!dblwr->batch_running);
+	ut_ad(dblwr->first_free == dblwr->b_reserved);
+	ut_ad(dblwr->b_reserved <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (dblwr->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&dblwr->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes_low(dblwr);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&dblwr->mutex);
 }
 
 /********************************************************************//**
@@ -1120,11 +1488,14 @@ buf_dblwr_write_single_page(
 	ulint		zip_size;
 	ulint		offset;
 	ulint		i;
+	buf_dblwr_t*	dblwr;
 
 	ut_a(buf_page_in_file(bpage));
 	ut_a(srv_use_doublewrite_buf);
 	ut_a(buf_dblwr != NULL);
 
+	dblwr = buf_dblwr_get_for_page(bpage);
+
 	/* total number of slots available for single page flushes
 	starts from srv_doublewrite_batch_size to the end of the
 	buffer. */
@@ -1147,43 +1518,43 @@ buf_dblwr_write_single_page(
 	}
 
 retry:
-	mutex_enter(&buf_dblwr->mutex);
-	if (buf_dblwr->s_reserved == n_slots) {
+	mutex_enter(&dblwr->mutex);
+	if (dblwr->s_reserved == n_slots) {
 
 		/* All slots are reserved. */
 		ib_int64_t	sig_count =
-			os_event_reset(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
-		os_event_wait_low(buf_dblwr->s_event, sig_count);
+			os_event_reset(dblwr->s_event);
+		mutex_exit(&dblwr->mutex);
+		os_event_wait_low(dblwr->s_event, sig_count);
 
 		goto retry;
 	}
 
 	for (i = srv_doublewrite_batch_size; i < size; ++i) {
 
-		if (!buf_dblwr->in_use[i]) {
+		if (!dblwr->in_use[i]) {
 			break;
 		}
 	}
 
 	/* We are guaranteed to find a slot. */
 	ut_a(i < size);
-	buf_dblwr->in_use[i] = true;
-	buf_dblwr->s_reserved++;
-	buf_dblwr->buf_block_arr[i] = bpage;
+	dblwr->in_use[i] = true;
+	dblwr->s_reserved++;
+	dblwr->buf_block_arr[i] = bpage;
 
 	/* increment the doublewrite flushed pages counter */
 	srv_stats.dblwr_pages_written.inc();
 	srv_stats.dblwr_writes.inc();
 
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&dblwr->mutex);
 
 	/* Lets see if we are going to write in the first or second
 	block of the doublewrite buffer. */
 	if (i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		offset = buf_dblwr->block1 + i;
+		offset = dblwr->block1 + i;
 	} else {
-		offset = buf_dblwr->block2 + i
+		offset = dblwr->block2 + i
 			 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 	}
 
@@ -1201,10 +1572,24 @@ buf_dblwr_write_single_page(
 	zip_size = buf_page_get_zip_size(bpage);
 	void * frame = buf_page_get_frame(bpage);
 
-	if (zip_size) {
-		memcpy(buf_dblwr->write_buf + UNIV_PAGE_SIZE * i,
+	if (dblwr->name != NULL) {
+		/* Copy the page to its slot in the memory buffer,
+		so that the write to the doublewrite file is of a
+		whole aligned page. */
+		byte*	slot = dblwr->write_buf + UNIV_PAGE_SIZE * i;
+
+		if (zip_size) {
+			memcpy(slot, frame, zip_size);
+			memset(slot + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
+		} else {
+			memcpy(slot, frame, UNIV_PAGE_SIZE);
+		}
+
+		buf_dblwr_file_write(dblwr, i, 1, slot);
+	} else if (zip_size) {
+		memcpy(dblwr->write_buf + UNIV_PAGE_SIZE * i,
 		       frame, zip_size);
-		memset(buf_dblwr->write_buf + UNIV_PAGE_SIZE * i
+		memset(dblwr->write_buf + UNIV_PAGE_SIZE * i
 		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 
 		fil_io(OS_FILE_WRITE,
@@ -1213,7 +1598,7 @@ buf_dblwr_write_single_page(
 			offset,
 			0,
 			UNIV_PAGE_SIZE,
-			(void*) (buf_dblwr->write_buf + UNIV_PAGE_SIZE * i),
+			(void*) (dblwr->write_buf + UNIV_PAGE_SIZE * i),
 			NULL,
 			0);
 	} else {
@@ -1231,7 +1616,11 @@ buf_dblwr_write_single_page(
 	}
 
 	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	if (dblwr->name != NULL) {
+		os_file_flush(dblwr->file);
+	} else {
+		fil_flush(TRX_SYS_SPACE);
+	}
 
 	/* We know that the write has been flushed to disk now
 	and during recovery we will find it in the doublewrite buffer
@@ -1045,7 +1045,7 @@ buf_flush_page(
 			/* avoiding deadlock possibility involves doublewrite
 			buffer, should flush it, because it might hold the
 			another block->lock. */
-			buf_dblwr_flush_buffered_writes();
+			buf_dblwr_flush_buffered_writes(buf_pool);
 
 			rw_lock_s_lock_gen(rw_lock, BUF_IO_WRITE);
                 }
@@ -1432,6 +1432,7 @@ buf_flush_LRU_list_batch(
 	ulint		scanned = 0;
 	ulint		free_len = UT_LIST_GET_LEN(buf_pool->free);
 	ulint		lru_len = UT_LIST_GET_LEN(buf_pool->LRU);
+	ulint		withdraw_depth = 0;
 
 	n->flushed = 0;
 	n->evicted = 0;
@@ -1439,9 +1440,18 @@ buf_flush_LRU_list_batch(
 
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
+	if (buf_pool->withdraw_target
+	    && buf_pool->withdraw_target
+	    > UT_LIST_GET_LEN(buf_pool->withdraw)) {
+		/* buf_pool_resize() is waiting for blocks to be
+		freed, so that they can be withdrawn. */
+		withdraw_depth = buf_pool->withdraw_target
+			- UT_LIST_GET_LEN(buf_pool->withdraw);
+	}
+
 	for (bpage = UT_LIST_GET_LAST(buf_pool->LRU);
 	     bpage != NULL && (n->evicted + n->flushed) < max
-	     && free_len < srv_LRU_scan_depth
+	     && free_len < srv_LRU_scan_depth + withdraw_depth
 	     && lru_len > BUF_LRU_MIN_LEN;
 	     ++scanned,
 	     bpage = buf_pool->lru_hp.get()) {
@@ -1667,10 +1677,13 @@ Gather the aggregated stats for both flush list and LRU list flushing */
 void
 buf_flush_common(
 /*=============*/
+	const buf_pool_t* buf_pool,	/*!< in: buffer pool instance that
+					was flushed, or NULL if several
+					instances were flushed */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_dblwr_flush_buffered_writes();
+	buf_dblwr_flush_buffered_writes(buf_pool);
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
@@ -1842,7 +1855,7 @@ buf_flush_list(
 
 		buf_flush_end(buf_pool, BUF_FLUSH_LIST);
 
-		buf_flush_common(BUF_FLUSH_LIST, n.flushed);
+		buf_flush_common(buf_pool, BUF_FLUSH_LIST, n.flushed);
 
 		if (n_processed) {
 			*n_processed += n.flushed;
@@ -1985,7 +1998,7 @@ buf_flush_LRU_tail(void)
 
 		buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-		buf_flush_common(BUF_FLUSH_LRU, n.flushed);
+		buf_flush_common(buf_pool, BUF_FLUSH_LRU, n.flushed);
 
 		if (n.flushed) {
 			MONITOR_INC_VALUE_CUMULATIVE(
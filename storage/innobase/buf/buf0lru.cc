@@ -1123,9 +1123,7 @@ buf_LRU_get_free_only(
 
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
-	block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
-
-	if (block) {
+	while ((block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free))) {
 
 		ut_ad(block->page.in_free_list);
 		ut_d(block->page.in_free_list = FALSE);
@@ -1134,6 +1132,16 @@ buf_LRU_get_free_only(
 		ut_a(!buf_page_in_file(&block->page));
 		UT_LIST_REMOVE(list, buf_pool->free, (&block->page));
 
+		if (buf_pool->withdraw_target
+		    && buf_block_will_withdrawn(buf_pool, block)) {
+			/* This block is in a chunk that
+			buf_pool_resize() is going to free. */
+			UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+					 &block->page);
+			ut_d(block->in_withdraw_list = TRUE);
+			continue;
+		}
+
 		mutex_enter(&block->mutex);
 
 		buf_block_set_state(block, BUF_BLOCK_READY_FOR_USE);
@@ -1142,6 +1150,7 @@ buf_LRU_get_free_only(
 		ut_ad(buf_pool_from_block(block) == buf_pool);
 
 		mutex_exit(&block->mutex);
+		break;
 	}
 
 	return(block);
@@ -1160,7 +1169,9 @@ buf_LRU_check_size_of_non_data_objects(
 {
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
-	if (!recv_recovery_on && UT_LIST_GET_LEN(buf_pool->free)
+	if (!recv_recovery_on
+	    && buf_pool->withdraw_target == 0
+	    && UT_LIST_GET_LEN(buf_pool->free)
 	    + UT_LIST_GET_LEN(buf_pool->LRU) < buf_pool->curr_size / 20) {
 		ut_print_timestamp(stderr);
 
@@ -1182,6 +1193,7 @@ buf_LRU_check_size_of_non_data_objects(
 		ut_error;
 
 	} else if (!recv_recovery_on
+		   && buf_pool->withdraw_target == 0
 		   && (UT_LIST_GET_LEN(buf_pool->free)
 		       + UT_LIST_GET_LEN(buf_pool->LRU))
 		   < buf_pool->curr_size / 3) {
@@ -2128,8 +2140,16 @@ buf_LRU_block_free_non_file_page(
 		page_zip_set_size(&block->page.zip, 0);
 	}
 
-	UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
-	ut_d(block->page.in_free_list = TRUE);
+	if (buf_pool->withdraw_target
+	    && buf_block_will_withdrawn(buf_pool, block)) {
+		/* This block is in a chunk that buf_pool_resize()
+		is going to free. */
+		UT_LIST_ADD_LAST(list, buf_pool->withdraw, &block->page);
+		ut_d(block->in_withdraw_list = TRUE);
+	} else {
+		UT_LIST_ADD_FIRST(list, buf_pool->free, &block->page);
+		ut_d(block->page.in_free_list = TRUE);
+	}
 
 	UNIV_MEM_ASSERT_AND_FREE(block->frame, UNIV_PAGE_SIZE);
 }
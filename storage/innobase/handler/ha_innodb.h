@@ -183,6 +183,7 @@ class ha_innobase: public handler
 	int optimize(THD* thd,HA_CHECK_OPT* check_opt);
 	int discard_or_import_tablespace(my_bool discard);
 	int extra(enum ha_extra_function operation);
+	int extra_opt(enum ha_extra_function operation, ulong cache_size);
 	int reset();
 	int external_lock(THD *thd, int lock_type);
 	int transactional_table_lock(THD *thd, int lock_type);
@@ -190,6 +191,7 @@ class ha_innobase: public handler
 	void position(uchar *record);
 	ha_rows records_in_range(uint inx, key_range *min_key, key_range
 								*max_key);
+	ha_rows records();
 	ha_rows estimate_rows_upper_bound();
 
 	void update_create_info(HA_CREATE_INFO* create_info);
@@ -47,6 +47,14 @@ UNIV_INTERN
 void
 btr_search_sys_free(void);
 /*=====================*/
+/*****************************************************************//**
+Resizes the hash tables of the adaptive search system after the
+buffer pool was resized. The adaptive hash index must be disabled. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
 
 /********************************************************************//**
 Disable the adaptive hash search system and empty the index. */
@@ -80,13 +88,14 @@ btr_search_info_create(
 	mem_heap_t*	heap);	/*!< in: heap where created */
 /*****************************************************************//**
 Returns the value of ref_count. The value is protected by
-btr_search_latch.
+the latch of the AHI partition corresponding to this index.
 @return	ref_count value. */
 UNIV_INTERN
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info);	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index); /*!< in: index */
 /*********************************************************************//**
 Updates the search info. */
 UNIV_INLINE
@@ -191,6 +200,113 @@ btr_search_validate(void);
 /*======================*/
 #endif /* defined UNIV_AHI_DEBUG || defined UNIV_DEBUG */
 
+/********************************************************************//**
+Returns the adaptive hash index table for a given index key.
+@return the adaptive hash index table for a given index key */
+UNIV_INLINE
+hash_table_t*
+btr_search_get_hash_table(
+/*======================*/
+	const dict_index_t*	index)	/*!< in: index */
+	MY_ATTRIBUTE((pure,warn_unused_result));
+
+/********************************************************************//**
+Returns the adaptive hash index latch for a given index key.
+@return the adaptive hash index latch for a given index key */
+UNIV_INLINE
+rw_lock_t*
+btr_search_get_latch(
+/*=================*/
+	const dict_index_t*	index)	/*!< in: index */
+	MY_ATTRIBUTE((pure,warn_unused_result));
+
+/*********************************************************************//**
+Returns the AHI partition number corresponding to a given index ID. */
+UNIV_INLINE
+ulint
+btr_search_get_key(
+/*===============*/
+	index_id_t	index_id)	/*!< in: index ID */
+	MY_ATTRIBUTE((pure,warn_unused_result));
+
+/*********************************************************************//**
+Initializes AHI-related fields in a newly created index. */
+UNIV_INLINE
+void
+btr_search_index_init(
+/*===============*/
+	dict_index_t*	index)	/*!< in: index */
+	MY_ATTRIBUTE((nonnull));
+
+/********************************************************************//**
+Latches all adaptive hash index latches in exclusive mode.  */
+UNIV_INLINE
+void
+btr_search_x_lock_all(void);
+/*========================*/
+
+/********************************************************************//**
+Unlatches all adaptive hash index latches in exclusive mode.  */
+UNIV_INLINE
+void
+btr_search_x_unlock_all(void);
+/*==========================*/
+
+/********************************************************************//**
+Latches the adaptive hash index partition of an index in shared mode. */
+UNIV_INLINE
+void
+btr_search_s_lock(
+/*==============*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/********************************************************************//**
+Unlatches the adaptive hash index partition of an index in shared mode. */
+UNIV_INLINE
+void
+btr_search_s_unlock(
+/*================*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/********************************************************************//**
+Latches the adaptive hash index partition of an index in exclusive mode. */
+UNIV_INLINE
+void
+btr_search_x_lock(
+/*==============*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/********************************************************************//**
+Unlatches the adaptive hash index partition of an index in exclusive mode. */
+UNIV_INLINE
+void
+btr_search_x_unlock(
+/*================*/
+	const dict_index_t*	index);	/*!< in: index */
+
+#ifdef UNIV_SYNC_DEBUG
+/******************************************************************//**
+Checks if the thread has locked all the adaptive hash index latches in the
+specified mode.
+
+@return true if all latches are locked by the current thread, false
+otherwise.  */
+UNIV_INLINE
+bool
+btr_search_own_all(
+/*===============*/
+	ulint lock_type)
+	MY_ATTRIBUTE((warn_unused_result));
+/********************************************************************//**
+Checks if the thread owns any adaptive hash latches in either S or X mode.
+@return	true if the thread owns at least one latch in any mode. */
+UNIV_INLINE
+bool
+btr_search_own_any(void)
+/*=====================*/
+	 MY_ATTRIBUTE((warn_unused_result));
+#endif
+
 /** The search info struct in an index */
 struct btr_search_t{
 	ulint	ref_count;	/*!< Number of blocks in this index tree
@@ -248,9 +364,9 @@ struct btr_search_t{
 
 /** The hash index system */
 struct btr_search_sys_t{
-	hash_table_t*	hash_index;	/*!< the adaptive hash index,
-					mapping dtuple_fold values
-					to rec_t pointers on index pages */
+	hash_table_t**	hash_tables;	/*!< the array of adaptive hash index
+					tables, mapping dtuple_fold values to
+					rec_t pointers on index pages */
 };
 
 /** The adaptive hash index */
@@ -70,6 +70,32 @@ buf_buddy_free(
 					up to UNIV_PAGE_SIZE */
 	MY_ATTRIBUTE((nonnull));
 
+/**********************************************************************//**
+Try to reallocate a block, so that the memory that it occupies can be
+withdrawn by buf_pool_resize().
+@return true if there was enough free memory for trying */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	void*		buf,		/*!< in: block to be reallocated,
+					must be pointed to by the
+					buffer pool */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+	MY_ATTRIBUTE((nonnull));
+
+/**********************************************************************//**
+Combine all pairs of free buddies that are located in the chunks to be
+withdrawn by buf_pool_resize(). */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+	MY_ATTRIBUTE((nonnull));
+
 #ifndef UNIV_NONINL
 # include "buf0buddy.ic"
 #endif
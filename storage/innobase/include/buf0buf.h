@@ -92,6 +92,15 @@ extern ibool		buf_debug_prints;/*!< If this is set TRUE, the program
 #endif /* UNIV_DEBUG */
 extern ulint srv_buf_pool_instances;
 extern ulint srv_buf_pool_curr_size;
+extern ulong srv_buf_pool_chunk_unit;
+
+/** true when blocks are being withdrawn from the buffer pool
+by buf_pool_resize(); pages may be relocated while it is set */
+extern volatile bool	buf_pool_withdrawing;
+/** incremented every time buf_pool_resize() has withdrawn blocks;
+a block pointer that was obtained before that must not be
+dereferenced, because the block may have been freed */
+extern volatile ulint	buf_withdraw_clock;
 #else /* !UNIV_HOTBACKUP */
 extern buf_block_t*	back_block1;	/*!< first block, for --apply-log */
 extern buf_block_t*	back_block2;	/*!< second block, for page reorganize */
@@ -244,6 +253,62 @@ void
 buf_pool_clear_hash_index(void);
 /*===========================*/
 
+/********************************************************************//**
+Calculates the size of the buffer pool that will actually be allocated
+for the requested size, which is rounded up to a multiple of
+innodb_buffer_pool_chunk_size * innodb_buffer_pool_instances.
+@return	aligned size in bytes */
+UNIV_INLINE
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size);	/*!< in: requested size in bytes */
+
+/********************************************************************//**
+Checks if a block pointer that was stored earlier may still be
+dereferenced, or if the block may have been freed by resizing the
+buffer pool.
+@return	true if the block must not be dereferenced */
+UNIV_INLINE
+bool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock);/*!< in: buf_withdraw_clock at the time
+				the block pointer was stored */
+
+/********************************************************************//**
+Checks if a block is in a chunk that is going to be freed by
+buf_pool_resize(), so that it must be withdrawn rather than reused.
+@return	true if the block should be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block);		/*!< in: block */
+
+/********************************************************************//**
+Checks if a pointer is in a chunk that is going to be freed by
+buf_pool_resize().
+@return	true if the memory should be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr);		/*!< in: pointer to a frame */
+
+/********************************************************************//**
+This is the thread for resizing the buffer pool. It waits for an event
+and when waked up either performs a resizing and sleeps again.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /********************************************************************//**
 Relocate a buffer control block.  Relocates the block on the LRU list
 and in buf_pool->page_hash.  Does not relocate bpage->list.
@@ -1430,9 +1495,10 @@ UNIV_INTERN
 buf_page_t*
 buf_pool_watch_set(
 /*===============*/
-	ulint	space,	/*!< in: space id */
-	ulint	offset,	/*!< in: page number */
-	ulint	fold)	/*!< in: buf_page_address_fold(space, offset) */
+	ulint		space,	/*!< in: space id */
+	ulint		offset,	/*!< in: page number */
+	ulint		fold,	/*!< in: buf_page_address_fold(space, offset) */
+	rw_lock_t**	hash_lock)/*!< in/out: x-latched page_hash lock */
 	MY_ATTRIBUTE((warn_unused_result));
 /****************************************************************//**
 Stop watching if the page has been read in.
@@ -1675,7 +1741,7 @@ struct buf_page_t{
 					in one of the following lists in
 					buf_pool:
 
-					- BUF_BLOCK_NOT_USED:	free
+					- BUF_BLOCK_NOT_USED:	free, withdraw
 					- BUF_BLOCK_FILE_PAGE:	flush_list
 					- BUF_BLOCK_ZIP_DIRTY:	flush_list
 					- BUF_BLOCK_ZIP_PAGE:	zip_clean
@@ -1794,6 +1860,9 @@ struct buf_block_t{
 	ibool		in_unzip_LRU_list;/*!< TRUE if the page is in the
 					decompressed LRU list;
 					used in debugging */
+	ibool		in_withdraw_list;/*!< TRUE if the block is in
+					buf_pool->withdraw;
+					used in debugging */
 #endif /* UNIV_DEBUG */
 	ib_mutex_t	mutex;		/*!< mutex protecting this block:
 					state (also protected by the buffer
@@ -2139,7 +2208,19 @@ struct buf_pool_t{
 	ulint		mutex_exit_forbidden; /*!< Forbid release mutex */
 #endif
 	ulint		n_chunks;	/*!< number of buffer pool chunks */
-	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
+	ulint		n_chunks_new;	/*!< number of buffer pool chunks
+					after the resize that is in
+					progress; equals n_chunks otherwise */
+	buf_chunk_t*	chunks;		/*!< buffer pool chunks; the array
+					may be read without holding any
+					mutex, by reading n_chunks first.
+					When the buffer pool grows, it is
+					replaced by a bigger array before
+					n_chunks is incremented */
+	buf_chunk_t*	chunks_old;	/*!< the array that chunks replaced
+					on the last resize, or NULL; it is
+					freed on the next resize, when no
+					thread can be reading it any more */
 	ulint		curr_size;	/*!< current pool size in pages */
 	hash_table_t*	page_hash;	/*!< hash table of buf_page_t or
 					buf_block_t file pages,
@@ -2244,6 +2325,18 @@ struct buf_pool_t{
 					/*!< base node of the free
 					block list */
 
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the withdrawn
+					block list. While the buffer pool
+					is being shrunk, the free blocks of
+					the chunks that are going to be
+					freed are moved here instead of
+					the free list */
+	ulint		withdraw_target;/*!< number of blocks in the
+					chunks that are going to be
+					freed, or 0 if the buffer pool
+					is not being shrunk */
+
 	/** "hazard pointer" used during scan of LRU while doing
 	LRU list batch.  Protected by buf_pool::mutex */
 	LRUHp		lru_hp;
@@ -2347,6 +2440,15 @@ Use these instead of accessing buf_pool->mutex directly. */
 # define buf_page_hash_lock_get(b, f)			\
 	hash_get_lock(b->page_hash, f)
 
+/** If the page_hash was resized while the lock was being acquired,
+relatch the appropriate page_hash_lock. This is not needed when
+holding buf_pool->mutex. */
+# define buf_page_hash_lock_s_confirm(l, b, f)		\
+	hash_lock_s_confirm(l, (b)->page_hash, f)
+
+# define buf_page_hash_lock_x_confirm(l, b, f)		\
+	hash_lock_x_confirm(l, (b)->page_hash, f)
+
 #ifdef UNIV_SYNC_DEBUG
 /** Test if page_hash lock is held in s-mode. */
 # define buf_page_hash_lock_held_s(b, p)		\
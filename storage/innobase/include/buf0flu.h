@@ -312,6 +312,9 @@ Gather the aggregated stats for both flush list and LRU list flushing */
 void
 buf_flush_common(
 /*=============*/
+	const buf_pool_t* buf_pool,	/*!< in: buffer pool instance that
+					was flushed, or NULL if several
+					instances were flushed */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count);	/*!< in: number of pages flushed */
 
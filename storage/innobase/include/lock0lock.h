@@ -36,6 +36,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "lock0types.h"
 #include "read0types.h"
 #include "hash0hash.h"
+#include "sync0rw.h"
 #include "srv0srv.h"
 #include "ut0vec.h"
 
@@ -52,6 +53,18 @@ enum innodb_lock_schedule_algorithm_t {
 
 extern ulong innodb_lock_schedule_algorithm;
 
+/** Alternatives for innodb_deadlock_detect */
+enum innodb_deadlock_detect_t {
+	INNODB_DEADLOCK_DETECT_OFF,		/*!< Only innodb_lock_wait_timeout
+						resolves deadlocks */
+	INNODB_DEADLOCK_DETECT_ON,		/*!< Search the waits-for graph
+						whenever a lock wait starts */
+	INNODB_DEADLOCK_DETECT_BACKGROUND	/*!< Search the waits-for graph
+						in lock_wait_timeout_thread */
+};
+
+extern ulong innodb_deadlock_detect;
+
 /*********************************************************************//**
 Gets the size of a lock struct.
 @return	size in bytes */
@@ -507,6 +520,17 @@ lock_rec_unlock(
 	const rec_t*		rec,	/*!< in: record */
 	enum lock_mode		lock_mode);/*!< in: LOCK_S or LOCK_X */
 /*********************************************************************//**
+Releases the record locks of a prepared transaction whose commit order
+has already been determined, and grants the waiting lock requests that
+they were blocking. Any transaction that acquires one of the locks will
+be committed after this one. The table locks are kept until the commit.
+@return true if another transaction was waiting for one of the locks */
+UNIV_INTERN
+bool
+lock_release_rec_locks_early(
+/*=========================*/
+	trx_t*	trx);	/*!< in/out: prepared transaction */
+/*********************************************************************//**
 Releases a transaction's locks, and releases possible other transactions
 waiting because of these locks. Change the state of the transaction to
 TRX_STATE_COMMITTED_IN_MEMORY. */
@@ -787,6 +811,16 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	void*	arg);	/*!< in: a dummy parameter required by
 			os_thread_create */
 
+/*********************************************************************//**
+Looks for deadlocks among the transactions that are suspended in a lock
+wait, and rolls back one transaction of each deadlock that is found.
+Used by lock_wait_timeout_thread when innodb_deadlock_detect=BACKGROUND.
+The caller must hold lock_sys->wait_mutex. */
+UNIV_INTERN
+void
+lock_deadlock_check_background(void);
+/*================================*/
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -936,10 +970,26 @@ struct lock_op_t{
 	enum lock_mode	mode;	/*!< lock mode */
 };
 
+/** Number of partitions of lock_sys->rec_hash, each protected by its
+own mutex; must be a power of 2 */
+#define LOCK_REC_N_MUTEXES	64
+
 /** The lock system struct */
 struct lock_sys_t{
-	ib_mutex_t	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. Holding it in exclusive
+						mode gives access to all locks.
+						Holding it in shared mode and
+						one of rec_mutexes gives access
+						to the record locks of the pages
+						in that partition of rec_hash,
+						and to the lock state of their
+						transactions */
+	ib_mutex_t	rec_mutexes[LOCK_REC_N_MUTEXES];
+						/*!< Mutexes protecting the
+						partitions of rec_hash; a page
+						belongs to the partition of its
+						hash cell */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	ib_mutex_t	wait_mutex;		/*!< Mutex protecting the
@@ -961,7 +1011,7 @@ struct lock_sys_t{
 						/*!< TRUE if rollback of all
 						recovered transactions is
 						complete. Protected by
-						lock_sys->mutex */
+						lock_sys->latch */
 
 	ulint		n_lock_max_wait_time;	/*!< Max wait time */
 
@@ -969,7 +1019,11 @@ struct lock_sys_t{
 						lock_wait_timeout_thread.
 						Not protected by a mutex,
 						but the waits are timed.
-						Signaled on shutdown only. */
+						Signaled on shutdown, and
+						when a lock wait starts
+						while the deadlock
+						detection runs in the
+						background. */
 
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
@@ -978,20 +1032,68 @@ struct lock_sys_t{
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
-#define lock_mutex_enter_nowait() mutex_enter_nowait(&lock_sys->mutex)
+/** Test if lock_sys->latch can be acquired in exclusive mode without
+waiting.
+@return 0 if it was acquired */
+#define lock_mutex_enter_nowait()			\
+	(!rw_lock_x_lock_nowait(&lock_sys->latch))
+
+#ifdef UNIV_SYNC_DEBUG
+/** Test if lock_sys->latch is owned in exclusive mode. */
+# define lock_mutex_own() rw_lock_own(&lock_sys->latch, RW_LOCK_EX)
 
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() mutex_own(&lock_sys->mutex)
+/** Test if lock_sys->latch is owned in shared or exclusive mode. */
+# define lock_latch_own() (lock_mutex_own()			\
+	|| rw_lock_own(&lock_sys->latch, RW_LOCK_SHARED))
+#else /* UNIV_SYNC_DEBUG */
+/** Test if lock_sys->latch is owned in exclusive mode. */
+# define lock_mutex_own()					\
+	(rw_lock_get_writer(&lock_sys->latch) == RW_LOCK_EX	\
+	 && os_thread_eq(lock_sys->latch.writer_thread,		\
+			 os_thread_get_curr_id()))
 
-/** Acquire the lock_sys->mutex. */
+/** Test if lock_sys->latch may be owned in shared mode by this thread,
+or is owned in exclusive mode. */
+# define lock_latch_own() (lock_mutex_own()			\
+	|| rw_lock_get_reader_count(&lock_sys->latch) > 0)
+#endif /* UNIV_SYNC_DEBUG */
+
+/** Acquire lock_sys->latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release lock_sys->latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	mutex_exit(&lock_sys->mutex);		\
+	rw_lock_x_unlock(&lock_sys->latch);	\
+} while (0)
+
+/** Get the mutex of the lock_sys->rec_hash partition of a page.
+@param space	tablespace id
+@param page_no	page number
+@return mutex */
+#define lock_rec_get_mutex(space, page_no)				\
+	(&lock_sys->rec_mutexes[ut_2pow_remainder(			\
+		lock_rec_hash(space, page_no), LOCK_REC_N_MUTEXES)])
+
+/** Test if the record locks of a page may be accessed: either
+lock_sys->latch is owned in exclusive mode, or the mutex of the
+lock_sys->rec_hash partition of the page is owned. */
+#define lock_rec_mutex_own(space, page_no)				\
+	(lock_mutex_own() || mutex_own(lock_rec_get_mutex(space, page_no)))
+
+/** Acquire lock_sys->latch in shared mode and the mutex of the
+lock_sys->rec_hash partition of a page. */
+#define lock_rec_mutex_enter(space, page_no) do {		\
+	rw_lock_s_lock(&lock_sys->latch);			\
+	mutex_enter(lock_rec_get_mutex(space, page_no));	\
+} while (0)
+
+/** Release the mutex of the lock_sys->rec_hash partition of a page
+and lock_sys->latch. */
+#define lock_rec_mutex_exit(space, page_no) do {		\
+	mutex_exit(lock_rec_get_mutex(space, page_no));		\
+	rw_lock_s_unlock(&lock_sys->latch);			\
 } while (0)
 
 /** Test if lock_sys->wait_mutex is owned. */
@@ -51,6 +51,8 @@ Created 12/9/1995 Heikki Tuuri
 struct log_t;
 /** Redo log group */
 struct log_group_t;
+/** Range of the redo log buffer being filled without the log mutex */
+struct log_copy_slot_t;
 
 #ifdef UNIV_DEBUG
 /** Flag: write to log file? */
@@ -100,6 +102,13 @@ log_reserve_and_write_fast(
 	ulint		len,	/*!< in: string length */
 	lsn_t*		start_lsn);/*!< out: start lsn of the log record */
 /***********************************************************************//**
+Acquires the log mutex for appending log records to the log buffer, and
+counts the acquisitions that had to wait. */
+UNIV_INLINE
+void
+log_mutex_enter_for_append(void);
+/*============================*/
+/***********************************************************************//**
 Releases the log mutex. */
 UNIV_INLINE
 void
@@ -140,6 +149,37 @@ lsn_t
 log_close(void);
 /*===========*/
 /************************************************************//**
+Reserves space for log records in the log buffer, so that they can be
+copied with log_copy_low() after the log mutex has been released. It is
+assumed that the caller holds the log mutex, acquired by
+log_reserve_and_open(). The reservation must be closed with log_close(),
+and log_copy_complete() must be called after the records were copied.
+@return	copy slot, or NULL if all slots are in use; then the records
+must be written with log_write_low() */
+UNIV_INTERN
+log_copy_slot_t*
+log_reserve_for_copy(
+/*=================*/
+	ulint	str_len);	/*!< in: length of the log records */
+/************************************************************//**
+Copies log records to the space reserved by log_reserve_for_copy().
+The caller must not hold the log mutex. */
+UNIV_INTERN
+void
+log_copy_low(
+/*=========*/
+	log_copy_slot_t*	slot,	/*!< in/out: copy slot */
+	const byte*		str,	/*!< in: string */
+	ulint			str_len);/*!< in: string length */
+/************************************************************//**
+Marks the log records of a copy slot complete, so that log_write_up_to()
+can write them to the log files. */
+UNIV_INTERN
+void
+log_copy_complete(
+/*==============*/
+	log_copy_slot_t*	slot);	/*!< in/out: copy slot */
+/************************************************************//**
 Gets the current lsn.
 @return	current lsn */
 UNIV_INLINE
@@ -209,8 +249,9 @@ log_io_complete(
 /******************************************************//**
 This function is called, e.g., when a transaction wants to commit. It checks
 that the log has been written to the log file up to the last log entry written
-by the transaction. If there is a flush running, it waits and checks if the
-flush flushed enough. If not, starts a new flush. */
+by the transaction. If the log writer threads are running, it leaves the
+write and the flush to them and waits. Otherwise, if there is a flush running,
+it waits and checks if the flush flushed enough. If not, starts a new flush. */
 UNIV_INTERN
 void
 log_write_up_to(
@@ -222,6 +263,13 @@ log_write_up_to(
 	ibool	flush_to_disk);
 			/*!< in: TRUE if we want the written log
 			also to be flushed to disk */
+/*****************************************************************//**
+Starts the log writer and the log flusher thread. After this,
+log_write_up_to() leaves the log writes and flushes to them. */
+UNIV_INTERN
+void
+log_writer_threads_start(void);
+/*==========================*/
 /****************************************************************//**
 Does a syncronous flush of the log buffer to disk. */
 UNIV_INTERN
@@ -783,6 +831,22 @@ struct log_group_t{
 			log_groups;	/*!< list of log groups */
 };
 
+/** Number of log_t::copy_slots */
+#define LOG_COPY_SLOTS		1024
+
+/** A range of the log buffer that was reserved by log_reserve_for_copy()
+and is being filled by a mini-transaction without the log mutex */
+struct log_copy_slot_t{
+	lsn_t		start_lsn;	/*!< start lsn of the range;
+					protected by log_sys->mutex */
+	ulint		offset;		/*!< offset in log_sys->buf where
+					log_copy_low() continues copying;
+					only accessed by the reserving thread */
+	volatile bool	copied;		/*!< true when all the log records
+					have been copied; set without
+					log_sys->mutex */
+};
+
 /** Redo log buffer */
 struct log_t{
 	byte		pad[64];	/*!< padding to prevent other memory
@@ -841,6 +905,24 @@ struct log_t{
 					groups */
 	volatile bool	is_extending;	/*!< this is set to true during extend
 					the log buffer size */
+	log_copy_slot_t* copy_slots;	/*!< LOG_COPY_SLOTS slots, used as a
+					ring buffer of the log buffer ranges
+					that are being filled by
+					log_copy_low(), in ascending lsn
+					order; the log buffer must not be
+					moved while any of them is in use */
+	ulint		copy_first;	/*!< index of the oldest copy slot
+					in use */
+	ulint		n_copy_slots;	/*!< number of copy slots in use;
+					this is peeked at by log_write_up_to()
+					without the log mutex */
+	byte*		write_tail_buf_ptr;/*!< unaligned write_tail_buf */
+	byte*		write_tail_buf;	/*!< when a log write stops at log
+					records that are still being copied,
+					the last, incomplete log block is
+					written from this buffer, so that the
+					log buffer is not changed by the
+					write */
 	lsn_t		written_to_some_lsn;
 					/*!< first log sequence number not yet
 					written to any log group; for this to
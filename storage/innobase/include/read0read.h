@@ -47,6 +47,19 @@ read_view_open_now(
 	mem_heap_t*	heap);		/*!< in: memory heap from which
 					allocated */
 /*********************************************************************//**
+Reopens a read view of a transaction that was closed at the end of an
+earlier statement or transaction, if no read-write transaction has started
+or ended since the view was opened. The view then sees exactly what a new
+view would see, and the active transaction ids need not be copied again.
+@return	true if the view was reopened */
+UNIV_INTERN
+bool
+read_view_reopen(
+/*=============*/
+	read_view_t*	view,	/*!< in/out: closed read view */
+	const trx_t*	trx)	/*!< in: transaction that opens the view */
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/*********************************************************************//**
 Makes a copy of the oldest existing read view, or opens a new. The view
 must be closed with ..._close.
 @return	own: read view struct */
@@ -156,6 +169,9 @@ struct read_view_t{
 	trx_id_t	creator_trx_id;
 				/*!< trx id of creating transaction, or
 				0 used in purge */
+	ulint		rw_trx_version;
+				/*!< trx_sys->rw_trx_version when the
+				view was opened */
 	UT_LIST_NODE_T(read_view_t) view_list;
 				/*!< List of read views in trx_sys */
 };
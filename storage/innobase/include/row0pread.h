@@ -0,0 +1,155 @@
+/*****************************************************************************
+
+Copyright (c) 2017, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel scan of a clustered index
+
+The clustered index is split into key ranges at the node pointer level
+of the B-tree, and the ranges are scanned by several threads in the read
+view of one transaction.
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "data0types.h"
+#include "dict0types.h"
+#include "mem0mem.h"
+#include "read0types.h"
+#include "rem0types.h"
+#include "trx0types.h"
+
+/** Maximum number of threads of one parallel scan */
+#define ROW_PREAD_MAX_THREADS	256
+
+/** The index is split into this many ranges for each thread, so that
+the threads finish at about the same time even if the ranges are of
+different size */
+#define ROW_PREAD_RANGES_PER_THREAD	4
+
+/** Function that is invoked for each record that a parallel scan finds
+in the read view. The ranges may be scanned in any order and at the same
+time, but the records of one range are passed in the order of the index,
+with the argument of that range.
+@param[in]	rec	the version of the record in the read view
+@param[in]	offsets	rec_get_offsets(rec, index)
+@param[in,out]	arg	argument of the range that contains the record
+@return DB_SUCCESS, or an error code to stop the scan */
+typedef dberr_t (*row_pread_func_t)(
+	const rec_t*	rec,
+	const ulint*	offsets,
+	void*		arg);
+
+/** Function that is invoked when the scan of a range of a parallel
+scan ends, in the thread that scanned the range, without holding any
+page latches. It is invoked also when the scan was stopped.
+@param[in]	err	DB_SUCCESS if all records of the range were
+			passed to the function of the scan, or the error
+			that stopped the scan
+@param[in,out]	arg	argument of the range
+@return DB_SUCCESS, or an error code to stop the scan */
+typedef dberr_t (*row_pread_end_func_t)(
+	dberr_t		err,
+	void*		arg);
+
+/** A parallel scan of a clustered index */
+struct row_pread_t {
+	dict_index_t*	index;		/*!< the clustered index */
+	trx_t*		trx;		/*!< transaction that runs the scan;
+					the threads check if it was
+					interrupted */
+	read_view_t*	view;		/*!< read view of the scan, or NULL
+					to read the latest version of the
+					records (READ UNCOMMITTED) */
+	mem_heap_t*	heap;		/*!< memory heap for the range
+					boundaries */
+	ulint		n_ranges;	/*!< number of ranges */
+	const dtuple_t** bounds;	/*!< n_ranges - 1 boundaries: range
+					i consists of the records that are
+					not less than bounds[i - 1] and less
+					than bounds[i] */
+	ulint		n_threads;	/*!< number of threads that scan */
+	row_pread_func_t func;		/*!< function to invoke for each
+					record */
+	row_pread_end_func_t end_func;	/*!< function to invoke at the end
+					of each range, or NULL */
+	void**		args;		/*!< n_ranges arguments of func */
+	ulint		next_range;	/*!< the next range to scan;
+					protected by atomic operations */
+	volatile dberr_t err;		/*!< DB_SUCCESS, or the error that
+					stopped the scan */
+};
+
+/*********************************************************************//**
+Creates a parallel scan of a clustered index and splits the index into
+key ranges. The number of ranges depends on the size of the index, and
+it is 1 for an index that consists of a single page.
+@return the parallel scan; free it with row_pread_free() */
+UNIV_INTERN
+row_pread_t*
+row_pread_create(
+/*=============*/
+	dict_index_t*	index,		/*!< in: clustered index */
+	trx_t*		trx,		/*!< in: transaction */
+	read_view_t*	view,		/*!< in: read view, or NULL */
+	ulint		n_threads)	/*!< in: number of threads to use,
+					at most ROW_PREAD_MAX_THREADS */
+	MY_ATTRIBUTE((nonnull(1,2), warn_unused_result));
+/*********************************************************************//**
+Scans all ranges of a parallel scan. The calling thread is one of the
+threads that scan; the function returns when all ranges were scanned or
+the scan was stopped.
+@return DB_SUCCESS, DB_INTERRUPTED or an error returned by func */
+UNIV_INTERN
+dberr_t
+row_pread_run(
+/*==========*/
+	row_pread_t*		reader,	/*!< in/out: parallel scan */
+	row_pread_func_t	func,	/*!< in: function to invoke for each
+					record in the read view */
+	row_pread_end_func_t	end_func,/*!< in: function to invoke at the
+					end of each range, or NULL */
+	void**			args)	/*!< in/out: reader->n_ranges
+					arguments of func */
+	MY_ATTRIBUTE((nonnull(1,2,4), warn_unused_result));
+/*********************************************************************//**
+Frees a parallel scan. */
+UNIV_INTERN
+void
+row_pread_free(
+/*===========*/
+	row_pread_t*	reader)		/*!< in, own: parallel scan */
+	MY_ATTRIBUTE((nonnull));
+/*********************************************************************//**
+Counts the records of a clustered index in a read view with several
+threads.
+@return DB_SUCCESS, DB_INTERRUPTED or error code */
+UNIV_INTERN
+dberr_t
+row_pread_count(
+/*============*/
+	dict_index_t*	index,		/*!< in: clustered index */
+	trx_t*		trx,		/*!< in: transaction */
+	read_view_t*	view,		/*!< in: read view, or NULL */
+	ulint		n_threads,	/*!< in: number of threads to use */
+	ulint*		n_rows)		/*!< out: number of records */
+	MY_ATTRIBUTE((nonnull(1,2,5), warn_unused_result));
+
+#endif /* row0pread_h */
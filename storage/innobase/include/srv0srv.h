@@ -204,6 +204,10 @@ extern os_event_t	srv_error_event;
 Set on shutdown or by buf_dump_start() or buf_load_start(). */
 extern os_event_t	srv_buf_dump_event;
 
+/** Event for waking up buf_resize_thread. Not protected by a mutex.
+Set on shutdown or when innodb_buffer_pool_size is changed. */
+extern os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 #define SRV_BUF_DUMP_FILENAME_DEFAULT	"ib_buffer_pool"
 extern char*		srv_buf_dump_filename;
@@ -275,6 +279,8 @@ extern ibool	srv_locks_unsafe_for_binlog;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads that read, sort and merge in index creation */
+extern ulong	srv_sort_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -353,6 +359,8 @@ extern ib_uint64_t	srv_log_file_size;
 extern ib_uint64_t	srv_log_file_size_requested;
 extern ulint	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
+extern my_bool	srv_log_concurrent_copy;
+extern my_bool	srv_log_writer_threads;
 extern uint	srv_flush_log_at_timeout;
 extern char	srv_adaptive_flushing;
 
@@ -374,6 +382,8 @@ extern my_bool	srv_use_sys_malloc;
 extern ibool	srv_use_sys_malloc;
 #endif /* UNIV_HOTBACKUP */
 extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
+extern ulong	srv_buf_pool_chunk_unit;/*!< size in bytes of one chunk
+					of a buffer pool instance */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
 extern ulong	srv_n_page_hash_locks;	/*!< number of locks to
 					protect buf_pool->page_hash */
@@ -385,6 +395,9 @@ extern ulint	srv_buf_pool_old_size;	/*!< previously requested size */
 extern ulint	srv_buf_pool_curr_size;	/*!< current size in bytes */
 extern ulong	srv_buf_pool_dump_pct;	/*!< dump that may % of each buffer
 					pool during BP dump */
+extern uint	srv_change_buffer_max_size;/*!< maximum size of the
+					change buffer in percent of the
+					buffer pool */
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
 
@@ -462,6 +475,7 @@ extern my_bool			srv_stats_include_delete_marked;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+extern ulong	srv_doublewrite_files;
 
 extern my_bool	srv_force_primary_key;
 
@@ -488,6 +502,9 @@ extern bool	srv_error_monitor_active;
 /* TRUE during the lifetime of the buffer pool dump/load thread */
 extern bool	srv_buf_dump_thread_active;
 
+/* TRUE during the lifetime of the buffer pool resize thread */
+extern bool	srv_buf_resize_thread_active;
+
 /* TRUE during the lifetime of the stats thread */
 extern bool	srv_dict_stats_thread_active;
 
@@ -550,6 +567,9 @@ extern ulong srv_n_purge_threads;
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/* the number of threads applying redo log records during recovery */
+extern ulong srv_n_recv_apply_threads;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -592,6 +612,9 @@ extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
 
 /* This macro register the current thread and its key with performance
 schema */
@@ -913,6 +936,8 @@ struct export_var_t{
 	ulint innodb_data_reads;		/*!< I/O read requests */
 	char  innodb_buffer_pool_dump_status[512];/*!< Buf pool dump status */
 	char  innodb_buffer_pool_load_status[512];/*!< Buf pool load status */
+	char  innodb_buffer_pool_resize_status[512];/*!< Buf pool resize
+						status */
 	ulint innodb_buffer_pool_pages_total;	/*!< Buffer pool size */
 	ulint innodb_buffer_pool_pages_data;	/*!< Data pages */
 	ulint innodb_buffer_pool_bytes_data;	/*!< File bytes used */
@@ -111,9 +111,10 @@ extern mysql_pfs_key_t	sync_thread_mutex_key;
 extern mysql_pfs_key_t	buf_dblwr_mutex_key;
 extern mysql_pfs_key_t	trx_undo_mutex_key;
 extern mysql_pfs_key_t	trx_mutex_key;
-extern mysql_pfs_key_t	lock_sys_mutex_key;
+extern mysql_pfs_key_t	lock_rec_mutex_key;
 extern mysql_pfs_key_t	lock_sys_wait_mutex_key;
 extern mysql_pfs_key_t	trx_sys_mutex_key;
+extern mysql_pfs_key_t	trx_rw_hash_mutex_key;
 extern mysql_pfs_key_t	srv_sys_mutex_key;
 extern mysql_pfs_key_t	srv_sys_tasks_mutex_key;
 #ifndef HAVE_ATOMIC_BUILTINS
@@ -609,9 +610,13 @@ V
 lock_sys_wait_mutex			Mutex protecting lock timeout data
 |
 V
-lock_sys_mutex				Mutex protecting lock_sys_t
+lock_sys->latch				Rw-latch protecting lock_sys_t
 |
 V
+lock_rec_mutex				Mutex protecting a partition of
+|					lock_sys->rec_hash; acquired while
+|					holding lock_sys->latch in shared mode
+V
 trx_sys->mutex				Mutex protecting trx_sys_t
 |
 V
@@ -624,6 +629,9 @@ V
 trx_mutex				Mutex protecting trx_t fields
 |
 V
+trx_rw_hash_mutex			Mutex protecting a partition of
+|					trx_sys->rw_trx_hash
+V
 Search system mutex
 |
 V
@@ -697,12 +705,14 @@ or row lock! */
 /*------------------------------------- MySQL query cache mutex */
 /*------------------------------------- MySQL binlog mutex */
 /*-------------------------------*/
-#define SYNC_LOCK_WAIT_SYS	300
-#define SYNC_LOCK_SYS		299
+#define SYNC_LOCK_WAIT_SYS	301
+#define SYNC_LOCK_SYS		300
+#define SYNC_LOCK_REC_HASH	299
 #define SYNC_TRX_SYS		298
 #define SYNC_TRX		297
 #define SYNC_THREADS		295
 #define SYNC_REC_LOCK		294
+#define SYNC_TRX_RW_HASH	293
 #define SYNC_TRX_SYS_HEADER	290
 #define	SYNC_PURGE_QUEUE	200
 #define SYNC_LOG		170
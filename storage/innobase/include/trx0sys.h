@@ -42,6 +42,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "read0types.h"
 #include "page0types.h"
 #include "ut0bh.h"
+#include "hash0hash.h"
 #ifdef WITH_WSREP
 #include "trx0xa.h"
 #endif /* WITH_WSREP */
@@ -172,13 +173,22 @@ trx_sysf_rseg_set_page_no(
 					the slot is reset to unused */
 	mtr_t*		mtr);		/*!< in: mtr */
 /*****************************************************************//**
-Allocates a new transaction id.
+Allocates a new transaction id. The caller must hold trx_sys->mutex.
 @return	new, allocated trx id */
 UNIV_INLINE
 trx_id_t
 trx_sys_get_new_trx_id(void);
 /*========================*/
 /*****************************************************************//**
+Allocates a new transaction id without acquiring trx_sys->mutex, unless
+the id must be written to the trx system header. The caller must not
+hold trx_sys->mutex.
+@return	new, allocated trx id */
+UNIV_INLINE
+trx_id_t
+trx_sys_get_new_trx_id_nowait(void);
+/*===============================*/
+/*****************************************************************//**
 Determines the maximum transaction id.
 @return maximum currently allocated trx id; will be stale after the
 next call to trx_sys_get_new_trx_id() */
@@ -248,19 +258,36 @@ trx_rw_is_active_low(
 	ibool*		corrupt);	/*!< in: NULL or pointer to a flag
 					that will be set if corrupt */
 /****************************************************************//**
-Checks if a rw transaction with the given id is active. If the caller is
-not holding lock_sys->mutex, the transaction may already have been
-committed.
+Checks if a rw transaction with the given id is active. The transaction
+is looked up in trx_sys->rw_trx_hash, without acquiring trx_sys->mutex.
+If the caller is not holding lock_sys->mutex, the transaction may
+already have been committed.
 @return	transaction instance if active, or NULL;
 the pointer must not be dereferenced unless lock_sys->mutex was
 acquired before calling this function and is still being held */
-UNIV_INLINE
+UNIV_INTERN
 trx_t*
 trx_rw_is_active(
 /*=============*/
 	trx_id_t	trx_id,		/*!< in: trx id of the transaction */
 	ibool*		corrupt);	/*!< in: NULL or pointer to a flag
 					that will be set if corrupt */
+/****************************************************************//**
+Adds a read-write transaction to trx_sys->rw_trx_hash. This must be done
+before the transaction id can be written to any record. */
+UNIV_INTERN
+void
+trx_rw_hash_insert(
+/*===============*/
+	trx_t*	trx);	/*!< in: read-write transaction */
+/****************************************************************//**
+Removes a read-write transaction from trx_sys->rw_trx_hash, when it is
+removed from trx_sys->rw_trx_list. */
+UNIV_INTERN
+void
+trx_rw_hash_delete(
+/*===============*/
+	trx_t*	trx);	/*!< in: read-write transaction */
 #ifdef UNIV_DEBUG
 /****************************************************************//**
 Checks whether a trx is in one of rw_trx_list or ro_trx_list.
@@ -632,6 +659,10 @@ identifier is added to this 64-bit constant. */
 /* @} */
 
 #ifndef UNIV_HOTBACKUP
+/** Number of mutexes protecting trx_sys->rw_trx_hash; must be a
+power of 2 */
+#define TRX_RW_HASH_N_MUTEXES	64
+
 /** The transaction system central memory data structure. */
 struct trx_sys_t{
 
@@ -650,7 +681,9 @@ struct trx_sys_t{
 					if such transactions exist. */
 	trx_id_t	max_trx_id;	/*!< The smallest number not yet
 					assigned as a transaction id or
-					transaction number */
+					transaction number; may also be
+					incremented without the mutex, see
+					trx_sys_get_new_trx_id_nowait() */
 #ifdef UNIV_DEBUG
 	trx_id_t	rw_max_trx_id;	/*!< Max trx id of read-write transactions
 					which exist or existed */
@@ -659,6 +692,12 @@ struct trx_sys_t{
 					memory read-write transactions, sorted
 					on trx id, biggest first. Recovered
 					transactions are always on this list. */
+	ulint		rw_trx_version;	/*!< Incremented whenever a
+					transaction is added to or removed
+					from rw_trx_list. A closed read view
+					whose rw_trx_version is still current
+					sees exactly what a new view would
+					see, see read_view_reopen() */
 	trx_list_t	ro_trx_list;	/*!< List of active and committed in
 					memory read-only transactions, sorted
 					on trx id, biggest first. NOTE:
@@ -692,8 +731,27 @@ struct trx_sys_t{
 	UT_LIST_BASE_NODE_T(read_view_t) view_list;
 					/*!< List of read views sorted
 					on trx no, biggest first */
+	hash_table_t*	rw_trx_hash;	/*!< Hash table of the transactions
+					on rw_trx_list, hashed on trx id.
+					Used by trx_rw_is_active() to look up
+					the holder of an implicit lock without
+					acquiring the mutex. Protected by
+					rw_trx_hash_mutexes, not by mutex */
+	ib_mutex_t	rw_trx_hash_mutexes[TRX_RW_HASH_N_MUTEXES];
+					/*!< Mutexes protecting the cells of
+					rw_trx_hash; a cell belongs to
+					the mutex trx_rw_hash_get_mutex() */
 };
 
+/** Gets the mutex protecting the cell of a transaction id in
+trx_sys->rw_trx_hash
+@param id	transaction id
+@return the mutex */
+#define trx_rw_hash_get_mutex(id)					\
+	(&trx_sys->rw_trx_hash_mutexes[ut_2pow_remainder(		\
+		hash_calc_hash(ut_fold_ull(id), trx_sys->rw_trx_hash),	\
+		TRX_RW_HASH_N_MUTEXES)])
+
 /** When a trx id which is zero modulo this number (which must be a power of
 two) is assigned, the field TRX_SYS_TRX_ID_STORE on the transaction system
 page is updated */
@@ -45,7 +45,8 @@ Created 3/26/1996 Heikki Tuuri
 extern sess_t*	trx_dummy_sess;
 
 /********************************************************************//**
-Releases the search latch if trx has reserved it. */
+A transaction can no longer own an adaptive hash index latch outside of
+InnoDB code, so there is nothing to release on demand. */
 UNIV_INLINE
 void
 trx_search_latch_release_if_reserved(
@@ -631,6 +632,16 @@ struct trx_lock_t {
 					mutex to prevent recursive deadlocks.
 					Protected by both the lock sys mutex
 					and the trx_t::mutex. */
+	bool		released_early;	/*!< true if the record locks of
+					the prepared transaction were
+					released by
+					lock_release_rec_locks_early()
+					before the commit. Implicit locks
+					of the transaction are then no longer
+					converted to explicit ones. Written
+					while holding lock_sys->latch and the
+					trx_t::mutex; read while holding
+					either one exclusively. */
 };
 
 #define TRX_MAGIC_N	91118598
@@ -807,8 +818,8 @@ struct trx_t{
 					flush the log in
 					trx_commit_complete_for_mysql() */
 	ulint		duplicates;	/*!< TRX_DUP_IGNORE | TRX_DUP_REPLACE */
-	ulint		has_search_latch;
-					/*!< TRUE if this trx has latched the
+	bool		has_search_latch;
+					/*!< true if this trx has latched any
 					search system latch in S-mode */
 	ulint		search_latch_timeout;
 					/*!< If we notice that someone is
@@ -895,6 +906,9 @@ struct trx_t{
 	ibool		in_rw_trx_list;	/*!< TRUE if in trx_sys->rw_trx_list */
 	/* @} */
 #endif /* UNIV_DEBUG */
+	trx_t*		rw_trx_hash;	/*!< hash chain node in
+					trx_sys->rw_trx_hash; protected by
+					trx_rw_hash_get_mutex(id) */
 	UT_LIST_NODE_T(trx_t)
 			mysql_trx_list;	/*!< list of transactions created for
 					MySQL; protected by trx_sys->mutex */
@@ -934,6 +948,11 @@ struct trx_t{
 					associated to a transaction (i.e.
 					same as global_read_view) or read view
 					associated to a cursor */
+	read_view_t*	prebuilt_view;	/*!< the last read view allocated
+					from global_read_view_heap, or NULL;
+					it is kept after the view is closed,
+					so that trx_assign_read_view() can
+					reopen it */
 	/*------------------------------*/
 	UT_LIST_BASE_NODE_T(trx_named_savept_t)
 			trx_savepoints;	/*!< savepoints set with SAVEPOINT ...,
@@ -1122,24 +1141,6 @@ struct commit_node_t{
 	mutex_exit(&t->mutex);			\
 } while (0)
 
-/** @brief The latch protecting the adaptive search system
-
-This latch protects the
-(1) hash index;
-(2) columns of a record to which we have a pointer in the hash index;
-
-but does NOT protect:
-
-(3) next record offset field in a record;
-(4) next or previous records on the same page.
-
-Bear in mind (3) and (4) when using the hash index.
-*/
-extern rw_lock_t*	btr_search_latch_temp;
-
-/** The latch protecting the adaptive search system */
-#define btr_search_latch	(*btr_search_latch_temp)
-
 #ifndef UNIV_NONINL
 #include "trx0trx.ic"
 #endif
@@ -490,10 +490,12 @@ typedef	ib_uint64_t		lsn_t;
 typedef unsigned __int64	ulint;
 typedef __int64			lint;
 # define ULINTPF		UINT64PF
+#define MYSQL_SYSVAR_ULINT MYSQL_SYSVAR_ULONGLONG
 #else
 typedef unsigned long int	ulint;
 typedef long int		lint;
 # define ULINTPF		"%lu"
+#define MYSQL_SYSVAR_ULINT MYSQL_SYSVAR_ULONG
 #endif /* _WIN64 */
 
 #ifndef UNIV_HOTBACKUP
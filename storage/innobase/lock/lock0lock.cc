@@ -50,6 +50,8 @@ Created 5/7/1996 Heikki Tuuri
 #include "btr0btr.h"
 #include "dict0boot.h"
 #include <set>
+#include <vector>
+#include <algorithm>
 #include "mysql/plugin.h"
 
 #include <mysql/service_wsrep.h>
@@ -79,6 +81,9 @@ bitmap */
 /** Lock scheduling algorithm */
 ulong innodb_lock_schedule_algorithm = INNODB_LOCK_SCHEDULE_ALGORITHM_FCFS;
 
+/** Deadlock detection mode */
+ulong innodb_deadlock_detect = INNODB_DEADLOCK_DETECT_ON;
+
 /* An explicit record lock affects both the record and the gap before it.
 An implicit x-lock does not affect the gap, it only locks the index
 record from read or update.
@@ -420,9 +425,14 @@ static lock_stack_t*	lock_stack;
 static const ulint	lock_types = UT_ARR_SIZE(lock_compatibility_matrix);
 #endif /* UNIV_DEBUG */
 
+#ifdef UNIV_PFS_RWLOCK
+/* Key to register rw-lock with performance schema */
+UNIV_INTERN mysql_pfs_key_t	lock_sys_latch_key;
+#endif /* UNIV_PFS_RWLOCK */
+
 #ifdef UNIV_PFS_MUTEX
 /* Key to register mutex with performance schema */
-UNIV_INTERN mysql_pfs_key_t	lock_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	lock_rec_mutex_key;
 /* Key to register mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	lock_sys_wait_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
@@ -653,7 +663,12 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create(lock_sys_mutex_key, &lock_sys->mutex, SYNC_LOCK_SYS);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_create(lock_rec_mutex_key, &lock_sys->rec_mutexes[i],
+			     SYNC_LOCK_REC_HASH);
+	}
 
 	mutex_create(lock_sys_wait_mutex_key,
 		     &lock_sys->wait_mutex, SYNC_LOCK_WAIT_SYS);
@@ -682,7 +697,12 @@ lock_sys_close(void)
 
 	hash_table_free(lock_sys->rec_hash);
 
-	mutex_free(&lock_sys->mutex);
+	rw_lock_free(&lock_sys->latch);
+
+	for (ulint i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_free(&lock_sys->rec_mutexes[i]);
+	}
+
 	mutex_free(&lock_sys->wait_mutex);
 
 	mem_free(lock_stack);
@@ -901,7 +921,10 @@ lock_reset_lock_and_trx_wait(
 	lock_t*	lock)	/*!< in/out: record lock */
 {
 	ut_ad(lock_get_wait(lock));
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_type_low(lock) == LOCK_REC
+	      ? lock_rec_mutex_own(lock->un_member.rec_lock.space,
+				   lock->un_member.rec_lock.page_no)
+	      : lock_mutex_own());
 
 	if (lock->trx->lock.wait_lock &&
 	    lock->trx->lock.wait_lock != lock) {
@@ -1307,12 +1330,13 @@ lock_rec_get_next_on_page_const(
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
 
 	space = lock->un_member.rec_lock.space;
 	page_no = lock->un_member.rec_lock.page_no;
 
+	ut_ad(lock_rec_mutex_own(space, page_no));
+
 	for (;;) {
 		lock = static_cast<const lock_t*>(HASH_GET_NEXT(hash, lock));
 
@@ -1356,7 +1380,7 @@ lock_rec_get_first_on_page_addr(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own(space, page_no));
 
 	for (lock = static_cast<lock_t*>(
 			HASH_GET_FIRST(lock_sys->rec_hash,
@@ -1408,7 +1432,7 @@ lock_rec_get_first_on_page(
 	ulint	space	= buf_block_get_space(block);
 	ulint	page_no	= buf_block_get_page_no(block);
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own(space, page_no));
 
 	hash = buf_block_get_lock_hash_val(block);
 
@@ -1945,7 +1969,9 @@ lock_rec_other_trx_holds_expl(
 
 	lock_mutex_enter();
 
-	if (trx_t *impl_trx = trx_rw_is_active(trx_id, NULL)) {
+	trx_t*	impl_trx = trx_rw_is_active(trx_id, NULL);
+
+	if (impl_trx != NULL && !impl_trx->lock.released_early) {
 		ulint heap_no = page_rec_get_heap_no(rec);
 		mutex_enter(&trx_sys->mutex);
 
@@ -2087,7 +2113,8 @@ lock_rec_create(
 	bool		wait_lock;
 	const page_t*	page;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own(buf_block_get_space(block),
+				 buf_block_get_page_no(block)));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -2141,7 +2168,7 @@ lock_rec_create(
 	lock->requested_time = ut_time();
 	lock->wait_time = 0;
 
-	index->table->n_rec_locks++;
+	os_atomic_increment_ulint(&index->table->n_rec_locks, 1);
 
 	ut_ad(index->table->n_ref_count > 0 || !index->table->can_be_evicted);
 
@@ -2259,8 +2286,8 @@ lock_rec_create(
 		trx_mutex_exit(trx);
 	}
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 	return(lock);
 }
 
@@ -2700,7 +2727,8 @@ lock_rec_lock_fast(
 	trx_t*			trx;
 	enum lock_rec_req_status status = LOCK_REC_SUCCESS;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own(buf_block_get_space(block),
+				 buf_block_get_page_no(block)));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2852,7 +2880,10 @@ Tries to lock the specified record in the mode requested. If not immediately
 possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
-of a page supremum record, a gap type lock.
+of a page supremum record, a gap type lock. The caller must not hold
+lock_sys->latch: the common cases only need the lock_sys->rec_hash
+partition of the page, and the others acquire lock_sys->latch in exclusive
+mode.
 @return	DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -2872,7 +2903,12 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ulint			space = buf_block_get_space(block);
+	ulint			page_no = buf_block_get_page_no(block);
+	enum lock_rec_req_status status;
+	dberr_t			err;
+
+	ut_ad(!lock_mutex_own());
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2885,19 +2921,32 @@ lock_rec_lock(
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
 	/* We try a simplified and faster subroutine for the most
-	common cases */
-	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	common cases. It only looks at the locks on the page, so that
+	the partition of lock_sys->rec_hash suffices. */
+	lock_rec_mutex_enter(space, page_no);
+
+	status = lock_rec_lock_fast(impl, mode, block, heap_no, index, thr);
+
+	lock_rec_mutex_exit(space, page_no);
+
+	switch (status) {
 	case LOCK_REC_SUCCESS:
 		return(DB_SUCCESS);
 	case LOCK_REC_SUCCESS_CREATED:
 		return(DB_SUCCESS_LOCKED_REC);
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+		break;
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	/* Waiting and deadlock detection may involve the locks of
+	any page and table. */
+	lock_mutex_enter();
+
+	err = lock_rec_lock_slow(impl, mode, block, heap_no, index, thr);
+
+	lock_mutex_exit();
+
+	return(err);
 }
 
 /*********************************************************************//**
@@ -2916,12 +2965,13 @@ lock_rec_has_to_wait_in_queue(
 	ulint		bit_mask;
 	ulint		bit_offset;
 
-	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
 
 	space = wait_lock->un_member.rec_lock.space;
 	page_no = wait_lock->un_member.rec_lock.page_no;
+
+	ut_ad(lock_rec_mutex_own(space, page_no));
 	heap_no = lock_rec_find_set_bit(wait_lock);
 
 	bit_offset = heap_no / 8;
@@ -2960,7 +3010,10 @@ lock_grant(
 	lock_t*	lock,	/*!< in/out: waiting lock request */
 	bool	owns_trx_mutex)    /*!< in: whether lock->trx->mutex is owned */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_type_low(lock) == LOCK_REC
+	      ? lock_rec_mutex_own(lock->un_member.rec_lock.space,
+				   lock->un_member.rec_lock.page_no)
+	      : lock_mutex_own());
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -3135,7 +3188,6 @@ lock_rec_dequeue_from_page(
 	lock_t*		lock;
 	trx_lock_t*	trx_lock;
 
-	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 	/* We may or may not be holding in_lock->trx->mutex here. */
 
@@ -3144,15 +3196,19 @@ lock_rec_dequeue_from_page(
 	space = in_lock->un_member.rec_lock.space;
 	page_no = in_lock->un_member.rec_lock.page_no;
 
-	in_lock->index->table->n_rec_locks--;
+	ut_ad(lock_rec_mutex_own(space, page_no));
+
+	/* The locks of other pages of the table may be released
+	concurrently */
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_sys->rec_hash,
 		    lock_rec_fold(space, page_no), in_lock);
 
 	UT_LIST_REMOVE(trx_locks, trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 
 	if (innodb_lock_schedule_algorithm
 		== INNODB_LOCK_SCHEDULE_ALGORITHM_FCFS ||
@@ -3200,15 +3256,15 @@ lock_rec_discard(
 	space = in_lock->un_member.rec_lock.space;
 	page_no = in_lock->un_member.rec_lock.page_no;
 
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_sys->rec_hash,
 		    lock_rec_fold(space, page_no), in_lock);
 
 	UT_LIST_REMOVE(trx_locks, trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 }
 
 /*************************************************************//**
@@ -4802,6 +4858,19 @@ lock_deadlock_check_and_resolve(
 		waitee_buf_ptr = NULL;
 	}
 
+	/* The waits of replication threads must be reported to the
+	server layer, which needs the search. Other lock waits are left
+	to lock_wait_timeout_thread or to innodb_lock_wait_timeout. */
+	if (innodb_deadlock_detect != INNODB_DEADLOCK_DETECT_ON
+	    && waitee_buf_ptr == NULL) {
+		return(0);
+	}
+
+	ullint	counter_time = MONITOR_IS_ON(MONITOR_DEADLOCK_CHECK_MICROSECOND)
+		? ut_time_us(NULL) : 0;
+
+	MONITOR_INC(MONITOR_DEADLOCK_CHECK);
+
 	/* Try and resolve as many deadlocks as possible. */
 	do {
 		lock_deadlock_ctx_t	ctx;
@@ -4870,9 +4939,275 @@ lock_deadlock_check_and_resolve(
 		lock_deadlock_found = TRUE;
 	}
 
+	MONITOR_INC_TIME_IN_MICRO_SECS(
+		MONITOR_DEADLOCK_CHECK_MICROSECOND, counter_time);
+
 	return(victim_trx_id);
 }
 
+/** A transaction in the waits-for graph of lock_deadlock_check_background() */
+struct lock_wait_node_t {
+	trx_t*		trx;		/*!< transaction that is waiting */
+	const lock_t*	wait_lock;	/*!< the lock that trx is waiting for */
+	const trx_t*	blocker;	/*!< owner of the first lock ahead of
+					wait_lock that wait_lock has to wait
+					for, or NULL */
+	ulint		next;		/*!< node of blocker, or
+					ULINT_UNDEFINED if blocker is not
+					waiting */
+	ulint		visited;	/*!< node where the search that first
+					visited this node started, or
+					ULINT_UNDEFINED */
+};
+
+/*********************************************************************//**
+Gets a transaction that a waiting lock request has to wait for. This is
+the owner of the first conflicting lock ahead of the request in its
+queue whose owner is itself waiting for a lock, or else the owner of
+the first conflicting lock.
+@return blocking transaction, or NULL */
+static
+const trx_t*
+lock_get_blocking_trx(
+/*==================*/
+	const lock_t*	wait_lock)	/*!< in: waiting lock request */
+{
+	const lock_t*	lock;
+	const trx_t*	blocker = NULL;
+	ulint		heap_no = ULINT_UNDEFINED;
+
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		heap_no = lock_rec_find_set_bit(wait_lock);
+		lock = lock_rec_get_first_on_page_addr(
+			wait_lock->un_member.rec_lock.space,
+			wait_lock->un_member.rec_lock.page_no);
+	} else {
+		lock = UT_LIST_GET_FIRST(
+			wait_lock->un_member.tab_lock.table->locks);
+	}
+
+	for (; lock != wait_lock;
+	     lock = heap_no == ULINT_UNDEFINED
+	     ? UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)
+	     : lock_rec_get_next_on_page_const(lock)) {
+
+		if ((heap_no != ULINT_UNDEFINED
+		     && !lock_rec_get_nth_bit(lock, heap_no))
+		    || !lock_has_to_wait(wait_lock, lock)) {
+			continue;
+		}
+
+#ifdef WITH_WSREP
+		if (heap_no != ULINT_UNDEFINED
+		    && wsrep_thd_is_BF(wait_lock->trx->mysql_thd, FALSE)
+		    && wsrep_thd_is_BF(lock->trx->mysql_thd, TRUE)) {
+			/* see lock_rec_has_to_wait_in_queue() */
+			continue;
+		}
+#endif /* WITH_WSREP */
+
+		if (lock->trx->lock.que_state == TRX_QUE_LOCK_WAIT) {
+			return(lock->trx);
+		}
+
+		if (blocker == NULL) {
+			blocker = lock->trx;
+		}
+	}
+
+	return(blocker);
+}
+
+/*********************************************************************//**
+Rolls back one transaction of a cycle in the waits-for graph, unless
+the cycle was already broken when an earlier cycle was resolved. */
+static
+void
+lock_deadlock_resolve_cycle(
+/*========================*/
+	const std::vector<lock_wait_node_t>&	nodes,	/*!< in: graph */
+	ulint					start)	/*!< in: a node
+							of the cycle */
+{
+	trx_t*	victim = NULL;
+	ulint	victim_n = 0;
+	ulint	n = 0;
+	ulint	i = start;
+
+	ut_ad(lock_mutex_own());
+
+	do {
+		const lock_wait_node_t&	node = nodes[i];
+
+		if (node.trx->lock.wait_lock != node.wait_lock
+		    || lock_get_blocking_trx(node.wait_lock) != node.blocker) {
+			return;
+		}
+
+		n++;
+		i = node.next;
+
+#ifdef WITH_WSREP
+		if (wsrep_thd_is_BF(node.trx->mysql_thd, TRUE)) {
+			continue;
+		}
+#endif /* WITH_WSREP */
+
+		if (victim == NULL || trx_weight_ge(victim, node.trx)) {
+			victim = node.trx;
+			victim_n = n;
+		}
+	} while (i != start);
+
+	if (victim == NULL) {
+		victim = nodes[start].trx;
+		victim_n = 1;
+	}
+
+	if (!srv_read_only_mode) {
+		char	buf[64];
+
+		lock_deadlock_start_print();
+
+		n = 0;
+
+		do {
+			const lock_wait_node_t&	node = nodes[i];
+
+			n++;
+
+			ut_snprintf(buf, sizeof buf,
+				    "\n*** (" ULINTPF ") TRANSACTION:\n", n);
+			lock_deadlock_fputs(buf);
+			lock_deadlock_trx_print(node.trx, 3000);
+
+			ut_snprintf(buf, sizeof buf,
+				    "*** (" ULINTPF ") WAITING FOR THIS LOCK"
+				    " TO BE GRANTED:\n", n);
+			lock_deadlock_fputs(buf);
+			lock_deadlock_lock_print(node.wait_lock);
+
+			i = node.next;
+		} while (i != start);
+
+		ut_snprintf(buf, sizeof buf,
+			    "*** WE ROLL BACK TRANSACTION (" ULINTPF ")\n",
+			    victim_n);
+		lock_deadlock_fputs(buf);
+	}
+
+	trx_mutex_enter(victim);
+
+	victim->lock.was_chosen_as_deadlock_victim = TRUE;
+
+	lock_cancel_waiting_and_release(victim->lock.wait_lock);
+
+	trx_mutex_exit(victim);
+
+	lock_deadlock_found = TRUE;
+
+	MONITOR_INC(MONITOR_DEADLOCK);
+	MONITOR_INC(MONITOR_DEADLOCK_BACKGROUND);
+}
+
+/*********************************************************************//**
+Looks for deadlocks among the transactions that are suspended in a lock
+wait, and rolls back one transaction of each deadlock that is found.
+Used by lock_wait_timeout_thread when innodb_deadlock_detect=BACKGROUND.
+The caller must hold lock_sys->wait_mutex. */
+UNIV_INTERN
+void
+lock_deadlock_check_background(void)
+/*================================*/
+{
+	typedef std::pair<const trx_t*, ulint>	trx_node_t;
+
+	std::vector<lock_wait_node_t>	nodes;
+	std::vector<trx_node_t>		trx_nodes;
+
+	ut_ad(lock_wait_mutex_own());
+	ut_ad(!srv_read_only_mode);
+
+	ullint	counter_time = MONITOR_IS_ON(MONITOR_DEADLOCK_CHECK_MICROSECOND)
+		? ut_time_us(NULL) : 0;
+
+	lock_mutex_enter();
+
+	/* Each waiting transaction gets one edge in the graph, chosen
+	by lock_get_blocking_trx(). Unlike lock_deadlock_search(), this
+	keeps the work linear in the number of waiting transactions even
+	when hundreds of them queue on the same record. A deadlock that
+	is not visible through the chosen edges is found by a later
+	pass, after the blocking transaction has made progress, or
+	resolved by innodb_lock_wait_timeout. */
+	for (const srv_slot_t* slot = lock_sys->waiting_threads;
+	     slot < lock_sys->last_slot;
+	     ++slot) {
+
+		if (!slot->in_use) {
+			continue;
+		}
+
+		trx_t*		trx = thr_get_trx(slot->thr);
+		const lock_t*	wait_lock = trx->lock.wait_lock;
+
+		if (wait_lock == NULL) {
+			continue;
+		}
+
+		lock_wait_node_t	node;
+
+		node.trx = trx;
+		node.wait_lock = wait_lock;
+		node.blocker = lock_get_blocking_trx(wait_lock);
+		node.next = ULINT_UNDEFINED;
+		node.visited = ULINT_UNDEFINED;
+
+		if (node.blocker != NULL) {
+			trx_nodes.push_back(trx_node_t(trx, nodes.size()));
+			nodes.push_back(node);
+		}
+	}
+
+	std::sort(trx_nodes.begin(), trx_nodes.end());
+
+	for (ulint i = 0; i < nodes.size(); i++) {
+		std::vector<trx_node_t>::const_iterator	it = std::lower_bound(
+			trx_nodes.begin(), trx_nodes.end(),
+			trx_node_t(nodes[i].blocker, 0));
+
+		if (it != trx_nodes.end() && it->first == nodes[i].blocker) {
+			nodes[i].next = it->second;
+		}
+	}
+
+	/* Every node has at most one outgoing edge. Follow the edges
+	from each node that was not visited yet. If the walk returns
+	to a node that it visited itself, that node is on a cycle. */
+	for (ulint i = 0; i < nodes.size(); i++) {
+		ulint	j = i;
+
+		while (j != ULINT_UNDEFINED
+		       && nodes[j].visited == ULINT_UNDEFINED) {
+			nodes[j].visited = i;
+			j = nodes[j].next;
+		}
+
+		if (j != ULINT_UNDEFINED && nodes[j].visited == i) {
+			lock_deadlock_resolve_cycle(nodes, j);
+		}
+	}
+
+	lock_mutex_exit();
+
+	MONITOR_INC(MONITOR_DEADLOCK_CHECK);
+	MONITOR_INC_TIME_IN_MICRO_SECS(
+		MONITOR_DEADLOCK_CHECK_MICROSECOND, counter_time);
+}
+
 /*========================= TABLE LOCKS ==============================*/
 
 /*********************************************************************//**
@@ -5624,6 +5959,161 @@ lock_rec_unlock(
 	trx_mutex_exit(trx);
 }
 
+/*********************************************************************//**
+Releases the record locks of a transaction that has been committed in memory
+or whose locks are being released early, and grants the waiting lock requests
+that they were blocking. Only the lock_sys->rec_hash partitions of the pages
+are latched, so that concurrent commits do not serialize on lock_sys->latch.
+The caller must hold lock_sys->latch in shared mode. */
+static
+void
+lock_release_rec_locks(
+/*===================*/
+	trx_t*	trx)	/*!< in/out: transaction */
+{
+	lock_t*		lock;
+	ulint		count = 0;
+
+	ut_ad(lock_latch_own());
+	ut_ad(!lock_mutex_own());
+	ut_ad(!trx_mutex_own(trx));
+	ut_ad(trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY)
+	      || trx->lock.released_early);
+
+	/* Other threads do not add locks to a committed transaction
+	(or convert the implicit locks of a transaction whose locks
+	were released early) while we hold lock_sys->latch, but
+	threads that hold it in exclusive mode may move them between
+	pages. Therefore we rescan the list after temporarily releasing
+	the latch. */
+
+	for (lock = UT_LIST_GET_LAST(trx->lock.trx_locks);
+	     lock != NULL; ) {
+
+		lock_t*	prev = UT_LIST_GET_PREV(trx_locks, lock);
+
+		if (lock_get_type_low(lock) == LOCK_REC) {
+			ulint	space = lock->un_member.rec_lock.space;
+			ulint	page_no = lock->un_member.rec_lock.page_no;
+
+#ifdef UNIV_DEBUG
+			/* Check if the transcation locked a record
+			in a system table in X mode. It should have set
+			the dict_op code correctly if it did. */
+			if (lock->index->table->id < DICT_HDR_FIRST_ID
+			    && lock_get_mode(lock) == LOCK_X) {
+
+				ut_ad(trx->dict_operation != TRX_DICT_OP_NONE);
+			}
+#endif /* UNIV_DEBUG */
+
+			mutex_enter(lock_rec_get_mutex(space, page_no));
+
+			lock_rec_dequeue_from_page(lock);
+
+			mutex_exit(lock_rec_get_mutex(space, page_no));
+
+			if (++count == LOCK_RELEASE_INTERVAL) {
+				/* Release the latch for a while, so that
+				we do not block exclusive requests */
+
+				rw_lock_s_unlock(&lock_sys->latch);
+
+				rw_lock_s_lock(&lock_sys->latch);
+
+				count = 0;
+				prev = UT_LIST_GET_LAST(trx->lock.trx_locks);
+			}
+		}
+
+		lock = prev;
+	}
+}
+
+/*********************************************************************//**
+Checks if a lock request is waiting for one of the records that are
+locked by a record lock.
+@return true if somebody is waiting */
+static
+bool
+lock_rec_has_waiters(
+/*=================*/
+	const lock_t*	lock)	/*!< in: granted record lock */
+{
+	ut_ad(lock_get_type_low(lock) == LOCK_REC);
+	ut_ad(!lock_get_wait(lock));
+
+	for (const lock_t* wait_lock = lock_rec_get_first_on_page_addr(
+		     lock->un_member.rec_lock.space,
+		     lock->un_member.rec_lock.page_no);
+	     wait_lock != NULL;
+	     wait_lock = lock_rec_get_next_on_page_const(wait_lock)) {
+
+		if (!lock_get_wait(wait_lock)) {
+			continue;
+		}
+
+		/* A waiting record lock request has exactly one bit set */
+		if (lock_rec_get_nth_bit(
+			    lock, lock_rec_find_set_bit(wait_lock))) {
+
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/*********************************************************************//**
+Releases the record locks of a prepared transaction whose commit order
+has already been determined, and grants the waiting lock requests that
+they were blocking. Any transaction that acquires one of the locks will
+be committed after this one. The table locks are kept until the commit.
+@return true if another transaction was waiting for one of the locks */
+UNIV_INTERN
+bool
+lock_release_rec_locks_early(
+/*=========================*/
+	trx_t*	trx)	/*!< in/out: prepared transaction */
+{
+	bool	waiters = false;
+
+	ut_ad(!lock_mutex_own());
+	ut_ad(trx_state_eq(trx, TRX_STATE_PREPARED));
+
+	rw_lock_s_lock(&lock_sys->latch);
+
+	/* From now on, the records that were modified by the transaction
+	are not considered to be implicitly locked by it. Without this,
+	lock_rec_convert_impl_to_expl() would create new explicit locks
+	on behalf of the transaction. */
+	trx_mutex_enter(trx);
+	ut_ad(!trx->lock.released_early);
+	ut_ad(trx->lock.wait_lock == NULL);
+	trx->lock.released_early = true;
+	trx_mutex_exit(trx);
+
+	for (const lock_t* lock = UT_LIST_GET_FIRST(trx->lock.trx_locks);
+	     lock != NULL && !waiters;
+	     lock = UT_LIST_GET_NEXT(trx_locks, lock)) {
+
+		if (lock_get_type_low(lock) == LOCK_REC) {
+			ulint	space = lock->un_member.rec_lock.space;
+			ulint	page_no = lock->un_member.rec_lock.page_no;
+
+			mutex_enter(lock_rec_get_mutex(space, page_no));
+			waiters = lock_rec_has_waiters(lock);
+			mutex_exit(lock_rec_get_mutex(space, page_no));
+		}
+	}
+
+	lock_release_rec_locks(trx);
+
+	rw_lock_s_unlock(&lock_sys->latch);
+
+	return(waiters);
+}
+
 /*********************************************************************//**
 Releases transaction locks, and releases possible other transactions waiting
 because of these locks. */
@@ -6621,6 +7111,7 @@ lock_rec_queue_validate(
 		because lock_trx_release_locks() acquires lock_sys->mutex */
 
 		if (impl_trx != NULL
+		    && !impl_trx->lock.released_early
 		    && lock_rec_other_has_expl_req(LOCK_S, 0, LOCK_WAIT,
 						   block, heap_no, impl_trx)) {
 
@@ -7148,9 +7639,12 @@ lock_rec_convert_impl_to_expl(
 		impl_trx = trx_rw_is_active(trx_id, NULL);
 
 		/* impl_trx cannot be committed until lock_mutex_exit()
-		because lock_trx_release_locks() acquires lock_sys->mutex */
+		because lock_trx_release_locks() acquires lock_sys->mutex.
+		A prepared transaction whose record locks were released
+		early no longer holds implicit locks. */
 
 		if (impl_trx != NULL
+		    && !impl_trx->lock.released_early
 		    && !lock_rec_has_expl(LOCK_X | LOCK_REC_NOT_GAP, block,
 					  heap_no, impl_trx)) {
 			ulint	type_mode = (LOCK_REC | LOCK_X
@@ -7207,17 +7701,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-	trx_t*		trx = thr_get_trx(thr);
-
-	ut_ad(lock_table_has(trx, index->table, LOCK_IX));
+	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -7268,17 +7757,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	trx_t* trx = thr_get_trx(thr);
-	lock_mutex_enter();
-
-	ut_ad(lock_table_has(trx, index->table, LOCK_IX));
+	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -7368,20 +7852,15 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	trx_t* trx = thr_get_trx(thr);
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
-	      || lock_table_has(trx, index->table, LOCK_IX));
+	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
-	      || lock_table_has(trx, index->table, LOCK_IS));
+	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -7441,20 +7920,15 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-	trx_t* trx = thr_get_trx(thr);
-
 	ut_ad(mode != LOCK_X
-	      || lock_table_has(trx, index->table, LOCK_IX));
+	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
-	      || lock_table_has(trx, index->table, LOCK_IS));
+	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -7909,8 +8383,11 @@ lock_trx_release_locks(
 	}
 
 	/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-	is protected by both the lock_sys->mutex and the trx->mutex. */
-	lock_mutex_enter();
+	is protected by both the lock_sys->latch and the trx->mutex.
+	Holding the latch in shared mode suffices, because the threads
+	that look at the state of other transactions hold it in exclusive
+	mode. */
+	rw_lock_s_lock(&lock_sys->latch);
 	trx_mutex_enter(trx);
 
 	/* The following assignment makes the transaction committed in memory
@@ -7944,11 +8421,30 @@ lock_trx_release_locks(
 
 	trx->is_recovered = FALSE;
 
+	trx->lock.released_early = false;
+
 	trx_mutex_exit(trx);
 
-	lock_release(trx);
+	lock_release_rec_locks(trx);
 
-	lock_mutex_exit();
+	rw_lock_s_unlock(&lock_sys->latch);
+
+	/* The table locks, if any, are released while holding
+	lock_sys->latch in exclusive mode. */
+
+	if (UT_LIST_GET_LEN(trx->lock.trx_locks) > 0) {
+		lock_mutex_enter();
+
+		lock_release(trx);
+
+		lock_mutex_exit();
+	} else {
+		ut_ad(ib_vector_is_empty(trx->autoinc_locks));
+
+		ib_vector_reset(trx->lock.table_locks);
+
+		mem_heap_empty(trx->lock.lock_heap);
+	}
 }
 
 /*********************************************************************//**
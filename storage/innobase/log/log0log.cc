@@ -164,6 +164,46 @@ extern "C" UNIV_INTERN
 os_thread_ret_t
 DECLARE_THREAD(log_scrub_thread)(void*);
 
+/** Number of events that threads wait on for the log to be written or
+flushed up to an lsn; an lsn maps to the event of its log block */
+#define LOG_N_WAIT_EVENTS	1024
+
+/** Maximum time to spin for a log write or flush before waiting on an
+event, in microseconds */
+#define LOG_WAIT_SPIN_MAX_USEC	200
+
+/** Event to wake up the log writer thread */
+static os_event_t	log_writer_event;
+
+/** Event to wake up the log flusher thread */
+static os_event_t	log_flusher_event;
+
+/** Events that are set when log_sys->written_to_all_lsn advances */
+static os_event_t	log_write_events[LOG_N_WAIT_EVENTS];
+
+/** Events that are set when log_sys->flushed_to_disk_lsn advances */
+static os_event_t	log_flush_events[LOG_N_WAIT_EVENTS];
+
+/** true while both the log writer and the log flusher thread are
+running; log_write_up_to() then leaves the i/o to them */
+static volatile bool	log_writer_threads_active;
+
+/** Number of running log writer and flusher threads */
+static ulint		log_n_writer_threads;
+
+/** Number of threads that are waiting for the log to be flushed */
+static ulint		log_n_flush_waiters;
+
+/** Moving averages of the duration of a log write and of a log flush
+by the log writer threads, in microseconds */
+static ulint		log_write_avg_usec;
+static ulint		log_flush_avg_usec;
+
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	log_writer_thread_key;
+UNIV_INTERN mysql_pfs_key_t	log_flusher_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /******************************************************//**
 Completes a checkpoint write i/o to a log file. */
 static
@@ -202,6 +242,38 @@ log_buf_pool_get_oldest_modification(void)
 	return(lsn);
 }
 
+/************************************************************//**
+Frees the copy slots at the start of log_sys->copy_slots whose log records
+have been copied to the log buffer.
+@return	lsn up to which the log buffer contents are complete */
+static
+lsn_t
+log_copy_get_ready_lsn(void)
+/*========================*/
+{
+	ut_ad(mutex_own(&log_sys->mutex));
+
+	while (log_sys->n_copy_slots > 0) {
+		const log_copy_slot_t*	slot
+			= &log_sys->copy_slots[log_sys->copy_first];
+
+		if (!slot->copied) {
+			os_rmb;
+			return(slot->start_lsn);
+		}
+
+		log_sys->copy_first = (log_sys->copy_first + 1)
+			% LOG_COPY_SLOTS;
+		log_sys->n_copy_slots--;
+	}
+
+	/* Make the log records that were copied by other threads
+	visible to this thread */
+	os_rmb;
+
+	return(log_sys->lsn);
+}
+
 /** Extends the log buffer.
 @param[in] len	requested minimum size in bytes */
 static
@@ -234,6 +306,7 @@ log_buffer_extend(
 	log_sys->is_extending = true;
 
 	while (log_sys->n_pending_writes != 0
+	       || log_copy_get_ready_lsn() != log_sys->lsn
 	       || ut_calc_align_down(log_sys->buf_free,
 				     OS_FILE_LOG_BLOCK_SIZE)
 		  != ut_calc_align_down(log_sys->buf_next_to_write,
@@ -316,7 +389,7 @@ log_reserve_and_open(
 		log_buffer_extend((len + 1) * 2);
 	}
 loop:
-	mutex_enter(&(log->mutex));
+	log_mutex_enter_for_append();
 	ut_ad(!recv_no_log_write);
 
 	if (log->is_extending) {
@@ -549,6 +622,185 @@ log_close(void)
 	return(lsn);
 }
 
+/************************************************************//**
+Reserves space for log records in the log buffer, so that they can be
+copied with log_copy_low() after the log mutex has been released. It is
+assumed that the caller holds the log mutex, acquired by
+log_reserve_and_open(). The reservation must be closed with log_close(),
+and log_copy_complete() must be called after the records were copied.
+@return	copy slot, or NULL if all slots are in use; then the records
+must be written with log_write_low() */
+UNIV_INTERN
+log_copy_slot_t*
+log_reserve_for_copy(
+/*=================*/
+	ulint	str_len)	/*!< in: length of the log records */
+{
+	log_t*			log	= log_sys;
+	log_copy_slot_t*	slot;
+	ulint			len;
+	ulint			data_len;
+	byte*			log_block;
+
+	ut_ad(mutex_own(&(log->mutex)));
+	ut_ad(!recv_no_log_write);
+	ut_ad(str_len > 0);
+
+	if (log->n_copy_slots == LOG_COPY_SLOTS) {
+		log_copy_get_ready_lsn();
+
+		if (log->n_copy_slots == LOG_COPY_SLOTS) {
+			MONITOR_INC(MONITOR_LOG_COPY_SLOTS_FULL);
+
+			return(NULL);
+		}
+	}
+
+	slot = &log->copy_slots[(log->copy_first + log->n_copy_slots)
+				% LOG_COPY_SLOTS];
+	log->n_copy_slots++;
+
+	slot->start_lsn = log->lsn;
+	slot->offset = log->buf_free;
+	slot->copied = false;
+
+	/* Advance the lsn and the log block headers as log_write_low()
+	would do, but leave the copying of the log records to the caller */
+	do {
+		data_len = (log->buf_free % OS_FILE_LOG_BLOCK_SIZE) + str_len;
+
+		if (data_len <= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+
+			len = str_len;
+		} else {
+			data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
+
+			len = OS_FILE_LOG_BLOCK_SIZE
+				- (log->buf_free % OS_FILE_LOG_BLOCK_SIZE)
+				- LOG_BLOCK_TRL_SIZE;
+		}
+
+		str_len -= len;
+
+		log_block = static_cast<byte*>(
+			ut_align_down(
+				log->buf + log->buf_free,
+				OS_FILE_LOG_BLOCK_SIZE));
+
+		log_block_set_data_len(log_block, data_len);
+
+		if (data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* This block became full */
+			log_block_set_data_len(log_block,
+					       OS_FILE_LOG_BLOCK_SIZE);
+			log_block_set_checkpoint_no(
+				log_block, log->next_checkpoint_no);
+			len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
+
+			log->lsn += len;
+
+			/* Initialize the next block header */
+			log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE,
+				       log->lsn);
+		} else {
+			log->lsn += len;
+		}
+
+		log->buf_free += len;
+
+		ut_ad(log->buf_free <= log->buf_size);
+	} while (str_len > 0);
+
+	srv_stats.log_write_requests.inc();
+	MONITOR_INC(MONITOR_LOG_CONCURRENT_COPIES);
+
+	return(slot);
+}
+
+/************************************************************//**
+Copies log records to the space reserved by log_reserve_for_copy().
+The caller must not hold the log mutex. */
+UNIV_INTERN
+void
+log_copy_low(
+/*=========*/
+	log_copy_slot_t*	slot,	/*!< in/out: copy slot */
+	const byte*		str,	/*!< in: string */
+	ulint			str_len)/*!< in: string length */
+{
+	ut_ad(!slot->copied);
+
+	while (str_len > 0) {
+		ulint	len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- slot->offset % OS_FILE_LOG_BLOCK_SIZE;
+
+		if (len > str_len) {
+			len = str_len;
+		}
+
+		ut_memcpy(log_sys->buf + slot->offset, str, len);
+
+		str_len -= len;
+		str += len;
+		slot->offset += len;
+
+		if (slot->offset % OS_FILE_LOG_BLOCK_SIZE
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the
+			header of the next one */
+			slot->offset += LOG_BLOCK_TRL_SIZE
+				+ LOG_BLOCK_HDR_SIZE;
+		}
+	}
+}
+
+/************************************************************//**
+Marks the log records of a copy slot complete, so that log_write_up_to()
+can write them to the log files. */
+UNIV_INTERN
+void
+log_copy_complete(
+/*==============*/
+	log_copy_slot_t*	slot)	/*!< in/out: copy slot */
+{
+	/* The log records must be visible before the flag */
+	os_wmb;
+	slot->copied = true;
+}
+
+/******************************************************//**
+Waits until the mini-transactions that reserved log buffer space below
+the given lsn with log_reserve_for_copy() have copied their records. */
+static
+void
+log_copy_wait(
+/*==========*/
+	lsn_t	lsn)	/*!< in: log sequence number */
+{
+	/* A dirty read is enough: copy slots are freed only after
+	their log records have been copied */
+	if (log_sys->n_copy_slots == 0) {
+		return;
+	}
+
+	mutex_enter(&(log_sys->mutex));
+
+	if (lsn > log_sys->lsn) {
+		lsn = log_sys->lsn;
+	}
+
+	while (log_copy_get_ready_lsn() < lsn) {
+		mutex_exit(&(log_sys->mutex));
+
+		MONITOR_INC(MONITOR_LOG_COPY_WAITS);
+		os_thread_yield();
+
+		mutex_enter(&(log_sys->mutex));
+	}
+
+	mutex_exit(&(log_sys->mutex));
+}
+
 /******************************************************//**
 Pads the current log block full with dummy log records. Used in producing
 consistent archived log files and scrubbing redo log. */
@@ -868,6 +1120,16 @@ log_init(void)
 	log_sys->buf_size = LOG_BUFFER_SIZE;
 	log_sys->is_extending = false;
 
+	log_sys->copy_slots = static_cast<log_copy_slot_t*>(
+		mem_zalloc(LOG_COPY_SLOTS * sizeof(log_copy_slot_t)));
+	log_sys->copy_first = 0;
+	log_sys->n_copy_slots = 0;
+
+	log_sys->write_tail_buf_ptr = static_cast<byte*>(
+		mem_zalloc(2 * OS_FILE_LOG_BLOCK_SIZE));
+	log_sys->write_tail_buf = static_cast<byte*>(
+		ut_align(log_sys->write_tail_buf_ptr, OS_FILE_LOG_BLOCK_SIZE));
+
 	log_sys->max_buf_free = log_sys->buf_size / LOG_BUF_FLUSH_RATIO
 		- LOG_BUF_FLUSH_MARGIN;
 	log_sys->check_flush_or_checkpoint = TRUE;
@@ -1140,9 +1402,11 @@ log_sys_check_flush_completion(void)
 		log_sys->written_to_all_lsn = log_sys->write_lsn;
 		log_sys->buf_next_to_write = log_sys->write_end_offset;
 
-		if (log_sys->write_end_offset > log_sys->max_buf_free / 2) {
+		if (log_sys->write_end_offset > log_sys->max_buf_free / 2
+		    && log_copy_get_ready_lsn() == log_sys->lsn) {
 			/* Move the log buffer content to the start of the
-			buffer */
+			buffer; this is not possible while some log records
+			are being copied to it */
 
 			move_start = ut_calc_align_down(
 				log_sys->write_end_offset,
@@ -1431,14 +1695,80 @@ log_group_write_buf(
 }
 
 /******************************************************//**
-This function is called, e.g., when a transaction wants to commit. It checks
-that the log has been written to the log file up to the last log entry written
-by the transaction. If there is a flush running, it waits and checks if the
-flush flushed enough. If not, starts a new flush. */
-UNIV_INTERN
+Writes the log buffer up to an offset before log_sys->buf_free, when the
+log records after it are still being copied by other threads. The complete
+log blocks are written from the log buffer, and the last, incomplete one from
+log_sys->write_tail_buf, because its contents in the log buffer may still
+change. The next write starts from that block again. */
+static
 void
-log_write_up_to(
-/*============*/
+log_write_partial(
+/*==============*/
+	ulint	area_start,	/*!< in: start of the write area in
+				the log buffer */
+	ulint	area_end,	/*!< in: end of the write area in
+				the log buffer */
+	ulint	start_offset,	/*!< in: log_sys->buf_next_to_write */
+	ulint	end_offset)	/*!< in: end of the complete log records
+				in the log buffer */
+{
+	log_group_t*	group;
+	ulint		tail_start	= area_end - OS_FILE_LOG_BLOCK_SIZE;
+	byte*		tail		= log_sys->write_tail_buf;
+	lsn_t		area_lsn;
+
+	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(end_offset > tail_start);
+
+	MONITOR_INC(MONITOR_LOG_PARTIAL_WRITES);
+
+	ut_memcpy(tail, log_sys->buf + tail_start, OS_FILE_LOG_BLOCK_SIZE);
+
+	/* Other threads may already have extended the block past
+	end_offset */
+	log_block_set_data_len(tail, end_offset - tail_start);
+	log_block_set_checkpoint_no(tail, log_sys->next_checkpoint_no);
+
+	if (tail_start == area_start) {
+		log_block_set_flush_bit(tail, TRUE);
+	} else {
+		log_block_set_flush_bit(log_sys->buf + area_start, TRUE);
+	}
+
+	log_sys->write_end_offset = end_offset;
+
+	area_lsn = ut_uint64_align_down(log_sys->written_to_all_lsn,
+					OS_FILE_LOG_BLOCK_SIZE);
+
+	for (group = UT_LIST_GET_FIRST(log_sys->log_groups);
+	     group != NULL;
+	     group = UT_LIST_GET_NEXT(log_groups, group)) {
+
+		if (tail_start > area_start) {
+			log_group_write_buf(
+				group, log_sys->buf + area_start,
+				tail_start - area_start, area_lsn,
+				start_offset - area_start);
+		}
+
+		log_group_write_buf(
+			group, tail, OS_FILE_LOG_BLOCK_SIZE,
+			area_lsn + (tail_start - area_start),
+			tail_start > area_start
+			? 0 : start_offset - area_start);
+
+		log_group_set_fields(group, log_sys->write_lsn);
+	}
+}
+
+/******************************************************//**
+Checks that the log has been written to the log file up to the given lsn.
+If there is a flush running, it waits and checks if the flush flushed enough.
+If not, starts a new flush. */
+static
+void
+log_write_up_to_low(
+/*================*/
 	lsn_t	lsn,	/*!< in: log sequence number up to which
 			the log should be written,
 			LSN_MAX if not specified */
@@ -1459,6 +1789,7 @@ log_write_up_to(
 	ulint		unlock;
 	ib_uint64_t	write_lsn;
 	ib_uint64_t	flush_lsn;
+	lsn_t		ready_lsn;
 
 	ut_ad(!srv_read_only_mode);
 
@@ -1469,6 +1800,7 @@ log_write_up_to(
 		return;
 	}
 
+	log_copy_wait(lsn);
 loop:
 #ifdef UNIV_DEBUG
 	loop_count++;
@@ -1532,8 +1864,13 @@ log_write_up_to(
 		goto loop;
 	}
 
+	/* Only the log records up to the first one that is still being
+	copied can be written */
+	ready_lsn = log_copy_get_ready_lsn();
+	end_offset = log_sys->buf_free - (ulint) (log_sys->lsn - ready_lsn);
+
 	if (!flush_to_disk
-	    && log_sys->buf_free == log_sys->buf_next_to_write) {
+	    && end_offset == log_sys->buf_next_to_write) {
 		/* Nothing to write and no flush to disk requested */
 
 		mutex_exit(&(log_sys->mutex));
@@ -1546,7 +1883,7 @@ log_write_up_to(
 		fprintf(stderr,
 			"Writing log from " LSN_PF " up to lsn " LSN_PF "\n",
 			log_sys->written_to_all_lsn,
-			log_sys->lsn);
+			ready_lsn);
 	}
 #endif /* UNIV_DEBUG */
 	log_sys->n_pending_writes++;
@@ -1560,21 +1897,27 @@ log_write_up_to(
 	os_event_reset(log_sys->one_flushed_event);
 
 	start_offset = log_sys->buf_next_to_write;
-	end_offset = log_sys->buf_free;
 
 	area_start = ut_calc_align_down(start_offset, OS_FILE_LOG_BLOCK_SIZE);
 	area_end = ut_calc_align(end_offset, OS_FILE_LOG_BLOCK_SIZE);
 
 	ut_ad(area_end - area_start > 0);
 
-	log_sys->write_lsn = log_sys->lsn;
+	log_sys->write_lsn = ready_lsn;
 
 	if (flush_to_disk) {
-		log_sys->current_flush_lsn = log_sys->lsn;
+		log_sys->current_flush_lsn = ready_lsn;
 	}
 
 	log_sys->one_flushed = FALSE;
 
+	if (ready_lsn != log_sys->lsn) {
+		log_write_partial(area_start, area_end, start_offset,
+				  end_offset);
+
+		goto write_done;
+	}
+
 	log_block_set_flush_bit(log_sys->buf + area_start, TRUE);
 	log_block_set_checkpoint_no(
 		log_sys->buf + area_end - OS_FILE_LOG_BLOCK_SIZE,
@@ -1608,6 +1951,7 @@ log_write_up_to(
 		group = UT_LIST_GET_NEXT(log_groups, group);
 	}
 
+write_done:
 	mutex_exit(&(log_sys->mutex));
 
 	if (srv_unix_file_flush_method == SRV_UNIX_O_DSYNC) {
@@ -1668,6 +2012,176 @@ log_write_up_to(
 	}
 }
 
+/******************************************************//**
+Checks if the log has been written, or flushed, up to an lsn. This is a
+dirty read, which is enough for deciding whether to wait.
+@return	true if the lsn has been reached */
+UNIV_INLINE
+bool
+log_writer_lsn_reached(
+/*===================*/
+	lsn_t	lsn,		/*!< in: log sequence number */
+	ibool	flush_to_disk)	/*!< in: TRUE if the log must have been
+				flushed to disk */
+{
+	return((flush_to_disk
+		? *(volatile lsn_t*) &log_sys->flushed_to_disk_lsn
+		: *(volatile lsn_t*) &log_sys->written_to_all_lsn) >= lsn);
+}
+
+/******************************************************//**
+Sets the wait events of the log blocks in an lsn range, after the log has
+been written or flushed up to the end of the range. */
+static
+void
+log_writer_notify(
+/*==============*/
+	os_event_t*	events,		/*!< in: log_write_events or
+					log_flush_events */
+	lsn_t		start_lsn,	/*!< in: old written or flushed lsn */
+	lsn_t		end_lsn)	/*!< in: new written or flushed lsn */
+{
+	lsn_t	start_no = start_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	lsn_t	end_no = end_lsn / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (start_lsn >= end_lsn) {
+		return;
+	}
+
+	if (end_no - start_no >= LOG_N_WAIT_EVENTS) {
+		start_no = end_no - (LOG_N_WAIT_EVENTS - 1);
+	}
+
+	for (lsn_t no = start_no; no <= end_no; no++) {
+		os_event_set(events[no % LOG_N_WAIT_EVENTS]);
+	}
+}
+
+/******************************************************//**
+Makes the log writer and flusher threads write, and if requested flush, the
+log up to an lsn, and waits for that. The waiting thread first spins for
+about as long as a write (and flush) has recently taken, and then waits on
+the event of the log block of the lsn.
+@return	false if the log writer threads exited before the lsn was reached */
+static
+bool
+log_writer_wait(
+/*============*/
+	lsn_t	lsn,		/*!< in: log sequence number */
+	ulint	wait,		/*!< in: LOG_NO_WAIT, LOG_WAIT_ONE_GROUP,
+				or LOG_WAIT_ALL_GROUPS */
+	ibool	flush_to_disk)	/*!< in: TRUE if we want the written log
+				also to be flushed to disk */
+{
+	os_event_t	event;
+	ulint		spin_usec;
+	bool		reached;
+
+	if (lsn == LSN_MAX) {
+		mutex_enter(&log_sys->mutex);
+		lsn = log_sys->lsn;
+		mutex_exit(&log_sys->mutex);
+	}
+
+	if (log_writer_lsn_reached(lsn, flush_to_disk)) {
+		return(true);
+	}
+
+	if (wait == LOG_NO_WAIT) {
+		os_event_set(log_writer_event);
+
+		if (flush_to_disk) {
+			/* The flusher flushes what has been written
+			when it wakes up, and once per second */
+			os_event_set(log_flusher_event);
+		}
+
+		return(true);
+	}
+
+	if (flush_to_disk) {
+		os_atomic_increment_ulint(&log_n_flush_waiters, 1);
+	}
+
+	os_event_set(log_writer_event);
+
+	/* Spin only if the write is expected to complete soon */
+	spin_usec = log_write_avg_usec;
+
+	if (flush_to_disk) {
+		spin_usec += log_flush_avg_usec;
+	}
+
+	reached = log_writer_lsn_reached(lsn, flush_to_disk);
+
+	if (!reached && spin_usec <= LOG_WAIT_SPIN_MAX_USEC) {
+		ullint	start_usec = ut_time_us(NULL);
+
+		do {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+
+			reached = log_writer_lsn_reached(lsn, flush_to_disk);
+		} while (!reached
+			 && ut_time_us(NULL) - start_usec < spin_usec);
+
+		if (reached) {
+			MONITOR_INC(MONITOR_LOG_WRITER_SPIN_WAITS);
+		}
+	}
+
+	if (!reached) {
+		MONITOR_INC(MONITOR_LOG_WRITER_EVENT_WAITS);
+
+		event = (flush_to_disk ? log_flush_events : log_write_events)
+			[(lsn / OS_FILE_LOG_BLOCK_SIZE) % LOG_N_WAIT_EVENTS];
+
+		for (;;) {
+			ib_int64_t	sig_count = os_event_reset(event);
+
+			reached = log_writer_lsn_reached(lsn, flush_to_disk);
+
+			if (reached || !log_writer_threads_active) {
+				break;
+			}
+
+			os_event_wait_low(event, sig_count);
+		}
+	}
+
+	if (flush_to_disk) {
+		os_atomic_decrement_ulint(&log_n_flush_waiters, 1);
+	}
+
+	return(reached);
+}
+
+/******************************************************//**
+This function is called, e.g., when a transaction wants to commit. It checks
+that the log has been written to the log file up to the last log entry written
+by the transaction. If the log writer threads are running, it leaves the
+write and the flush to them and waits. Otherwise, if there is a flush running,
+it waits and checks if the flush flushed enough. If not, starts a new flush. */
+UNIV_INTERN
+void
+log_write_up_to(
+/*============*/
+	lsn_t	lsn,	/*!< in: log sequence number up to which
+			the log should be written,
+			LSN_MAX if not specified */
+	ulint	wait,	/*!< in: LOG_NO_WAIT, LOG_WAIT_ONE_GROUP,
+			or LOG_WAIT_ALL_GROUPS */
+	ibool	flush_to_disk)
+			/*!< in: TRUE if we want the written log
+			also to be flushed to disk */
+{
+	if (log_writer_threads_active
+	    && log_writer_wait(lsn, wait, flush_to_disk)) {
+		return;
+	}
+
+	log_write_up_to_low(lsn, wait, flush_to_disk);
+}
+
 /****************************************************************//**
 Does a syncronous flush of the log buffer to disk. */
 UNIV_INTERN
@@ -3266,6 +3780,7 @@ logs_empty_and_mark_files_at_shutdown(void)
 		os_event_set(srv_error_event);
 		os_event_set(srv_monitor_event);
 		os_event_set(srv_buf_dump_event);
+		os_event_set(srv_buf_resize_event);
 		os_event_set(lock_sys->timeout_event);
 		os_event_set(dict_stats_event);
 	}
@@ -3305,6 +3820,8 @@ logs_empty_and_mark_files_at_shutdown(void)
 		thread_name = "lock_wait_timeout_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_name = "buf_dump_thread";
+	} else if (srv_buf_resize_thread_active) {
+		thread_name = "buf_resize_thread";
 	} else {
 		thread_name = NULL;
 	}
@@ -3364,8 +3881,15 @@ logs_empty_and_mark_files_at_shutdown(void)
 		os_event_set(log_scrub_event);
 	}
 
+	if (log_n_writer_threads) {
+		ut_ad(!srv_read_only_mode);
+		os_event_set(log_writer_event);
+		os_event_set(log_flusher_event);
+	}
+
 	mutex_enter(&log_sys->mutex);
 	server_busy = log_scrub_thread_active
+		|| log_n_writer_threads
 		|| log_sys->n_pending_checkpoint_writes
 #ifdef UNIV_LOG_ARCHIVE
 		|| log_sys->n_pending_archive_ios
@@ -3386,6 +3910,7 @@ logs_empty_and_mark_files_at_shutdown(void)
 	}
 
 	ut_ad(!log_scrub_thread_active);
+	ut_ad(!log_writer_threads_active);
 
 	pending_io = buf_pool_check_no_pending_io();
 
@@ -3719,6 +4244,11 @@ log_shutdown(void)
 	mem_free(log_sys->checkpoint_buf_ptr);
 	log_sys->checkpoint_buf_ptr = NULL;
 	log_sys->checkpoint_buf = NULL;
+	mem_free(log_sys->copy_slots);
+	log_sys->copy_slots = NULL;
+	mem_free(log_sys->write_tail_buf_ptr);
+	log_sys->write_tail_buf_ptr = NULL;
+	log_sys->write_tail_buf = NULL;
 
 	os_event_free(log_sys->no_flush_event);
 	os_event_free(log_sys->one_flushed_event);
@@ -3731,6 +4261,18 @@ log_shutdown(void)
 		os_event_free(log_scrub_event);
 	}
 
+	if (log_writer_event != NULL) {
+		os_event_free(log_writer_event);
+		os_event_free(log_flusher_event);
+
+		for (ulint i = 0; i < LOG_N_WAIT_EVENTS; i++) {
+			os_event_free(log_write_events[i]);
+			os_event_free(log_flush_events[i]);
+		}
+
+		log_writer_event = NULL;
+	}
+
 #ifdef UNIV_LOG_ARCHIVE
 	rw_lock_free(&log_sys->archive_lock);
 	os_event_create();
@@ -3807,4 +4349,193 @@ DECLARE_THREAD(log_scrub_thread)(void*)
 
 	OS_THREAD_DUMMY_RETURN;
 }
+
+/******************************************************//**
+Updates a moving average of the duration of a log i/o. */
+UNIV_INLINE
+void
+log_writer_update_avg(
+/*==================*/
+	ulint*	avg_usec,	/*!< in/out: moving average */
+	ullint	start_usec)	/*!< in: start time of the i/o */
+{
+	ullint	usec = ut_time_us(NULL) - start_usec;
+
+	*avg_usec = (ulint) ((*avg_usec * 7 + usec) / 8);
+}
+
+/******************************************************//**
+Marks a log writer thread as exited. Waiting threads are woken up, so that
+they can do their log write or flush by themselves. */
+static
+void
+log_writer_thread_exit(void)
+/*========================*/
+{
+	log_writer_threads_active = false;
+
+	for (ulint i = 0; i < LOG_N_WAIT_EVENTS; i++) {
+		os_event_set(log_write_events[i]);
+		os_event_set(log_flush_events[i]);
+	}
+
+	os_event_set(log_writer_event);
+	os_event_set(log_flusher_event);
+
+	os_atomic_decrement_ulint(&log_n_writer_threads, 1);
+}
+
+/*****************************************************************//**
+This is the log writer thread. It writes the log buffer to the log files
+whenever a thread waits for a log write or flush, and wakes up the threads
+that wait for a write, and the log flusher thread.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(void*)
+{
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_writer_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_FLUSH_PHASE) {
+		ib_int64_t	sig_count = os_event_reset(log_writer_event);
+		lsn_t		lsn;
+		lsn_t		written_lsn;
+		lsn_t		flushed_lsn;
+
+		mutex_enter(&log_sys->mutex);
+		lsn = log_sys->lsn;
+		written_lsn = log_sys->written_to_all_lsn;
+		flushed_lsn = log_sys->flushed_to_disk_lsn;
+		mutex_exit(&log_sys->mutex);
+
+		if (written_lsn < lsn) {
+			ullint	start_usec = ut_time_us(NULL);
+
+			log_write_up_to_low(lsn, LOG_WAIT_ALL_GROUPS, FALSE);
+
+			log_writer_update_avg(&log_write_avg_usec, start_usec);
+
+			mutex_enter(&log_sys->mutex);
+			lsn = log_sys->written_to_all_lsn;
+			mutex_exit(&log_sys->mutex);
+
+			log_writer_notify(log_write_events, written_lsn, lsn);
+
+			/* With O_DSYNC the write also flushed the log */
+			log_writer_notify(log_flush_events, flushed_lsn,
+					  log_sys->flushed_to_disk_lsn);
+
+			if (log_n_flush_waiters > 0) {
+				os_event_set(log_flusher_event);
+			}
+
+			continue;
+		}
+
+		if (log_n_flush_waiters > 0 && flushed_lsn < written_lsn) {
+			os_event_set(log_flusher_event);
+		}
+
+		os_event_wait_time_low(log_writer_event, 1000000, sig_count);
+	}
+
+	log_writer_thread_exit();
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*****************************************************************//**
+This is the log flusher thread. It flushes to disk the log that the log
+writer thread has written, and wakes up the threads that wait for a flush.
+Flushing in a thread of its own lets the next log write proceed while the
+previous one is being flushed.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(void*)
+{
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flusher_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_FLUSH_PHASE) {
+		ib_int64_t	sig_count = os_event_reset(log_flusher_event);
+		lsn_t		written_lsn;
+		lsn_t		flushed_lsn;
+		lsn_t		write_lsn;
+
+		mutex_enter(&log_sys->mutex);
+		written_lsn = log_sys->written_to_all_lsn;
+		flushed_lsn = log_sys->flushed_to_disk_lsn;
+		mutex_exit(&log_sys->mutex);
+
+		if (written_lsn <= flushed_lsn) {
+			os_event_wait_time_low(log_flusher_event, 1000000,
+					       sig_count);
+			continue;
+		}
+
+		if (srv_unix_file_flush_method != SRV_UNIX_O_DSYNC) {
+			ullint	start_usec = ut_time_us(NULL);
+
+			/* Everything up to written_lsn has been written
+			with synchronous i/o, so the flush covers it */
+			fil_flush(UT_LIST_GET_FIRST(log_sys->log_groups)
+				  ->space_id);
+
+			log_writer_update_avg(&log_flush_avg_usec, start_usec);
+		}
+
+		mutex_enter(&log_sys->mutex);
+		if (log_sys->flushed_to_disk_lsn < written_lsn) {
+			log_sys->flushed_to_disk_lsn = written_lsn;
+		}
+		write_lsn = log_sys->write_lsn;
+		mutex_exit(&log_sys->mutex);
+
+		log_writer_notify(log_flush_events, flushed_lsn, written_lsn);
+
+		innobase_mysql_log_notify(write_lsn, written_lsn);
+	}
+
+	log_writer_thread_exit();
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*****************************************************************//**
+Starts the log writer and the log flusher thread. After this,
+log_write_up_to() leaves the log writes and flushes to them. */
+UNIV_INTERN
+void
+log_writer_threads_start(void)
+/*==========================*/
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(log_writer_event == NULL);
+
+	log_writer_event = os_event_create();
+	log_flusher_event = os_event_create();
+
+	for (ulint i = 0; i < LOG_N_WAIT_EVENTS; i++) {
+		log_write_events[i] = os_event_create();
+		log_flush_events[i] = os_event_create();
+	}
+
+	log_n_writer_threads = 2;
+	log_writer_threads_active = true;
+
+	os_thread_create(log_writer_thread, NULL, NULL);
+	os_thread_create(log_flusher_thread, NULL, NULL);
+}
 #endif /* !UNIV_HOTBACKUP */
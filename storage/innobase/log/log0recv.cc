@@ -172,6 +172,7 @@ UNIV_INTERN mysql_pfs_key_t	recv_sys_mutex_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 UNIV_INTERN mysql_pfs_key_t	recv_writer_thread_key;
+UNIV_INTERN mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 # ifdef UNIV_PFS_MUTEX
@@ -214,6 +215,8 @@ recv_sys_create(void)
 #ifndef UNIV_HOTBACKUP
 	mutex_create(recv_writer_mutex_key, &recv_sys->writer_mutex,
 		     SYNC_LEVEL_VARYING);
+
+	recv_sys->apply_done_event = os_event_create();
 #endif /* !UNIV_HOTBACKUP */
 
 	recv_sys->heap = NULL;
@@ -246,7 +249,9 @@ recv_sys_close(void)
 
 #ifndef UNIV_HOTBACKUP
 		ut_ad(!recv_writer_thread_active);
+		ut_ad(recv_sys->n_apply_threads == 0);
 		mutex_free(&recv_sys->writer_mutex);
+		os_event_free(recv_sys->apply_done_event);
 #endif /* !UNIV_HOTBACKUP */
 
 		mutex_free(&recv_sys->mutex);
@@ -1781,51 +1786,38 @@ recv_read_in_area(
 }
 
 /*******************************************************************//**
-Empties the hash table of stored log records, applying them to appropriate
-pages.
-@return DB_SUCCESS when successfull or DB_ERROR when fails. */
-UNIV_INTERN
-dberr_t
-recv_apply_hashed_log_recs(
-/*=======================*/
-	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
-				allowed during the application; if FALSE,
-				no ibuf operations are allowed, and after
-				the application all file pages are flushed to
-				disk and invalidated in buffer pool: this
-				alternative means that no new log records
-				can be generated during the application;
-				the caller must in this case own the log
-				mutex */
+Applies the log records of the pages in the addr_hash cells handed out from
+recv_sys->apply_cell, until all cells have been handed out. Pages which are
+in the buffer pool are recovered directly; for the others an asynchronous
+read is posted for the surrounding area, and the records are applied by the
+i/o handler thread when the read completes. This is run by the thread
+calling recv_apply_hashed_log_recs() and by the additional log apply
+threads, so that the cells, and thus the pages, are split between them. */
+static
+void
+recv_apply_hashed_cells(
+/*====================*/
+	ibool*	has_printed)	/*!< in/out: whether the start of the
+				batch has been reported */
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ibool	has_printed	= FALSE;
-	ulong progress;
-	mtr_t	mtr;
-	dberr_t err = DB_SUCCESS;
-loop:
-	mutex_enter(&(recv_sys->mutex));
-
-	if (recv_sys->apply_batch_on) {
-
-		mutex_exit(&(recv_sys->mutex));
-
-		os_thread_sleep(500000);
-
-		goto loop;
-	}
+	recv_addr_t*	recv_addr;
+	ulint		n_cells = hash_get_n_cells(recv_sys->addr_hash);
+	ulong		progress;
+	mtr_t		mtr;
 
-	ut_ad((!allow_ibuf) == mutex_own(&log_sys->mutex));
+	mutex_enter(&(recv_sys->mutex));
 
-	if (!allow_ibuf) {
-		recv_no_ibuf_operations = TRUE;
-	}
+	while (recv_sys->apply_cell < n_cells) {
+		ulint	i = recv_sys->apply_cell++;
 
-	recv_sys->apply_log_recs = TRUE;
-	recv_sys->apply_batch_on = TRUE;
+		progress = (ulong) (i * 100) / n_cells;
+		if (*has_printed
+		    && progress != ((i + 1) * 100) / n_cells) {
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+			fprintf(stderr, "%lu ", progress);
+			sd_notifyf(0, "STATUS=Applying batch of log records for"
+				   " InnoDB: Progress %lu", progress);
+		}
 
 		for (recv_addr = static_cast<recv_addr_t*>(
 				HASH_GET_FIRST(recv_sys->addr_hash, i));
@@ -1838,14 +1830,14 @@ recv_apply_hashed_log_recs(
 			ulint	page_no = recv_addr->page_no;
 
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
+				if (!*has_printed) {
 					ib_logf(IB_LOG_LEVEL_INFO,
 						"Starting an apply batch"
 						" of log records"
 						" to the database...");
 					fputs("InnoDB: Progress in percent: ",
 					      stderr);
-					has_printed = TRUE;
+					*has_printed = TRUE;
 				}
 
 				mutex_exit(&(recv_sys->mutex));
@@ -1871,20 +1863,116 @@ recv_apply_hashed_log_recs(
 				mutex_enter(&(recv_sys->mutex));
 			}
 		}
+	}
 
-		progress = (ulong) (i * 100)
-                                   / hash_get_n_cells(recv_sys->addr_hash);
-		if (has_printed
-		    && progress
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
+	mutex_exit(&(recv_sys->mutex));
+}
 
-			fprintf(stderr, "%lu ", progress);
-			sd_notifyf(0, "STATUS=Applying batch of log records for"
-				   " InnoDB: Progress %lu", progress);
-		}
+/******************************************************************//**
+Additional thread applying hashed log records during recovery, started by
+recv_apply_hashed_log_recs() when innodb_recovery_apply_threads > 1.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: pointer to the has_printed flag of
+			the batch */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	recv_apply_hashed_cells(static_cast<ibool*>(arg));
+
+	mutex_enter(&(recv_sys->mutex));
+
+	ut_a(recv_sys->n_apply_threads > 0);
+
+	if (--recv_sys->n_apply_threads == 0) {
+		os_event_set(recv_sys->apply_done_event);
 	}
 
+	mutex_exit(&(recv_sys->mutex));
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Empties the hash table of stored log records, applying them to appropriate
+pages.
+@return DB_SUCCESS when successfull or DB_ERROR when fails. */
+UNIV_INTERN
+dberr_t
+recv_apply_hashed_log_recs(
+/*=======================*/
+	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
+				allowed during the application; if FALSE,
+				no ibuf operations are allowed, and after
+				the application all file pages are flushed to
+				disk and invalidated in buffer pool: this
+				alternative means that no new log records
+				can be generated during the application;
+				the caller must in this case own the log
+				mutex */
+{
+	ulint	i;
+	ulint	n_threads;
+	ulint	n_pages;
+	ullint	start_time;
+	ibool	has_printed	= FALSE;
+	dberr_t err = DB_SUCCESS;
+loop:
+	mutex_enter(&(recv_sys->mutex));
+
+	if (recv_sys->apply_batch_on) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_thread_sleep(500000);
+
+		goto loop;
+	}
+
+	ut_ad((!allow_ibuf) == mutex_own(&log_sys->mutex));
+
+	if (!allow_ibuf) {
+		recv_no_ibuf_operations = TRUE;
+	}
+
+	recv_sys->apply_log_recs = TRUE;
+	recv_sys->apply_batch_on = TRUE;
+
+	/* Hand out the cells of the hash table, that is, sets of pages,
+	to this thread and to srv_n_recv_apply_threads - 1 additional
+	threads. */
+	n_pages = recv_sys->n_addrs;
+	n_threads = ut_min(srv_n_recv_apply_threads,
+			   hash_get_n_cells(recv_sys->addr_hash));
+	start_time = ut_time_us(NULL);
+	recv_sys->apply_cell = 0;
+	recv_sys->n_apply_threads = n_threads > 1 ? n_threads - 1 : 0;
+	os_event_reset(recv_sys->apply_done_event);
+
+	mutex_exit(&(recv_sys->mutex));
+
+	for (i = 1; i < n_threads; i++) {
+		os_thread_create(recv_apply_thread, &has_printed, NULL);
+	}
+
+	recv_apply_hashed_cells(&has_printed);
+
+	if (n_threads > 1) {
+		os_event_wait(recv_sys->apply_done_event);
+	}
+
+	mutex_enter(&(recv_sys->mutex));
+
 	/* Wait until all the pages have been processed */
 
 	while (recv_sys->n_addrs != 0) {
@@ -1944,6 +2032,12 @@ recv_apply_hashed_log_recs(
 	if (has_printed) {
 		fprintf(stderr, "InnoDB: Apply batch completed\n");
 		sd_notify(0, "STATUS=InnoDB: Apply batch completed");
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Applied log records to " ULINTPF " pages"
+			" using " ULINTPF " threads in %.3f seconds",
+			n_pages, n_threads,
+			(double) (ut_time_us(NULL) - start_time) / 1000000);
 	}
 
 	mutex_exit(&(recv_sys->mutex));
@@ -205,7 +205,7 @@ que_thr_end_lock_wait(
 	que_thr_t*	thr;
 	ibool		was_active;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_latch_own());
 	ut_ad(trx_mutex_own(trx));
 
 	thr = trx->lock.wait_thr;
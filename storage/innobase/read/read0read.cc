@@ -343,6 +343,7 @@ read_view_open_now_low(
 	view->undo_no = 0;
 	view->type = VIEW_NORMAL;
 	view->creator_trx_id = cr_trx_id;
+	view->rw_trx_version = trx_sys->rw_trx_version;
 
 	/* No future transactions should be visible in the view */
 
@@ -392,6 +393,48 @@ read_view_open_now(
 	return(view);
 }
 
+/*********************************************************************//**
+Reopens a read view of a transaction that was closed at the end of an
+earlier statement or transaction, if no read-write transaction has started
+or ended since the view was opened. The view then sees exactly what a new
+view would see, and the active transaction ids need not be copied again.
+@return	true if the view was reopened */
+UNIV_INTERN
+bool
+read_view_reopen(
+/*=============*/
+	read_view_t*	view,	/*!< in/out: closed read view */
+	const trx_t*	trx)	/*!< in: transaction that opens the view */
+{
+	bool	reopened = false;
+
+	ut_ad(view->type == VIEW_NORMAL);
+
+	mutex_enter(&trx_sys->mutex);
+
+	/* If rw_trx_list did not change, then all the transactions that
+	modified the database since the view was opened are still active
+	and invisible in the view. Any ids assigned since then belong to
+	read-only transactions that do not write any records, so the stale
+	low_limit_id does not matter. The low_limit_no of the view can only
+	be smaller than that of a new view, which is safe for purge.
+
+	A read-only transaction may reopen the view of an earlier read-only
+	transaction, because neither of them modified anything. */
+
+	if (view->rw_trx_version == trx_sys->rw_trx_version
+	    && (view->creator_trx_id == trx->id || trx->read_only)) {
+
+		read_view_add(view);
+
+		reopened = true;
+	}
+
+	mutex_exit(&trx_sys->mutex);
+
+	return(reopened);
+}
+
 /*********************************************************************//**
 Makes a copy of the oldest existing read view, with the exception that also
 the creating trx of the oldest view is set as not visible in the 'copied'
@@ -489,7 +532,8 @@ read_view_close_for_mysql(
 
 	read_view_remove(trx->global_read_view, false);
 
-	mem_heap_empty(trx->global_read_view_heap);
+	/* The memory of the view is kept in trx->prebuilt_view, so that
+	the next statement can reopen it. */
 
 	trx->read_view = NULL;
 	trx->global_read_view = NULL;
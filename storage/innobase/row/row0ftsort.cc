@@ -31,6 +31,7 @@ Created 10/13/2010 Jimmy Yang
 #include "row0merge.h"
 #include "row0row.h"
 #include "btr0cur.h"
+#include "btr0sea.h"
 
 /** Read the next record to buffer N.
 @param N	index into array of merge info structure */
@@ -91,6 +92,8 @@ row_merge_create_fts_sort_index(
 	new_index->n_def = FTS_NUM_FIELDS_SORT;
 	new_index->cached = TRUE;
 
+	btr_search_index_init(new_index);
+
 	idx_field = dict_index_get_nth_field(index, 0);
 	charset = fts_index_get_charset(index);
 
@@ -920,7 +923,8 @@ fts_parallel_tokenization(
 				       psort_info->psort_common->dup,
 				       merge_file[i], block[i], &tmpfd[i],
 				       false, 0.0/* pct_progress */, 0.0/* pct_cost */,
-				       crypt_data, crypt_block[i], table->space);
+				       crypt_data, crypt_block[i], table->space,
+				       1);
 
 		if (error != DB_SUCCESS) {
 			close(tmpfd[i]);
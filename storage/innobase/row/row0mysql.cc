@@ -36,6 +36,7 @@ Created 9/17/2000 Heikki Tuuri
 #include <sql_const.h>
 #include "row0ins.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "row0sel.h"
 #include "row0upd.h"
 #include "row0row.h"
@@ -850,6 +851,9 @@ row_create_prebuilt(
 
 	prebuilt->mysql_row_len = mysql_row_len;
 
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+	prebuilt->fetch_cache_max_bytes = MYSQL_FETCH_CACHE_MAX_BYTES;
+
 	return(prebuilt);
 }
 
@@ -912,11 +916,11 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
+	if (prebuilt->fetch_cache != NULL) {
 		byte*	base = prebuilt->fetch_cache[0] - 4;
 		byte*	ptr = base;
 
-		for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
+		for (i = 0; i < prebuilt->fetch_cache_size; i++) {
 			byte*	row;
 			ulint	magic1;
 			ulint	magic2;
@@ -942,7 +946,7 @@ row_prebuilt_free(
 			}
 		}
 
-		mem_free(base);
+		mem_free(prebuilt->fetch_cache);
 	}
 
 	dict_table_close(prebuilt->table, dict_locked, TRUE);
@@ -5418,6 +5422,174 @@ row_rename_table_for_mysql(
 	return(err);
 }
 
+/*********************************************************************//**
+Checks that an index record is greater than the previous record, and that
+the two records do not break a unique constraint.
+@return true if ok */
+static
+bool
+row_check_index_order(
+/*==================*/
+	const trx_t*		trx,		/*!< in: transaction */
+	const dict_index_t*	index,		/*!< in: index */
+	const dtuple_t*		prev_entry,	/*!< in: previous record */
+	const rec_t*		rec,		/*!< in: record */
+	const ulint*		offsets)	/*!< in: rec_get_offsets(rec) */
+{
+	ulint	matched_fields	= 0;
+	ulint	matched_bytes	= 0;
+	ibool	contains_null	= FALSE;
+	int	cmp;
+
+	cmp = cmp_dtuple_rec_with_match(prev_entry, rec, offsets,
+					&matched_fields, &matched_bytes);
+
+	/* In a unique secondary index we allow equal key values if
+	they contain SQL NULLs */
+
+	for (ulint i = 0;
+	     i < dict_index_get_n_ordering_defined_by_user(index);
+	     i++) {
+		if (UNIV_SQL_NULL == dfield_get_len(
+			    dtuple_get_nth_field(prev_entry, i))) {
+
+			contains_null = TRUE;
+			break;
+		}
+	}
+
+	if (cmp > 0) {
+		fputs("InnoDB: index records in a wrong order in ",
+		      stderr);
+	} else if (dict_index_is_unique(index)
+		   && !contains_null
+		   && matched_fields
+		   >= dict_index_get_n_ordering_defined_by_user(index)) {
+
+		fputs("InnoDB: duplicate key in ", stderr);
+	} else {
+		return(true);
+	}
+
+	dict_index_name_print(stderr, trx, index);
+	fputs("\n"
+	      "InnoDB: prev record ", stderr);
+	dtuple_print(stderr, prev_entry);
+	fputs("\n"
+	      "InnoDB: record ", stderr);
+	rec_print_new(stderr, rec, offsets);
+	putc('\n', stderr);
+
+	return(false);
+}
+
+/** State of the check of one range of a clustered index */
+struct row_check_range_t {
+	const trx_t*	trx;		/*!< transaction */
+	dict_index_t*	index;		/*!< clustered index */
+	mem_heap_t*	heap;		/*!< heap for prev_entry */
+	dtuple_t*	prev_entry;	/*!< previous record, or NULL */
+	ulint		n_rows;		/*!< number of records */
+	bool		is_ok;		/*!< false if an error was found */
+};
+
+/*********************************************************************//**
+Checks a record of a clustered index that a parallel scan found.
+@return DB_SUCCESS */
+static
+dberr_t
+row_check_range_rec(
+/*================*/
+	const rec_t*	rec,		/*!< in: record in the read view */
+	const ulint*	offsets,	/*!< in: rec_get_offsets(rec) */
+	void*		arg)		/*!< in/out: row_check_range_t */
+{
+	row_check_range_t*	check = static_cast<row_check_range_t*>(arg);
+	ulint			n_ext;
+
+	check->n_rows++;
+
+	if (check->prev_entry != NULL
+	    && !row_check_index_order(check->trx, check->index,
+				      check->prev_entry, rec, offsets)) {
+		check->is_ok = false;
+	}
+
+	mem_heap_empty(check->heap);
+
+	check->prev_entry = row_rec_to_index_entry(
+		rec, check->index, offsets, &n_ext, check->heap);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Checks a clustered index like row_check_index_for_mysql(), but scans it
+with several threads. The order of the records is checked within each
+range of the parallel scan; the order between the ranges is checked by
+btr_validate_index().
+@return true if ok */
+static
+bool
+row_check_clust_index_parallel(
+/*===========================*/
+	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
+						in MySQL handle */
+	dict_index_t*		index,		/*!< in: clustered index */
+	ulint			n_threads,	/*!< in: number of threads */
+	ulint*			n_rows)		/*!< out: number of entries
+						seen in the consistent read */
+{
+	trx_t*			trx	= prebuilt->trx;
+	row_pread_t*		reader;
+	row_check_range_t*	checks;
+	void**			args;
+	dberr_t			err;
+	bool			is_ok	= true;
+
+	trx_start_if_not_started(trx);
+
+	reader = row_pread_create(index, trx, trx_assign_read_view(trx),
+				  n_threads);
+
+	checks = static_cast<row_check_range_t*>(
+		mem_heap_zalloc(reader->heap,
+				reader->n_ranges * sizeof *checks));
+	args = static_cast<void**>(
+		mem_heap_alloc(reader->heap,
+			       reader->n_ranges * sizeof *args));
+
+	for (ulint i = 0; i < reader->n_ranges; i++) {
+		checks[i].trx = trx;
+		checks[i].index = index;
+		checks[i].heap = mem_heap_create(100);
+		checks[i].is_ok = true;
+		args[i] = &checks[i];
+	}
+
+	err = row_pread_run(reader, row_check_range_rec, NULL, args);
+
+	if (err != DB_SUCCESS && err != DB_INTERRUPTED) {
+		ut_print_timestamp(stderr);
+		fputs("  InnoDB: Warning: CHECK TABLE on ", stderr);
+		dict_index_name_print(stderr, trx, index);
+		fprintf(stderr, " returned %lu\n", (ulong) err);
+		/* this error is ignored by CHECK TABLE */
+	}
+
+	*n_rows = 0;
+
+	for (ulint i = 0; i < reader->n_ranges; i++) {
+		*n_rows += checks[i].n_rows;
+		is_ok = is_ok && checks[i].is_ok;
+		mem_heap_free(checks[i].heap);
+	}
+
+	row_pread_free(reader);
+
+	return(is_ok);
+}
+
 /*********************************************************************//**
 Checks that the index contains entries in an ascending order, unique
 constraint is not broken, and calculates the number of index entries
@@ -5430,19 +5602,17 @@ row_check_index_for_mysql(
 	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
 						in MySQL handle */
 	const dict_index_t*	index,		/*!< in: index */
+	ulint			n_threads,	/*!< in: number of threads
+						that may scan a clustered
+						index */
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 {
 	dtuple_t*	prev_entry	= NULL;
-	ulint		matched_fields;
-	ulint		matched_bytes;
 	byte*		buf;
 	ulint		ret;
 	rec_t*		rec;
 	bool		is_ok		= true;
-	int		cmp;
-	ibool		contains_null;
-	ulint		i;
 	ulint		cnt;
 	mem_heap_t*	heap		= NULL;
 	ulint		n_ext;
@@ -5460,6 +5630,12 @@ row_check_index_for_mysql(
 		indexes of the old table will remain valid and the new
 		table will be unaccessible to MySQL until the
 		completion of the ALTER TABLE. */
+		if (n_threads > 1) {
+			return(row_check_clust_index_parallel(
+				       prebuilt,
+				       const_cast<dict_index_t*>(index),
+				       n_threads, n_rows));
+		}
 	} else if (dict_index_is_online_ddl(index)
 		   || (index->type & DICT_FTS)) {
 		/* Full Text index are implemented by auxiliary tables,
@@ -5511,52 +5687,10 @@ row_check_index_for_mysql(
 	offsets = rec_get_offsets(rec, index, offsets_,
 				  ULINT_UNDEFINED, &heap);
 
-	if (prev_entry != NULL) {
-		matched_fields = 0;
-		matched_bytes = 0;
-
-		cmp = cmp_dtuple_rec_with_match(prev_entry, rec, offsets,
-						&matched_fields,
-						&matched_bytes);
-		contains_null = FALSE;
-
-		/* In a unique secondary index we allow equal key values if
-		they contain SQL NULLs */
-
-		for (i = 0;
-		     i < dict_index_get_n_ordering_defined_by_user(index);
-		     i++) {
-			if (UNIV_SQL_NULL == dfield_get_len(
-				    dtuple_get_nth_field(prev_entry, i))) {
-
-				contains_null = TRUE;
-				break;
-			}
-		}
-
-		if (cmp > 0) {
-			fputs("InnoDB: index records in a wrong order in ",
-			      stderr);
-not_ok:
-			dict_index_name_print(stderr,
-					      prebuilt->trx, index);
-			fputs("\n"
-			      "InnoDB: prev record ", stderr);
-			dtuple_print(stderr, prev_entry);
-			fputs("\n"
-			      "InnoDB: record ", stderr);
-			rec_print_new(stderr, rec, offsets);
-			putc('\n', stderr);
-			is_ok = false;
-		} else if (dict_index_is_unique(index)
-			   && !contains_null
-			   && matched_fields
-			   >= dict_index_get_n_ordering_defined_by_user(
-				   index)) {
-
-			fputs("InnoDB: duplicate key in ", stderr);
-			goto not_ok;
-		}
+	if (prev_entry != NULL
+	    && !row_check_index_order(prebuilt->trx, index,
+				      prev_entry, rec, offsets)) {
+		is_ok = false;
 	}
 
 	{
@@ -1235,7 +1235,8 @@ row_sel_try_search_shortcut(
 	ut_ad(!plan->must_get_clust);
 #ifdef UNIV_SYNC_DEBUG
 	if (search_latch_locked) {
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
+		ut_ad(rw_lock_own(btr_search_get_latch(index),
+				  RW_LOCK_SHARED));
 	}
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -1407,10 +1408,11 @@ row_sel(
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			btr_search_s_lock(index);
 
 			search_latch_locked = TRUE;
-		} else if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_WAIT_EX) {
+		} else if (rw_lock_get_writer(btr_search_get_latch(index))
+			   == RW_LOCK_WAIT_EX) {
 
 			/* There is an x-latch request waiting: release the
 			s-latch for a moment; as an s-latch here is often
@@ -1419,8 +1421,8 @@ row_sel(
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			btr_search_s_unlock(index);
+			btr_search_s_lock(index);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan,
@@ -1445,7 +1447,7 @@ row_sel(
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		btr_search_s_unlock(index);
 
 		search_latch_locked = FALSE;
 	}
@@ -2017,7 +2019,7 @@ row_sel(
 
 func_exit:
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		btr_search_s_unlock(index);
 	}
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
@@ -2788,6 +2790,9 @@ row_sel_store_mysql_field_func(
 		/* Copy an externally stored field to a temporary heap */
 
 		ut_a(!prebuilt->trx->has_search_latch);
+#ifdef UNIV_SYNC_DEBUG
+		ut_ad(!btr_search_own_any());
+#endif
 		ut_ad(field_no == templ->clust_rec_field_no);
 
 		if (UNIV_UNLIKELY(templ->type == DATA_BLOB)) {
@@ -3392,22 +3397,36 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
-UNIV_INLINE
+Initialise the prefetch cache, or enlarge it to fetch_cache_limit rows.
+The cache must be empty. */
+static
 void
 row_sel_prefetch_cache_init(
 /*========================*/
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ulint	i;
+	ulint	n;
 	ulint	sz;
 	byte*	ptr;
 
-	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
-	ptr = static_cast<byte*>(mem_alloc(sz));
+	ut_ad(prebuilt->n_fetch_cached == 0);
+	ut_ad(prebuilt->fetch_cache_limit > prebuilt->fetch_cache_size);
+
+	if (prebuilt->fetch_cache != NULL) {
+		mem_free(prebuilt->fetch_cache);
+	}
+
+	n = prebuilt->fetch_cache_limit;
+
+	/* Reserve space for the pointers and the magic numbers. */
+	sz = n * (sizeof(byte*) + prebuilt->mysql_row_len + 8);
+	prebuilt->fetch_cache = static_cast<byte**>(mem_alloc(sz));
+	prebuilt->fetch_cache_size = n;
+
+	ptr = reinterpret_cast<byte*>(prebuilt->fetch_cache + n);
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < n; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3424,6 +3443,44 @@ row_sel_prefetch_cache_init(
 	}
 }
 
+/********************************************************************//**
+Determines the size of the next batch of prefetched rows after a batch
+was read to the end. A long scan doubles the batch each time, so that it
+soon reads most of the records of an index page in one visit, while a
+short scan, for example one that is stopped by LIMIT, fetches at most
+about as many rows in advance as it has already read. The batch is
+limited by MYSQL_FETCH_CACHE_MAX_SIZE, by fetch_cache_max_bytes and by
+the number of rows that the optimizer expects the scan to return. */
+UNIV_INLINE
+void
+row_sel_prefetch_cache_grow(
+/*========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	limit = prebuilt->fetch_cache_limit * 2;
+	ulint	max_rows = prebuilt->fetch_cache_max_bytes
+		/ (prebuilt->mysql_row_len + 8);
+
+	if (limit > max_rows) {
+		limit = max_rows;
+	}
+
+	if (limit > MYSQL_FETCH_CACHE_MAX_SIZE) {
+		limit = MYSQL_FETCH_CACHE_MAX_SIZE;
+	}
+
+	/* The estimate may be too small; once we have read more rows
+	than expected, it is ignored. */
+	if (prebuilt->fetch_cache_hint > prebuilt->n_rows_fetched
+	    && limit > prebuilt->fetch_cache_hint - prebuilt->n_rows_fetched) {
+		limit = prebuilt->fetch_cache_hint - prebuilt->n_rows_fetched;
+	}
+
+	if (limit > prebuilt->fetch_cache_limit) {
+		prebuilt->fetch_cache_limit = limit;
+	}
+}
+
 /********************************************************************//**
 Get the last fetch cache buffer from the queue.
 @return pointer to buffer. */
@@ -3434,12 +3491,10 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
 		/* Allocate memory for the fetch cache */
-		ut_ad(prebuilt->n_fetch_cached == 0);
-
 		row_sel_prefetch_cache_init(prebuilt);
 	}
 
@@ -3497,11 +3552,11 @@ row_sel_try_search_shortcut_for_mysql(
 	ut_ad(!prebuilt->templ_contains_blob);
 
 #ifndef UNIV_SEARCH_DEBUG
+	ut_ad(trx->has_search_latch);
+
 	btr_pcur_open_with_no_init(index, search_tuple, PAGE_CUR_GE,
 				   BTR_SEARCH_LEAF, pcur,
-				   (trx->has_search_latch)
-				    ? RW_S_LATCH
-				    : 0,
+				   RW_S_LATCH,
 				   mtr);
 #else /* UNIV_SEARCH_DEBUG */
 	btr_pcur_open_with_no_init(index, search_tuple, PAGE_CUR_GE,
@@ -3706,7 +3761,9 @@ row_search_for_mysql(
 		return(DB_END_OF_INDEX);
 	}
 
+	ut_ad(!trx->has_search_latch);
 #ifdef UNIV_SYNC_DEBUG
+	ut_ad(!btr_search_own_any());
 	ut_ad(!sync_thread_levels_nonempty_trx(trx->has_search_latch));
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -3770,24 +3827,6 @@ row_search_for_mysql(
 	fprintf(stderr, "N tables locked %lu\n",
 		(ulong) trx->mysql_n_tables_locked);
 #endif
-	/*-------------------------------------------------------------*/
-	/* PHASE 0: Release a possible s-latch we are holding on the
-	adaptive hash index latch if there is someone waiting behind */
-
-	if (UNIV_UNLIKELY(rw_lock_get_writer(&btr_search_latch) != RW_LOCK_NOT_LOCKED)
-	    && trx->has_search_latch) {
-
-		/* There is an x-latch request on the adaptive hash index:
-		release the s-latch to reduce starvation and wait for
-		BTR_SEA_TIMEOUT rounds before trying to keep it again over
-		calls from MySQL */
-
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
-
-		trx->search_latch_timeout = BTR_SEA_TIMEOUT;
-	}
-
 	/* Reset the new record lock info if srv_locks_unsafe_for_binlog
 	is set or session is using a READ COMMITED isolation level. Then
 	we are able to remove the record locks set here on an individual
@@ -3803,6 +3842,7 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3827,6 +3867,7 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -3838,7 +3879,8 @@ row_search_for_mysql(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -3855,6 +3897,12 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 500000000;
 		}
 
+		if (prebuilt->n_rows_fetched > MYSQL_FETCH_CACHE_THRESHOLD) {
+			/* Any prefetched rows were read: the scan
+			goes on, so prefetch more rows at a time. */
+			row_sel_prefetch_cache_grow(prebuilt);
+		}
+
 		mode = pcur->search_mode;
 	}
 
@@ -3934,10 +3982,9 @@ row_search_for_mysql(
 			hash index semaphore! */
 
 #ifndef UNIV_SEARCH_DEBUG
-			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
-				trx->has_search_latch = TRUE;
-			}
+			ut_ad(!trx->has_search_latch);
+			btr_search_s_lock(index);
+			trx->has_search_latch = TRUE;
 #endif
 			switch (row_sel_try_search_shortcut_for_mysql(
 					&rec, prebuilt, &offsets, &heap,
@@ -3993,7 +4040,7 @@ row_search_for_mysql(
 				fputs(" shortcut\n", stderr); */
 
 				err = DB_SUCCESS;
-				goto release_search_latch_if_needed;
+				goto release_search_latch;
 
 			case SEL_EXHAUSTED:
 			shortcut_mismatch:
@@ -4003,15 +4050,9 @@ row_search_for_mysql(
 				fputs(" record not found 2\n", stderr); */
 
 				err = DB_RECORD_NOT_FOUND;
-release_search_latch_if_needed:
-				if (trx->search_latch_timeout > 0
-				    && trx->has_search_latch) {
-
-					trx->search_latch_timeout--;
-
-					rw_lock_s_unlock(&btr_search_latch);
-					trx->has_search_latch = FALSE;
-				}
+release_search_latch:
+				btr_search_s_unlock(index);
+				trx->has_search_latch = FALSE;
 
 				/* NOTE that we do NOT store the cursor
 				position */
@@ -4026,16 +4067,19 @@ row_search_for_mysql(
 
 			mtr_commit(&mtr);
 			mtr_start_trx(&mtr, trx);
+
+			btr_search_s_unlock(index);
+			trx->has_search_latch = FALSE;
 		}
 	}
 
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
-	}
+	ut_ad(!trx->has_search_latch);
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(!btr_search_own_any());
+#endif
 
 	/* The state of a running trx can only be changed by the
 	thread that is currently serving the transaction. Because we
@@ -4926,7 +4970,7 @@ row_search_for_mysql(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -4979,7 +5023,7 @@ row_search_for_mysql(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
 			goto next_rec;
 		}
 
@@ -5267,7 +5311,9 @@ row_search_for_mysql(
 		}
 	}
 
+	ut_ad(!trx->has_search_latch);
 #ifdef UNIV_SYNC_DEBUG
+	ut_ad(!btr_search_own_any());
 	ut_ad(!sync_thread_levels_nonempty_trx(trx->has_search_latch));
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -5330,13 +5376,9 @@ row_search_check_if_query_cache_permitted(
 		/* If the isolation level is high, assign a read view for the
 		transaction if it does not yet have one */
 
-		if (trx->isolation_level >= TRX_ISO_REPEATABLE_READ
-		    && !trx->read_view) {
-
-			trx->read_view = read_view_open_now(
-				trx->id, trx->global_read_view_heap);
+		if (trx->isolation_level >= TRX_ISO_REPEATABLE_READ) {
 
-			trx->global_read_view = trx->read_view;
+			trx_assign_read_view(trx);
 		}
 	}
 
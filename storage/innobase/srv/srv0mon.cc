@@ -30,6 +30,7 @@ Created 12/9/2009 Jimmy Yang
 #include "mach0data.h"
 #include "srv0mon.h"
 #include "srv0srv.h"
+#include "btr0types.h"
 #include "buf0buf.h"
 #include "trx0sys.h"
 #include "trx0rseg.h"
@@ -53,6 +54,27 @@ Created 12/9/2009 Jimmy Yang
 #define MONITOR_BUF_PAGE_WRITTEN(name, description, code)	\
 	 MONITOR_BUF_PAGE(name, description, code, "written", PAGE_WRITTEN)
 
+/* Macro to define the counters of one adaptive hash index partition */
+#define MONITOR_AHI_PART(p)						\
+	{"adaptive_hash_searches_part" #p, "adaptive_hash_index",	\
+	 "Number of successful searches using Adaptive Hash Index"	\
+	 " partition " #p,						\
+	 MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_AHI_PART_SEARCH(p)}, \
+	{"adaptive_hash_searches_btree_part" #p, "adaptive_hash_index", \
+	 "Number of unsuccessful searches in Adaptive Hash Index"	\
+	 " partition " #p,						\
+	 MONITOR_NONE, MONITOR_DEFAULT_START,				\
+	 MONITOR_AHI_PART_SEARCH_BTREE(p)},				\
+	{"adaptive_hash_latch_waits_part" #p, "adaptive_hash_index",	\
+	 "Number of waits for the latch of Adaptive Hash Index"	\
+	 " partition " #p,						\
+	 MONITOR_NONE, MONITOR_DEFAULT_START,				\
+	 MONITOR_AHI_PART_LATCH_WAITS(p)}
+
+#if BTR_SEARCH_MAX_PARTITIONS != 64
+# error "Update the MONITOR_AHI_PART() list in innodb_counter_info[]"
+#endif
+
 
 /** This array defines basic static information of monitor counters,
 including each monitor's name, module it belongs to, a short
@@ -105,6 +127,22 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DEFAULT_ON,
 	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK},
 
+	{"lock_deadlocks_background", "lock",
+	 "Number of deadlocks resolved by the background deadlock detection"
+	 " (innodb_deadlock_detect=BACKGROUND)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_BACKGROUND},
+
+	{"lock_deadlock_checks", "lock",
+	 "Number of searches for deadlocks in the waits-for graph",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECK},
+
+	{"lock_deadlock_check_usec", "lock",
+	 "Time (in microseconds) spent searching for deadlocks",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECK_MICROSECOND},
+
 	{"lock_timeouts", "lock", "Number of lock timeouts",
 	 MONITOR_DEFAULT_ON,
 	 MONITOR_DEFAULT_START, MONITOR_TIMEOUT},
@@ -119,6 +157,18 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_TABLELOCK_WAIT},
 
+	{"lock_rec_release_early", "lock",
+	 "Number of prepared transactions whose record locks were released"
+	 " before the commit (innodb_release_locks_early)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_RECLOCK_RELEASE_EARLY},
+
+	{"lock_rec_release_early_waits", "lock",
+	 "Number of early releases of record locks that other transactions"
+	 " were waiting for",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_RECLOCK_RELEASE_EARLY_WAIT},
+
 	{"lock_rec_lock_requests", "lock",
 	 "Number of record locks requested",
 	 MONITOR_NONE,
@@ -763,6 +813,29 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_TRX_ACTIVE},
 
+	{"trx_sys_mutex_waits", "transaction",
+	 "Number of times trx_sys->mutex was busy when a transaction "
+	 "was started or committed",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_SYS_MUTEX_WAIT},
+
+	{"trx_ids_nowait", "transaction",
+	 "Number of transaction ids of read-only transactions allocated "
+	 "without acquiring trx_sys->mutex",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_ID_NOWAIT},
+
+	{"trx_rw_hash_lookups", "transaction",
+	 "Number of lookups of active read-write transactions in "
+	 "trx_sys->rw_trx_hash",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_RW_HASH_LOOKUP},
+
+	{"trx_rw_hash_mutex_waits", "transaction",
+	 "Number of times a trx_sys->rw_trx_hash mutex was busy",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_RW_HASH_MUTEX_WAIT},
+
 	{"trx_rseg_history_len", "transaction",
 	 "Length of the TRX_RSEG_HISTORY list",
 	 static_cast<monitor_type_t>(
@@ -902,6 +975,48 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOG_WRITES},
 
+	{"log_mutex_waits", "recovery",
+	 "Number of times the log mutex was busy when a mini-transaction"
+	 " was writing its log records",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_MUTEX_WAITS},
+
+	{"log_concurrent_copies", "recovery",
+	 "Number of mini-transactions that copied their log records"
+	 " without holding the log mutex (innodb_log_concurrent_copy)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_CONCURRENT_COPIES},
+
+	{"log_copy_slots_full", "recovery",
+	 "Number of mini-transactions that copied their log records"
+	 " under the log mutex because all copy slots were in use",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_COPY_SLOTS_FULL},
+
+	{"log_copy_waits", "recovery",
+	 "Number of times a log write waited for mini-transactions"
+	 " to finish copying their log records",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_COPY_WAITS},
+
+	{"log_partial_writes", "recovery",
+	 "Number of log writes that stopped at log records"
+	 " that were still being copied",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_PARTIAL_WRITES},
+
+	{"log_writer_spin_waits", "recovery",
+	 "Number of waits for the log writer threads that ended"
+	 " while spinning",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_WRITER_SPIN_WAITS},
+
+	{"log_writer_event_waits", "recovery",
+	 "Number of waits for the log writer threads that had to"
+	 " wait on an event",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_WRITER_EVENT_WAITS},
+
 	/* ========== Counters for Page Compression ========== */
 	{"module_compress", "compression", "Page Compression Info",
 	 MONITOR_MODULE,
@@ -1083,6 +1198,29 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
 
+	MONITOR_AHI_PART(0), MONITOR_AHI_PART(1), MONITOR_AHI_PART(2),
+	MONITOR_AHI_PART(3), MONITOR_AHI_PART(4), MONITOR_AHI_PART(5),
+	MONITOR_AHI_PART(6), MONITOR_AHI_PART(7), MONITOR_AHI_PART(8),
+	MONITOR_AHI_PART(9), MONITOR_AHI_PART(10), MONITOR_AHI_PART(11),
+	MONITOR_AHI_PART(12), MONITOR_AHI_PART(13), MONITOR_AHI_PART(14),
+	MONITOR_AHI_PART(15), MONITOR_AHI_PART(16), MONITOR_AHI_PART(17),
+	MONITOR_AHI_PART(18), MONITOR_AHI_PART(19), MONITOR_AHI_PART(20),
+	MONITOR_AHI_PART(21), MONITOR_AHI_PART(22), MONITOR_AHI_PART(23),
+	MONITOR_AHI_PART(24), MONITOR_AHI_PART(25), MONITOR_AHI_PART(26),
+	MONITOR_AHI_PART(27), MONITOR_AHI_PART(28), MONITOR_AHI_PART(29),
+	MONITOR_AHI_PART(30), MONITOR_AHI_PART(31), MONITOR_AHI_PART(32),
+	MONITOR_AHI_PART(33), MONITOR_AHI_PART(34), MONITOR_AHI_PART(35),
+	MONITOR_AHI_PART(36), MONITOR_AHI_PART(37), MONITOR_AHI_PART(38),
+	MONITOR_AHI_PART(39), MONITOR_AHI_PART(40), MONITOR_AHI_PART(41),
+	MONITOR_AHI_PART(42), MONITOR_AHI_PART(43), MONITOR_AHI_PART(44),
+	MONITOR_AHI_PART(45), MONITOR_AHI_PART(46), MONITOR_AHI_PART(47),
+	MONITOR_AHI_PART(48), MONITOR_AHI_PART(49), MONITOR_AHI_PART(50),
+	MONITOR_AHI_PART(51), MONITOR_AHI_PART(52), MONITOR_AHI_PART(53),
+	MONITOR_AHI_PART(54), MONITOR_AHI_PART(55), MONITOR_AHI_PART(56),
+	MONITOR_AHI_PART(57), MONITOR_AHI_PART(58), MONITOR_AHI_PART(59),
+	MONITOR_AHI_PART(60), MONITOR_AHI_PART(61), MONITOR_AHI_PART(62),
+	MONITOR_AHI_PART(63),
+
 	/* ========== Counters for tablespace ========== */
 	{"module_file", "file_system", "Tablespace and File System Manager",
 	 MONITOR_MODULE,
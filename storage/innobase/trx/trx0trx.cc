@@ -326,8 +326,11 @@ trx_free_prepared(
 
 	ut_a(!trx->read_only);
 
+	trx_rw_hash_delete(trx);
+
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
+	trx_sys->rw_trx_version++;
 
 	/* Undo trx_resurrect_table_locks(). */
 	UT_LIST_INIT(trx->lock.trx_locks);
@@ -414,6 +417,9 @@ trx_list_rw_insert_ordered(
 
 	ut_ad(!trx->in_rw_trx_list);
 	ut_d(trx->in_rw_trx_list = TRUE);
+	trx_sys->rw_trx_version++;
+
+	trx_rw_hash_insert(trx);
 }
 
 /****************************************************************//**
@@ -829,6 +835,20 @@ trx_assign_rseg(
 	trx->rseg = trx_assign_rseg_low(srv_undo_logs, srv_undo_tablespaces);
 }
 
+/****************************************************************//**
+Acquires trx_sys->mutex when a transaction is started or committed, and
+counts the acquisitions that had to wait. */
+static
+void
+trx_sys_mutex_enter_and_count(void)
+/*===============================*/
+{
+	if (mutex_enter_nowait(&trx_sys->mutex)) {
+		MONITOR_INC(MONITOR_TRX_SYS_MUTEX_WAIT);
+		mutex_enter(&trx_sys->mutex);
+	}
+}
+
 /****************************************************************//**
 Starts a transaction. */
 static
@@ -878,7 +898,29 @@ trx_start_low(
 	ut_a(ib_vector_is_empty(trx->autoinc_locks));
 	ut_a(ib_vector_is_empty(trx->lock.table_locks));
 
-	mutex_enter(&trx_sys->mutex);
+	ut_ad(!trx->in_rw_trx_list);
+	ut_ad(!trx->in_ro_trx_list);
+
+	if (trx_is_autocommit_non_locking(trx)) {
+		ut_ad(trx->read_only);
+
+		/* The transaction is not put on any list, and its id is
+		never written to a record, so that trx_sys->mutex is not
+		needed. As in trx_commit_in_memory(), the state change is
+		not protected by trx_sys->mutex. The id is assigned before
+		the state, for lock_print_info_all_transactions(). */
+
+		trx->id = trx_sys_get_new_trx_id_nowait();
+
+		os_wmb;
+
+		trx->state = TRX_STATE_ACTIVE;
+
+		MONITOR_INC(MONITOR_TRX_ID_NOWAIT);
+		goto func_exit;
+	}
+
+	trx_sys_mutex_enter_and_count();
 
 	/* If this transaction came from trx_allocate_for_mysql(),
 	trx->in_mysql_trx_list would hold. In that case, the trx->state
@@ -887,10 +929,10 @@ trx_start_low(
 
 	trx->state = TRX_STATE_ACTIVE;
 
-	trx->id = trx_sys_get_new_trx_id();
+	/* The lists are sorted on trx id, and the id must be allocated
+	while holding the mutex. */
 
-	ut_ad(!trx->in_rw_trx_list);
-	ut_ad(!trx->in_ro_trx_list);
+	trx->id = trx_sys_get_new_trx_id();
 
 	if (trx->read_only) {
 
@@ -898,10 +940,8 @@ trx_start_low(
 		be ordered, we should exploit this using a list type that
 		doesn't need a list wide lock to increase concurrency. */
 
-		if (!trx_is_autocommit_non_locking(trx)) {
-			UT_LIST_ADD_FIRST(trx_list, trx_sys->ro_trx_list, trx);
-			ut_d(trx->in_ro_trx_list = TRUE);
-		}
+		UT_LIST_ADD_FIRST(trx_list, trx_sys->ro_trx_list, trx);
+		ut_d(trx->in_ro_trx_list = TRUE);
 	} else {
 
 		ut_ad(trx->rseg != NULL
@@ -910,6 +950,7 @@ trx_start_low(
 		ut_ad(!trx_is_autocommit_non_locking(trx));
 		UT_LIST_ADD_FIRST(trx_list, trx_sys->rw_trx_list, trx);
 		ut_d(trx->in_rw_trx_list = TRUE);
+		trx_sys->rw_trx_version++;
 #ifdef UNIV_DEBUG
 		if (trx->id > trx_sys->rw_max_trx_id) {
 			trx_sys->rw_max_trx_id = trx->id;
@@ -921,6 +962,11 @@ trx_start_low(
 
 	mutex_exit(&trx_sys->mutex);
 
+	if (!trx->read_only) {
+		trx_rw_hash_insert(trx);
+	}
+
+func_exit:
 	trx->start_time = ut_time();
 
 	trx->start_time_micro = clock();
@@ -942,7 +988,7 @@ trx_serialisation_number_get(
 
 	ut_ad(mutex_own(&rseg->mutex));
 
-	mutex_enter(&trx_sys->mutex);
+	trx_sys_mutex_enter_and_count();
 
 	trx->no = trx_sys_get_new_trx_id();
 
@@ -1229,7 +1275,11 @@ trx_commit_in_memory(
 
 		ut_ad(trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY));
 
-		mutex_enter(&trx_sys->mutex);
+		if (!trx->read_only) {
+			trx_rw_hash_delete(trx);
+		}
+
+		trx_sys_mutex_enter_and_count();
 
 		assert_trx_in_list(trx);
 
@@ -1240,6 +1290,7 @@ trx_commit_in_memory(
 		} else {
 			UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 			ut_d(trx->in_rw_trx_list = FALSE);
+			trx_sys->rw_trx_version++;
 			MONITOR_INC(MONITOR_TRX_RW_COMMIT);
 		}
 
@@ -1260,12 +1311,10 @@ trx_commit_in_memory(
 		mutex_exit(&trx_sys->mutex);
 	}
 
-	if (trx->global_read_view != NULL) {
-
-		mem_heap_empty(trx->global_read_view_heap);
+	/* The memory of the view is kept in trx->prebuilt_view, for
+	trx_assign_read_view() of the next transaction. */
 
-		trx->global_read_view = NULL;
-	}
+	trx->global_read_view = NULL;
 
 	trx->read_view = NULL;
 
@@ -1477,14 +1526,17 @@ trx_cleanup_at_db_startup(
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
 
-	mutex_enter(&trx_sys->mutex);
-
 	ut_a(!trx->read_only);
 
+	trx_rw_hash_delete(trx);
+
+	mutex_enter(&trx_sys->mutex);
+
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 
 	assert_trx_in_rw_list(trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
+	trx_sys->rw_trx_version++;
 
 	mutex_exit(&trx_sys->mutex);
 
@@ -1515,14 +1567,24 @@ trx_assign_read_view(
 		return(trx->read_view);
 	}
 
-	if (!trx->read_view) {
+	ut_ad(trx->global_read_view == NULL);
+
+	if (trx->prebuilt_view != NULL
+	    && read_view_reopen(trx->prebuilt_view, trx)) {
+
+		trx->read_view = trx->prebuilt_view;
+	} else {
+		/* Free the previous view, if any. */
+		mem_heap_empty(trx->global_read_view_heap);
 
 		trx->read_view = read_view_open_now(
 			trx->id, trx->global_read_view_heap);
 
-		trx->global_read_view = trx->read_view;
+		trx->prebuilt_view = trx->read_view;
 	}
 
+	trx->global_read_view = trx->read_view;
+
 	return(trx->read_view);
 }
 
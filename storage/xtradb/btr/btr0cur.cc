@@ -571,7 +571,7 @@ btr_cur_search_to_nth_level(
 
 	if (has_search_latch) {
 		/* Release possible search latch to obey latching order */
-		rw_lock_s_unlock(btr_search_get_latch(cursor->index));
+		btr_search_s_unlock(cursor->index);
 	}
 
 	/* Store the position of the tree latch we push to mtr so that we
@@ -908,7 +908,7 @@ btr_cur_search_to_nth_level(
 
 	if (has_search_latch) {
 
-		rw_lock_s_lock(btr_search_get_latch(cursor->index));
+		btr_search_s_lock(cursor->index);
 	}
 
 	return err;
@@ -2251,13 +2251,13 @@ btr_cur_update_in_place(
 			btr_search_update_hash_on_delete(cursor);
 		}
 
-		rw_lock_x_lock(btr_search_get_latch(cursor->index));
+		btr_search_x_lock(cursor->index);
 	}
 
 	row_upd_rec_in_place(rec, index, offsets, update, page_zip);
 
 	if (is_hashed) {
-		rw_lock_x_unlock(btr_search_get_latch(cursor->index));
+		btr_search_x_unlock(cursor->index);
 	}
 
 	btr_cur_update_in_place_log(flags, rec, index, update,
@@ -147,15 +147,18 @@ btr_search_check_free_space_in_heap(
 	if (heap->free_block == NULL) {
 		buf_block_t*	block = buf_block_alloc(NULL);
 
-		rw_lock_x_lock(btr_search_get_latch(index));
+		btr_search_x_lock(index);
 
-		if (heap->free_block == NULL) {
+		/* If the adaptive hash index was disabled meanwhile,
+		the block must not be kept, because buf_pool_resize()
+		may need to withdraw it. */
+		if (btr_search_enabled && heap->free_block == NULL) {
 			heap->free_block = block;
 		} else {
 			buf_block_free(block);
 		}
 
-		rw_lock_x_unlock(btr_search_get_latch(index));
+		btr_search_x_unlock(index);
 	}
 }
 
@@ -235,6 +238,41 @@ btr_search_sys_free(void)
 	btr_search_sys = NULL;
 }
 
+/*****************************************************************//**
+Resizes the hash tables of the adaptive search system after the
+buffer pool was resized. The adaptive hash index must be disabled. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size)	/*!< in: hash index hash table size */
+{
+	ulint	i;
+
+	/* hash_size is the total size of all partitions */
+	hash_size /= btr_search_index_num;
+
+	btr_search_x_lock_all();
+
+	ut_a(!btr_search_enabled);
+
+	for (i = 0; i < btr_search_index_num; i++) {
+
+		mem_heap_free(btr_search_sys->hash_tables[i]->heap);
+
+		hash_table_free(btr_search_sys->hash_tables[i]);
+
+		btr_search_sys->hash_tables[i]
+			= ha_create(hash_size, 0, MEM_HEAP_FOR_BTR_SEARCH, 0);
+
+#if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
+		btr_search_sys->hash_tables[i]->adaptive = TRUE;
+#endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
+	}
+
+	btr_search_x_unlock_all();
+}
+
 /********************************************************************//**
 Set index->ref_count = 0 on all indexes of a table. */
 static
@@ -308,6 +346,15 @@ void
 btr_search_enable(void)
 /*====================*/
 {
+	buf_pool_mutex_enter_all();
+	if (srv_buf_pool_old_size != srv_buf_pool_size) {
+		/* buf_pool_resize() will enable the adaptive hash
+		index when it has completed. */
+		buf_pool_mutex_exit_all();
+		return;
+	}
+	buf_pool_mutex_exit_all();
+
 	btr_search_x_lock_all();
 
 	btr_search_enabled = TRUE;
@@ -376,9 +423,9 @@ btr_search_info_get_ref_count(
 	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(btr_search_get_latch(index));
+	btr_search_s_lock(index);
 	ret = info->ref_count;
-	rw_lock_s_unlock(btr_search_get_latch(index));
+	btr_search_s_unlock(index);
 
 	return(ret);
 }
@@ -702,11 +749,11 @@ btr_search_info_update_slow(
 		btr_search_n_hash_fail++;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-		rw_lock_x_lock(btr_search_get_latch(cursor->index));
+		btr_search_x_lock(cursor->index);
 
 		btr_search_update_hash_ref(info, block, cursor);
 
-		rw_lock_x_unlock(btr_search_get_latch(cursor->index));
+		btr_search_x_unlock(cursor->index);
 	}
 
 	if (build_index) {
@@ -951,7 +998,7 @@ btr_search_guess_on_hash(
 	cursor->flag = BTR_CUR_HASH;
 
 	if (UNIV_LIKELY(!has_search_latch)) {
-		rw_lock_s_lock(btr_search_get_latch(index));
+		btr_search_s_lock(index);
 
 		if (UNIV_UNLIKELY(!btr_search_enabled)) {
 			goto failure_unlock;
@@ -980,7 +1027,7 @@ btr_search_guess_on_hash(
 			goto failure_unlock;
 		}
 
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 	}
@@ -1072,16 +1119,21 @@ btr_search_guess_on_hash(
 	buf_pool = buf_pool_from_bpage(&block->page);
 	buf_pool->stat.n_page_gets++;
 
+	MONITOR_INC(MONITOR_AHI_PART_SEARCH(btr_search_get_key(index_id)));
+
 	return(TRUE);
 
 	/*-------------------------------------------*/
 failure_unlock:
 	if (UNIV_LIKELY(!has_search_latch)) {
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 	}
 failure:
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	MONITOR_INC(MONITOR_AHI_PART_SEARCH_BTREE(
+			    btr_search_get_key(index_id)));
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	info->n_hash_fail++;
 
@@ -1141,11 +1193,11 @@ btr_search_drop_page_hash_index(
 	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_SHARED));
 	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
-	rw_lock_s_lock(btr_search_get_latch(index));
+	btr_search_s_lock(index);
 
 	if (UNIV_UNLIKELY(index != block->index)) {
 
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 
 		goto retry;
 	}
@@ -1188,7 +1240,7 @@ btr_search_drop_page_hash_index(
 	releasing btr_search_latch, as the index page might only
 	be s-latched! */
 
-	rw_lock_s_unlock(btr_search_get_latch(index));
+	btr_search_s_unlock(index);
 
 	ut_a(n_fields + n_bytes > 0);
 
@@ -1239,7 +1291,7 @@ btr_search_drop_page_hash_index(
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(btr_search_get_latch(index));
+	btr_search_x_lock(index);
 
 	if (UNIV_UNLIKELY(!block->index)) {
 		/* Someone else has meanwhile dropped the hash index */
@@ -1255,7 +1307,7 @@ btr_search_drop_page_hash_index(
 		/* Someone else has meanwhile built a new hash index on the
 		page, with different parameters */
 
-		rw_lock_x_unlock(btr_search_get_latch(index));
+		btr_search_x_unlock(index);
 
 		mem_free(folds);
 		goto retry;
@@ -1286,14 +1338,14 @@ btr_search_drop_page_hash_index(
 			"InnoDB: the hash index to a page of %s,"
 			" still %lu hash nodes remain.\n",
 			index->name, (ulong) block->n_pointers);
-		rw_lock_x_unlock(btr_search_get_latch(index));
+		btr_search_x_unlock(index);
 
 		ut_ad(btr_search_validate());
 	} else {
-		rw_lock_x_unlock(btr_search_get_latch(index));
+		btr_search_x_unlock(index);
 	}
 #else /* UNIV_AHI_DEBUG || UNIV_DEBUG */
-	rw_lock_x_unlock(btr_search_get_latch(index));
+	btr_search_x_unlock(index);
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
 	mem_free(folds);
@@ -1377,10 +1429,10 @@ btr_search_build_page_hash_index(
 	      || rw_lock_own(&(block->lock), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(btr_search_get_latch(index));
+	btr_search_s_lock(index);
 
 	if (!btr_search_enabled) {
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 		return;
 	}
 
@@ -1391,11 +1443,11 @@ btr_search_build_page_hash_index(
 			     || (block->curr_n_bytes != n_bytes)
 			     || (block->curr_left_side != left_side))) {
 
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 
 		btr_search_drop_page_hash_index(block);
 	} else {
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 	}
 
 	n_recs = page_get_n_recs(page);
@@ -1491,7 +1543,7 @@ btr_search_build_page_hash_index(
 
 	btr_search_check_free_space_in_heap(index);
 
-	rw_lock_x_lock(btr_search_get_latch(index));
+	btr_search_x_lock(index);
 
 	if (UNIV_UNLIKELY(!btr_search_enabled)) {
 		goto exit_func;
@@ -1527,7 +1579,7 @@ btr_search_build_page_hash_index(
 	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
 	MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_ADDED, n_cached);
 exit_func:
-	rw_lock_x_unlock(btr_search_get_latch(index));
+	btr_search_x_unlock(index);
 
 	mem_free(folds);
 	mem_free(recs);
@@ -1562,7 +1614,7 @@ btr_search_move_or_delete_hash_entries(
 	ut_ad(rw_lock_own(&(new_block->lock), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(btr_search_get_latch(index));
+	btr_search_s_lock(index);
 
 	ut_a(!new_block->index || new_block->index == index);
 	ut_a(!block->index || block->index == index);
@@ -1571,7 +1623,7 @@ btr_search_move_or_delete_hash_entries(
 
 	if (new_block->index) {
 
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 
 		btr_search_drop_page_hash_index(block);
 
@@ -1588,7 +1640,7 @@ btr_search_move_or_delete_hash_entries(
 		new_block->n_bytes = block->curr_n_bytes;
 		new_block->left_side = left_side;
 
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 
 		ut_a(n_fields + n_bytes > 0);
 
@@ -1600,7 +1652,7 @@ btr_search_move_or_delete_hash_entries(
 		return;
 	}
 
-	rw_lock_s_unlock(btr_search_get_latch(index));
+	btr_search_s_unlock(index);
 }
 
 /********************************************************************//**
@@ -1650,7 +1702,7 @@ btr_search_update_hash_on_delete(
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(btr_search_get_latch(cursor->index));
+	btr_search_x_lock(cursor->index);
 
 	if (block->index) {
 		ut_a(block->index == index);
@@ -1663,7 +1715,7 @@ btr_search_update_hash_on_delete(
 		}
 	}
 
-	rw_lock_x_unlock(btr_search_get_latch(cursor->index));
+	btr_search_x_unlock(cursor->index);
 }
 
 /********************************************************************//**
@@ -1700,7 +1752,7 @@ btr_search_update_hash_node_on_insert(
 	ut_a(cursor->index == index);
 	ut_a(!dict_index_is_ibuf(index));
 
-	rw_lock_x_lock(btr_search_get_latch(cursor->index));
+	btr_search_x_lock(cursor->index);
 
 	if (!block->index) {
 
@@ -1723,9 +1775,9 @@ btr_search_update_hash_node_on_insert(
 		}
 
 func_exit:
-		rw_lock_x_unlock(btr_search_get_latch(cursor->index));
+		btr_search_x_unlock(cursor->index);
 	} else {
-		rw_lock_x_unlock(btr_search_get_latch(cursor->index));
+		btr_search_x_unlock(cursor->index);
 
 		btr_search_update_hash_on_insert(cursor);
 	}
@@ -1807,7 +1859,7 @@ btr_search_update_hash_on_insert(
 	} else {
 		if (left_side) {
 
-			rw_lock_x_lock(btr_search_get_latch(index));
+			btr_search_x_lock(index);
 
 			locked = TRUE;
 
@@ -1825,7 +1877,7 @@ btr_search_update_hash_on_insert(
 
 		if (!locked) {
 
-			rw_lock_x_lock(btr_search_get_latch(index));
+			btr_search_x_lock(index);
 
 			locked = TRUE;
 
@@ -1847,7 +1899,7 @@ btr_search_update_hash_on_insert(
 		if (!left_side) {
 
 			if (!locked) {
-				rw_lock_x_lock(btr_search_get_latch(index));
+				btr_search_x_lock(index);
 
 				locked = TRUE;
 
@@ -1866,7 +1918,7 @@ btr_search_update_hash_on_insert(
 
 		if (!locked) {
 
-			rw_lock_x_lock(btr_search_get_latch(index));
+			btr_search_x_lock(index);
 
 			locked = TRUE;
 
@@ -1893,7 +1945,7 @@ btr_search_update_hash_on_insert(
 		mem_heap_free(heap);
 	}
 	if (locked) {
-		rw_lock_x_unlock(btr_search_get_latch(index));
+		btr_search_x_unlock(index);
 	}
 }
 
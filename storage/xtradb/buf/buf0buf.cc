@@ -48,6 +48,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "ibuf0ibuf.h"
 #include "trx0undo.h"
 #include "log0log.h"
+#include "buf0dump.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
 #include "dict0dict.h"
@@ -64,6 +65,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "ut0byte.h"
 #include "fil0pagecompress.h"
 #include "ha_prototypes.h"
+#include <algorithm>
 
 /* prototypes for new functions added to ha_innodb.cc */
 trx_t* innobase_get_trx();
@@ -285,6 +287,17 @@ static const ulint BUF_PAGE_READ_MAX_RETRIES = 100;
 /** The buffer pools of the database */
 UNIV_INTERN buf_pool_t*	buf_pool_ptr;
 
+/** true when blocks are being withdrawn from the buffer pool
+by buf_pool_resize(); pages may be relocated while it is set */
+UNIV_INTERN volatile bool	buf_pool_withdrawing;
+
+/** incremented every time buf_pool_resize() has withdrawn blocks */
+UNIV_INTERN volatile ulint	buf_withdraw_clock;
+
+/** Number of times buf_pool_withdraw_blocks() tries to withdraw
+the blocks before giving up for a while */
+static const ulint	BUF_POOL_WITHDRAW_MAX_LOOPS = 10;
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 static ulint	buf_dbg_counter	= 0; /*!< This is used to insert validation
 					operations in execution in the
@@ -1201,6 +1214,7 @@ buf_block_init(
 	block->page.in_free_list = FALSE;
 	block->page.in_LRU_list = FALSE;
 	block->in_unzip_LRU_list = FALSE;
+	block->in_withdraw_list = FALSE;
 #endif /* UNIV_DEBUG */
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 	block->n_pointers = 0;
@@ -1339,6 +1353,28 @@ buf_chunk_init(
 	return(chunk);
 }
 
+/********************************************************************//**
+Frees a chunk of buffer frames that was allocated by buf_chunk_init().
+None of the blocks may be in use or in any list of the buffer pool. */
+static
+void
+buf_chunk_free(
+/*===========*/
+	buf_chunk_t*	chunk)	/*!< in/out: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+
+	for (ulint i = chunk->size; i--; block++) {
+		mutex_free(&block->mutex);
+		rw_lock_free(&block->lock);
+#ifdef UNIV_SYNC_DEBUG
+		rw_lock_free(&block->debug_latch);
+#endif /* UNIV_SYNC_DEBUG */
+	}
+
+	os_mem_free_large(chunk->mem, chunk->mem_size);
+}
+
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Finds a block in the given buffer chunk that points to a
@@ -1500,23 +1536,40 @@ buf_pool_init_instance(
 		     &buf_pool->flush_state_mutex, SYNC_BUF_FLUSH_STATE);
 
 	if (buf_pool_size > 0) {
-		buf_pool->n_chunks = 1;
+		ulint	n_chunks = buf_pool_size / srv_buf_pool_chunk_unit;
+
+		ut_ad(n_chunks > 0);
+		ut_ad(buf_pool_size % srv_buf_pool_chunk_unit == 0);
+
+		buf_pool->n_chunks = buf_pool->n_chunks_new = n_chunks;
 
-		buf_pool->chunks = chunk =
-			(buf_chunk_t*) mem_zalloc(sizeof *chunk);
+		buf_pool->chunks = chunk = static_cast<buf_chunk_t*>(
+			mem_zalloc(n_chunks * sizeof *chunk));
 
 		UT_LIST_INIT(buf_pool->free);
+		UT_LIST_INIT(buf_pool->withdraw);
 
-		if (!buf_chunk_init(buf_pool, chunk, buf_pool_size)) {
-			mem_free(chunk);
-			mem_free(buf_pool);
+		buf_pool->curr_size = 0;
 
-			return(DB_ERROR);
+		for (i = 0; i < n_chunks; i++, chunk++) {
+
+			if (!buf_chunk_init(buf_pool, chunk,
+					    srv_buf_pool_chunk_unit)) {
+
+				while (--chunk >= buf_pool->chunks) {
+					buf_chunk_free(chunk);
+				}
+
+				mem_free(buf_pool->chunks);
+
+				return(DB_ERROR);
+			}
+
+			buf_pool->curr_size += chunk->size;
 		}
 
 		buf_pool->instance_no = instance_no;
 		buf_pool->old_pool_size = buf_pool_size;
-		buf_pool->curr_size = chunk->size;
 		buf_pool->read_ahead_area
 			= ut_min(64, ut_2_power_up(buf_pool->curr_size / 32));
 		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
@@ -1629,6 +1682,10 @@ buf_pool_free_instance(
 	}
 
 	mem_free(buf_pool->chunks);
+
+	if (buf_pool->chunks_old) {
+		mem_free(buf_pool->chunks_old);
+	}
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
@@ -1762,6 +1819,11 @@ buf_pool_clear_hash_index(void)
 
 	for (p = 0; p < srv_buf_pool_instances; p++) {
 		buf_pool_t*	buf_pool = buf_pool_from_array(p);
+
+		/* buf_pool->mutex prevents buf_pool_resize() from
+		freeing chunks while we are accessing them. */
+		buf_pool_mutex_enter(buf_pool);
+
 		buf_chunk_t*	chunks	= buf_pool->chunks;
 		buf_chunk_t*	chunk	= chunks + buf_pool->n_chunks;
 
@@ -1787,6 +1849,8 @@ buf_pool_clear_hash_index(void)
 # endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 			}
 		}
+
+		buf_pool_mutex_exit(buf_pool);
 	}
 }
 
@@ -1878,6 +1942,914 @@ buf_relocate(
 	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold, dpage);
 }
 
+/********************************************************************//**
+Checks if a block is in a chunk that is going to be freed by
+buf_pool_resize(), so that it must be withdrawn rather than reused.
+@return	true if the block should be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: block */
+{
+	/* buf_pool_resize() holds all of these mutexes while it frees
+	the chunks. */
+	ut_ad(mutex_own(&buf_pool->free_list_mutex)
+	      || mutex_own(&buf_pool->zip_free_mutex)
+	      || mutex_own(&buf_pool->LRU_list_mutex));
+
+	if (UT_LIST_GET_LEN(buf_pool->withdraw)
+	    >= buf_pool->withdraw_target) {
+		return(false);
+	}
+
+	const buf_chunk_t*	chunk
+		= buf_pool->chunks + buf_pool->n_chunks_new;
+	const buf_chunk_t*	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		if (block >= chunk->blocks
+		    && block < chunk->blocks + chunk->size) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Checks if a pointer is in a chunk that is going to be freed by
+buf_pool_resize().
+@return	true if the memory should be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr)		/*!< in: pointer to a frame */
+{
+	/* buf_pool_resize() holds all of these mutexes while it frees
+	the chunks. */
+	ut_ad(mutex_own(&buf_pool->free_list_mutex)
+	      || mutex_own(&buf_pool->zip_free_mutex)
+	      || mutex_own(&buf_pool->LRU_list_mutex));
+
+	if (UT_LIST_GET_LEN(buf_pool->withdraw)
+	    >= buf_pool->withdraw_target) {
+		return(false);
+	}
+
+	const buf_chunk_t*	chunk
+		= buf_pool->chunks + buf_pool->n_chunks_new;
+	const buf_chunk_t*	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		if (ptr >= chunk->blocks->frame
+		    && ptr < (chunk->blocks + chunk->size - 1)->frame
+		    + UNIV_PAGE_SIZE) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Relocates a file page from a block that is going to be withdrawn by
+buf_pool_resize() to a free block. The page must not be buffer-fixed
+or I/O-fixed, or it will not be relocated.
+@return	true if a free block was available, false if the free list
+was empty */
+static
+bool
+buf_page_realloc(
+/*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_block_t*	block)		/*!< in/out: block to relocate */
+{
+	buf_block_t*	new_block;
+
+	ut_ad(buf_pool_withdrawing);
+	ut_ad(mutex_own(&buf_pool->LRU_list_mutex));
+	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+
+	new_block = buf_LRU_get_free_only(buf_pool);
+
+	if (new_block == NULL) {
+		return(false);
+	}
+
+	ulint		fold = buf_page_address_fold(
+		block->page.space, block->page.offset);
+	prio_rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
+	rw_lock_x_lock(hash_lock);
+	mutex_enter(&block->mutex);
+
+	if (!buf_page_can_relocate(&block->page)) {
+		rw_lock_x_unlock(hash_lock);
+		mutex_exit(&block->mutex);
+
+		mutex_enter(&new_block->mutex);
+		buf_LRU_block_free_non_file_page(new_block);
+		mutex_exit(&new_block->mutex);
+
+		return(true);
+	}
+
+	mutex_enter(&new_block->mutex);
+
+	memcpy(new_block->frame, block->frame, UNIV_PAGE_SIZE);
+	memcpy(&new_block->page, &block->page, sizeof block->page);
+
+	/* Relocate buf_pool->LRU. */
+	ut_ad(block->page.in_LRU_list);
+	ut_ad(!block->page.in_zip_hash);
+	ut_d(block->page.in_LRU_list = FALSE);
+
+	buf_page_t*	prev_b = UT_LIST_GET_PREV(LRU, &block->page);
+	UT_LIST_REMOVE(LRU, buf_pool->LRU, &block->page);
+
+	if (prev_b != NULL) {
+		UT_LIST_INSERT_AFTER(LRU, buf_pool->LRU, prev_b,
+				     &new_block->page);
+	} else {
+		UT_LIST_ADD_FIRST(LRU, buf_pool->LRU, &new_block->page);
+	}
+
+	if (buf_pool->LRU_old == &block->page) {
+		buf_pool->LRU_old = &new_block->page;
+	}
+
+	ut_ad(new_block->page.in_LRU_list);
+
+	/* Relocate buf_pool->unzip_LRU. */
+	if (block->page.zip.data != NULL) {
+		ut_ad(block->in_unzip_LRU_list);
+		ut_d(new_block->in_unzip_LRU_list = TRUE);
+
+		buf_block_t*	prev_block = UT_LIST_GET_PREV(unzip_LRU, block);
+		UT_LIST_REMOVE(unzip_LRU, buf_pool->unzip_LRU, block);
+
+		ut_d(block->in_unzip_LRU_list = FALSE);
+		block->page.zip.data = NULL;
+		page_zip_set_size(&block->page.zip, 0);
+
+		if (prev_block != NULL) {
+			UT_LIST_INSERT_AFTER(unzip_LRU, buf_pool->unzip_LRU,
+					     prev_block, new_block);
+		} else {
+			UT_LIST_ADD_FIRST(unzip_LRU, buf_pool->unzip_LRU,
+					  new_block);
+		}
+	} else {
+		ut_ad(!block->in_unzip_LRU_list);
+		ut_d(new_block->in_unzip_LRU_list = FALSE);
+	}
+
+	/* Relocate buf_pool->page_hash. */
+	ut_ad(block->page.in_page_hash);
+	ut_ad(&block->page == buf_page_hash_get_low(
+		      buf_pool, block->page.space, block->page.offset, fold));
+	ut_d(block->page.in_page_hash = FALSE);
+	HASH_DELETE(buf_page_t, hash, buf_pool->page_hash, fold,
+		    (&block->page));
+	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold,
+		    (&new_block->page));
+	ut_ad(new_block->page.in_page_hash);
+
+	/* Invalidate any stored pointers to the old block. */
+	buf_block_modify_clock_inc(block);
+	memset(block->frame + FIL_PAGE_OFFSET, 0xff, 4);
+	memset(block->frame + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID, 0xff, 4);
+	UNIV_MEM_INVALID(block->frame, UNIV_PAGE_SIZE);
+	buf_block_set_state(block, BUF_BLOCK_REMOVE_HASH);
+
+	/* Relocate buf_pool->flush_list. */
+	if (block->page.oldest_modification) {
+		buf_flush_relocate_on_flush_list(
+			&block->page, &new_block->page);
+	}
+
+	/* The adaptive hash index is disabled while blocks are
+	being withdrawn. */
+	ut_ad(!block->index);
+	new_block->index = NULL;
+	new_block->n_hash_helps = 0;
+	new_block->n_fields = 1;
+	new_block->left_side = TRUE;
+
+	new_block->lock_hash_val = block->lock_hash_val;
+	new_block->check_index_page_at_flush
+		= block->check_index_page_at_flush;
+
+	rw_lock_x_unlock(hash_lock);
+	mutex_exit(&new_block->mutex);
+
+	/* Free the old block; it will be put to buf_pool->withdraw. */
+	buf_block_set_state(block, BUF_BLOCK_MEMORY);
+	buf_LRU_block_free_non_file_page(block);
+
+	mutex_exit(&block->mutex);
+
+	return(true);
+}
+
+/********************************************************************//**
+Sets the global variable that feeds MySQL's
+innodb_buffer_pool_resize_status to the specified string. The format
+and the following parameters are the same as the ones used for
+printf(3). */
+static MY_ATTRIBUTE((format(printf, 1, 2)))
+void
+buf_resize_status(
+/*==============*/
+	const char*	fmt,	/*!< in: format */
+	...)			/*!< in: extra parameters according to fmt */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+
+	ut_vsnprintf(
+		export_vars.innodb_buffer_pool_resize_status,
+		sizeof(export_vars.innodb_buffer_pool_resize_status),
+		fmt, ap);
+
+	va_end(ap);
+
+	ib_logf(IB_LOG_LEVEL_INFO, "%s",
+		export_vars.innodb_buffer_pool_resize_status);
+}
+
+/********************************************************************//**
+Withdraws the blocks in the chunks that are going to be freed by
+buf_pool_resize(), by moving them from the free list to
+buf_pool->withdraw, and by evicting or relocating the pages in them.
+@return	true if the withdrawal should be retried later */
+static
+bool
+buf_pool_withdraw_blocks(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	buf_block_t*	block;
+	ulint		loop_count = 0;
+	ulint		i = buf_pool_index(buf_pool);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Buffer pool %lu: start to withdraw the last %lu blocks.",
+		i, buf_pool->withdraw_target);
+
+	/* Minimize buf_pool->zip_free[] */
+	mutex_enter(&buf_pool->zip_free_mutex);
+	buf_buddy_condense_free(buf_pool);
+	mutex_exit(&buf_pool->zip_free_mutex);
+
+	while (UT_LIST_GET_LEN(buf_pool->withdraw)
+	       < buf_pool->withdraw_target) {
+
+		/* Try to withdraw from the free list. */
+		ulint	count1 = 0;
+
+		mutex_enter(&buf_pool->free_list_mutex);
+
+		block = reinterpret_cast<buf_block_t*>(
+			UT_LIST_GET_FIRST(buf_pool->free));
+
+		while (block != NULL
+		       && UT_LIST_GET_LEN(buf_pool->withdraw)
+		       < buf_pool->withdraw_target) {
+
+			buf_block_t*	next_block = reinterpret_cast<
+				buf_block_t*>(UT_LIST_GET_NEXT(
+						      list, &block->page));
+
+			ut_ad(block->page.in_free_list);
+			ut_ad(!block->page.in_flush_list);
+			ut_ad(!block->page.in_LRU_list);
+			ut_a(!buf_page_in_file(&block->page));
+
+			if (buf_block_will_withdrawn(buf_pool, block)) {
+				UT_LIST_REMOVE(list, buf_pool->free,
+					       &block->page);
+				ut_d(block->page.in_free_list = FALSE);
+				UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+						 &block->page);
+				ut_d(block->in_withdraw_list = TRUE);
+				count1++;
+			}
+
+			block = next_block;
+		}
+
+		mutex_exit(&buf_pool->free_list_mutex);
+
+		/* Evict pages from the tail of the LRU list, so that
+		blocks in the area to be withdrawn become free. */
+		if (UT_LIST_GET_LEN(buf_pool->withdraw)
+		    < buf_pool->withdraw_target
+		    && buf_flush_start(buf_pool, BUF_FLUSH_LRU)) {
+
+			flush_counters_t	n;
+			ulint			scan_depth;
+
+			mutex_enter(&buf_pool->LRU_list_mutex);
+			scan_depth = UT_LIST_GET_LEN(buf_pool->LRU);
+			mutex_exit(&buf_pool->LRU_list_mutex);
+
+			scan_depth = ut_min(
+				ut_max(buf_pool->withdraw_target
+				       - UT_LIST_GET_LEN(buf_pool->withdraw),
+				       static_cast<ulint>(
+					       srv_LRU_scan_depth)),
+				scan_depth);
+
+			buf_flush_batch(buf_pool, BUF_FLUSH_LRU,
+					scan_depth, 0, false, &n);
+			buf_flush_end(buf_pool, BUF_FLUSH_LRU);
+			buf_flush_common(buf_pool, BUF_FLUSH_LRU, n.flushed);
+
+			if (n.flushed) {
+				MONITOR_INC_VALUE_CUMULATIVE(
+					MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
+					MONITOR_LRU_BATCH_FLUSH_COUNT,
+					MONITOR_LRU_BATCH_FLUSH_PAGES,
+					n.flushed);
+			}
+		}
+
+		buf_flush_wait_batch_end(buf_pool, BUF_FLUSH_LRU);
+
+		/* Relocate the pages and compressed pages that are
+		still in the area to be withdrawn. */
+		ulint	count2 = 0;
+
+		mutex_enter(&buf_pool->LRU_list_mutex);
+
+		buf_page_t*	bpage = UT_LIST_GET_FIRST(buf_pool->LRU);
+
+		while (bpage != NULL) {
+			ib_mutex_t*	block_mutex;
+			buf_page_t*	next_bpage;
+
+			block_mutex = buf_page_get_mutex(bpage);
+			mutex_enter(block_mutex);
+
+			next_bpage = UT_LIST_GET_NEXT(LRU, bpage);
+
+			if (bpage->zip.data != NULL
+			    && buf_frame_will_withdrawn(
+				    buf_pool,
+				    static_cast<byte*>(bpage->zip.data))
+			    && buf_page_can_relocate(bpage)) {
+
+				mutex_exit(block_mutex);
+
+				if (!buf_buddy_realloc(
+					    buf_pool, bpage->zip.data,
+					    page_zip_get_size(&bpage->zip))) {
+					/* The free list is empty. */
+					break;
+				}
+
+				mutex_enter(block_mutex);
+				count2++;
+			}
+
+			if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE
+			    && buf_block_will_withdrawn(
+				    buf_pool,
+				    reinterpret_cast<buf_block_t*>(bpage))
+			    && buf_page_can_relocate(bpage)) {
+
+				mutex_exit(block_mutex);
+
+				if (!buf_page_realloc(
+					    buf_pool,
+					    reinterpret_cast<buf_block_t*>(
+						    bpage))) {
+					/* The free list is empty. */
+					break;
+				}
+
+				count2++;
+			} else {
+				mutex_exit(block_mutex);
+			}
+
+			bpage = next_bpage;
+		}
+
+		mutex_exit(&buf_pool->LRU_list_mutex);
+
+		buf_resize_status(
+			"buffer pool %lu : withdrawing blocks. (%lu/%lu)",
+			i, UT_LIST_GET_LEN(buf_pool->withdraw),
+			buf_pool->withdraw_target);
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Buffer pool %lu: withdrew %lu blocks from free list."
+			" Tried to relocate %lu pages (%lu/%lu).",
+			i, count1, count2,
+			UT_LIST_GET_LEN(buf_pool->withdraw),
+			buf_pool->withdraw_target);
+
+		if (++loop_count >= BUF_POOL_WITHDRAW_MAX_LOOPS) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Buffer pool %lu: will retry to withdraw"
+				" later.", i);
+			return(true);
+		}
+	}
+
+	/* Confirm that every block in the area was withdrawn. */
+	const buf_chunk_t*	chunk
+		= buf_pool->chunks + buf_pool->n_chunks_new;
+	const buf_chunk_t*	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		block = chunk->blocks;
+
+		for (ulint j = chunk->size; j--; block++) {
+			ut_a(buf_block_get_state(block) == BUF_BLOCK_NOT_USED);
+			ut_ad(block->in_withdraw_list);
+		}
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Buffer pool %lu: withdrew the target of %lu blocks.",
+		i, UT_LIST_GET_LEN(buf_pool->withdraw));
+
+	/* Pointers to blocks that were stored before this point
+	must not be dereferenced any more. */
+	++buf_withdraw_clock;
+	os_wmb;
+
+	return(false);
+}
+
+/********************************************************************//**
+Resizes page_hash and zip_hash of a buffer pool instance to fit its
+current size. The caller must hold buf_pool->zip_hash_mutex and all
+page_hash latches. */
+static
+void
+buf_pool_resize_hash(
+/*=================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	hash_table_t*	new_hash_table;
+
+	ut_ad(mutex_own(&buf_pool->zip_hash_mutex));
+
+	/* Rebuild page_hash in place, so that the page_hash latches
+	are preserved; the new number of cells will make readers
+	relatch through buf_page_hash_lock_s_confirm(). */
+	new_hash_table = hash_create(2 * buf_pool->curr_size);
+
+	for (ulint i = 0; i < hash_get_n_cells(buf_pool->page_hash); i++) {
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			HASH_GET_FIRST(buf_pool->page_hash, i));
+
+		while (bpage) {
+			buf_page_t*	next_bpage = static_cast<buf_page_t*>(
+				HASH_GET_NEXT(hash, bpage));
+			ulint		fold = buf_page_address_fold(
+				bpage->space, bpage->offset);
+
+			HASH_INSERT(buf_page_t, hash, new_hash_table,
+				    fold, bpage);
+
+			bpage = next_bpage;
+		}
+	}
+
+	std::swap(buf_pool->page_hash->array, new_hash_table->array);
+	std::swap(buf_pool->page_hash->n_cells, new_hash_table->n_cells);
+	hash_table_free(new_hash_table);
+
+	/* zip_hash is protected by buf_pool->zip_hash_mutex only,
+	so it can simply be replaced. */
+	new_hash_table = hash_create(2 * buf_pool->curr_size);
+
+	for (ulint i = 0; i < hash_get_n_cells(buf_pool->zip_hash); i++) {
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			HASH_GET_FIRST(buf_pool->zip_hash, i));
+
+		while (bpage) {
+			buf_page_t*	next_bpage = static_cast<buf_page_t*>(
+				HASH_GET_NEXT(hash, bpage));
+			ulint		fold = BUF_POOL_ZIP_FOLD_PTR(
+				reinterpret_cast<buf_block_t*>(bpage)->frame);
+
+			HASH_INSERT(buf_page_t, hash, new_hash_table,
+				    fold, bpage);
+
+			bpage = next_bpage;
+		}
+	}
+
+	hash_table_free(buf_pool->zip_hash);
+	buf_pool->zip_hash = new_hash_table;
+}
+
+/********************************************************************//**
+Cancels an interrupted withdrawal, putting the withdrawn blocks back
+to the free lists. */
+static
+void
+buf_pool_withdraw_cancel(void)
+/*==========================*/
+{
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		buf_page_t*	bpage;
+
+		mutex_enter(&buf_pool->LRU_list_mutex);
+		mutex_enter(&buf_pool->free_list_mutex);
+
+		while ((bpage = UT_LIST_GET_FIRST(buf_pool->withdraw))) {
+			UT_LIST_REMOVE(list, buf_pool->withdraw, bpage);
+			ut_d(reinterpret_cast<buf_block_t*>(bpage)
+			     ->in_withdraw_list = FALSE);
+			UT_LIST_ADD_LAST(list, buf_pool->free, bpage);
+			ut_d(bpage->in_free_list = TRUE);
+		}
+
+		buf_pool->withdraw_target = 0;
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
+
+		mutex_exit(&buf_pool->free_list_mutex);
+		mutex_exit(&buf_pool->LRU_list_mutex);
+	}
+
+	buf_pool_withdrawing = false;
+}
+
+/********************************************************************//**
+Resizes the buffer pool to srv_buf_pool_size, by allocating or freeing
+chunks of srv_buf_pool_chunk_unit bytes in each instance. Before
+chunks are freed, the blocks in them are withdrawn: their pages are
+evicted or relocated to other blocks. */
+static
+void
+buf_pool_resize(void)
+/*=================*/
+{
+	buf_pool_t*	buf_pool;
+	ulint		new_instance_size;
+	bool		warning = false;
+	bool		resize_hash = false;
+
+	ut_ad(!buf_pool_withdrawing);
+	ut_ad(srv_buf_pool_chunk_unit > 0);
+
+	new_instance_size = srv_buf_pool_size / srv_buf_pool_instances;
+
+	buf_resize_status("Resizing buffer pool from %lu to %lu (unit=%lu).",
+			  srv_buf_pool_old_size, srv_buf_pool_size,
+			  srv_buf_pool_chunk_unit);
+
+	/* Set the new number of chunks for all buffer pool instances. */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool = buf_pool_from_array(i);
+		mutex_enter(&buf_pool->LRU_list_mutex);
+
+		ut_ad(buf_pool->n_chunks_new == buf_pool->n_chunks);
+		ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw) == 0);
+		ut_ad(buf_pool->withdraw_target == 0);
+
+		buf_pool->n_chunks_new
+			= new_instance_size / srv_buf_pool_chunk_unit;
+
+		mutex_exit(&buf_pool->LRU_list_mutex);
+	}
+
+	/* The adaptive hash index would keep pointers to the blocks,
+	and its memory is allocated from the buffer pool. */
+	bool	btr_search_disabled = btr_search_enabled;
+
+	if (btr_search_disabled) {
+		buf_resize_status("Disabling adaptive hash index.");
+		btr_search_disable();
+	}
+
+	/* Set the withdraw target. */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool = buf_pool_from_array(i);
+
+		if (buf_pool->n_chunks_new >= buf_pool->n_chunks) {
+			continue;
+		}
+
+		ulint	withdraw_target = 0;
+
+		const buf_chunk_t*	chunk
+			= buf_pool->chunks + buf_pool->n_chunks_new;
+		const buf_chunk_t*	echunk
+			= buf_pool->chunks + buf_pool->n_chunks;
+
+		for (; chunk < echunk; chunk++) {
+			withdraw_target += chunk->size;
+		}
+
+		mutex_enter(&buf_pool->LRU_list_mutex);
+		mutex_enter(&buf_pool->free_list_mutex);
+		buf_pool->withdraw_target = withdraw_target;
+		mutex_exit(&buf_pool->free_list_mutex);
+		mutex_exit(&buf_pool->LRU_list_mutex);
+
+		buf_pool_withdrawing = true;
+	}
+
+	ulint	retry_interval = 1;
+
+	while (buf_pool_withdrawing) {
+		bool	should_retry_withdraw = false;
+
+		buf_resize_status("Withdrawing blocks to be shrunken.");
+
+		for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+			buf_pool = buf_pool_from_array(i);
+
+			if (buf_pool->withdraw_target) {
+				should_retry_withdraw
+					|= buf_pool_withdraw_blocks(buf_pool);
+			}
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			/* Abort the resizing for shutdown. */
+			buf_pool_withdraw_cancel();
+			return;
+		}
+
+		/* Abort loading the buffer pool, which would
+		compete for the free blocks. */
+		buf_load_abort();
+
+		if (!should_retry_withdraw) {
+			break;
+		}
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Will retry to withdraw %lu seconds later.",
+			retry_interval);
+		os_thread_sleep(retry_interval * 1000000);
+
+		if (retry_interval > 5) {
+			retry_interval = 10;
+		} else {
+			retry_interval *= 2;
+		}
+	}
+
+	buf_resize_status("Latching whole of buffer pool.");
+
+	/* Acquire all LRU list mutexes and page_hash latches. The
+	free list, zip_free and zip_hash mutexes are acquired for each
+	instance below. */
+	buf_pool_mutex_enter_all();
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		hash_lock_x_all(buf_pool_from_array(i)->page_hash);
+	}
+
+	buf_pool_withdrawing = false;
+
+	/* Add or delete chunks. */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_chunk_t*	chunk;
+		buf_chunk_t*	echunk;
+
+		buf_pool = buf_pool_from_array(i);
+
+		mutex_enter(&buf_pool->free_list_mutex);
+		mutex_enter(&buf_pool->zip_free_mutex);
+		mutex_enter(&buf_pool->zip_hash_mutex);
+
+		buf_resize_status(
+			"buffer pool %lu : resizing with chunks %lu to %lu.",
+			i, buf_pool->n_chunks, buf_pool->n_chunks_new);
+
+		/* The chunk array of the previous resize is no longer
+		being read by buf_block_align(). */
+		if (buf_pool->chunks_old) {
+			mem_free(buf_pool->chunks_old);
+			buf_pool->chunks_old = NULL;
+		}
+
+		if (buf_pool->n_chunks_new < buf_pool->n_chunks) {
+			ulint	sum_freed = 0;
+			ulint	n_chunks = buf_pool->n_chunks;
+
+			/* Publish the shrunk n_chunks before freeing
+			the memory. The chunk array itself is kept, so
+			that lock-free readers that saw the old n_chunks
+			stay within it. */
+			buf_pool->n_chunks = buf_pool->n_chunks_new;
+			os_wmb;
+
+			chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+			echunk = buf_pool->chunks + n_chunks;
+
+			for (; chunk < echunk; chunk++) {
+				sum_freed += chunk->size;
+				buf_chunk_free(chunk);
+			}
+
+			/* Discard the withdraw list. */
+			UT_LIST_INIT(buf_pool->withdraw);
+			buf_pool->withdraw_target = 0;
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Buffer pool %lu: %lu chunks (%lu blocks)"
+				" were freed.",
+				i, n_chunks - buf_pool->n_chunks, sum_freed);
+
+		} else if (buf_pool->n_chunks_new > buf_pool->n_chunks) {
+			ulint		sum_added = 0;
+			const ulint	n_chunks_old = buf_pool->n_chunks;
+			ulint		n_chunks = n_chunks_old;
+			buf_chunk_t*	new_chunks = static_cast<buf_chunk_t*>(
+				mem_zalloc(buf_pool->n_chunks_new
+					   * sizeof *new_chunks));
+
+			memcpy(new_chunks, buf_pool->chunks,
+			       n_chunks * sizeof *new_chunks);
+
+			chunk = new_chunks + n_chunks;
+			echunk = new_chunks + buf_pool->n_chunks_new;
+
+			for (; chunk < echunk; chunk++) {
+				if (!buf_chunk_init(buf_pool, chunk,
+						    srv_buf_pool_chunk_unit)) {
+					ib_logf(IB_LOG_LEVEL_ERROR,
+						"Buffer pool %lu: failed to"
+						" allocate new memory.", i);
+					warning = true;
+					break;
+				}
+
+				sum_added += chunk->size;
+				++n_chunks;
+			}
+
+			/* Publish the new chunk array before the new
+			n_chunks; see buf_block_align_instance(). */
+			buf_pool->chunks_old = buf_pool->chunks;
+			buf_pool->chunks = new_chunks;
+			os_wmb;
+			buf_pool->n_chunks = n_chunks;
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Buffer pool %lu: %lu chunks (%lu blocks)"
+				" were added.",
+				i, n_chunks - n_chunks_old, sum_added);
+		}
+
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
+
+		/* Recalculate buf_pool->curr_size. */
+		ulint	new_size = 0;
+
+		chunk = buf_pool->chunks;
+		echunk = buf_pool->chunks + buf_pool->n_chunks;
+
+		for (; chunk < echunk; chunk++) {
+			new_size += chunk->size;
+		}
+
+		buf_pool->curr_size = new_size;
+		buf_pool->curr_pool_size = new_size * UNIV_PAGE_SIZE;
+		buf_pool->old_pool_size = buf_pool->curr_pool_size;
+		buf_pool->read_ahead_area
+			= ut_min(64, ut_2_power_up(new_size / 32));
+
+		/* Resize the hash tables if the size changed by more
+		than a factor of two since they were created. */
+		ulint	n_cells = hash_get_n_cells(buf_pool->page_hash);
+
+		if (!warning
+		    && (n_cells > 4 * new_size || n_cells < new_size)) {
+			buf_pool_resize_hash(buf_pool);
+			resize_hash = true;
+		}
+
+		mutex_exit(&buf_pool->zip_hash_mutex);
+		mutex_exit(&buf_pool->zip_free_mutex);
+		mutex_exit(&buf_pool->free_list_mutex);
+	}
+
+	{
+		ulint	curr_size = 0;
+
+		for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+			curr_size += buf_pool_from_array(i)->curr_pool_size;
+		}
+
+		srv_buf_pool_curr_size = curr_size;
+	}
+
+	/* Release all page_hash latches and LRU list mutexes. */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		hash_unlock_x_all(buf_pool_from_array(i)->page_hash);
+	}
+
+	buf_pool_mutex_exit_all();
+
+	if (resize_hash) {
+		btr_search_sys_resize(
+			buf_pool_get_curr_size() / sizeof(void*) / 64);
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Resized the buffer pool and adaptive hash index"
+			" hash tables.");
+	}
+
+	/* Adjust the maximum size of the change buffer. */
+	ibuf_max_size_update(srv_change_buffer_max_size);
+
+	buf_pool_mutex_enter_all();
+	if (srv_buf_pool_old_size != srv_buf_pool_size) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Completed to resize buffer pool from %lu to %lu.",
+			srv_buf_pool_old_size, srv_buf_pool_size);
+		srv_buf_pool_old_size = srv_buf_pool_size;
+	}
+	buf_pool_mutex_exit_all();
+
+	if (btr_search_disabled) {
+		btr_search_enable();
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Re-enabled adaptive hash index.");
+	}
+
+	char	now[32];
+
+	ut_sprintf_timestamp(now);
+
+	if (!warning) {
+		buf_resize_status("Completed resizing buffer pool at %s.",
+				  now);
+	} else {
+		buf_resize_status("Resizing buffer pool failed,"
+				  " finished resizing at %s.", now);
+	}
+
+#if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
+	ut_a(buf_validate());
+#endif /* UNIV_DEBUG || UNIV_BUF_DEBUG */
+}
+
+/********************************************************************//**
+This is the thread for resizing the buffer pool. It waits for an event
+and when waked up either performs a resizing and sleeps again.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*)	/*!< in: a dummy parameter required by
+		os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		os_event_wait(srv_buf_resize_event);
+		os_event_reset(srv_buf_resize_event);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		buf_pool_mutex_enter_all();
+		if (srv_buf_pool_old_size == srv_buf_pool_size) {
+			buf_pool_mutex_exit_all();
+			buf_resize_status("Size did not change (old size ="
+					  " new size = %lu). Nothing to do.",
+					  srv_buf_pool_size);
+			continue;
+		}
+		buf_pool_mutex_exit_all();
+
+		buf_pool_resize();
+	}
+
+	srv_buf_resize_thread_active = false;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /********************************************************************//**
 Determine if a block is a sentinel for a buffer pool watch.
 @return	TRUE if a sentinel for a buffer pool watch, FALSE if not */
@@ -2076,6 +3048,9 @@ buf_pool_watch_unset(
 
 	rw_lock_x_lock(hash_lock);
 
+	/* If not own LRU_list_mutex, page_hash can be changed. */
+	hash_lock = buf_page_hash_lock_x_confirm(hash_lock, buf_pool, fold);
+
 	/* The page must exist because buf_pool_watch_set() increments
 	buf_fix_count. */
 
@@ -2122,6 +3097,9 @@ buf_pool_watch_occurred(
 
 	rw_lock_s_lock(hash_lock);
 
+	/* If not own LRU_list_mutex, page_hash can be changed. */
+	hash_lock = buf_page_hash_lock_s_confirm(hash_lock, buf_pool, fold);
+
 	/* The page must exist because buf_pool_watch_set()
 	increments buf_fix_count. */
 	bpage = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -2576,12 +3554,21 @@ buf_block_align_instance(
 	buf_chunk_t*	chunk;
 	ulint		i;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	for (chunk = buf_pool->chunks, i = buf_pool->n_chunks; i--; chunk++) {
+	/* buf_pool->chunks is not protected by any mutex.
+	buf_pool_resize() replaces it with a bigger array before
+	incrementing n_chunks, and it frees the chunks at the end of
+	the array after decrementing n_chunks. The memory of a chunk
+	is only dereferenced if ptr points inside it. */
+	i = buf_pool->n_chunks;
+	os_rmb;
+
+	for (chunk = buf_pool->chunks; i--; chunk++) {
 		ulint	offs;
 
-		if (UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
+		if (ptr < static_cast<const byte*>(chunk->mem)
+		    || ptr >= static_cast<const byte*>(chunk->mem)
+		    + chunk->mem_size
+		    || UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
 
 			continue;
 		}
@@ -2704,11 +3691,13 @@ buf_pointer_is_block_field_instance(
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	const void*	ptr)		/*!< in: pointer not dereferenced */
 {
+	/* See buf_block_align_instance() for the protection of
+	buf_pool->chunks. */
+	const ulint			n_chunks = buf_pool->n_chunks;
+	os_rmb;
 	const buf_chunk_t*		chunk	= buf_pool->chunks;
-	const buf_chunk_t* const	echunk	= chunk + buf_pool->n_chunks;
+	const buf_chunk_t* const	echunk	= chunk + n_chunks;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
 	while (chunk < echunk) {
 		if (ptr >= (void*) chunk->blocks
 		    && ptr < (void*) (chunk->blocks + chunk->size)) {
@@ -2927,6 +3916,9 @@ buf_page_get_gen(
 
 	rw_lock_s_lock(hash_lock);
 
+	/* If not own LRU_list_mutex, page_hash can be changed. */
+	hash_lock = buf_page_hash_lock_s_confirm(hash_lock, buf_pool, fold);
+
 	if (block != NULL) {
 
 		/* If the guess is a compressed page descriptor that
@@ -2963,6 +3955,11 @@ buf_page_get_gen(
 
 		if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 			mutex_enter(&buf_pool->LRU_list_mutex);
+
+			/* The page_hash may have been resized while we
+			were not holding buf_pool->LRU_list_mutex. */
+			hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
 			rw_lock_x_lock(hash_lock);
 			block = (buf_block_t*) buf_pool_watch_set(
 				space, offset, fold);
@@ -3188,6 +4185,10 @@ buf_page_get_gen(
 
 		mutex_enter(&buf_pool->LRU_list_mutex);
 
+		/* The page_hash may have been resized while we were
+		not holding buf_pool->LRU_list_mutex. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
 		rw_lock_x_lock(hash_lock);
 
 		/* Buffer-fixing prevents the page_hash from changing. */
@@ -3363,6 +4364,9 @@ buf_page_get_gen(
 
 			if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 				mutex_enter(&buf_pool->LRU_list_mutex);
+
+				hash_lock = buf_page_hash_lock_get(
+					buf_pool, fold);
 				rw_lock_x_lock(hash_lock);
 
 				/* Set the watch, as it would have
@@ -3373,6 +4377,12 @@ buf_page_get_gen(
 				mutex_exit(&buf_pool->LRU_list_mutex);
 			} else {
 				rw_lock_x_lock(hash_lock);
+
+				/* If not own LRU_list_mutex,
+				page_hash can be changed. */
+				hash_lock = buf_page_hash_lock_x_confirm(
+					hash_lock, buf_pool, fold);
+
 				block = (buf_block_t*) buf_page_hash_get_low(
 					buf_pool, space, offset, fold);
 			}
@@ -4029,10 +5039,11 @@ buf_page_init_for_read(
 	}
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	ut_ad(!mutex_own(&buf_pool->LRU_list_mutex));
 	mutex_enter(&buf_pool->LRU_list_mutex);
+
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	watch_page = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -4134,6 +5145,10 @@ buf_page_init_for_read(
 		uninitialized data. */
 		data = buf_buddy_alloc(buf_pool, zip_size, &lru);
 
+		/* buf_buddy_alloc() may have released
+		buf_pool->LRU_list_mutex, and the page_hash may have
+		been resized meanwhile. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 
 		/* We must check the page_hash again, as it may have been
@@ -4275,10 +5290,11 @@ buf_page_create(
 	free_block = buf_LRU_get_free_block(buf_pool);
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	ut_ad(!mutex_own(&buf_pool->LRU_list_mutex));
 	mutex_enter(&buf_pool->LRU_list_mutex);
+
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	block = (buf_block_t*) buf_page_hash_get_low(
@@ -4522,13 +5538,14 @@ buf_mark_space_corrupt(
 	ibool		ret = TRUE;
 	const ulint	fold = buf_page_address_fold(bpage->space,
 						     bpage->offset);
-	prio_rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+	prio_rw_lock_t*	hash_lock;
 
 	/* First unfix and release lock on the bpage */
 	ut_ad(!mutex_own(&buf_pool->LRU_list_mutex));
 
 	if (!bpage->encrypted) {
 		mutex_enter(&buf_pool->LRU_list_mutex);
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 		mutex_enter(buf_page_get_mutex(bpage));
 		ut_ad(buf_page_get_io_fix(bpage) == BUF_IO_READ);
@@ -5342,9 +6359,12 @@ buf_pool_validate_instance(
 
 	mutex_exit(&buf_pool->LRU_list_mutex);
 
-	if (UT_LIST_GET_LEN(buf_pool->free) != n_free) {
-		fprintf(stderr, "Free list len %lu, free blocks %lu\n",
+	if (UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw) != n_free) {
+		fprintf(stderr, "Free list len %lu, withdraw list len %lu,"
+			" free blocks %lu\n",
 			UT_LIST_GET_LEN(buf_pool->free),
+			UT_LIST_GET_LEN(buf_pool->withdraw),
 			n_free);
 		ut_error;
 	}
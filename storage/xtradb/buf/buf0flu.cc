@@ -1096,7 +1096,7 @@ buf_flush_page(
 			/* avoiding deadlock possibility involves doublewrite
 			buffer, should flush it, because it might hold the
 			another block->lock. */
-			buf_dblwr_flush_buffered_writes();
+			buf_dblwr_flush_buffered_writes(buf_pool);
 
 			rw_lock_s_lock_gen(rw_lock, BUF_IO_WRITE);
                 }
@@ -1528,6 +1528,7 @@ buf_flush_LRU_list_batch(
 	ulint		max_scanned_pages;
 	ulint		free_len = UT_LIST_GET_LEN(buf_pool->free);
 	ulint		lru_len = UT_LIST_GET_LEN(buf_pool->LRU);
+	ulint		withdraw_depth = 0;
 
 	n->flushed = 0;
 	n->evicted = 0;
@@ -1535,13 +1536,25 @@ buf_flush_LRU_list_batch(
 
 	ut_ad(mutex_own(&buf_pool->LRU_list_mutex));
 
-	max_scanned_pages = limited_scan ? srv_LRU_scan_depth : lru_len * max;
-	max_lru_position = ut_min(srv_LRU_scan_depth, lru_len);
+	if (buf_pool->withdraw_target
+	    && buf_pool->withdraw_target
+	    > UT_LIST_GET_LEN(buf_pool->withdraw)) {
+		/* buf_pool_resize() is waiting for blocks to be
+		freed, so that they can be withdrawn. The length is
+		read without free_list_mutex; it is only a hint. */
+		withdraw_depth = buf_pool->withdraw_target
+			- UT_LIST_GET_LEN(buf_pool->withdraw);
+	}
+
+	max_scanned_pages = limited_scan
+		? srv_LRU_scan_depth + withdraw_depth : lru_len * max;
+	max_lru_position = ut_min(srv_LRU_scan_depth + withdraw_depth,
+				  lru_len);
 
 	bpage = UT_LIST_GET_LAST(buf_pool->LRU);
 	while (bpage != NULL
 	       && (srv_cleaner_eviction_factor ? n->evicted : n->flushed) < max
-	       && free_len < srv_LRU_scan_depth
+	       && free_len < srv_LRU_scan_depth + withdraw_depth
 	       && lru_len > BUF_LRU_MIN_LEN
 	       && lru_position < max_lru_position
 	       && scanned < max_scanned_pages) {
@@ -1836,11 +1849,14 @@ Gather the aggregated stats for both flush list and LRU list flushing */
 void
 buf_flush_common(
 /*=============*/
+	const buf_pool_t* buf_pool,	/*!< in: buffer pool instance that
+					was flushed, or NULL if several
+					instances were flushed */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
 	if (page_count) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool);
 	}
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
@@ -1997,7 +2013,7 @@ buf_flush_LRU(
 
 	buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-	buf_flush_common(BUF_FLUSH_LRU, n->flushed);
+	buf_flush_common(buf_pool, BUF_FLUSH_LRU, n->flushed);
 
 	return(true);
 }
@@ -2123,7 +2139,7 @@ buf_flush_list(
 			}
 		}
 
-		buf_flush_common(BUF_FLUSH_LIST, flush_common_batch);
+		buf_flush_common(NULL, BUF_FLUSH_LIST, flush_common_batch);
 	}
 
 	/* If we haven't flushed all the instances due to timeout or a repeat
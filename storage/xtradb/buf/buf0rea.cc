@@ -66,9 +66,10 @@ buf_read_page_handle_error(
 					== BUF_BLOCK_FILE_PAGE);
 	const ulint	fold = buf_page_address_fold(bpage->space,
 						     bpage->offset);
-	prio_rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	mutex_enter(&buf_pool->LRU_list_mutex);
+
+	prio_rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 	mutex_enter(buf_page_get_mutex(bpage));
 
@@ -282,6 +282,64 @@ hash_unlock_x_all_but(
 	}
 }
 
+/************************************************************//**
+Checks that an s-latched lock still protects a fold value in a hash
+table whose number of cells may have been changed while the lock was
+being acquired, and relatches the appropriate lock if not.
+@return	s-latched lock protecting the fold value */
+UNIV_INTERN
+prio_rw_lock_t*
+hash_lock_s_confirm(
+/*================*/
+	prio_rw_lock_t*	hash_lock,	/*!< in: s-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold)		/*!< in: fold */
+{
+	prio_rw_lock_t*	lock;
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(hash_lock, RW_LOCK_SHARED));
+#endif /* UNIV_SYNC_DEBUG */
+
+	/* The number of cells can only be changed while all the
+	locks are x-latched, so it is stable while we hold one. */
+	while ((lock = hash_get_lock(table, fold)) != hash_lock) {
+		rw_lock_s_unlock(hash_lock);
+		hash_lock = lock;
+		rw_lock_s_lock(hash_lock);
+	}
+
+	return(hash_lock);
+}
+
+/************************************************************//**
+Checks that an x-latched lock still protects a fold value in a hash
+table whose number of cells may have been changed while the lock was
+being acquired, and relatches the appropriate lock if not.
+@return	x-latched lock protecting the fold value */
+UNIV_INTERN
+prio_rw_lock_t*
+hash_lock_x_confirm(
+/*================*/
+	prio_rw_lock_t*	hash_lock,	/*!< in: x-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold)		/*!< in: fold */
+{
+	prio_rw_lock_t*	lock;
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(hash_lock, RW_LOCK_EX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	while ((lock = hash_get_lock(table, fold)) != hash_lock) {
+		rw_lock_x_unlock(hash_lock);
+		hash_lock = lock;
+		rw_lock_x_lock(hash_lock);
+	}
+
+	return(hash_lock);
+}
+
 #endif /* !UNIV_HOTBACKUP */
 
 /*************************************************************//**
@@ -86,6 +86,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "fil0crypt.h"
 #include "trx0xa.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "dict0boot.h"
 #include "dict0stats.h"
 #include "dict0stats_bg.h"
@@ -200,10 +201,6 @@ static my_bool innodb_buffer_pool_populate;
 Connected to buf_LRU_old_ratio. */
 static uint innobase_old_blocks_pct;
 
-/** Maximum on-disk size of change buffer in terms of percentage
-of the buffer pool. */
-static uint innobase_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
-
 /* The default values for the following char* start-up parameters
 are determined in innobase_init below: */
 
@@ -364,6 +361,22 @@ static TYPELIB innodb_lock_schedule_algorithm_typelib = {
 	NULL
 };
 
+/** Possible values of the parameter innodb_deadlock_detect */
+static const char* innodb_deadlock_detect_names[] = {
+	"OFF",
+	"ON",
+	"BACKGROUND",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_deadlock_detect. */
+static TYPELIB innodb_deadlock_detect_typelib = {
+	array_elements(innodb_deadlock_detect_names) - 1,
+	"innodb_deadlock_detect_typelib",
+	innodb_deadlock_detect_names,
+	NULL
+};
 
 /* The following counter is used to convey information to InnoDB
 about server activity: in case of normal DML ops it is not
@@ -478,7 +491,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&buf_dblwr_mutex_key, "buf_dblwr_mutex", 0},
 	{&trx_undo_mutex_key, "trx_undo_mutex", 0},
 	{&srv_sys_mutex_key, "srv_sys_mutex", 0},
-	{&lock_sys_mutex_key, "lock_mutex", 0},
+	{&lock_rec_mutex_key, "lock_rec_mutex", 0},
 	{&lock_sys_wait_mutex_key, "lock_wait_mutex", 0},
 	{&trx_mutex_key, "trx_mutex", 0},
 	{&srv_sys_tasks_mutex_key, "srv_threads_mutex", 0},
@@ -495,6 +508,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 #endif /* !HAVE_ATOMIC_BUILTINS_64 */
 	{&ut_list_mutex_key, "ut_list_mutex", 0},
 	{&trx_sys_mutex_key, "trx_sys_mutex", 0},
+	{&trx_rw_hash_mutex_key, "trx_rw_hash_mutex", 0},
 	{&zip_pad_mutex_key, "zip_pad_mutex", 0},
 };
 # endif /* UNIV_PFS_MUTEX */
@@ -517,6 +531,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	{&dict_operation_lock_key, "dict_operation_lock", 0},
 	{&fil_space_latch_key, "fil_space_latch", 0},
 	{&checkpoint_lock_key, "checkpoint_lock", 0},
+	{&lock_sys_latch_key, "lock_sys_latch", 0},
 	{&fts_cache_rw_lock_key, "fts_cache_rw_lock", 0},
 	{&fts_cache_init_rw_lock_key, "fts_cache_init_rw_lock", 0},
 	{&trx_i_s_cache_lock_key, "trx_i_s_cache_lock", 0},
@@ -543,6 +558,9 @@ static PSI_thread_info	all_innodb_threads[] = {
 	{&buf_page_cleaner_thread_key, "page_cleaner_thread", 0},
 	{&buf_lru_manager_thread_key, "lru_manager_thread", 0},
 	{&recv_writer_thread_key, "recv_writer_thread", 0},
+	{&recv_apply_thread_key, "recv_apply_thread", 0},
+	{&log_writer_thread_key, "log_writer_thread", 0},
+	{&log_flusher_thread_key, "log_flusher_thread", 0},
 	{&srv_log_tracking_thread_key, "srv_redo_log_follow_thread", 0}
 };
 # endif /* UNIV_PFS_THREAD */
@@ -951,6 +969,14 @@ static MYSQL_THDVAR_BOOL(table_locks, PLUGIN_VAR_OPCMDARG,
   /* check_func */ NULL, /* update_func */ NULL,
   /* default */ TRUE);
 
+static MYSQL_THDVAR_BOOL(release_locks_early, PLUGIN_VAR_OPCMDARG,
+  "Release the record locks of a transaction as soon as its commit order"
+  " has been determined in two-phase commit with the binary log, instead"
+  " of after the commit. Updates of frequently modified rows can then"
+  " proceed while the previous transaction is being written to the binary"
+  " log, and be committed in the same group.",
+  NULL, NULL, FALSE);
+
 static MYSQL_THDVAR_BOOL(strict_mode, PLUGIN_VAR_OPCMDARG,
   "Use strict mode when evaluating create options.",
   NULL, NULL, FALSE);
@@ -964,6 +990,10 @@ static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 1, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_ULONG(parallel_read_threads, PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index for SELECT COUNT(*) without a WHERE clause and for CHECK TABLE. 1 means that the rows are counted by the usual scan of the query.",
+  NULL, NULL, 1, 1, ROW_PREAD_MAX_THREADS, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
@@ -1012,6 +1042,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
   {"buffer_pool_load_status",
   (char*) &export_vars.innodb_buffer_pool_load_status,	  SHOW_CHAR},
+  {"buffer_pool_resize_status",
+  (char*) &export_vars.innodb_buffer_pool_resize_status,  SHOW_CHAR},
   {"buffer_pool_pages_data",
   (char*) &export_vars.innodb_buffer_pool_pages_data,	  SHOW_LONG},
   {"buffer_pool_pages_dirty",
@@ -1345,6 +1377,7 @@ innobase_close_connection(
 					which to close the connection */
 
 static void innobase_commit_ordered(handlerton *hton, THD* thd, bool all);
+static void innobase_prepare_ordered(handlerton *hton, THD* thd, bool all);
 static void innobase_checkpoint_request(handlerton *hton, void *cookie);
 
 /*****************************************************************//**
@@ -3775,6 +3808,7 @@ innobase_init(
 	innobase_hton->savepoint_rollback_can_release_mdl =
 				innobase_rollback_to_savepoint_can_release_mdl;
 	innobase_hton->savepoint_release = innobase_release_savepoint;
+	innobase_hton->prepare_ordered=innobase_prepare_ordered;
 	innobase_hton->commit_ordered=innobase_commit_ordered;
 	innobase_hton->commit = innobase_commit;
 	innobase_hton->rollback = innobase_rollback;
@@ -4440,13 +4474,16 @@ innobase_init(
 		goto mem_free_and_error;
 	}
 
+	/* The buffer pool size was aligned to the chunk size. */
+	innobase_buffer_pool_size = static_cast<long long>(srv_buf_pool_size);
+
 	/* Adjust the innodb_undo_logs config object */
 	innobase_undo_logs_init_default_max();
 
 	innobase_old_blocks_pct = static_cast<uint>(
 		buf_LRU_old_ratio_update(innobase_old_blocks_pct, TRUE));
 
-	ibuf_max_size_update(innobase_change_buffer_max_size);
+	ibuf_max_size_update(srv_change_buffer_max_size);
 
 	innobase_open_tables = hash_create(200);
 	mysql_mutex_init(innobase_share_mutex_key,
@@ -4839,6 +4876,57 @@ innobase_commit_ordered(
 	DBUG_VOID_RETURN;
 }
 
+/*****************************************************************//**
+Release the record locks of a prepared transaction early, if
+innodb_release_locks_early is set.
+
+This is called after a successful prepare, in the same order as
+innobase_commit_ordered(), so any transaction that is granted one of
+the released locks will also be committed after this one.
+
+Note that this method can be called from a different thread than
+the one handling the rest of the transaction. */
+static
+void
+innobase_prepare_ordered(
+/*=====================*/
+	handlerton *hton, /*!< in: Innodb handlerton */
+	THD*	thd,	/*!< in: MySQL thread handle of the user for whom
+			the transaction is being committed */
+	bool	all)	/*!< in:	TRUE - commit transaction
+				FALSE - the current SQL statement ended */
+{
+	DBUG_ENTER("innobase_prepare_ordered");
+	DBUG_ASSERT(hton == innodb_hton_ptr);
+
+	if (!THDVAR(thd, release_locks_early)) {
+		DBUG_VOID_RETURN;
+	}
+
+#ifdef WITH_WSREP
+	/* Galera determines the commit order by certification. */
+	if (wsrep_on(thd)) {
+		DBUG_VOID_RETURN;
+	}
+#endif /* WITH_WSREP */
+
+	trx_t*	trx = thd_to_trx(thd);
+
+	/* The transaction might not have been prepared in InnoDB, for
+	example if innodb_support_xa=OFF. */
+	if (trx == NULL || !trx_state_eq(trx, TRX_STATE_PREPARED)) {
+		DBUG_VOID_RETURN;
+	}
+
+	MONITOR_INC(MONITOR_RECLOCK_RELEASE_EARLY);
+
+	if (lock_release_rec_locks_early(trx)) {
+		MONITOR_INC(MONITOR_RECLOCK_RELEASE_EARLY_WAIT);
+	}
+
+	DBUG_VOID_RETURN;
+}
+
 /*****************************************************************//**
 Commits a transaction in an InnoDB database or marks an SQL statement
 ended.
@@ -5527,12 +5615,18 @@ ha_innobase::table_flags() const
 	/* Need to use tx_isolation here since table flags is (also)
 	called before prebuilt is inited. */
 	ulong const tx_isolation = thd_tx_isolation(ha_thd());
+	Table_flags flags = int_table_flags;
+
+	if (THDVAR(ha_thd(), parallel_read_threads) > 1) {
+		/* Count the rows for SELECT COUNT(*) in records(). */
+		flags |= HA_HAS_RECORDS;
+	}
 
 	if (tx_isolation <= ISO_READ_COMMITTED) {
-		return(int_table_flags);
+		return(flags);
 	}
 
-	return(int_table_flags | HA_BINLOG_STMT_CAPABLE);
+	return(flags | HA_BINLOG_STMT_CAPABLE);
 }
 
 /****************************************************************//**
@@ -10112,6 +10206,13 @@ ha_innobase::change_active_index(
 
 	prebuilt->index = innobase_get_index(keynr);
 
+	/* If the range optimizer estimated the number of rows in the
+	scanned range with records_in_range(), do not prefetch more rows
+	than that. */
+	prebuilt->fetch_cache_hint = keynr < MAX_KEY
+		&& table->quick_keys.is_set(keynr)
+		? static_cast<ulint>(table->quick_rows[keynr]) : 0;
+
 	if (UNIV_UNLIKELY(!prebuilt->index)) {
 		sql_print_warning("InnoDB: change_active_index(%u) failed",
 				  keynr);
@@ -13737,6 +13838,67 @@ ha_innobase::records_in_range(
 	DBUG_RETURN((ha_rows) n_rows);
 }
 
+/*********************************************************************//**
+Counts the rows of the table in the read view of the transaction by
+scanning the clustered index with innodb_parallel_read_threads threads.
+This is used for SELECT COUNT(*) without a WHERE clause.
+@return number of rows, or HA_POS_ERROR if the rows must be counted by
+reading them */
+UNIV_INTERN
+ha_rows
+ha_innobase::records()
+/*===================*/
+{
+	dict_index_t*	index;
+	trx_t*		trx;
+	ulint		n_rows;
+	dberr_t		err;
+
+	DBUG_ENTER("ha_innobase::records");
+
+	update_thd(ha_thd());
+
+	trx = prebuilt->trx;
+	index = dict_table_get_first_index(prebuilt->table);
+
+	/* A locking read must lock the rows, and the usual scan reports
+	the errors about a table that cannot be read. */
+	if (THDVAR(user_thd, parallel_read_threads) <= 1
+	    || prebuilt->select_lock_type != LOCK_NONE
+	    || index == NULL
+	    || dict_table_is_discarded(prebuilt->table)
+	    || prebuilt->table->ibd_file_missing
+	    || prebuilt->table->corrupted
+	    || dict_index_is_corrupted(index)
+	    || !row_merge_is_index_usable(trx, index)) {
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	trx->op_info = "counting records";
+
+	innobase_srv_conc_enter_innodb(trx);
+
+	trx_start_if_not_started(trx);
+
+	err = row_pread_count(
+		index, trx,
+		trx->isolation_level == TRX_ISO_READ_UNCOMMITTED
+		? NULL : trx_assign_read_view(trx),
+		THDVAR(user_thd, parallel_read_threads), &n_rows);
+
+	innobase_srv_conc_exit_innodb(trx);
+
+	trx->op_info = "";
+
+	if (err != DB_SUCCESS) {
+		/* The scan of the query will report the error, or
+		notice that the query was killed. */
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	DBUG_RETURN(n_rows);
+}
+
 /*********************************************************************//**
 Gives an UPPER BOUND to the number of rows in a table. This is used in
 filesort.cc.
@@ -14768,7 +14930,9 @@ ha_innobase::check(
 		prebuilt->select_lock_type = LOCK_NONE;
 
 		bool check_result
-			= row_check_index_for_mysql(prebuilt, index, &n_rows);
+			= row_check_index_for_mysql(
+				prebuilt, index,
+				THDVAR(thd, parallel_read_threads), &n_rows);
 		DBUG_EXECUTE_IF(
 				"dict_set_index_corrupted",
 				if (!(index->type & DICT_CLUSTERED)) {
@@ -15335,6 +15499,9 @@ ha_innobase::extra(
 	case HA_EXTRA_KEYREAD_PRESERVE_FIELDS:
 		prebuilt->keep_other_fields_on_keyread = 1;
 		break;
+	case HA_EXTRA_NO_CACHE:
+		prebuilt->fetch_cache_max_bytes = MYSQL_FETCH_CACHE_MAX_BYTES;
+		break;
 
 		/* IMPORTANT: prebuilt->trx can be obsolete in
 		this method, because it is not sure that MySQL
@@ -15361,6 +15528,26 @@ ha_innobase::extra(
 	return(0);
 }
 
+/*******************************************************************//**
+Tells the handler how much memory it may use for caching rows. For
+HA_EXTRA_CACHE, which is passed before a sequential scan, this limits the
+size of the row prefetch cache.
+@return	0 or error number */
+UNIV_INTERN
+int
+ha_innobase::extra_opt(
+/*===================*/
+	enum ha_extra_function operation,
+			   /*!< in: HA_EXTRA_CACHE */
+	ulong cache_size)  /*!< in: size of the cache, in bytes */
+{
+	if (operation == HA_EXTRA_CACHE) {
+		prebuilt->fetch_cache_max_bytes = cache_size;
+	}
+
+	return(extra(operation));
+}
+
 /******************************************************************//**
 */
 UNIV_INTERN
@@ -15381,6 +15568,8 @@ ha_innobase::reset()
 	/* This is a statement level counter. */
 	prebuilt->autoinc_last_value = 0;
 
+	prebuilt->fetch_cache_max_bytes = MYSQL_FETCH_CACHE_MAX_BYTES;
+
 	return(0);
 }
 
@@ -17974,9 +18163,9 @@ innodb_change_buffer_max_size_update(
 	const void*			save)	/*!< in: immediate result
 						from check function */
 {
-	innobase_change_buffer_max_size =
+	srv_change_buffer_max_size =
 			(*static_cast<const uint*>(save));
-	ibuf_max_size_update(innobase_change_buffer_max_size);
+	ibuf_max_size_update(srv_change_buffer_max_size);
 }
 
 #ifdef UNIV_DEBUG
@@ -19900,9 +20089,7 @@ wsrep_fake_trx_id(
 	handlerton	*hton,
 	THD		*thd)	/*!< in: user thread handle */
 {
-	mutex_enter(&trx_sys->mutex);
-	trx_id_t trx_id = trx_sys_get_new_trx_id();
-	mutex_exit(&trx_sys->mutex);
+	trx_id_t trx_id = trx_sys_get_new_trx_id_nowait();
 
 	wsrep_ws_handle_for_trx(wsrep_thd_ws_handle(thd), trx_id);
 }
@@ -20067,6 +20254,14 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   "Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_files, srv_doublewrite_files,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of files ib_doublewrite_<n> in the data home directory that "
+  "replace the doublewrite buffer in the system tablespace. Each buffer "
+  "pool instance writes through one of the files. 0 (the default) uses "
+  "the doublewrite buffer in the system tablespace.",
+  NULL, NULL, 0, 0, MAX_BUFFER_POOLS, 0);
+
 static MYSQL_SYSVAR_BOOL(use_atomic_writes, innobase_use_atomic_writes,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Prevent partial page writes, via atomic writes (beta). "
@@ -20145,6 +20340,15 @@ static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   1,			/* Minimum value */
   SRV_MAX_N_PURGE_THREADS, 0);		/* Maximum value */
 
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads applying redo log records to pages during crash"
+  " recovery. Default is 1.",
+  NULL, NULL,
+  1,			/* Default setting */
+  1,			/* Minimum value */
+  64, 0);		/* Maximum value */
+
 static MYSQL_SYSVAR_ULONG(sync_array_size, srv_sync_array_size,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Size of the mutex/lock wait array.",
@@ -20409,10 +20613,160 @@ static MYSQL_SYSVAR_ULONG(autoextend_increment, srv_auto_extend_increment,
   "Data file autoextend increment in megabytes",
   NULL, NULL, 64L, 1L, 1000L, 0);
 
+/****************************************************************//**
+Check if it is a valid value of innodb_buffer_pool_size, and reserve
+the resize of the buffer pool. This function is registered as a
+callback with MySQL.
+@return 0 for valid innodb_buffer_pool_size */
+static
+int
+innodb_buffer_pool_size_validate(
+/*=============================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to system
+						variable */
+	void*				save,	/*!< out: immediate result
+						for update function */
+	struct st_mysql_value*		value);	/*!< in: incoming value */
+
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_size, and request the
+buffer pool to be resized. This function is registered as a callback
+with MySQL. */
+static
+void
+innodb_buffer_pool_size_update(
+/*===========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	longlong	in_val = *static_cast<const longlong*>(save);
+
+	ut_snprintf(export_vars.innodb_buffer_pool_resize_status,
+		    sizeof(export_vars.innodb_buffer_pool_resize_status),
+		    "Requested to resize buffer pool.");
+
+	os_event_set(srv_buf_resize_event);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Requested to resize buffer pool."
+		" (new size: %lld bytes)", in_val);
+
+	innobase_buffer_pool_size = in_val;
+}
+
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
-  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  PLUGIN_VAR_RQCMDARG,
   "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
-  NULL, NULL, 128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+  innodb_buffer_pool_size_validate, innodb_buffer_pool_size_update,
+  128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_chunk_size, srv_buf_pool_chunk_unit,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Size of a single memory chunk within each buffer pool instance"
+  " for resizing buffer pool. Online buffer pool resizing happens"
+  " at this granularity.",
+  NULL, NULL, 128 * 1024 * 1024, 1024 * 1024, LONG_MAX, 1024 * 1024);
+
+/****************************************************************//**
+Check if it is a valid value of innodb_buffer_pool_size, and reserve
+the resize of the buffer pool. This function is registered as a
+callback with MySQL.
+@return 0 for valid innodb_buffer_pool_size */
+static
+int
+innodb_buffer_pool_size_validate(
+/*=============================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to system
+						variable */
+	void*				save,	/*!< out: immediate result
+						for update function */
+	struct st_mysql_value*		value)	/*!< in: incoming value */
+{
+	longlong	intbuf;
+
+	value->val_int(value, &intbuf);
+
+	if (!srv_was_started) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Cannot update innodb_buffer_pool_size,"
+				    " because InnoDB is not started.");
+		return(1);
+	}
+
+	if (srv_read_only_mode) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Cannot update innodb_buffer_pool_size"
+				    " in read-only mode.");
+		return(1);
+	}
+
+	if (intbuf < MYSQL_SYSVAR_NAME(buffer_pool_size).min_val) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size must be at least"
+				    " %lld.",
+				    MYSQL_SYSVAR_NAME(buffer_pool_size).min_val);
+		return(1);
+	}
+
+	buf_pool_mutex_enter_all();
+
+	if (srv_buf_pool_old_size != srv_buf_pool_size) {
+		buf_pool_mutex_exit_all();
+		my_printf_error(ER_WRONG_ARGUMENTS,
+				"Another buffer pool resize is already"
+				" in progress.", MYF(0));
+		return(1);
+	}
+
+	if (srv_buf_pool_instances > 1 && intbuf < 1024 * 1024 * 1024) {
+		buf_pool_mutex_exit_all();
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Cannot update innodb_buffer_pool_size"
+				    " to less than 1GB if"
+				    " innodb_buffer_pool_instances > 1.");
+		return(1);
+	}
+
+	ulint	requested_buf_pool_size
+		= buf_pool_size_align(static_cast<ulint>(intbuf));
+
+	*static_cast<longlong*>(save) = requested_buf_pool_size;
+
+	if (srv_buf_pool_size == requested_buf_pool_size) {
+		buf_pool_mutex_exit_all();
+		/* Nothing to do */
+		return(0);
+	}
+
+	/* Reserve the resize; buf_resize_thread() will perform it. */
+	srv_buf_pool_size = requested_buf_pool_size;
+
+	buf_pool_mutex_exit_all();
+
+	if (intbuf != static_cast<longlong>(requested_buf_pool_size)) {
+		char	buf[64];
+		int	len = 64;
+
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_TRUNCATED_WRONG_VALUE,
+				    "Truncated incorrect %-.32s value: '%-.128s'",
+				    "innodb_buffer_pool_size",
+				    value->val_str(value, buf, &len));
+	}
+
+	return(0);
+}
 
 static MYSQL_SYSVAR_BOOL(buffer_pool_populate, innodb_buffer_pool_populate,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -20557,6 +20911,19 @@ static MYSQL_SYSVAR_ENUM(lock_schedule_algorithm, innodb_lock_schedule_algorithm
   NULL, NULL, INNODB_LOCK_SCHEDULE_ALGORITHM_FCFS,
   &innodb_lock_schedule_algorithm_typelib);
 
+static MYSQL_SYSVAR_ENUM(deadlock_detect, innodb_deadlock_detect,
+  PLUGIN_VAR_RQCMDARG,
+  "How InnoDB detects deadlocks between transactions. Possible values are"
+  " OFF"
+    " rely on innodb_lock_wait_timeout;"
+  " ON"
+    " search the waits-for graph whenever a lock wait starts;"
+  " BACKGROUND"
+    " search the waits-for graph in a background thread"
+    " after lock waits have started.",
+  NULL, NULL, INNODB_DEADLOCK_DETECT_ON,
+  &innodb_deadlock_detect_typelib);
+
 static MYSQL_SYSVAR_LONG(buffer_pool_instances, innobase_buffer_pool_instances,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Number of buffer pool instances, set to higher value on high-end machines to increase scalability",
@@ -20752,6 +21119,11 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(sort_threads, srv_sort_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the table, sort the index entries and merge the sorted runs when creating secondary indexes. Each thread uses up to 3 times innodb_sort_buffer_size of memory.",
+  NULL, NULL, 1, 1, ROW_MERGE_MAX_THREADS, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -20788,6 +21160,19 @@ static MYSQL_SYSVAR_LONG(log_buffer_size, innobase_log_buffer_size,
   "The size of the buffer which InnoDB uses to write log to the log files on disk.",
   NULL, NULL, 16*1024*1024L, 256*1024L, LONG_MAX, 1024);
 
+static MYSQL_SYSVAR_BOOL(log_concurrent_copy, srv_log_concurrent_copy,
+  PLUGIN_VAR_OPCMDARG,
+  "Let mini-transactions copy their redo log records to the log buffer"
+  " after releasing the log mutex. Log writes then stop at the first"
+  " record that is still being copied.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use a dedicated thread for writing the log and another for flushing it."
+  " Committing transactions wait for them instead of doing the log i/o.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_LONGLONG(log_file_size, innobase_log_file_size,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Size of each log file in a log group.",
@@ -20972,7 +21357,7 @@ static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
   innodb_change_buffering_update, "all");
 
 static MYSQL_SYSVAR_UINT(change_buffer_max_size,
-  innobase_change_buffer_max_size,
+  srv_change_buffer_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum on-disk size of change buffer in terms of percentage"
   " of the buffer pool.",
@@ -21388,6 +21773,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(api_bk_commit_interval),
   MYSQL_SYSVAR(autoextend_increment),
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_chunk_size),
   MYSQL_SYSVAR(buffer_pool_populate),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(buffer_pool_filename),
@@ -21418,6 +21804,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_files),
   MYSQL_SYSVAR(api_enable_binlog),
   MYSQL_SYSVAR(api_enable_mdl),
   MYSQL_SYSVAR(api_disable_rowlock),
@@ -21447,8 +21834,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(large_prefix),
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(lock_schedule_algorithm),
+  MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(release_locks_early),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
+  MYSQL_SYSVAR(parallel_read_threads),
 #ifdef UNIV_LOG_ARCHIVE
   MYSQL_SYSVAR(log_arch_dir),
   MYSQL_SYSVAR(log_archive),
@@ -21456,6 +21846,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* UNIV_LOG_ARCHIVE */
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
+  MYSQL_SYSVAR(log_concurrent_copy),
+  MYSQL_SYSVAR(log_writer_threads),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_group_home_dir),
@@ -21494,6 +21886,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(sort_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -21536,6 +21929,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(monitor_reset),
   MYSQL_SYSVAR(monitor_reset_all),
   MYSQL_SYSVAR(purge_threads),
+  MYSQL_SYSVAR(recovery_apply_threads),
   MYSQL_SYSVAR(purge_batch_size),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(purge_run_now),
@@ -5181,10 +5181,12 @@ i_s_innodb_fill_buffer_pool(
 
 	heap = mem_heap_create(10000);
 
-	/* Go through each chunk of buffer pool. Currently, we only
-	have one single chunk for each buffer pool */
-	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+	/* Go through each chunk of buffer pool. The chunks may be
+	added or freed by buf_pool_resize() while we are not holding
+	buf_pool->LRU_list_mutex. */
+	for (ulint n = 0;; n++) {
 		const buf_block_t*	block;
+		const buf_block_t*	chunk_blocks;
 		ulint			n_blocks;
 		buf_page_info_t*	info_buffer;
 		ulint			num_page;
@@ -5193,8 +5195,19 @@ i_s_innodb_fill_buffer_pool(
 		ulint			num_to_process = 0;
 		ulint			block_id = 0;
 
+		buf_pool_mutex_enter(buf_pool);
+
+		if (n >= buf_pool->n_chunks) {
+			buf_pool_mutex_exit(buf_pool);
+			break;
+		}
+
 		/* Get buffer block of the nth chunk */
-		block = buf_get_nth_chunk_block(buf_pool, n, &chunk_size);
+		block = chunk_blocks = buf_get_nth_chunk_block(
+			buf_pool, n, &chunk_size);
+
+		buf_pool_mutex_exit(buf_pool);
+
 		num_page = 0;
 
 		while (chunk_size > 0) {
@@ -5211,6 +5224,18 @@ i_s_innodb_fill_buffer_pool(
 			info_buffer = (buf_page_info_t*) mem_heap_zalloc(
 				heap, mem_size);
 
+			/* buf_pool->LRU_list_mutex prevents
+			buf_pool_resize() from freeing the chunk while
+			we are accessing it */
+			buf_pool_mutex_enter(buf_pool);
+
+			if (n >= buf_pool->n_chunks
+			    || buf_pool->chunks[n].blocks != chunk_blocks) {
+				/* The chunk was freed by buf_pool_resize(). */
+				buf_pool_mutex_exit(buf_pool);
+				break;
+			}
+
 			/* GO through each block in the chunk */
 			for (n_blocks = num_to_process; n_blocks--; block++) {
 				i_s_innodb_buffer_page_get_info(
@@ -5220,6 +5245,8 @@ i_s_innodb_fill_buffer_pool(
 				num_page++;
 			}
 
+			buf_pool_mutex_exit(buf_pool);
+
 			/* Fill in information schema table with information
 			just collected from the buffer chunk scan */
 			status = i_s_innodb_buffer_page_fill(
@@ -47,6 +47,14 @@ UNIV_INTERN
 void
 btr_search_sys_free(void);
 /*=====================*/
+/*****************************************************************//**
+Resizes the hash tables of the adaptive search system after the
+buffer pool was resized. The adaptive hash index must be disabled. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
 
 /********************************************************************//**
 Disable the adaptive hash search system and empty the index. */
@@ -244,6 +252,38 @@ void
 btr_search_x_unlock_all(void);
 /*==========================*/
 
+/********************************************************************//**
+Latches the adaptive hash index partition of an index in shared mode. */
+UNIV_INLINE
+void
+btr_search_s_lock(
+/*==============*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/********************************************************************//**
+Unlatches the adaptive hash index partition of an index in shared mode. */
+UNIV_INLINE
+void
+btr_search_s_unlock(
+/*================*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/********************************************************************//**
+Latches the adaptive hash index partition of an index in exclusive mode. */
+UNIV_INLINE
+void
+btr_search_x_lock(
+/*==============*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/********************************************************************//**
+Unlatches the adaptive hash index partition of an index in exclusive mode. */
+UNIV_INLINE
+void
+btr_search_x_unlock(
+/*================*/
+	const dict_index_t*	index);	/*!< in: index */
+
 #ifdef UNIV_SYNC_DEBUG
 /******************************************************************//**
 Checks if the thread has locked all the adaptive hash index latches in the
@@ -66,6 +66,9 @@ extern char	btr_search_enabled;
 /** Number of adaptive hash index partitions */
 extern ulint	btr_search_index_num;
 
+/** Maximum number of adaptive hash index partitions */
+#define BTR_SEARCH_MAX_PARTITIONS	64
+
 #ifdef UNIV_BLOB_DEBUG
 # include "buf0types.h"
 /** An index->blobs entry for keeping track of off-page column references */
@@ -92,6 +92,15 @@ extern ibool		buf_debug_prints;/*!< If this is set TRUE, the program
 #endif /* UNIV_DEBUG */
 extern ulint srv_buf_pool_instances;
 extern ulint srv_buf_pool_curr_size;
+extern ulong srv_buf_pool_chunk_unit;
+
+/** true when blocks are being withdrawn from the buffer pool
+by buf_pool_resize(); pages may be relocated while it is set */
+extern volatile bool	buf_pool_withdrawing;
+/** incremented every time buf_pool_resize() has withdrawn blocks;
+a block pointer that was obtained before that must not be
+dereferenced, because the block may have been freed */
+extern volatile ulint	buf_withdraw_clock;
 #else /* !UNIV_HOTBACKUP */
 extern buf_block_t*	back_block1;	/*!< first block, for --apply-log */
 extern buf_block_t*	back_block2;	/*!< second block, for page reorganize */
@@ -206,6 +215,19 @@ struct buf_pools_list_size_t {
 };
 
 #ifndef UNIV_HOTBACKUP
+/********************************************************************//**
+Acquire LRU list mutex on all buffer pool instances */
+UNIV_INLINE
+void
+buf_pool_mutex_enter_all(void);
+/*===========================*/
+
+/********************************************************************//**
+Release LRU list mutex on all buffer pool instances */
+UNIV_INLINE
+void
+buf_pool_mutex_exit_all(void);
+/*==========================*/
 
 /********************************************************************//**
 Creates the buffer pool.
@@ -232,6 +254,62 @@ void
 buf_pool_clear_hash_index(void);
 /*===========================*/
 
+/********************************************************************//**
+Calculates the size of the buffer pool that will actually be allocated
+for the requested size, which is rounded up to a multiple of
+innodb_buffer_pool_chunk_size * innodb_buffer_pool_instances.
+@return	aligned size in bytes */
+UNIV_INLINE
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size);	/*!< in: requested size in bytes */
+
+/********************************************************************//**
+Checks if a block pointer that was stored earlier may still be
+dereferenced, or if the block may have been freed by resizing the
+buffer pool.
+@return	true if the block must not be dereferenced */
+UNIV_INLINE
+bool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock);/*!< in: buf_withdraw_clock at the time
+				the block pointer was stored */
+
+/********************************************************************//**
+Checks if a block is in a chunk that is going to be freed by
+buf_pool_resize(), so that it must be withdrawn rather than reused.
+@return	true if the block should be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block);		/*!< in: block */
+
+/********************************************************************//**
+Checks if a pointer is in a chunk that is going to be freed by
+buf_pool_resize().
+@return	true if the memory should be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr);		/*!< in: pointer to a frame */
+
+/********************************************************************//**
+This is the thread for resizing the buffer pool. It waits for an event
+and when waked up either performs a resizing and sleeps again.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /********************************************************************//**
 Relocate a buffer control block.  Relocates the block on the LRU list
 and in buf_pool->page_hash.  Does not relocate bpage->list.
@@ -1710,7 +1788,7 @@ struct buf_page_t{
 					in one of the following lists in
 					buf_pool:
 
-					- BUF_BLOCK_NOT_USED:	free
+					- BUF_BLOCK_NOT_USED:	free, withdraw
 					- BUF_BLOCK_FILE_PAGE:	flush_list
 					- BUF_BLOCK_ZIP_DIRTY:	flush_list
 					- BUF_BLOCK_ZIP_PAGE:	zip_clean
@@ -1831,6 +1909,9 @@ struct buf_block_t{
 	ibool		in_unzip_LRU_list;/*!< TRUE if the page is in the
 					decompressed LRU list;
 					used in debugging */
+	ibool		in_withdraw_list;/*!< TRUE if the block is in
+					buf_pool->withdraw;
+					used in debugging */
 #endif /* UNIV_DEBUG */
 	ib_mutex_t	mutex;		/*!< mutex protecting this block:
 					state, io_fix, buf_fix_count,
@@ -2050,7 +2131,19 @@ struct buf_pool_t{
 					the buffer pool to the buddy system */
 #endif
 	ulint		n_chunks;	/*!< number of buffer pool chunks */
-	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
+	ulint		n_chunks_new;	/*!< number of buffer pool chunks
+					after the resize that is in
+					progress; equals n_chunks otherwise */
+	buf_chunk_t*	chunks;		/*!< buffer pool chunks; the array
+					may be read without holding any
+					mutex, by reading n_chunks first.
+					When the buffer pool grows, it is
+					replaced by a bigger array before
+					n_chunks is incremented */
+	buf_chunk_t*	chunks_old;	/*!< the array that chunks replaced
+					on the last resize, or NULL; it is
+					freed on the next resize, when no
+					thread can be reading it any more */
 	ulint		curr_size;	/*!< current pool size in pages */
 	ulint		read_ahead_area;/*!< size in pages of the area which
 					the read-ahead algorithms read if
@@ -2157,6 +2250,20 @@ struct buf_pool_t{
 	UT_LIST_BASE_NODE_T(buf_page_t) free;
 					/*!< base node of the free
 					block list */
+
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the withdrawn
+					block list. While the buffer pool
+					is being shrunk, the free blocks of
+					the chunks that are going to be
+					freed are moved here instead of
+					the free list. Protected by
+					free_list_mutex */
+	ulint		withdraw_target;/*!< number of blocks in the
+					chunks that are going to be
+					freed, or 0 if the buffer pool
+					is not being shrunk. Protected by
+					free_list_mutex and LRU_list_mutex */
 	UT_LIST_BASE_NODE_T(buf_page_t) LRU;
 					/*!< base node of the LRU list */
 	buf_page_t*	LRU_old;	/*!< pointer to the about
@@ -2240,6 +2347,15 @@ Use these instead of accessing buffer pool mutexes directly. */
 # define buf_page_hash_lock_get(b, f)			\
 	hash_get_lock(b->page_hash, f)
 
+/** If the page_hash was resized while the lock was being acquired,
+relatch the appropriate page_hash_lock. This is not needed when
+holding buf_pool->LRU_list_mutex. */
+# define buf_page_hash_lock_s_confirm(l, b, f)		\
+	hash_lock_s_confirm(l, (b)->page_hash, f)
+
+# define buf_page_hash_lock_x_confirm(l, b, f)		\
+	hash_lock_x_confirm(l, (b)->page_hash, f)
+
 #ifdef UNIV_SYNC_DEBUG
 /** Test if page_hash lock is held in s-mode. */
 # define buf_page_hash_lock_held_s(b, p)		\
@@ -36,6 +36,11 @@ Created 2011/12/19 Inaam Rana
 
 /** Doublewrite system */
 extern buf_dblwr_t*	buf_dblwr;
+/** Doublewrite files that are used instead of the doublewrite buffer in
+the system tablespace when innodb_doublewrite_files > 0, or NULL */
+extern buf_dblwr_t*	buf_dblwr_files;
+/** Number of elements in buf_dblwr_files */
+extern ulint		buf_dblwr_n_files;
 /** Set to TRUE when the doublewrite buffer is being created */
 extern ibool		buf_dblwr_being_created;
 
@@ -106,8 +111,12 @@ and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
 UNIV_INTERN
 void
-buf_dblwr_flush_buffered_writes(void);
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	const buf_pool_t*	buf_pool);	/*!< in: buffer pool instance
+						whose writes to flush, or NULL
+						to flush the writes of all
+						instances */
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -157,6 +166,12 @@ struct buf_dblwr_t{
 	buf_page_t**	buf_block_arr;/*!< array to store pointers to
 				the buffer blocks which have been
 				cached to write_buf */
+	char*		name;	/*!< path of the doublewrite file, or
+				NULL if the doublewrite buffer is in
+				the system tablespace (block1, block2) */
+	os_file_t	file;	/*!< handle of the doublewrite file;
+				the slots of write_buf are written to
+				the same offsets in the file */
 };
 
 
@@ -534,6 +534,30 @@ hash_unlock_x_all_but(
 /*==================*/
 	hash_table_t*	table,		/*!< in: hash table */
 	prio_rw_lock_t*	keep_lock);	/*!< in: lock to keep */
+/************************************************************//**
+Checks that an s-latched lock still protects a fold value in a hash
+table whose number of cells may have been changed while the lock was
+being acquired, and relatches the appropriate lock if not.
+@return	s-latched lock protecting the fold value */
+UNIV_INTERN
+prio_rw_lock_t*
+hash_lock_s_confirm(
+/*================*/
+	prio_rw_lock_t*	hash_lock,	/*!< in: s-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold */
+/************************************************************//**
+Checks that an x-latched lock still protects a fold value in a hash
+table whose number of cells may have been changed while the lock was
+being acquired, and relatches the appropriate lock if not.
+@return	x-latched lock protecting the fold value */
+UNIV_INTERN
+prio_rw_lock_t*
+hash_lock_x_confirm(
+/*================*/
+	prio_rw_lock_t*	hash_lock,	/*!< in: x-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold */
 
 #else /* !UNIV_HOTBACKUP */
 # define hash_get_heap(table, fold)	((table)->heap)
@@ -389,8 +389,8 @@ struct recv_dblwr_t {
 struct recv_sys_t{
 #ifndef UNIV_HOTBACKUP
 	ib_mutex_t		mutex;	/*!< mutex protecting the fields apply_log_recs,
-				n_addrs, and the state field in each recv_addr
-				struct */
+				n_addrs, apply_cell, n_apply_threads, and the
+				state field in each recv_addr struct */
 	ib_mutex_t		writer_mutex;/*!< mutex coordinating
 				flushing between recv_writer_thread and
 				the recovery thread. */
@@ -449,6 +449,16 @@ struct recv_sys_t{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+#ifndef UNIV_HOTBACKUP
+	ulint		apply_cell;/*!< next cell of addr_hash to be
+				handed out to a log apply thread in
+				recv_apply_hashed_log_recs() */
+	ulint		n_apply_threads;/*!< number of additional log
+				apply threads which have not yet finished
+				the current batch */
+	os_event_t	apply_done_event;/*!< set when the last additional
+				log apply thread has finished the batch */
+#endif /* !UNIV_HOTBACKUP */
 
 	recv_dblwr_t	dblwr;
 };
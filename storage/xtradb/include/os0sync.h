@@ -469,6 +469,11 @@ compare to, new_val is the value to swap in. */
 #  define os_compare_and_swap_uint32(ptr, old_val, new_val) \
 	os_compare_and_swap(ptr, old_val, new_val)
 
+# ifdef HAVE_ATOMIC_BUILTINS_64
+#  define os_compare_and_swap_uint64(ptr, old_val, new_val) \
+	os_compare_and_swap(ptr, old_val, new_val)
+# endif /* HAVE_ATOMIC_BUILTINS_64 */
+
 # ifdef HAVE_IB_ATOMIC_PTHREAD_T_GCC
 #  define os_compare_and_swap_thread_id(ptr, old_val, new_val) \
 	os_compare_and_swap(ptr, old_val, new_val)
@@ -613,6 +618,9 @@ compare to, new_val is the value to swap in. */
 # define os_compare_and_swap_lint(ptr, old_val, new_val) \
 	((lint) atomic_cas_ulong((ulong_t*) ptr, old_val, new_val) == old_val)
 
+# define os_compare_and_swap_uint64(ptr, old_val, new_val) \
+	(atomic_cas_64(ptr, old_val, new_val) == old_val)
+
 # ifdef HAVE_IB_ATOMIC_PTHREAD_T_SOLARIS
 #  if SIZEOF_PTHREAD_T == 4
 #   define os_compare_and_swap_thread_id(ptr, old_val, new_val) \
@@ -783,6 +791,12 @@ compare to, new_val is the value to swap in. */
 # define os_compare_and_swap_lint(ptr, old_val, new_val) \
 	(win_cmp_and_xchg_lint(ptr, new_val, old_val) == old_val)
 
+# define os_compare_and_swap_uint64(ptr, old_val, new_val)		\
+	((ib_uint64_t) InterlockedCompareExchange64(			\
+				(volatile ib_int64_t*) ptr,		\
+				(ib_int64_t) new_val,			\
+				(ib_int64_t) old_val) == old_val)
+
 /* windows thread objects can always be passed to windows atomic functions */
 # define os_compare_and_swap_thread_id(ptr, old_val, new_val) \
 	(win_cmp_and_xchg_dword(ptr, new_val, old_val) == old_val)
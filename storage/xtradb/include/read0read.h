@@ -71,6 +71,19 @@ read_view_add(
 /*==========*/
 	read_view_t*	view);		/*!< in: view to add to */
 /*********************************************************************//**
+Reopens a read view of a transaction that was closed at the end of an
+earlier statement or transaction, if no read-write transaction has started
+or ended since the view was opened. The view then sees exactly what a new
+view would see, and the active transaction ids need not be copied again.
+@return	true if the view was reopened */
+UNIV_INTERN
+bool
+read_view_reopen(
+/*=============*/
+	read_view_t*	view,	/*!< in/out: closed read view */
+	const trx_t*	trx)	/*!< in: transaction that opens the view */
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/*********************************************************************//**
 Makes a copy of the oldest existing read view, or opens a new. The view
 must be closed with ..._close.
 @return	own: read view struct */
@@ -195,6 +208,10 @@ struct read_view_t{
 	trx_id_t	creator_trx_id;
 				/*!< trx id of creating transaction, or
 				0 used in purge */
+	ulint		rw_trx_version;
+				/*!< trx_sys->rw_trx_version when the
+				view was opened, or ULINT_UNDEFINED
+				if the view must not be reopened */
 	UT_LIST_NODE_T(read_view_t) view_list;
 				/*!< List of read views in trx_sys */
 };
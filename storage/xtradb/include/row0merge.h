@@ -44,6 +44,10 @@ Created 13/06/2005 Jan Lindstrom
 /* Reserve free space from every block for key_version */
 #define ROW_MERGE_RESERVE_SIZE 4
 
+/* Maximum number of threads that read, sort and merge when creating
+indexes (innodb_sort_threads) */
+#define ROW_MERGE_MAX_THREADS 64
+
 /* Cluster index read task is mandatory */
 #define COST_READ_CLUSTERED_INDEX            1.0
 
@@ -402,7 +406,10 @@ row_merge_sort(
 	const float		pct_cost, /*!< in: current progress percent */
 	fil_space_crypt_t*	crypt_data,/*!< in: table crypt data */
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
-	ulint			space)	   /*!< in: space id */
+	ulint			space,	   /*!< in: space id */
+	ulint			n_threads) /*!< in: number of threads that
+					   merge, at most
+					   ROW_MERGE_MAX_THREADS */
 	__attribute__((nonnull(1,2,3,4,5)));
 /*********************************************************************//**
 Allocate a sort buffer.
@@ -564,6 +564,9 @@ row_check_index_for_mysql(
 	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
 						in MySQL handle */
 	const dict_index_t*	index,		/*!< in: index */
+	ulint			n_threads,	/*!< in: number of threads
+						that may scan a clustered
+						index */
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
@@ -659,9 +662,15 @@ struct mysql_row_templ_t {
 					it is an unsigned integer type */
 };
 
+/* Number of rows in the first batch that is prefetched to fetch_cache */
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
+/* Maximum number of rows in a batch that is prefetched to fetch_cache */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	512
+/* Default limit for the memory of fetch_cache, in bytes; a sequential
+scan can change it with HA_EXTRA_CACHE */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(128 * 1024)
 
 #define ROW_PREBUILT_ALLOCATED	78540783
 #define ROW_PREBUILT_FREED	26423527
@@ -836,16 +845,35 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte**		fetch_cache;
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
-					batch; we reserve mysql_row_len
+					batch; this is an array of
+					fetch_cache_size pointers, followed
+					by the rows in the same memory
+					block; we reserve mysql_row_len
 					bytes for each such row; these
 					pointers point 4 bytes past the
-					allocated mem buf start, because
+					start of the row slot, because
 					there is a 4 byte magic number at the
 					start and at the end */
+	ulint		fetch_cache_size;/*!< number of rows allocated
+					in fetch_cache; the cache is kept
+					for the lifetime of the handle and
+					only grows */
+	ulint		fetch_cache_limit;/*!< number of rows to prefetch
+					in a batch; starts from
+					MYSQL_FETCH_CACHE_SIZE when the
+					cursor is positioned and doubles
+					after every batch that was read to
+					the end */
+	ulint		fetch_cache_max_bytes;/*!< limit for the size
+					of fetch_cache, in bytes */
+	ulint		fetch_cache_hint;/*!< number of rows that the
+					optimizer expects to read with the
+					current index (from records_in_range),
+					or 0 if not known */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
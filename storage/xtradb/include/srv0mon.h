@@ -130,9 +130,14 @@ enum monitor_id_t {
 	/* Lock manager related counters */
 	MONITOR_MODULE_LOCK,
 	MONITOR_DEADLOCK,
+	MONITOR_DEADLOCK_BACKGROUND,
+	MONITOR_DEADLOCK_CHECK,
+	MONITOR_DEADLOCK_CHECK_MICROSECOND,
 	MONITOR_TIMEOUT,
 	MONITOR_LOCKREC_WAIT,
 	MONITOR_TABLELOCK_WAIT,
+	MONITOR_RECLOCK_RELEASE_EARLY,
+	MONITOR_RECLOCK_RELEASE_EARLY_WAIT,
 	MONITOR_NUM_RECLOCK_REQ,
 	MONITOR_RECLOCK_CREATED,
 	MONITOR_RECLOCK_REMOVED,
@@ -275,6 +280,10 @@ enum monitor_id_t {
 	MONITOR_TRX_ROLLBACK_SAVEPOINT,
 	MONITOR_TRX_ROLLBACK_ACTIVE,
 	MONITOR_TRX_ACTIVE,
+	MONITOR_TRX_SYS_MUTEX_WAIT,
+	MONITOR_TRX_ID_NOWAIT,
+	MONITOR_TRX_RW_HASH_LOOKUP,
+	MONITOR_TRX_RW_HASH_MUTEX_WAIT,
 	MONITOR_RSEG_HISTORY_LEN,
 	MONITOR_NUM_UNDO_SLOT_USED,
 	MONITOR_NUM_UNDO_SLOT_CACHED,
@@ -306,6 +315,13 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WAITS,
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
+	MONITOR_LOG_MUTEX_WAITS,
+	MONITOR_LOG_CONCURRENT_COPIES,
+	MONITOR_LOG_COPY_SLOTS_FULL,
+	MONITOR_LOG_COPY_WAITS,
+	MONITOR_LOG_PARTIAL_WRITES,
+	MONITOR_LOG_WRITER_SPIN_WAITS,
+	MONITOR_LOG_WRITER_EVENT_WAITS,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
@@ -352,6 +368,12 @@ enum monitor_id_t {
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
 	MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+	/* Per-partition counters, see MONITOR_AHI_PART_SEARCH(). There
+	are 3 counters for each of the BTR_SEARCH_MAX_PARTITIONS (64)
+	partitions; srv0mon.cc checks that the numbers match. */
+	MONITOR_ADAPTIVE_HASH_PARTITION,
+	MONITOR_ADAPTIVE_HASH_PARTITION_LAST = MONITOR_ADAPTIVE_HASH_PARTITION
+		+ 3 * 64 - 1,
 
 	/* Tablespace related counters */
 	MONITOR_MODULE_FIL_SYSTEM,
@@ -425,6 +447,15 @@ enum monitor_id_t {
 	NUM_MONITOR
 };
 
+/** Counters of the adaptive hash index partition p: successful searches,
+searches that fell back to the B-tree, and waits for the partition latch */
+#define MONITOR_AHI_PART_SEARCH(p)					\
+	static_cast<monitor_id_t>(MONITOR_ADAPTIVE_HASH_PARTITION + 3 * (p))
+#define MONITOR_AHI_PART_SEARCH_BTREE(p)				\
+	static_cast<monitor_id_t>(MONITOR_ADAPTIVE_HASH_PARTITION + 3 * (p) + 1)
+#define MONITOR_AHI_PART_LATCH_WAITS(p)					\
+	static_cast<monitor_id_t>(MONITOR_ADAPTIVE_HASH_PARTITION + 3 * (p) + 2)
+
 /** This informs the monitor control system to turn
 on/off and reset monitor counters through wild card match */
 #define	MONITOR_WILDCARD_MATCH		(NUM_MONITOR + 1)
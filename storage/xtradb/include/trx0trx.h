@@ -663,6 +663,16 @@ struct trx_lock_t {
 					mutex to prevent recursive deadlocks.
 					Protected by both the lock sys mutex
 					and the trx_t::mutex. */
+	bool		released_early;	/*!< true if the record locks of
+					the prepared transaction were
+					released by
+					lock_release_rec_locks_early()
+					before the commit. Implicit locks
+					of the transaction are then no longer
+					converted to explicit ones. Written
+					while holding lock_sys->latch and the
+					trx_t::mutex; read while holding
+					either one exclusively. */
 };
 
 #define TRX_MAGIC_N	91118598
@@ -930,6 +940,9 @@ struct trx_t{
 	ibool		in_rw_trx_list;	/*!< TRUE if in trx_sys->rw_trx_list */
 	/* @} */
 #endif /* UNIV_DEBUG */
+	trx_t*		rw_trx_hash;	/*!< hash chain node in
+					trx_sys->rw_trx_hash; protected by
+					trx_rw_hash_get_mutex(id) */
 	UT_LIST_NODE_T(trx_t)
 			mysql_trx_list;	/*!< list of transactions created for
 					MySQL; protected by trx_sys->mutex */
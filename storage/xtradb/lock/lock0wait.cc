@@ -287,6 +287,11 @@ lock_wait_suspend_thread(
 	lock_wait_mutex_exit();
 	trx_mutex_exit(trx);
 
+	if (innodb_deadlock_detect == INNODB_DEADLOCK_DETECT_BACKGROUND) {
+		/* Wake up lock_wait_timeout_thread to look for deadlocks. */
+		os_event_set(lock_sys->timeout_event);
+	}
+
 	ulint	lock_type = ULINT_UNDEFINED;
 
 	lock_mutex_enter();
@@ -426,13 +431,14 @@ lock_wait_release_thread_if_suspended(
 	que_thr_t*	thr)	/*!< in: query thread associated with the
 				user OS thread	 */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_latch_own());
 	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 
-	/* We own both the lock mutex and the trx_t::mutex but not the
-	lock wait mutex. This is OK because other threads will see the state
-	of this slot as being in use and no other thread can change the state
-	of the slot to free unless that thread also owns the lock mutex. */
+	/* We own both the lock_sys->latch (possibly in shared mode) and
+	the trx_t::mutex but not the lock wait mutex. This is OK because
+	other threads will see the state of this slot as being in use and
+	no other thread can change the state of the slot to free unless that
+	thread owns the lock_sys->latch in exclusive mode. */
 
 	if (thr->slot != NULL && thr->slot->in_use && thr->slot->thr == thr) {
 		trx_t*	trx = thr_get_trx(thr);
@@ -507,7 +513,8 @@ lock_wait_check_and_cancel(
 }
 
 /*********************************************************************//**
-A thread which wakes up threads whose lock wait may have lasted too long.
+A thread which wakes up threads whose lock wait may have lasted too long,
+and looks for deadlocks if innodb_deadlock_detect=BACKGROUND.
 @return	a dummy parameter */
 extern "C" UNIV_INTERN
 os_thread_ret_t
@@ -537,6 +544,11 @@ DECLARE_THREAD(lock_wait_timeout_thread)(void*)
 
 		lock_wait_mutex_enter();
 
+		if (innodb_deadlock_detect
+		    == INNODB_DEADLOCK_DETECT_BACKGROUND) {
+			lock_deadlock_check_background();
+		}
+
 		/* Check all slots for user threads that are waiting
 	       	on locks, and if they have exceeded the time limit. */
 
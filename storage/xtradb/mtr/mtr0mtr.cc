@@ -273,7 +273,7 @@ mtr_log_reserve_and_write(
 			return;
 		}
 	} else {
-		mutex_enter(&log_sys->mutex);
+		log_mutex_enter_for_append();
 	}
 
 	data_size = dyn_array_get_data_size(mlog);
@@ -282,6 +282,32 @@ mtr_log_reserve_and_write(
 	mtr->start_lsn = log_open(data_size);
 
 	if (mtr->log_mode == MTR_LOG_ALL) {
+		log_copy_slot_t*	slot = srv_log_concurrent_copy
+			? log_reserve_for_copy(data_size) : NULL;
+
+		if (slot != NULL) {
+			/* Copy the log records after releasing the log
+			mutex. The pages stay latched until the copy has
+			completed, and log_write_up_to() waits for it
+			before writing past start_lsn. */
+			mtr->end_lsn = log_close();
+
+			mtr_add_dirtied_pages_to_flush_list(mtr);
+
+			for (dyn_block_t* block = mlog;
+			     block != 0;
+			     block = dyn_array_get_next_block(mlog, block)) {
+
+				log_copy_low(
+					slot,
+					dyn_block_get_data(block),
+					dyn_block_get_used(block));
+			}
+
+			log_copy_complete(slot);
+
+			return;
+		}
 
 		for (dyn_block_t* block = mlog;
 		     block != 0;
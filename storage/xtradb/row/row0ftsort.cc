@@ -923,7 +923,8 @@ fts_parallel_tokenization(
 				       psort_info->psort_common->dup,
 				       merge_file[i], block[i], &tmpfd[i],
 				       false, 0.0/* pct_progress */, 0.0/* pct_cost */,
-				       crypt_data, crypt_block[i], table->space);
+				       crypt_data, crypt_block[i], table->space,
+				       1);
 
 		if (error != DB_SUCCESS) {
 			close(tmpfd[i]);
@@ -43,6 +43,7 @@ Completed by Sunny Bains and Marko Makela
 #include "ha_prototypes.h"
 #include "math.h" /* log2() */
 #include "fil0crypt.h"
+#include "row0pread.h"
 
 float my_log2f(float n)
 {
@@ -734,9 +735,10 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (os_atomic_increment_ulint(&dup->n_dup, 1) == 1) {
 		/* Only report the first duplicate record,
-		but count all duplicate records. */
+		but count all duplicate records. The threads of
+		row_merge_read_clustered_index_parallel() share dup. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
 	}
 }
@@ -1439,6 +1441,419 @@ row_merge_file_create_if_needed(
 	return(file->fd);
 }
 
+/** Context of a parallel scan of the clustered index that creates the
+temporary files for row_merge_read_clustered_index(). */
+struct row_merge_pread_t {
+	trx_t*			trx;	/*!< transaction */
+	const dict_table_t*	table;	/*!< the table; the indexes are
+					created without rebuilding it */
+	dict_index_t**		index;	/*!< indexes to be created */
+	merge_file_t*		files;	/*!< temporary files; the blocks
+					are appended to them by all
+					threads */
+	row_merge_dup_t*	dups;	/*!< for reporting duplicates in
+					each index; shared by the threads */
+	ulint			n_index;/*!< number of indexes */
+	fil_space_crypt_t*	crypt_data;/*!< crypt data or NULL */
+	os_thread_id_t		thread;	/*!< the thread that runs the
+					ALTER TABLE */
+	ib_int64_t		total_rows;/*!< estimated number of rows */
+	float			pct_cost;/*!< percent of task weight */
+	ulint			n_rows;	/*!< number of rows read so far;
+					protected by atomic operations */
+	ulint			error_key_num;/*!< the index that failed */
+};
+
+/** State of one range of the parallel scan. The buffers are allocated
+when the first row of the range is read, and freed at the end of the
+range, so that only the ranges that are being scanned use memory. */
+struct row_merge_pread_range_t {
+	row_merge_pread_t*	ctx;	/*!< the parallel scan */
+	row_merge_buf_t**	merge_buf;/*!< sort buffers for each index,
+					or NULL */
+	mem_heap_t*		row_heap;/*!< heap for the rows */
+	row_merge_block_t*	block;	/*!< buffer for writing a block */
+	row_merge_block_t*	crypt_block;/*!< buffer for encrypting a
+					block, or NULL */
+	ulint			block_size;/*!< size of block and
+					crypt_block */
+};
+
+/** Sort the buffer of an index for a range of a parallel clustered
+index scan, and append it to the temporary file as one block.
+@param[in,out]	range	range of the scan
+@param[in]	i	index number
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+row_merge_pread_write(
+	row_merge_pread_range_t*	range,
+	ulint				i)
+{
+	row_merge_pread_t*	ctx	= range->ctx;
+	row_merge_buf_t*	buf	= range->merge_buf[i];
+	merge_file_t*		file	= &ctx->files[i];
+
+	if (!buf->n_tuples) {
+		return(DB_SUCCESS);
+	}
+
+	if (dict_index_is_unique(buf->index)) {
+		row_merge_buf_sort(buf, &ctx->dups[i]);
+
+		if (ctx->dups[i].n_dup) {
+			ctx->error_key_num = i;
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, file, range->block);
+
+	/* The blocks of the threads are appended in any order. Each
+	block is a sorted run for row_merge_sort(). */
+	if (!row_merge_write(file->fd,
+			     os_atomic_increment_ulint(&file->offset, 1) - 1,
+			     range->block, ctx->crypt_data,
+			     range->crypt_block, ctx->table->space)) {
+		ctx->error_key_num = i;
+		return(DB_TEMP_FILE_WRITE_FAILURE);
+	}
+
+	os_atomic_increment_uint64(&file->n_rec, buf->n_tuples);
+
+	UNIV_MEM_INVALID(&range->block[0], srv_sort_buf_size);
+
+	range->merge_buf[i] = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/** Add a row to the sort buffers of a range of a parallel clustered
+index scan. This is a row_pread_func_t.
+@param[in]	rec	clustered index record in the read view
+@param[in]	offsets	rec_get_offsets(rec)
+@param[in,out]	arg	the range (row_merge_pread_range_t)
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_pread_rec(
+	const rec_t*	rec,
+	const ulint*	offsets,
+	void*		arg)
+{
+	row_merge_pread_range_t*range	= static_cast<
+		row_merge_pread_range_t*>(arg);
+	row_merge_pread_t*	ctx	= range->ctx;
+	const dtuple_t*		row;
+	row_ext_t*		ext;
+	dberr_t			err	= DB_SUCCESS;
+	ulint			n_rows;
+
+	if (range->merge_buf == NULL) {
+		range->block_size = srv_sort_buf_size;
+		range->block = static_cast<row_merge_block_t*>(
+			os_mem_alloc_large(&range->block_size));
+
+		if (range->block == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+
+		if (ctx->crypt_data != NULL) {
+			range->crypt_block = static_cast<row_merge_block_t*>(
+				os_mem_alloc_large(&range->block_size));
+
+			if (range->crypt_block == NULL) {
+				return(DB_OUT_OF_MEMORY);
+			}
+		}
+
+		range->merge_buf = static_cast<row_merge_buf_t**>(
+			mem_alloc(ctx->n_index * sizeof *range->merge_buf));
+
+		for (ulint i = 0; i < ctx->n_index; i++) {
+			range->merge_buf[i] = row_merge_buf_create(
+				ctx->index[i]);
+		}
+
+		range->row_heap = mem_heap_create(sizeof(mrec_buf_t));
+	}
+
+	ut_ad(!rec_offs_any_null_extern(rec, offsets));
+
+	row = row_build(ROW_COPY_POINTERS,
+			dict_table_get_first_index(ctx->table),
+			rec, offsets, ctx->table, NULL, NULL, &ext,
+			range->row_heap);
+
+	for (ulint i = 0; i < ctx->n_index; i++) {
+		doc_id_t	doc_id		= 0;
+		bool		exceed_page	= false;
+
+		if (!row_merge_buf_add(range->merge_buf[i], NULL, ctx->table,
+				       NULL, row, ext, &doc_id, NULL,
+				       &exceed_page, ctx->trx)) {
+			/* The buffer is full. Write it as a block. */
+			err = row_merge_pread_write(range, i);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			if (!row_merge_buf_add(range->merge_buf[i], NULL,
+					       ctx->table, NULL, row, ext,
+					       &doc_id, NULL, &exceed_page,
+					       ctx->trx)) {
+				/* An empty buffer should have enough
+				room for at least one record. */
+				ut_error;
+			}
+		}
+
+		if (exceed_page) {
+			err = DB_TOO_BIG_RECORD;
+			ctx->error_key_num = i;
+			break;
+		}
+	}
+
+	mem_heap_empty(range->row_heap);
+
+	/* Increment innodb_onlineddl_pct_progress status variable */
+	n_rows = os_atomic_increment_ulint(&ctx->n_rows, 1);
+
+	if (n_rows % 1000 == 0) {
+		/* Update progress for each 1000 rows */
+		ib_int64_t	read_rows = n_rows;
+
+		/* presenting 10.12% as 1012 integer */
+		onlineddl_pct_progress = (read_rows >= ctx->total_rows
+					  ? ctx->pct_cost
+					  : ((ctx->pct_cost * read_rows)
+					     / ctx->total_rows)) * 100;
+
+#ifndef UNIV_SOLARIS
+		/* Only the thread of the connection may report to
+		the client. */
+		if (os_thread_eq(os_thread_get_curr_id(), ctx->thread)) {
+			thd_progress_report(ctx->trx->mysql_thd,
+					    read_rows, ctx->total_rows);
+		}
+#endif /* UNIV_SOLARIS */
+	}
+
+	return(err);
+}
+
+/** Write the remaining rows of a range of a parallel clustered index
+scan, and free the buffers of the range. This is a row_pread_end_func_t.
+@param[in]	err	DB_SUCCESS if the range was scanned completely
+@param[in,out]	arg	the range (row_merge_pread_range_t)
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_pread_end(
+	dberr_t		err,
+	void*		arg)
+{
+	row_merge_pread_range_t*range	= static_cast<
+		row_merge_pread_range_t*>(arg);
+
+	if (range->merge_buf != NULL) {
+		for (ulint i = 0; i < range->ctx->n_index; i++) {
+			if (err == DB_SUCCESS) {
+				err = row_merge_pread_write(range, i);
+			}
+
+			row_merge_buf_free(range->merge_buf[i]);
+		}
+
+		mem_free(range->merge_buf);
+		mem_heap_free(range->row_heap);
+		range->merge_buf = NULL;
+	}
+
+	if (range->block != NULL) {
+		os_mem_free_large(range->block, range->block_size);
+		range->block = NULL;
+	}
+
+	if (range->crypt_block != NULL) {
+		os_mem_free_large(range->crypt_block, range->block_size);
+		range->crypt_block = NULL;
+	}
+
+	return(err);
+}
+
+/** Read the clustered index of the table with several threads and
+create the temporary files containing the entries of secondary indexes
+that are created without rebuilding the table. Each thread sorts its
+buffers and appends them to the files as sorted runs.
+@param[in]	trx		transaction
+@param[in,out]	table		MySQL table object, for reporting
+				erroneous records
+@param[in]	old_table	table where the indexes are created
+@param[in]	online		true if creating indexes online
+@param[in]	index		indexes to be created
+@param[in,out]	files		temporary files
+@param[in]	key_numbers	MySQL key numbers to create
+@param[in]	n_index		number of indexes to create
+@param[in,out]	tmpfd		temporary file handle
+@param[in]	pct_cost	percent of task weight out of total alter job
+@param[in]	crypt_data	crypt data or NULL
+@param[in]	n_threads	number of threads
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((nonnull(1,2,3,5,6,7,9), warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+	trx_t*			trx,
+	struct TABLE*		table,
+	const dict_table_t*	old_table,
+	bool			online,
+	dict_index_t**		index,
+	merge_file_t*		files,
+	const ulint*		key_numbers,
+	ulint			n_index,
+	int*			tmpfd,
+	float			pct_cost,
+	fil_space_crypt_t*	crypt_data,
+	ulint			n_threads)
+{
+	row_merge_pread_t	ctx;
+	row_pread_t*		reader;
+	row_merge_pread_range_t*ranges;
+	void**			args;
+	dberr_t			err	= DB_SUCCESS;
+	const char*		path	= thd_innodb_tmpdir(trx->mysql_thd);
+
+	DBUG_ENTER("row_merge_read_clustered_index_parallel");
+
+	ut_ad(!online || trx->read_view);
+
+	trx->op_info = "reading clustered index";
+
+	/* The threads append to all files, so create them in advance. */
+	for (ulint i = 0; i < n_index; i++) {
+		if (row_merge_file_create_if_needed(
+			    &files[i], tmpfd, 0, path) < 0) {
+			trx->error_key_num = i;
+			trx->op_info = "";
+			DBUG_RETURN(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	ctx.trx = trx;
+	ctx.table = old_table;
+	ctx.index = index;
+	ctx.files = files;
+	ctx.n_index = n_index;
+	ctx.crypt_data = crypt_data;
+	ctx.thread = os_thread_get_curr_id();
+	ctx.total_rows = dict_table_get_n_rows(old_table);
+	ctx.pct_cost = pct_cost;
+	ctx.n_rows = 0;
+	ctx.error_key_num = 0;
+	ctx.dups = static_cast<row_merge_dup_t*>(
+		mem_alloc(n_index * sizeof *ctx.dups));
+
+	if (ctx.total_rows == 0) {
+		/* We don't know total row count */
+		ctx.total_rows = 1;
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		ctx.dups[i].index = index[i];
+		ctx.dups[i].table = table;
+		ctx.dups[i].col_map = NULL;
+		ctx.dups[i].n_dup = 0;
+	}
+
+	/* When creating indexes online, perform a REPEATABLE READ, like
+	row_merge_read_clustered_index() does. Otherwise, the table is
+	locked, and the latest versions of the records are read. */
+	reader = row_pread_create(dict_table_get_first_index(old_table),
+				  trx, online ? trx->read_view : NULL,
+				  n_threads);
+
+	ranges = static_cast<row_merge_pread_range_t*>(
+		mem_heap_zalloc(reader->heap,
+				reader->n_ranges * sizeof *ranges));
+	args = static_cast<void**>(
+		mem_heap_alloc(reader->heap,
+			       reader->n_ranges * sizeof *args));
+
+	for (ulint i = 0; i < reader->n_ranges; i++) {
+		ranges[i].ctx = &ctx;
+		args[i] = &ranges[i];
+	}
+
+	sql_print_information("InnoDB: Online DDL : Reading the clustered"
+			      " index in %lu ranges with %lu threads",
+			      reader->n_ranges, reader->n_threads);
+
+#ifndef UNIV_SOLARIS
+	thd_progress_init(trx->mysql_thd, 1);
+#endif /* UNIV_SOLARIS */
+
+	err = row_pread_run(reader, row_merge_pread_rec, row_merge_pread_end,
+			    args);
+
+#ifndef UNIV_SOLARIS
+	thd_progress_end(trx->mysql_thd);
+#endif /* UNIV_SOLARIS */
+
+	row_pread_free(reader);
+
+	switch (err) {
+	case DB_SUCCESS:
+		break;
+	case DB_DUPLICATE_KEY:
+		trx->error_key_num = key_numbers[ctx.error_key_num];
+		break;
+	case DB_TOO_BIG_RECORD:
+	case DB_TEMP_FILE_WRITE_FAILURE:
+		trx->error_key_num = ctx.error_key_num;
+		break;
+	default:
+		trx->error_key_num = 0;
+	}
+
+	for (ulint i = 0; err == DB_SUCCESS && i < n_index; i++) {
+		if (!files[i].offset) {
+			/* There are no entries to sort and insert. */
+			row_merge_file_destroy(&files[i]);
+		}
+
+		if (online) {
+			/* Note the newest transaction that modified
+			this index when the scan was completed. We
+			prevent older readers from accessing this
+			index, to ensure read consistency. */
+			trx_id_t	max_trx_id;
+
+			rw_lock_x_lock(dict_index_get_lock(index[i]));
+			ut_a(dict_index_get_online_status(index[i])
+			     == ONLINE_INDEX_CREATION);
+
+			max_trx_id = row_log_get_max_trx(index[i]);
+
+			if (max_trx_id > index[i]->trx_id) {
+				index[i]->trx_id = max_trx_id;
+			}
+
+			rw_lock_x_unlock(dict_index_get_lock(index[i]));
+		}
+	}
+
+	mem_free(ctx.dups);
+
+	trx->op_info = "";
+
+	DBUG_RETURN(err);
+}
+
 /** Reads clustered index of the table and create temporary files
 containing the index entries for the indexes to be built.
 @param[in]	trx		transaction
@@ -2434,6 +2849,244 @@ row_merge_blocks_copy(
 	       != NULL);
 }
 
+/** A pass of merge sort that merges pairs of runs with several threads.
+Each pair of runs is merged to the position of the output file that
+follows the space of the preceding input runs, because a merged run
+never occupies more blocks than its two input runs together. */
+struct row_merge_pass_t {
+	trx_t*			trx;	/*!< transaction */
+	const row_merge_dup_t*	dup;	/*!< descriptor of index being
+					created */
+	const merge_file_t*	file;	/*!< input file */
+	int			fd;	/*!< output file */
+	ulint			n_run;	/*!< number of input runs */
+	const ulint*		run_offset;/*!< first block of each input
+					run */
+	ulint*			out_offset;/*!< first block of each output
+					run */
+	ulint*			out_end;/*!< end of each output run */
+	ulint			n_out;	/*!< number of output runs */
+	ulint			next;	/*!< the next output run to merge;
+					protected by atomic operations */
+	ib_uint64_t		n_rec;	/*!< number of records written;
+					protected by atomic operations */
+	fil_space_crypt_t*	crypt_data;/*!< crypt data or NULL */
+	ulint			space;	/*!< space id */
+	volatile dberr_t	err;	/*!< DB_SUCCESS, or the error that
+					stopped the pass */
+};
+
+/** Arguments of a thread of a parallel merge pass */
+struct row_merge_pass_thread_t {
+	row_merge_pass_t*	pass;	/*!< the merge pass */
+	row_merge_block_t*	block;	/*!< 3 buffers of the thread */
+	row_merge_block_t*	crypt_block;/*!< 3 buffers for encryption,
+					or NULL */
+};
+
+/** Merge pairs of runs of a parallel merge pass until all pairs were
+assigned to a thread or the pass was stopped.
+@param[in,out]	pass		the merge pass
+@param[in,out]	block		3 buffers
+@param[in,out]	crypt_block	3 buffers for encryption, or NULL */
+static
+void
+row_merge_pass_worker(
+	row_merge_pass_t*	pass,
+	row_merge_block_t*	block,
+	row_merge_block_t*	crypt_block)
+{
+	const ulint	half = pass->n_run / 2;
+
+	while (pass->err == DB_SUCCESS) {
+		ulint		k = os_atomic_increment_ulint(
+			&pass->next, 1) - 1;
+		dberr_t		err = DB_SUCCESS;
+		merge_file_t	of;
+
+		if (k >= pass->n_out) {
+			break;
+		}
+
+		if (trx_is_interrupted(pass->trx)) {
+			pass->err = DB_INTERRUPTED;
+			break;
+		}
+
+		of.fd = pass->fd;
+		of.offset = pass->out_offset[k];
+		of.n_rec = 0;
+
+		if (k < half) {
+			ulint	foffs0 = pass->run_offset[k];
+			ulint	foffs1 = pass->run_offset[half + k];
+
+			err = row_merge_blocks(pass->dup, pass->file, block,
+					       &foffs0, &foffs1, &of,
+					       pass->crypt_data, crypt_block,
+					       pass->space);
+		} else {
+			/* Copy the last run of an odd number of runs. */
+			ulint	foffs1 = pass->run_offset[pass->n_run - 1];
+
+			if (!row_merge_blocks_copy(pass->dup->index,
+						   pass->file, block,
+						   &foffs1, &of,
+						   pass->crypt_data,
+						   crypt_block,
+						   pass->space)) {
+				err = DB_CORRUPTION;
+			}
+		}
+
+		if (err != DB_SUCCESS) {
+			pass->err = err;
+			break;
+		}
+
+		pass->out_end[k] = of.offset;
+		os_atomic_increment_uint64(&pass->n_rec, of.n_rec);
+	}
+}
+
+/** Thread function of a parallel merge pass.
+@param[in,out]	arg	row_merge_pass_thread_t
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_merge_pass_thread)(
+	void*	arg)
+{
+	row_merge_pass_thread_t*	t
+		= static_cast<row_merge_pass_thread_t*>(arg);
+
+	my_thread_init();
+
+	row_merge_pass_worker(t->pass, t->block, t->crypt_block);
+
+	my_thread_end();
+
+	/* The thread is joined by row_merge_parallel(). */
+	os_thread_exit(NULL, false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Merge disk files with several threads. This does the same as
+row_merge(), but the pairs of runs are merged at the same time.
+@param[in]	trx		transaction
+@param[in]	dup		descriptor of index being created
+@param[in,out]	file		file containing index entries
+@param[in,out]	threads		buffers of the threads; the first one
+				is used by the calling thread
+@param[in]	n_threads	number of threads
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	num_run		number of runs that remain to be merged
+@param[in,out]	run_offset	first block of each run
+@param[in]	crypt_data	crypt data or NULL
+@param[in]	space		space id
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((nonnull(1,2,3,4,6,7,8), warn_unused_result))
+dberr_t
+row_merge_parallel(
+	trx_t*			trx,
+	const row_merge_dup_t*	dup,
+	merge_file_t*		file,
+	row_merge_pass_thread_t*threads,
+	ulint			n_threads,
+	int*			tmpfd,
+	ulint*			num_run,
+	ulint*			run_offset,
+	fil_space_crypt_t*	crypt_data,
+	ulint			space)
+{
+	row_merge_pass_t	pass;
+	os_thread_t		handles[ROW_MERGE_MAX_THREADS];
+	const ulint		half = *num_run / 2;
+
+	ut_ad(*num_run > 1);
+	ut_ad(run_offset[0] == 0);
+	ut_ad(n_threads <= ROW_MERGE_MAX_THREADS);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	/* Each block will be read exactly once. */
+	posix_fadvise(file->fd, 0, 0,
+		      POSIX_FADV_SEQUENTIAL | POSIX_FADV_NOREUSE);
+#endif /* POSIX_FADV_SEQUENTIAL */
+
+	pass.trx = trx;
+	pass.dup = dup;
+	pass.file = file;
+	pass.fd = *tmpfd;
+	pass.n_run = *num_run;
+	pass.run_offset = run_offset;
+	pass.n_out = *num_run - half;
+	pass.next = 0;
+	pass.n_rec = 0;
+	pass.crypt_data = crypt_data;
+	pass.space = space;
+	pass.err = DB_SUCCESS;
+
+	pass.out_offset = static_cast<ulint*>(
+		mem_alloc(2 * pass.n_out * sizeof *pass.out_offset));
+	pass.out_end = pass.out_offset + pass.n_out;
+
+	/* Output run k is written after the input runs that precede
+	the runs that are merged to it. */
+	for (ulint k = 0; k < half; k++) {
+		pass.out_offset[k] = run_offset[k] + run_offset[half + k]
+			- run_offset[half];
+	}
+
+	if (pass.n_out > half) {
+		pass.out_offset[half] = run_offset[*num_run - 1];
+	}
+
+	for (ulint i = 0; i < n_threads; i++) {
+		threads[i].pass = &pass;
+	}
+
+	n_threads = ut_min(n_threads, pass.n_out);
+
+	for (ulint i = 1; i < n_threads; i++) {
+		handles[i] = os_thread_create(row_merge_pass_thread,
+					      &threads[i], NULL);
+	}
+
+	row_merge_pass_worker(&pass, threads[0].block,
+			      threads[0].crypt_block);
+
+	for (ulint i = 1; i < n_threads; i++) {
+		os_thread_join(handles[i]);
+	}
+
+	if (pass.err == DB_SUCCESS && pass.n_rec != file->n_rec) {
+		pass.err = DB_CORRUPTION;
+	}
+
+	if (pass.err == DB_SUCCESS) {
+		merge_file_t	of;
+
+		of.fd = *tmpfd;
+		of.offset = pass.out_end[pass.n_out - 1];
+		of.n_rec = pass.n_rec;
+
+		ut_ad(of.offset <= file->offset);
+
+		memcpy(run_offset, pass.out_offset,
+		       pass.n_out * sizeof *run_offset);
+		*num_run = pass.n_out;
+
+		/* Swap file descriptors for the next pass. */
+		*tmpfd = file->fd;
+		*file = of;
+	}
+
+	mem_free(pass.out_offset);
+
+	return(pass.err);
+}
+
 /*************************************************************//**
 Merge disk files.
 @return	DB_SUCCESS or error code */
@@ -2600,7 +3253,10 @@ row_merge_sort(
 	const float		pct_cost, /*!< in: current progress percent */
 	fil_space_crypt_t*	crypt_data,/*!< in: table crypt data */
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
-	ulint			space)	   /*!< in: space id */
+	ulint			space,	   /*!< in: space id */
+	ulint			n_threads) /*!< in: number of threads that
+					   merge, at most
+					   ROW_MERGE_MAX_THREADS */
 {
 	const ulint	half	= file->offset / 2;
 	ulint		num_runs;
@@ -2609,6 +3265,8 @@ row_merge_sort(
 	ulint		merge_count = 0;
 	ulint		total_merge_sort_count;
 	float		curr_progress = 0;
+	ulint		block_size = 3 * srv_sort_buf_size;
+	row_merge_pass_thread_t* threads = NULL;
 
 	DBUG_ENTER("row_merge_sort");
 
@@ -2634,6 +3292,51 @@ row_merge_sort(
 	of merge. */
 	run_offset[half] = half;
 
+	n_threads = ut_min(n_threads, num_runs / 2);
+
+	if (n_threads > 1) {
+		/* Allocate 3 buffers for each thread that merges. The
+		calling thread uses block[] and crypt_block[]. If the
+		memory runs out, use fewer threads. */
+		threads = static_cast<row_merge_pass_thread_t*>(
+			mem_alloc(n_threads * sizeof *threads));
+
+		threads[0].block = block;
+		threads[0].crypt_block = crypt_block;
+
+		for (ulint i = 1; i < n_threads; i++) {
+			threads[i].block = static_cast<row_merge_block_t*>(
+				os_mem_alloc_large(&block_size));
+			threads[i].crypt_block = NULL;
+
+			if (threads[i].block != NULL && crypt_block != NULL) {
+				threads[i].crypt_block = static_cast<
+					row_merge_block_t*>(
+					os_mem_alloc_large(&block_size));
+
+				if (threads[i].crypt_block == NULL) {
+					os_mem_free_large(threads[i].block,
+							  block_size);
+					threads[i].block = NULL;
+				}
+			}
+
+			if (threads[i].block == NULL) {
+				n_threads = i;
+				break;
+			}
+		}
+
+		/* row_merge_parallel() needs the first block of each
+		run. Initially, each block is a run. */
+		for (ulint i = 0; i < num_runs; i++) {
+			run_offset[i] = i;
+		}
+
+		sql_print_information("InnoDB: Online DDL : merge-sorting"
+				      " with %lu threads", n_threads);
+	}
+
 	/* The file should always contain at least one byte (the end
 	of file marker).  Thus, it must be at least one block. */
 	ut_ad(file->offset > 0);
@@ -2654,9 +3357,16 @@ row_merge_sort(
 			thd_progress_report(trx->mysql_thd, file->offset - num_runs, file->offset);
 		}
 
-		error = row_merge(trx, dup, file, block, tmpfd,
-				  &num_runs, run_offset,
-				  crypt_data, crypt_block, space);
+		if (n_threads > 1) {
+			error = row_merge_parallel(trx, dup, file,
+						   threads, n_threads, tmpfd,
+						   &num_runs, run_offset,
+						   crypt_data, space);
+		} else {
+			error = row_merge(trx, dup, file, block, tmpfd,
+					  &num_runs, run_offset,
+					  crypt_data, crypt_block, space);
+		}
 
 		if(update_progress) {
 			merge_count++;
@@ -2676,6 +3386,19 @@ row_merge_sort(
 
 	mem_free(run_offset);
 
+	if (threads != NULL) {
+		for (ulint i = 1; i < n_threads; i++) {
+			os_mem_free_large(threads[i].block, block_size);
+
+			if (threads[i].crypt_block != NULL) {
+				os_mem_free_large(threads[i].crypt_block,
+						  block_size);
+			}
+		}
+
+		mem_free(threads);
+	}
+
 	/* Progress report only for "normal" indexes. */
 	if (!(dup->index->type & DICT_FTS)) {
 		thd_progress_end(trx->mysql_thd);
@@ -2758,6 +3481,9 @@ row_merge_insert_index_tuples(
 	mrec_buf_t*		buf;
 	ib_int64_t		inserted_rows = 0;
 	float			curr_progress;
+	btr_cur_t		cursor;
+	mtr_t			mtr;
+	bool			mtr_started = false;
 	DBUG_ENTER("row_merge_insert_index_tuples");
 
 	ut_ad(!srv_read_only_mode);
@@ -2792,8 +3518,6 @@ row_merge_insert_index_tuples(
 			ulint		n_ext;
 			big_rec_t*	big_rec;
 			rec_t*		rec;
-			btr_cur_t	cursor;
-			mtr_t		mtr;
 
 			b = row_merge_read_rec(block, buf, b, index,
 					       fd, &foffs, &mrec, offsets,
@@ -2824,6 +3548,14 @@ row_merge_insert_index_tuples(
 				/* There are no externally stored columns. */
 			} else {
 				ut_ad(dict_index_is_clust(index));
+
+				if (mtr_started) {
+					/* Do not hold the page latch of
+					the index while reading the BLOBs. */
+					mtr_commit(&mtr);
+					mtr_started = false;
+				}
+
 				/* Off-page columns can be fetched safely
 				when concurrent modifications to the table
 				are disabled. (Purge can process delete-marked
@@ -2850,18 +3582,23 @@ row_merge_insert_index_tuples(
 			}
 
 			ut_ad(dtuple_validate(dtuple));
-			log_free_check();
-
-			mtr_start(&mtr);
-			/* Insert after the last user record. */
-			btr_cur_open_at_index_side(
-				false, index, BTR_MODIFY_LEAF,
-				&cursor, 0, &mtr);
-			page_cur_position(
-				page_rec_get_prev(btr_cur_get_rec(&cursor)),
-				btr_cur_get_block(&cursor),
-				btr_cur_get_page_cur(&cursor));
-			cursor.flag = BTR_CUR_BINARY;
+
+			if (!mtr_started) {
+				log_free_check();
+
+				mtr_start(&mtr);
+				mtr_started = true;
+				/* Insert after the last user record. */
+				btr_cur_open_at_index_side(
+					false, index, BTR_MODIFY_LEAF,
+					&cursor, 0, &mtr);
+				page_cur_position(
+					page_rec_get_prev(
+						btr_cur_get_rec(&cursor)),
+					btr_cur_get_block(&cursor),
+					btr_cur_get_page_cur(&cursor));
+				cursor.flag = BTR_CUR_BINARY;
+			}
 #ifdef UNIV_DEBUG
 			/* Check that the records are inserted in order. */
 			rec = btr_cur_get_rec(&cursor);
@@ -2883,8 +3620,11 @@ row_merge_insert_index_tuples(
 				dtuple, &rec, &big_rec, 0, NULL, &mtr);
 
 			if (error == DB_FAIL) {
+				/* The last leaf page is full. */
 				ut_ad(!big_rec);
 				mtr_commit(&mtr);
+				mtr_started = false;
+				log_free_check();
 				mtr_start(&mtr);
 				btr_cur_open_at_index_side(
 					false, index, BTR_MODIFY_TREE,
@@ -2910,7 +3650,25 @@ row_merge_insert_index_tuples(
 					trx_id, &mtr);
 			}
 
-			mtr_commit(&mtr);
+			if (mtr_started && error == DB_SUCCESS && !big_rec
+			    && !btr_cur_get_page_zip(&cursor)) {
+				/* Keep appending to the last leaf page
+				in the same mini-transaction, until the
+				page is full. This avoids a descent from
+				the root page for every record, and the
+				redo log of the mini-transaction stays
+				within the size of one page. An insert
+				into a compressed page latches the insert
+				buffer bitmap page in the mini-transaction,
+				and no further index pages may be latched
+				after that. */
+				page_cur_position(
+					rec, btr_cur_get_block(&cursor),
+					btr_cur_get_page_cur(&cursor));
+			} else {
+				mtr_commit(&mtr);
+				mtr_started = false;
+			}
 
 			if (UNIV_LIKELY_NULL(big_rec)) {
 				/* If the system crashes at this
@@ -2953,6 +3711,10 @@ row_merge_insert_index_tuples(
 	}
 
 err_exit:
+	if (mtr_started) {
+		mtr_commit(&mtr);
+	}
+
 	mem_heap_free(tuple_heap);
 	mem_heap_free(ins_heap);
 	mem_heap_free(heap);
@@ -3977,6 +4739,7 @@ row_merge_build_indexes(
 	uint total_index_blocks = 0;
 	float pct_cost=0;
 	float pct_progress=0;
+	const ulint		n_threads = srv_sort_threads;
 
 	DBUG_ENTER("row_merge_build_indexes");
 
@@ -4082,12 +4845,19 @@ row_merge_build_indexes(
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
 
-	error = row_merge_read_clustered_index(
+	if (n_threads > 1 && old_table == new_table && !fts_sort_idx) {
+		error = row_merge_read_clustered_index_parallel(
+			trx, table, old_table, online, indexes,
+			merge_files, key_numbers, n_indexes, &tmpfd,
+			pct_cost, crypt_data, n_threads);
+	} else {
+		error = row_merge_read_clustered_index(
 			trx, table, old_table, new_table, online, indexes,
 			fts_sort_idx, psort_info, merge_files, key_numbers,
 			n_indexes, add_cols, col_map,
 			add_autoinc, sequence, block, &tmpfd, pct_cost,
 			crypt_data, crypt_block);
+	}
 
 	pct_progress += pct_cost;
 
@@ -4215,7 +4985,8 @@ row_merge_build_indexes(
 					trx, &dup, &merge_files[i],
 					block, &tmpfd, true,
 					pct_progress, pct_cost,
-					crypt_data, crypt_block, new_table->space);
+					crypt_data, crypt_block, new_table->space,
+					n_threads);
 
 			pct_progress += pct_cost;
 
@@ -0,0 +1,508 @@
+/*****************************************************************************
+
+Copyright (c) 2017, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel scan of a clustered index
+*******************************************************/
+
+#include "row0pread.h"
+
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "lock0lock.h"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "page0page.h"
+#include "rem0cmp.h"
+#include "row0vers.h"
+#include "trx0trx.h"
+
+/*********************************************************************//**
+Splits a clustered index into ranges. The boundaries are node pointers
+of the highest level of the B-tree that has at least as many records as
+the wanted number of ranges, or of the level above the leaves if no level
+has that many. The node pointers of one level are evenly spaced in the
+key order by the number of pages below them.
+@return number of boundaries, less than n */
+static
+ulint
+row_pread_split(
+/*============*/
+	dict_index_t*		index,	/*!< in: clustered index */
+	ulint			n,	/*!< in: wanted number of ranges */
+	mem_heap_t*		heap,	/*!< in: heap for the boundaries */
+	const dtuple_t**	bounds)	/*!< out: boundaries */
+{
+	mtr_t		mtr;
+	buf_block_t*	block;
+	buf_block_t**	blocks;
+	ulint		n_blocks;
+	ulint		n_recs;
+	ulint		n_bounds	= 0;
+	ulint		level;
+	const ulint	space		= dict_index_get_space(index);
+	const ulint	zip_size	= dict_table_zip_size(index->table);
+
+	/* The pages of the level that is split are latched at the same
+	time. We only descend to a level if the level above it has fewer
+	than n records, so there are at most n pages to latch. */
+	blocks = static_cast<buf_block_t**>(
+		mem_alloc(n * sizeof *blocks));
+
+	mtr_start(&mtr);
+
+	/* Prevent changes to the structure of the tree while we look at
+	more than one page of a level. */
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	block = btr_block_get(space, zip_size, dict_index_get_page(index),
+			      RW_S_LATCH, index, &mtr);
+	blocks[0] = block;
+	n_blocks = 1;
+	level = btr_page_get_level(buf_block_get_frame(block), &mtr);
+
+	for (;;) {
+		n_recs = 0;
+
+		for (ulint i = 0; i < n_blocks; i++) {
+			n_recs += page_get_n_recs(
+				buf_block_get_frame(blocks[i]));
+		}
+
+		if (level <= 1 || n_recs >= n) {
+			break;
+		}
+
+		/* Descend to the level below, and latch all its pages
+		from left to right. */
+		ulint	n_child = 0;
+
+		for (ulint i = 0; i < n_blocks; i++) {
+			const page_t*	page = buf_block_get_frame(blocks[i]);
+			const rec_t*	rec = page_rec_get_next_const(
+				page_get_infimum_rec(page));
+
+			for (; !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+				ulint	offsets_[REC_OFFS_NORMAL_SIZE];
+				ulint*	offsets = offsets_;
+				rec_offs_init(offsets_);
+
+				offsets = rec_get_offsets(
+					rec, index, offsets,
+					ULINT_UNDEFINED, &heap);
+
+				ut_a(n_child < n);
+				blocks[n_child++] = btr_block_get(
+					space, zip_size,
+					btr_node_ptr_get_child_page_no(
+						rec, offsets),
+					RW_S_LATCH, index, &mtr);
+			}
+		}
+
+		n_blocks = n_child;
+		level--;
+	}
+
+	if (level > 0 && n_recs > 1) {
+		/* Use every step-th node pointer as a boundary. The
+		first node pointer of the level is the minimum record,
+		which is not a usable boundary. */
+		ulint	step = n_recs / n;
+		ulint	j = 0;
+
+		if (step == 0) {
+			step = 1;
+		}
+
+		for (ulint i = 0; i < n_blocks && n_bounds < n - 1; i++) {
+			const page_t*	page = buf_block_get_frame(blocks[i]);
+			const rec_t*	rec = page_rec_get_next_const(
+				page_get_infimum_rec(page));
+
+			for (; !page_rec_is_supremum(rec) && n_bounds < n - 1;
+			     rec = page_rec_get_next_const(rec), j++) {
+				if (j == 0 || j % step != 0) {
+					continue;
+				}
+
+				bounds[n_bounds++] = dict_index_build_data_tuple(
+					index, const_cast<rec_t*>(rec),
+					dict_index_get_n_unique_in_tree(index),
+					heap);
+			}
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	mem_free(blocks);
+
+	return(n_bounds);
+}
+
+/*********************************************************************//**
+Creates a parallel scan of a clustered index and splits the index into
+key ranges. The number of ranges depends on the size of the index, and
+it is 1 for an index that consists of a single page.
+@return the parallel scan; free it with row_pread_free() */
+UNIV_INTERN
+row_pread_t*
+row_pread_create(
+/*=============*/
+	dict_index_t*	index,		/*!< in: clustered index */
+	trx_t*		trx,		/*!< in: transaction */
+	read_view_t*	view,		/*!< in: read view, or NULL */
+	ulint		n_threads)	/*!< in: number of threads to use,
+					at most ROW_PREAD_MAX_THREADS */
+{
+	mem_heap_t*	heap;
+	row_pread_t*	reader;
+	ulint		n;
+
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(n_threads > 0);
+	ut_ad(n_threads <= ROW_PREAD_MAX_THREADS);
+
+	heap = mem_heap_create(1024);
+
+	reader = static_cast<row_pread_t*>(
+		mem_heap_zalloc(heap, sizeof *reader));
+
+	n = n_threads * ROW_PREAD_RANGES_PER_THREAD;
+
+	reader->index = index;
+	reader->trx = trx;
+	reader->view = view;
+	reader->heap = heap;
+	reader->bounds = static_cast<const dtuple_t**>(
+		mem_heap_alloc(heap, n * sizeof *reader->bounds));
+	reader->n_ranges = row_pread_split(index, n, heap, reader->bounds)
+		+ 1;
+	reader->n_threads = ut_min(n_threads, reader->n_ranges);
+	reader->err = DB_SUCCESS;
+
+	return(reader);
+}
+
+/*********************************************************************//**
+Frees a parallel scan. */
+UNIV_INTERN
+void
+row_pread_free(
+/*===========*/
+	row_pread_t*	reader)		/*!< in, own: parallel scan */
+{
+	mem_heap_free(reader->heap);
+}
+
+/*********************************************************************//**
+Scans one range of a parallel scan.
+@return DB_SUCCESS, DB_INTERRUPTED or an error returned by func */
+static
+dberr_t
+row_pread_scan_range(
+/*=================*/
+	row_pread_t*	reader,		/*!< in: parallel scan */
+	ulint		range,		/*!< in: range to scan */
+	mem_heap_t*	heap)		/*!< in: empty heap for the records */
+{
+	dict_index_t*		index	= reader->index;
+	const dtuple_t*		start	= range > 0
+		? reader->bounds[range - 1] : NULL;
+	const dtuple_t*		end	= range < reader->n_ranges - 1
+		? reader->bounds[range] : NULL;
+	const ulint		comp	= dict_table_is_comp(index->table);
+	void*			arg	= reader->args[range];
+	dberr_t			err	= DB_SUCCESS;
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+
+	mtr_start(&mtr);
+
+	if (start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		btr_pcur_open(index, start, PAGE_CUR_GE, BTR_SEARCH_LEAF,
+			      &pcur, &mtr);
+		/* The loop below moves to the next record before it
+		looks at it. The cursor is not before the first record,
+		because start is greater than the minimum record. */
+		btr_pcur_move_to_prev_on_page(&pcur);
+	}
+
+	for (;;) {
+		const rec_t*	rec;
+		ulint*		offsets;
+		page_cur_t*	cur	= btr_pcur_get_page_cur(&pcur);
+
+		page_cur_move_to_next(cur);
+
+		if (page_cur_is_after_last(cur)) {
+			ulint		next_page_no;
+			buf_block_t*	block;
+
+			if (reader->err != DB_SUCCESS) {
+				/* Another range failed. */
+				break;
+			}
+
+			if (trx_is_interrupted(reader->trx)) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+
+			next_page_no = btr_page_get_next(
+				page_cur_get_page(cur), &mtr);
+
+			if (next_page_no == FIL_NULL) {
+				break;
+			}
+
+			block = page_cur_get_block(cur);
+			block = btr_block_get(
+				buf_block_get_space(block),
+				buf_block_get_zip_size(block),
+				next_page_no, BTR_SEARCH_LEAF, index, &mtr);
+
+			btr_leaf_page_release(page_cur_get_block(cur),
+					      BTR_SEARCH_LEAF, &mtr);
+			page_cur_set_before_first(block, cur);
+
+			/* Do not keep the released pages in the
+			mini-transaction memo for the whole scan. The
+			position is restored before the first record
+			of the page, or before its successor if the
+			record was purged meanwhile. */
+			btr_pcur_store_position(&pcur, &mtr);
+			mtr_commit(&mtr);
+			mtr_start(&mtr);
+			btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur, &mtr);
+			continue;
+		}
+
+		rec = page_cur_get_rec(cur);
+
+		mem_heap_empty(heap);
+
+		offsets = rec_get_offsets(rec, index, NULL,
+					  ULINT_UNDEFINED, &heap);
+
+		if (end != NULL && cmp_dtuple_rec(end, rec, offsets) <= 0) {
+			break;
+		}
+
+		if (reader->view != NULL
+		    && !lock_clust_rec_cons_read_sees(
+			    rec, index, offsets, reader->view)) {
+			rec_t*	old_vers;
+
+			err = row_vers_build_for_consistent_read(
+				rec, &mtr, index, &offsets, reader->view,
+				&heap, heap, &old_vers);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			if (old_vers == NULL) {
+				/* The record did not exist in the
+				read view. */
+				continue;
+			}
+
+			rec = old_vers;
+		}
+
+		if (rec_get_deleted_flag(rec, comp)) {
+			continue;
+		}
+
+		err = reader->func(rec, offsets, arg);
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	if (reader->end_func != NULL) {
+		dberr_t	end_err = reader->end_func(
+			err != DB_SUCCESS ? err : reader->err, arg);
+
+		if (err == DB_SUCCESS) {
+			err = end_err;
+		}
+	}
+
+	return(err);
+}
+
+/*********************************************************************//**
+Scans ranges of a parallel scan until all ranges were assigned to a
+thread or the scan was stopped. */
+static
+void
+row_pread_worker(
+/*=============*/
+	row_pread_t*	reader)		/*!< in/out: parallel scan */
+{
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	while (reader->err == DB_SUCCESS) {
+		ulint	range = os_atomic_increment_ulint(
+			&reader->next_range, 1) - 1;
+
+		if (range >= reader->n_ranges) {
+			break;
+		}
+
+		dberr_t	err = row_pread_scan_range(reader, range, heap);
+
+		if (err != DB_SUCCESS) {
+			/* If several threads fail at the same time,
+			any of the errors is reported. */
+			reader->err = err;
+			break;
+		}
+	}
+
+	mem_heap_free(heap);
+}
+
+/*********************************************************************//**
+Thread function of a parallel scan.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_pread_thread)(
+/*=============================*/
+	void*	arg)	/*!< in/out: parallel scan */
+{
+	my_thread_init();
+
+	row_pread_worker(static_cast<row_pread_t*>(arg));
+
+	my_thread_end();
+
+	/* The thread is joined by row_pread_run(). */
+	os_thread_exit(NULL, false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Scans all ranges of a parallel scan. The calling thread is one of the
+threads that scan; the function returns when all ranges were scanned or
+the scan was stopped.
+@return DB_SUCCESS, DB_INTERRUPTED or an error returned by func */
+UNIV_INTERN
+dberr_t
+row_pread_run(
+/*==========*/
+	row_pread_t*		reader,	/*!< in/out: parallel scan */
+	row_pread_func_t	func,	/*!< in: function to invoke for each
+					record in the read view */
+	row_pread_end_func_t	end_func,/*!< in: function to invoke at the
+					end of each range, or NULL */
+	void**			args)	/*!< in/out: reader->n_ranges
+					arguments of func */
+{
+	os_thread_t	threads[ROW_PREAD_MAX_THREADS];
+
+	reader->func = func;
+	reader->end_func = end_func;
+	reader->args = args;
+	reader->next_range = 0;
+	reader->err = DB_SUCCESS;
+
+	for (ulint i = 1; i < reader->n_threads; i++) {
+		threads[i] = os_thread_create(row_pread_thread, reader, NULL);
+	}
+
+	row_pread_worker(reader);
+
+	for (ulint i = 1; i < reader->n_threads; i++) {
+		os_thread_join(threads[i]);
+	}
+
+	return(reader->err);
+}
+
+/*********************************************************************//**
+Counts a record for row_pread_count().
+@return DB_SUCCESS */
+static
+dberr_t
+row_pread_count_rec(
+/*================*/
+	const rec_t*	rec MY_ATTRIBUTE((unused)),
+					/*!< in: record */
+	const ulint*	offsets MY_ATTRIBUTE((unused)),
+					/*!< in: rec_get_offsets(rec) */
+	void*		arg)		/*!< in/out: counter of the range */
+{
+	++*static_cast<ulint*>(arg);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Counts the records of a clustered index in a read view with several
+threads.
+@return DB_SUCCESS, DB_INTERRUPTED or error code */
+UNIV_INTERN
+dberr_t
+row_pread_count(
+/*============*/
+	dict_index_t*	index,		/*!< in: clustered index */
+	trx_t*		trx,		/*!< in: transaction */
+	read_view_t*	view,		/*!< in: read view, or NULL */
+	ulint		n_threads,	/*!< in: number of threads to use */
+	ulint*		n_rows)		/*!< out: number of records */
+{
+	row_pread_t*	reader = row_pread_create(index, trx, view, n_threads);
+	ulint*		counts = static_cast<ulint*>(
+		mem_heap_zalloc(reader->heap,
+				reader->n_ranges * sizeof *counts));
+	void**		args = static_cast<void**>(
+		mem_heap_alloc(reader->heap,
+			       reader->n_ranges * sizeof *args));
+
+	for (ulint i = 0; i < reader->n_ranges; i++) {
+		args[i] = &counts[i];
+	}
+
+	dberr_t	err = row_pread_run(reader, row_pread_count_rec, NULL, args);
+
+	*n_rows = 0;
+
+	for (ulint i = 0; i < reader->n_ranges; i++) {
+		*n_rows += counts[i];
+	}
+
+	row_pread_free(reader);
+
+	return(err);
+}
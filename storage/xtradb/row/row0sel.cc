@@ -1409,7 +1409,7 @@ row_sel(
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
 		if (!search_latch_locked) {
-			rw_lock_s_lock(btr_search_get_latch(index));
+			btr_search_s_lock(index);
 
 			search_latch_locked = TRUE;
 		} else if (rw_lock_get_writer(btr_search_get_latch(index))
@@ -1422,8 +1422,8 @@ row_sel(
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(btr_search_get_latch(index));
-			rw_lock_s_lock(btr_search_get_latch(index));
+			btr_search_s_unlock(index);
+			btr_search_s_lock(index);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan,
@@ -1448,7 +1448,7 @@ row_sel(
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 
 		search_latch_locked = FALSE;
 	}
@@ -2020,7 +2020,7 @@ row_sel(
 
 func_exit:
 	if (search_latch_locked) {
-		rw_lock_s_unlock(btr_search_get_latch(index));
+		btr_search_s_unlock(index);
 	}
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
@@ -3403,22 +3403,36 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
-UNIV_INLINE
+Initialise the prefetch cache, or enlarge it to fetch_cache_limit rows.
+The cache must be empty. */
+static
 void
 row_sel_prefetch_cache_init(
 /*========================*/
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ulint	i;
+	ulint	n;
 	ulint	sz;
 	byte*	ptr;
 
-	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
-	ptr = static_cast<byte*>(mem_alloc(sz));
+	ut_ad(prebuilt->n_fetch_cached == 0);
+	ut_ad(prebuilt->fetch_cache_limit > prebuilt->fetch_cache_size);
+
+	if (prebuilt->fetch_cache != NULL) {
+		mem_free(prebuilt->fetch_cache);
+	}
+
+	n = prebuilt->fetch_cache_limit;
+
+	/* Reserve space for the pointers and the magic numbers. */
+	sz = n * (sizeof(byte*) + prebuilt->mysql_row_len + 8);
+	prebuilt->fetch_cache = static_cast<byte**>(mem_alloc(sz));
+	prebuilt->fetch_cache_size = n;
+
+	ptr = reinterpret_cast<byte*>(prebuilt->fetch_cache + n);
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < n; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3435,6 +3449,44 @@ row_sel_prefetch_cache_init(
 	}
 }
 
+/********************************************************************//**
+Determines the size of the next batch of prefetched rows after a batch
+was read to the end. A long scan doubles the batch each time, so that it
+soon reads most of the records of an index page in one visit, while a
+short scan, for example one that is stopped by LIMIT, fetches at most
+about as many rows in advance as it has already read. The batch is
+limited by MYSQL_FETCH_CACHE_MAX_SIZE, by fetch_cache_max_bytes and by
+the number of rows that the optimizer expects the scan to return. */
+UNIV_INLINE
+void
+row_sel_prefetch_cache_grow(
+/*========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	limit = prebuilt->fetch_cache_limit * 2;
+	ulint	max_rows = prebuilt->fetch_cache_max_bytes
+		/ (prebuilt->mysql_row_len + 8);
+
+	if (limit > max_rows) {
+		limit = max_rows;
+	}
+
+	if (limit > MYSQL_FETCH_CACHE_MAX_SIZE) {
+		limit = MYSQL_FETCH_CACHE_MAX_SIZE;
+	}
+
+	/* The estimate may be too small; once we have read more rows
+	than expected, it is ignored. */
+	if (prebuilt->fetch_cache_hint > prebuilt->n_rows_fetched
+	    && limit > prebuilt->fetch_cache_hint - prebuilt->n_rows_fetched) {
+		limit = prebuilt->fetch_cache_hint - prebuilt->n_rows_fetched;
+	}
+
+	if (limit > prebuilt->fetch_cache_limit) {
+		prebuilt->fetch_cache_limit = limit;
+	}
+}
+
 /********************************************************************//**
 Get the last fetch cache buffer from the queue.
 @return pointer to buffer. */
@@ -3445,12 +3497,10 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
 		/* Allocate memory for the fetch cache */
-		ut_ad(prebuilt->n_fetch_cached == 0);
-
 		row_sel_prefetch_cache_init(prebuilt);
 	}
 
@@ -3799,6 +3849,7 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3823,6 +3874,7 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -3834,7 +3886,8 @@ row_search_for_mysql(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -3851,6 +3904,12 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 500000000;
 		}
 
+		if (prebuilt->n_rows_fetched > MYSQL_FETCH_CACHE_THRESHOLD) {
+			/* Any prefetched rows were read: the scan
+			goes on, so prefetch more rows at a time. */
+			row_sel_prefetch_cache_grow(prebuilt);
+		}
+
 		mode = pcur->search_mode;
 	}
 
@@ -3931,7 +3990,7 @@ row_search_for_mysql(
 
 #ifndef UNIV_SEARCH_DEBUG
 			ut_ad(!trx->has_search_latch);
-			rw_lock_s_lock(btr_search_get_latch(index));
+			btr_search_s_lock(index);
 			trx->has_search_latch = TRUE;
 #endif
 			switch (row_sel_try_search_shortcut_for_mysql(
@@ -3999,8 +4058,7 @@ row_search_for_mysql(
 
 				err = DB_RECORD_NOT_FOUND;
 release_search_latch:
-				rw_lock_s_unlock(
-					btr_search_get_latch(index));
+				btr_search_s_unlock(index);
 				trx->has_search_latch = FALSE;
 
 				/* NOTE that we do NOT store the cursor
@@ -4017,7 +4075,7 @@ row_search_for_mysql(
 			mtr_commit(&mtr);
 			mtr_start(&mtr);
 
-			rw_lock_s_unlock(btr_search_get_latch(index));
+			btr_search_s_unlock(index);
 			trx->has_search_latch = FALSE;
 		}
 	}
@@ -4943,7 +5001,7 @@ row_search_for_mysql(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -4996,7 +5054,7 @@ row_search_for_mysql(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
 			goto next_rec;
 		}
 
@@ -5349,13 +5407,9 @@ row_search_check_if_query_cache_permitted(
 		/* If the isolation level is high, assign a read view for the
 		transaction if it does not yet have one */
 
-		if (trx->isolation_level >= TRX_ISO_REPEATABLE_READ
-		    && !trx->read_view) {
+		if (trx->isolation_level >= TRX_ISO_REPEATABLE_READ) {
 
-			trx->read_view =
-				read_view_open_now(trx->id,
-						   trx->prebuilt_view);
-			trx->global_read_view = trx->read_view;
+			trx_assign_read_view(trx);
 		}
 	}
 
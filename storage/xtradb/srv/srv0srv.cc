@@ -111,6 +111,8 @@ UNIV_INTERN bool	srv_error_monitor_active;
 
 UNIV_INTERN bool	srv_buf_dump_thread_active;
 
+UNIV_INTERN bool	srv_buf_resize_thread_active;
+
 UNIV_INTERN bool	srv_dict_stats_thread_active;
 
 UNIV_INTERN my_bool	srv_scrub_log;
@@ -170,6 +172,8 @@ on duplicate key checking and foreign key checking */
 UNIV_INTERN ibool	srv_locks_unsafe_for_binlog = FALSE;
 /** Sort buffer size in index creation */
 UNIV_INTERN ulong	srv_sort_buf_size = 1048576;
+/** Number of threads that read, sort and merge in index creation */
+UNIV_INTERN ulong	srv_sort_threads = 1;
 /** Maximum modification log file size for online index creation */
 UNIV_INTERN unsigned long long	srv_online_max_size;
 
@@ -254,6 +258,12 @@ UNIV_INTERN ib_uint64_t	srv_log_file_size_requested;
 /* size in database pages */
 UNIV_INTERN ulint	srv_log_buffer_size	= ULINT_MAX;
 UNIV_INTERN uint	srv_flush_log_at_timeout = 1;
+/* If this is TRUE, mini-transactions copy their redo log records to
+the log buffer after releasing log_sys->mutex */
+UNIV_INTERN my_bool	srv_log_concurrent_copy = FALSE;
+/* If this is TRUE, dedicated threads write and flush the log, and
+committing transactions wait for them */
+UNIV_INTERN my_bool	srv_log_writer_threads = FALSE;
 UNIV_INTERN ulong	srv_page_size		= UNIV_PAGE_SIZE_DEF;
 UNIV_INTERN ulong	srv_page_size_shift	= UNIV_PAGE_SIZE_SHIFT_DEF;
 UNIV_INTERN char	srv_use_global_flush_log_at_trx_commit	= TRUE;
@@ -287,6 +297,8 @@ UNIV_INTERN const byte*	srv_latin1_ordering;
 UNIV_INTERN my_bool	srv_use_sys_malloc	= TRUE;
 /* requested size in kilobytes */
 UNIV_INTERN ulint	srv_buf_pool_size	= ULINT_MAX;
+/* size in bytes of one chunk of a buffer pool instance */
+UNIV_INTERN ulong	srv_buf_pool_chunk_unit;
 /* requested number of buffer pool instances */
 UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
 /* number of locks to protect buf_pool->page_hash */
@@ -301,6 +313,8 @@ UNIV_INTERN ulint	srv_buf_pool_old_size;
 UNIV_INTERN ulint	srv_buf_pool_curr_size	= 0;
 /* dump that may % of each buffer pool during BP dump */
 UNIV_INTERN ulong	srv_buf_pool_dump_pct;
+/* maximum size of the change buffer in percent of the buffer pool */
+UNIV_INTERN uint	srv_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
 /* size in bytes */
 UNIV_INTERN ulint	srv_mem_pool_size	= ULINT_MAX;
 UNIV_INTERN ulint	srv_lock_table_size	= ULINT_MAX;
@@ -456,6 +470,10 @@ UNIV_INTERN my_bool	srv_master_thread_priority	= FALSE;
 /* The number of purge threads to use.*/
 UNIV_INTERN ulong	srv_n_purge_threads = 1;
 
+/* The number of threads applying redo log records to pages in parallel
+during crash recovery. */
+UNIV_INTERN ulong	srv_n_recv_apply_threads = 1;
+
 /* the number of pages to purge in one batch */
 UNIV_INTERN ulong	srv_purge_batch_size = 20;
 
@@ -525,6 +543,13 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 UNIV_INTERN ulong	srv_doublewrite_batch_size	= 120;
 
+/** Number of doublewrite files. When this is nonzero, each buffer pool
+instance writes its pages through one of the files ib_doublewrite_<n> in
+the data home directory instead of the doublewrite buffer in the system
+tablespace, so that the page cleaner threads do not serialize on one
+doublewrite buffer. */
+UNIV_INTERN ulong	srv_doublewrite_files		= 0;
+
 UNIV_INTERN ulong	srv_replication_delay		= 0;
 
 UNIV_INTERN ulong	srv_pass_corrupt_table = 0; /* 0:disable 1:enable */
@@ -833,6 +858,10 @@ UNIV_INTERN os_event_t	srv_error_event;
 Set on shutdown or by buf_dump_start() or buf_load_start(). */
 UNIV_INTERN os_event_t	srv_buf_dump_event;
 
+/** Event for waking up buf_resize_thread. Not protected by a mutex.
+Set on shutdown or when innodb_buffer_pool_size is changed. */
+UNIV_INTERN os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 UNIV_INTERN char*	srv_buf_dump_filename;
 
@@ -1229,6 +1258,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create();
 
+		srv_buf_resize_event = os_event_create();
+
 		srv_checkpoint_completed_event = os_event_create();
 
 		srv_redo_log_tracked_event = os_event_create();
@@ -1291,6 +1322,7 @@ srv_free(void)
 		os_event_free(srv_error_event);
 		os_event_free(srv_monitor_event);
 		os_event_free(srv_buf_dump_event);
+		os_event_free(srv_buf_resize_event);
 		os_event_free(srv_checkpoint_completed_event);
 		os_event_free(srv_redo_log_tracked_event);
 		mutex_free(&srv_sys->mutex);
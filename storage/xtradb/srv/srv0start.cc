@@ -165,6 +165,7 @@ void *mtflush_ctx=NULL;
 static os_thread_t	thread_handles[SRV_MAX_N_IO_THREADS + 7 + SRV_MAX_N_PURGE_THREADS];
 static os_thread_t	buf_flush_page_cleaner_thread_handle;
 static os_thread_t	buf_dump_thread_handle;
+static os_thread_t	buf_resize_thread_handle;
 static os_thread_t	dict_stats_thread_handle;
 static os_thread_t	buf_flush_lru_manager_thread_handle;
 static os_thread_t	srv_redo_log_follow_thread_handle;
@@ -172,6 +173,7 @@ static os_thread_t	srv_redo_log_follow_thread_handle;
 static bool		thread_started[SRV_MAX_N_IO_THREADS + 7 + SRV_MAX_N_PURGE_THREADS] = {false};
 static bool		buf_flush_page_cleaner_thread_started = false;
 static bool		buf_dump_thread_started = false;
+static bool		buf_resize_thread_started = false;
 static bool		dict_stats_thread_started = false;
 static bool		buf_flush_lru_manager_thread_started = false;
 static bool		srv_redo_log_follow_thread_started = false;
@@ -1936,17 +1938,20 @@ innobase_start_or_create_for_mysql(void)
 			    + 1 /* srv_redo_log_follow_thread */
 			    + 1 /* srv_purge_coordinator_thread */
 			    + 1 /* buf_dump_thread */
+			    + 1 /* buf_resize_thread */
 			    + 1 /* dict_stats_thread */
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
 			    + 1 /* buf_flush_page_cleaner_thread */
 			    + 1 /* trx_rollback_or_clean_all_recovered */
+			    + 2 /* log_writer_thread, log_flusher_thread */
 			    + 128 /* added as margin, for use of
 				  InnoDB Memcached etc. */
 			    + max_connections
 			    + srv_n_read_io_threads
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
+			    + srv_n_recv_apply_threads
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
 			      * max_connections;
@@ -1957,6 +1962,19 @@ innobase_start_or_create_for_mysql(void)
 		srv_buf_pool_instances = 1;
 	}
 
+	if (srv_buf_pool_chunk_unit * srv_buf_pool_instances
+	    > srv_buf_pool_size) {
+		/* The chunk size is larger than the buffer pool
+		instance; use one chunk per instance. */
+		srv_buf_pool_chunk_unit = static_cast<ulong>(
+			srv_buf_pool_size / srv_buf_pool_instances);
+		if (srv_buf_pool_size % srv_buf_pool_instances != 0) {
+			++srv_buf_pool_chunk_unit;
+		}
+	}
+
+	srv_buf_pool_size = buf_pool_size_align(srv_buf_pool_size);
+
 	srv_boot();
 
 	if (ut_crc32_sse2_enabled) {
@@ -2865,6 +2883,12 @@ innobase_start_or_create_for_mysql(void)
 			srv_monitor_thread,
 			NULL, thread_ids + 4 + SRV_MAX_N_IO_THREADS);
 		thread_started[4 + SRV_MAX_N_IO_THREADS] = true;
+
+		if (srv_log_writer_threads) {
+			/* Create the threads which write and flush
+			the log on behalf of committing transactions */
+			log_writer_threads_start();
+		}
 	}
 
 	/* Create the SYS_FOREIGN and SYS_FOREIGN_COLS system tables */
@@ -3011,6 +3035,12 @@ innobase_start_or_create_for_mysql(void)
 		srv_dict_stats_thread_active = true;
 		dict_stats_thread_started = true;
 
+		/* Create the buffer pool resize thread */
+		buf_resize_thread_handle = os_thread_create(
+			buf_resize_thread, NULL, NULL);
+		srv_buf_resize_thread_active = true;
+		buf_resize_thread_started = true;
+
 		/* Create the thread that will optimize the FTS sub-system. */
 		fts_optimize_init();
 
@@ -3216,6 +3246,10 @@ innobase_shutdown_for_mysql(void)
 			CloseHandle(buf_dump_thread_handle);
 		}
 
+		if (buf_resize_thread_started) {
+			CloseHandle(buf_resize_thread_handle);
+		}
+
 		if (dict_stats_thread_started) {
 			CloseHandle(dict_stats_thread_handle);
 		}
@@ -1253,8 +1253,10 @@ sync_thread_add_level(
 	case SYNC_DOUBLEWRITE:
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
+	case SYNC_LOCK_REC_HASH:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_TRX_SYS:
+	case SYNC_TRX_RW_HASH:
 	case SYNC_IBUF_BITMAP_MUTEX:
 	case SYNC_RSEG:
 	case SYNC_TRX_UNDO:
@@ -1277,7 +1279,7 @@ sync_thread_add_level(
 		}
 		break;
 	case SYNC_TRX:
-		/* Either the thread must own the lock_sys->mutex, or
+		/* Either the thread must own the lock_sys->latch, or
 		it is allowed to own only ONE trx->mutex. */
 		if (!sync_thread_levels_g(array, level, FALSE)) {
 			ut_a(sync_thread_levels_g(array, level - 1, TRUE));
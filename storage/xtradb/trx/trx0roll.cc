@@ -213,6 +213,19 @@ trx_rollback_for_mysql(
 
 	case TRX_STATE_PREPARED:
 		ut_ad(!trx_is_autocommit_non_locking(trx));
+
+		if (trx->lock.released_early) {
+			/* The commit failed after the commit order was
+			determined. Later transactions may already have
+			modified the records, and their changes are not
+			rolled back. */
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Rolling back transaction " TRX_ID_FMT
+				" whose record locks were released"
+				" before the commit",
+				trx->id);
+		}
+
 		return(trx_rollback_for_mysql_low(trx));
 
 	case TRX_STATE_COMMITTED_IN_MEMORY:
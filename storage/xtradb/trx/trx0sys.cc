@@ -46,6 +46,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "log0recv.h"
 #include "os0file.h"
 #include "read0read.h"
+#include "srv0mon.h"
 
 #ifdef WITH_WSREP
 #include "ha_prototypes.h" /* wsrep_is_wsrep_xid() */
@@ -125,6 +126,7 @@ static const ulint	FILE_FORMAT_NAME_N
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	file_format_max_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	trx_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	trx_rw_hash_mutex_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 #ifndef UNIV_HOTBACKUP
@@ -173,6 +175,114 @@ trx_in_trx_list(
 }
 #endif /* UNIV_DEBUG */
 
+/****************************************************************//**
+Acquires a mutex of trx_sys->rw_trx_hash, and counts the acquisitions
+that had to wait. */
+static
+void
+trx_rw_hash_mutex_enter(
+/*====================*/
+	ib_mutex_t*	mutex)	/*!< in: mutex of trx_sys->rw_trx_hash */
+{
+	if (mutex_enter_nowait(mutex)) {
+		MONITOR_INC(MONITOR_TRX_RW_HASH_MUTEX_WAIT);
+		mutex_enter(mutex);
+	}
+}
+
+/****************************************************************//**
+Checks if a rw transaction with the given id is active. The transaction
+is looked up in trx_sys->rw_trx_hash, without acquiring trx_sys->mutex.
+If the caller is not holding lock_sys->mutex, the transaction may
+already have been committed.
+@return	transaction instance if active, or NULL;
+the pointer must not be dereferenced unless lock_sys->mutex was
+acquired before calling this function and is still being held */
+UNIV_INTERN
+trx_t*
+trx_rw_is_active(
+/*=============*/
+	trx_id_t	trx_id,		/*!< in: trx id of the transaction */
+	ibool*		corrupt)	/*!< in: NULL or pointer to a flag
+					that will be set if corrupt */
+{
+	trx_t*		trx;
+	ib_mutex_t*	mutex;
+
+	if (trx_id >= trx_sys_get_max_trx_id()) {
+
+		/* There must be corruption: we let the caller handle the
+		diagnostic prints in this case. */
+
+		if (corrupt != NULL) {
+			*corrupt = TRUE;
+		}
+
+		return(NULL);
+	}
+
+	MONITOR_INC(MONITOR_TRX_RW_HASH_LOOKUP);
+
+	mutex = trx_rw_hash_get_mutex(trx_id);
+
+	trx_rw_hash_mutex_enter(mutex);
+
+	HASH_SEARCH(rw_trx_hash, trx_sys->rw_trx_hash, ut_fold_ull(trx_id),
+		    trx_t*, trx, assert_trx_in_rw_list(trx),
+		    trx->id == trx_id);
+
+	if (trx != NULL && trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY)) {
+
+		trx = NULL;
+	}
+
+	mutex_exit(mutex);
+
+	return(trx);
+}
+
+/****************************************************************//**
+Adds a read-write transaction to trx_sys->rw_trx_hash. This must be done
+before the transaction id can be written to any record. */
+UNIV_INTERN
+void
+trx_rw_hash_insert(
+/*===============*/
+	trx_t*	trx)	/*!< in: read-write transaction */
+{
+	ib_mutex_t*	mutex = trx_rw_hash_get_mutex(trx->id);
+
+	assert_trx_in_rw_list(trx);
+
+	trx_rw_hash_mutex_enter(mutex);
+
+	HASH_INSERT(trx_t, rw_trx_hash, trx_sys->rw_trx_hash,
+		    ut_fold_ull(trx->id), trx);
+
+	mutex_exit(mutex);
+}
+
+/****************************************************************//**
+Removes a read-write transaction from trx_sys->rw_trx_hash, when it is
+removed from trx_sys->rw_trx_list. */
+UNIV_INTERN
+void
+trx_rw_hash_delete(
+/*===============*/
+	trx_t*	trx)	/*!< in: read-write transaction */
+{
+	ib_mutex_t*	mutex = trx_rw_hash_get_mutex(trx->id);
+
+	assert_trx_in_rw_list(trx);
+
+	trx_rw_hash_mutex_enter(mutex);
+
+	HASH_DELETE(trx_t, rw_trx_hash, trx_sys->rw_trx_hash,
+		    ut_fold_ull(trx->id), trx);
+
+	mutex_exit(mutex);
+}
+
 /*****************************************************************//**
 Writes the value of max_trx_id to the file based trx system header. */
 UNIV_INTERN
@@ -740,6 +850,13 @@ trx_sys_create(void)
 	trx_sys = static_cast<trx_sys_t*>(mem_zalloc(sizeof(*trx_sys)));
 
 	mutex_create(trx_sys_mutex_key, &trx_sys->mutex, SYNC_TRX_SYS);
+
+	trx_sys->rw_trx_hash = hash_create(srv_max_n_threads);
+
+	for (ulint i = 0; i < TRX_RW_HASH_N_MUTEXES; i++) {
+		mutex_create(trx_rw_hash_mutex_key,
+			     &trx_sys->rw_trx_hash_mutexes[i], SYNC_TRX_RW_HASH);
+	}
 }
 
 /*****************************************************************//**
@@ -1378,6 +1495,12 @@ trx_sys_close(void)
 	ut_ad(trx_sys->descr_n_used == 0);
 	ut_free(trx_sys->descriptors);
 
+	for (ulint i = 0; i < TRX_RW_HASH_N_MUTEXES; i++) {
+		mutex_free(&trx_sys->rw_trx_hash_mutexes[i]);
+	}
+
+	hash_table_free(trx_sys->rw_trx_hash);
+
 	mem_free(trx_sys);
 
 	trx_sys = NULL;
@@ -175,6 +175,7 @@ trx_reserve_descriptor(
 	*descr = trx->id;
 
 	trx_sys->descr_n_used = n_used;
+	trx_sys->rw_trx_version++;
 }
 
 /*************************************************************//**
@@ -215,6 +216,7 @@ trx_release_descriptor(
 	}
 
 	trx_sys->descr_n_used--;
+	trx_sys->rw_trx_version++;
 }
 
 /****************************************************************//**
@@ -492,6 +494,8 @@ trx_free_prepared(
 
 	ut_a(!trx->read_only);
 
+	trx_rw_hash_delete(trx);
+
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
 
@@ -592,6 +596,8 @@ trx_list_rw_insert_ordered(
 
 	ut_ad(!trx->in_rw_trx_list);
 	ut_d(trx->in_rw_trx_list = TRUE);
+
+	trx_rw_hash_insert(trx);
 }
 
 /****************************************************************//**
@@ -1018,6 +1024,20 @@ trx_assign_rseg(
 	trx->rseg = trx_assign_rseg_low(srv_undo_logs, srv_undo_tablespaces);
 }
 
+/****************************************************************//**
+Acquires trx_sys->mutex when a transaction is started or committed, and
+counts the acquisitions that had to wait. */
+static
+void
+trx_sys_mutex_enter_and_count(void)
+/*===============================*/
+{
+	if (mutex_enter_nowait(&trx_sys->mutex)) {
+		MONITOR_INC(MONITOR_TRX_SYS_MUTEX_WAIT);
+		mutex_enter(&trx_sys->mutex);
+	}
+}
+
 /****************************************************************//**
 Starts a transaction. */
 static
@@ -1067,7 +1087,35 @@ trx_start_low(
 	ut_a(ib_vector_is_empty(trx->autoinc_locks));
 	ut_a(ib_vector_is_empty(trx->lock.table_locks));
 
-	mutex_enter(&trx_sys->mutex);
+	/* Cache the state of fake_changes that transaction will use for
+	lifetime. Any change in session/global fake_changes configuration during
+	lifetime of transaction will not be honored by already started
+	transaction. */
+	trx->fake_changes = thd_fake_changes(trx->mysql_thd);
+
+	ut_ad(!trx->in_rw_trx_list);
+	ut_ad(!trx->in_ro_trx_list);
+
+	if (trx_is_autocommit_non_locking(trx)) {
+		ut_ad(trx->read_only);
+
+		/* The transaction is not put on any list, and its id is
+		never written to a record, so that trx_sys->mutex is not
+		needed. As in trx_commit_in_memory(), the state change is
+		not protected by trx_sys->mutex. The id is assigned before
+		the state, for lock_print_info_all_transactions(). */
+
+		trx->id = trx_sys_get_new_trx_id_nowait();
+
+		os_wmb;
+
+		trx->state = TRX_STATE_ACTIVE;
+
+		MONITOR_INC(MONITOR_TRX_ID_NOWAIT);
+		goto func_exit;
+	}
+
+	trx_sys_mutex_enter_and_count();
 
 	/* If this transaction came from trx_allocate_for_mysql(),
 	trx->in_mysql_trx_list would hold. In that case, the trx->state
@@ -1076,16 +1124,10 @@ trx_start_low(
 
 	trx->state = TRX_STATE_ACTIVE;
 
-	trx->id = trx_sys_get_new_trx_id();
-
-	/* Cache the state of fake_changes that transaction will use for
-	lifetime. Any change in session/global fake_changes configuration during
-	lifetime of transaction will not be honored by already started
-	transaction. */
-	trx->fake_changes = thd_fake_changes(trx->mysql_thd);
+	/* The lists are sorted on trx id, and the id must be allocated
+	while holding the mutex. */
 
-	ut_ad(!trx->in_rw_trx_list);
-	ut_ad(!trx->in_ro_trx_list);
+	trx->id = trx_sys_get_new_trx_id();
 
 	if (trx->read_only) {
 
@@ -1093,10 +1135,8 @@ trx_start_low(
 		be ordered, we should exploit this using a list type that
 		doesn't need a list wide lock to increase concurrency. */
 
-		if (!trx_is_autocommit_non_locking(trx)) {
-			UT_LIST_ADD_FIRST(trx_list, trx_sys->ro_trx_list, trx);
-			ut_d(trx->in_ro_trx_list = TRUE);
-		}
+		UT_LIST_ADD_FIRST(trx_list, trx_sys->ro_trx_list, trx);
+		ut_d(trx->in_ro_trx_list = TRUE);
 	} else {
 
 		ut_ad(trx->rseg != NULL
@@ -1119,6 +1159,11 @@ trx_start_low(
 
 	mutex_exit(&trx_sys->mutex);
 
+	if (!trx->read_only) {
+		trx_rw_hash_insert(trx);
+	}
+
+func_exit:
 	trx->start_time = ut_time();
 
 	trx->start_time_micro = clock();
@@ -1140,7 +1185,7 @@ trx_serialisation_number_get(
 
 	ut_ad(mutex_own(&rseg->mutex));
 
-	mutex_enter(&trx_sys->mutex);
+	trx_sys_mutex_enter_and_count();
 
 	trx->no = trx_sys_get_new_trx_id();
 
@@ -1442,7 +1487,11 @@ trx_commit_in_memory(
 
 		ut_ad(trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY));
 
-		mutex_enter(&trx_sys->mutex);
+		if (!trx->read_only) {
+			trx_rw_hash_delete(trx);
+		}
+
+		trx_sys_mutex_enter_and_count();
 
 		assert_trx_in_list(trx);
 
@@ -1700,10 +1749,12 @@ trx_cleanup_at_db_startup(
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
 
-	mutex_enter(&trx_sys->mutex);
-
 	ut_a(!trx->read_only);
 
+	trx_rw_hash_delete(trx);
+
+	mutex_enter(&trx_sys->mutex);
+
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 	ut_ad(trx_sys->descr_n_used <= UT_LIST_GET_LEN(trx_sys->rw_trx_list));
 
@@ -1741,7 +1792,17 @@ trx_assign_read_view(
 		return(trx->read_view);
 	}
 
-	trx->read_view = read_view_open_now(trx->id, trx->prebuilt_view);
+	ut_ad(trx->global_read_view == NULL);
+
+	if (trx->prebuilt_view != NULL
+	    && read_view_reopen(trx->prebuilt_view, trx)) {
+
+		trx->read_view = trx->prebuilt_view;
+	} else {
+		trx->read_view = read_view_open_now(trx->id,
+						    trx->prebuilt_view);
+	}
+
 	trx->global_read_view = trx->read_view;
 
 	return(trx->read_view);
@@ -1772,6 +1833,10 @@ trx_clone_read_view(
 	trx->read_view = read_view_clone(from_trx->read_view,
 					 trx->prebuilt_view);
 
+	/* The clone sees the changes of the donor, which may still be
+	active, so it must not be reopened after it has been closed. */
+	trx->read_view->rw_trx_version = ULINT_UNDEFINED;
+
 	read_view_add(trx->read_view);
 
 	trx->global_read_view = trx->read_view;
@@ -0,0 +1,182 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Stress test for the InnoDB adaptive hash index. Many sessions run
+# primary key lookups on several tables, while some sessions update a
+# secondary index column so that the hash index must be modified too.
+# The point lookups are served from the adaptive hash index, so the
+# throughput depends on the contention on its latches.
+#
+# Example:  ahi_concurrency.pl --socket=/tmp/mysql.sock --sessions=8,64,256
+#
+# Compare a server started with --innodb-adaptive-hash-index-partitions=1
+# and one started with a larger value. The latch waits are read from the
+# adaptive_hash_latch_waits_part% counters in INNODB_METRICS.
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_sessions="8,64,256";
+$opt_seconds=30;
+$opt_rows=10000;
+$opt_tables=8;
+$opt_writers=1;
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","sessions=s",
+	   "seconds=i","rows=i","tables=i","writers=i") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+for ($t=1 ; $t <= $opt_tables ; $t++)
+{
+  print "Creating table bench_ahi$t with $opt_rows rows\n";
+  $dbh->do("drop table if exists bench_ahi$t");
+  $dbh->do("create table bench_ahi$t (id int not null primary key, " .
+	   "k int not null, c char(60) not null default '', key(k)) " .
+	   "engine=InnoDB") || die $DBI::errstr;
+  $dbh->do("begin");
+  for ($i=1 ; $i <= $opt_rows ; $i++)
+  {
+    $dbh->do("insert into bench_ahi$t (id,k) values ($i,$i)") ||
+      die $DBI::errstr;
+  }
+  $dbh->do("commit");
+}
+
+$dbh->do("set global innodb_monitor_enable='adaptive_hash_latch_waits_part%'");
+
+printf("%10s %12s %12s %14s\n", "sessions", "selects/s", "updates/s",
+       "latch_waits/s");
+
+foreach $sessions (split(/,/,$opt_sessions))
+{
+  run_test($sessions);
+}
+
+$dbh->do("set global innodb_monitor_disable='adaptive_hash_latch_waits_part%'");
+for ($t=1 ; $t <= $opt_tables ; $t++)
+{
+  $dbh->do("drop table bench_ahi$t");
+}
+$dbh->disconnect;
+exit(0);
+
+#
+# Runs the lookups in $sessions processes and the updates in $opt_writers
+# processes for $opt_seconds seconds, and prints the totals reported by
+# the processes
+#
+
+sub run_test
+{
+  my ($sessions)=@_;
+  my ($i,$pid,%pipes,%writer,$selects,$updates,$waits);
+
+  $waits=-latch_waits();
+
+  for ($i=0 ; $i < $sessions + $opt_writers ; $i++)
+  {
+    my ($reader,$writer);
+    my $is_writer= $i >= $sessions;
+    pipe($reader,$writer) || die "pipe: $!";
+    if (($pid=fork()) == 0)
+    {
+      close($reader);
+      exit(test_session($writer,$is_writer));
+    }
+    die "fork: $!" if (!defined($pid));
+    close($writer);
+    $pipes{$pid}=$reader;
+    $writer{$pid}=$is_writer;
+  }
+
+  $selects=$updates=0;
+  foreach $pid (keys %pipes)
+  {
+    my $reader=$pipes{$pid};
+    my $line=<$reader>;
+    close($reader);
+    waitpid($pid,0);
+    if (!defined($line) || $?)
+    {
+      print "Session $pid failed\n";
+      next;
+    }
+    if ($writer{$pid})
+    {
+      $updates+=$line;
+    }
+    else
+    {
+      $selects+=$line;
+    }
+  }
+
+  $waits+=latch_waits();
+
+  printf("%10d %12.1f %12.1f %14.1f\n", $sessions,
+	 $selects / $opt_seconds, $updates / $opt_seconds,
+	 $waits / $opt_seconds);
+}
+
+sub latch_waits
+{
+  my $row=$dbh->selectrow_arrayref("select sum(count) from " .
+				   "information_schema.innodb_metrics " .
+				   "where name like " .
+				   "'adaptive_hash_latch_waits_part%'");
+  return $row && defined($row->[0]) ? $row->[0] : 0;
+}
+
+sub test_session
+{
+  my ($writer,$is_writer)=@_;
+  my ($dbh,@sth,$end,$t,$n);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+    return 1;
+  for ($t=1 ; $t <= $opt_tables ; $t++)
+  {
+    $sth[$t]=$dbh->prepare($is_writer ?
+			   "update bench_ahi$t set k=k+1 where id=?" :
+			   "select c from bench_ahi$t where id=?") ||
+      return 1;
+  }
+  srand($$);
+
+  $n=0;
+  $end=time() + $opt_seconds;
+  while (time() < $end)
+  {
+    $t=int(rand($opt_tables)) + 1;
+    $sth[$t]->execute(int(rand($opt_rows)) + 1) || return 1;
+    $sth[$t]->fetchall_arrayref() if (!$is_writer);
+    $n++;
+  }
+  $dbh->disconnect;
+  print $writer "$n\n";
+  close($writer);
+  return 0;
+}
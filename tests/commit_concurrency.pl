@@ -0,0 +1,150 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures commit throughput and latency of small autocommit updates
+# with an increasing number of concurrent sessions. This is meant for
+# comparing the log write strategies of InnoDB, for example a server
+# started with and without --innodb-log-writer-threads.
+#
+# Example:  commit_concurrency.pl --socket=/tmp/mysql.sock --sessions=1,64,512
+#
+# Note that max_connections must be larger than the largest session count.
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_sessions="1,64,512";
+$opt_seconds=30;
+$opt_rows=10000;
+$opt_engine="InnoDB";
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","sessions=s",
+	   "seconds=i","rows=i","engine=s") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+print "Creating table bench_commit with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_commit");
+$dbh->do("create table bench_commit (id int not null primary key, " .
+	 "k int not null default 0, c char(120) not null default '', " .
+	 "pad char(60) not null default '') engine=$opt_engine") ||
+  die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i++)
+{
+  $dbh->do("insert into bench_commit (id,k,c,pad) values ($i,$i," .
+	   "'" . ("x" x 119) . "','" . ("y" x 59) . "')") ||
+    die $DBI::errstr;
+}
+$dbh->do("commit");
+
+printf("%10s %12s %14s %14s\n", "sessions", "commits/s", "avg_lat_ms",
+       "max_lat_ms");
+
+foreach $sessions (split(/,/,$opt_sessions))
+{
+  run_test($sessions);
+}
+
+$dbh->do("drop table bench_commit");
+$dbh->disconnect;
+exit(0);
+
+#
+# Runs autocommit updates of random rows in $sessions processes for
+# $opt_seconds seconds, and prints the totals reported by the processes
+#
+
+sub run_test
+{
+  my ($sessions)=@_;
+  my ($i,$pid,%pipes,$commits,$total_lat,$max_lat);
+
+  for ($i=0 ; $i < $sessions ; $i++)
+  {
+    my ($reader,$writer);
+    pipe($reader,$writer) || die "pipe: $!";
+    if (($pid=fork()) == 0)
+    {
+      close($reader);
+      exit(test_session($writer));
+    }
+    die "fork: $!" if (!defined($pid));
+    close($writer);
+    $pipes{$pid}=$reader;
+  }
+
+  $commits=$total_lat=$max_lat=0;
+  foreach $pid (keys %pipes)
+  {
+    my $reader=$pipes{$pid};
+    my $line=<$reader>;
+    close($reader);
+    waitpid($pid,0);
+    if (!defined($line) || $?)
+    {
+      print "Session $pid failed\n";
+      next;
+    }
+    my ($n,$lat,$max)=split(/ /,$line);
+    $commits+=$n;
+    $total_lat+=$lat;
+    $max_lat=$max if ($max > $max_lat);
+  }
+
+  printf("%10d %12.1f %14.3f %14.3f\n", $sessions,
+	 $commits / $opt_seconds,
+	 $commits ? $total_lat * 1000 / $commits : 0,
+	 $max_lat * 1000);
+}
+
+sub test_session
+{
+  my ($writer)=@_;
+  my ($dbh,$sth,$end,$start,$lat,$n,$total_lat,$max_lat);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+    return 1;
+  $dbh->{AutoCommit}=1;
+  $sth=$dbh->prepare("update bench_commit set k=k+1 where id=?") ||
+    return 1;
+  srand($$);
+
+  $n=$total_lat=$max_lat=0;
+  $end=time() + $opt_seconds;
+  while (($start=time()) < $end)
+  {
+    $sth->execute(int(rand($opt_rows)) + 1) || return 1;
+    $lat=time() - $start;
+    $n++;
+    $total_lat+=$lat;
+    $max_lat=$lat if ($lat > $max_lat);
+  }
+  $dbh->disconnect;
+  print $writer "$n $total_lat $max_lat\n";
+  close($writer);
+  return 0;
+}
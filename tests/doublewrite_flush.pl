@@ -0,0 +1,178 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures the page flushing throughput of InnoDB under a write heavy
+# load. A number of sessions update random rows of a table that is
+# larger than the dirty page limit, and the pages flushed per second
+# and the doublewrite counters are printed.
+#
+# The doublewrite configuration can only be set at server startup.
+# Compare for example a server started with
+#
+#   --innodb-buffer-pool-size=2G --innodb-buffer-pool-instances=8
+#   --innodb-use-mtflush --innodb-mtflush-threads=8
+#   --innodb-max-dirty-pages-pct=10
+#
+# and the same server started with --innodb-doublewrite-files=8.
+#
+# Example:  doublewrite_flush.pl --socket=/tmp/mysql.sock --rows=2000000
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_sessions=32;
+$opt_seconds=60;
+$opt_rows=1000000;
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","sessions=i",
+	   "seconds=i","rows=i") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+foreach $var ("innodb_buffer_pool_instances","innodb_doublewrite",
+	      "innodb_doublewrite_files")
+{
+  my ($name,$value)=$dbh->selectrow_array("show global variables like '$var'");
+  printf("%-30s %s\n", $var, defined($value) ? $value : "(not available)");
+}
+
+print "Creating table bench_flush with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_flush");
+$dbh->do("create table bench_flush (id int not null primary key, " .
+	 "k int not null default 0, c char(200) not null default '') " .
+	 "engine=InnoDB") || die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i+=1000)
+{
+  my (@rows,$j);
+  for ($j=$i ; $j < $i+1000 && $j <= $opt_rows ; $j++)
+  {
+    push(@rows,"($j,$j,repeat(md5($j),6))");
+  }
+  $dbh->do("insert into bench_flush values " . join(",",@rows)) ||
+    die $DBI::errstr;
+}
+$dbh->do("commit");
+
+%start=get_status();
+$start_time=time();
+$updates=run_sessions();
+$time=time() - $start_time;
+%end=get_status();
+
+$flushed=$end{innodb_buffer_pool_pages_flushed} -
+  $start{innodb_buffer_pool_pages_flushed};
+$dblwr_pages=$end{innodb_dblwr_pages_written} -
+  $start{innodb_dblwr_pages_written};
+$dblwr_writes=$end{innodb_dblwr_writes} - $start{innodb_dblwr_writes};
+
+printf("%-30s %12.1f\n", "updates/s", $updates / $time);
+printf("%-30s %12.1f\n", "pages flushed/s", $flushed / $time);
+printf("%-30s %12.1f\n", "doublewrite pages/s", $dblwr_pages / $time);
+printf("%-30s %12.1f\n", "doublewrite writes/s", $dblwr_writes / $time);
+printf("%-30s %12.1f\n", "pages per doublewrite write",
+       $dblwr_writes ? $dblwr_pages / $dblwr_writes : 0);
+
+$dbh->do("drop table bench_flush");
+$dbh->disconnect;
+exit(0);
+
+sub get_status
+{
+  my (%status,$row);
+  foreach $row (@{$dbh->selectall_arrayref("show global status where " .
+	"variable_name in ('innodb_buffer_pool_pages_flushed'," .
+	"'innodb_dblwr_pages_written','innodb_dblwr_writes')")})
+  {
+    $status{lc($row->[0])}=$row->[1];
+  }
+  return %status;
+}
+
+#
+# Runs updates of random rows in $opt_sessions processes for
+# $opt_seconds seconds, and returns the number of updates
+#
+
+sub run_sessions
+{
+  my ($i,$pid,%pipes,$updates);
+
+  for ($i=0 ; $i < $opt_sessions ; $i++)
+  {
+    my ($reader,$writer);
+    pipe($reader,$writer) || die "pipe: $!";
+    if (($pid=fork()) == 0)
+    {
+      close($reader);
+      exit(test_session($writer));
+    }
+    die "fork: $!" if (!defined($pid));
+    close($writer);
+    $pipes{$pid}=$reader;
+  }
+
+  $updates=0;
+  foreach $pid (keys %pipes)
+  {
+    my $reader=$pipes{$pid};
+    my $line=<$reader>;
+    close($reader);
+    waitpid($pid,0);
+    if (!defined($line) || $?)
+    {
+      print "Session $pid failed\n";
+      next;
+    }
+    $updates+=$line;
+  }
+  return $updates;
+}
+
+sub test_session
+{
+  my ($writer)=@_;
+  my ($dbh,$sth,$end,$n);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+    return 1;
+  $dbh->{AutoCommit}=1;
+  $sth=$dbh->prepare("update bench_flush set k=k+1 where id=?") ||
+    return 1;
+  srand($$);
+
+  $n=0;
+  $end=time() + $opt_seconds;
+  while (time() < $end)
+  {
+    $sth->execute(int(rand($opt_rows)) + 1) || return 1;
+    $n++;
+  }
+  $dbh->disconnect;
+  print $writer "$n\n";
+  close($writer);
+  return 0;
+}
@@ -0,0 +1,174 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures the throughput of autocommit updates of a single hot row, such
+# as a stock counter, with innodb_release_locks_early OFF and ON. All
+# sessions decrement the same row, and the final value of the row is
+# checked against the number of successful updates.
+#
+# The early release of locks only applies to two-phase commit with the
+# binary log, so the server should be started with for example
+#
+#   --log-bin --sync-binlog=1 --innodb-flush-log-at-trx-commit=1
+#
+# Example:  hot_row_update.pl --socket=/tmp/mysql.sock --sessions=64
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_sessions=32;
+$opt_seconds=30;
+$opt_rows=1;
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","sessions=i",
+	   "seconds=i","rows=i") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+foreach $var ("log_bin","sync_binlog","innodb_flush_log_at_trx_commit")
+{
+  my ($name,$value)=$dbh->selectrow_array("show global variables like '$var'");
+  printf("%-30s %s\n", $var, defined($value) ? $value : "(not available)");
+}
+
+$dbh->do("drop table if exists bench_hot_row");
+$dbh->do("create table bench_hot_row (id int not null primary key, " .
+	 "stock bigint not null) engine=InnoDB") || die $DBI::errstr;
+
+printf("\n%-20s %12s %12s %12s %8s\n", "release_locks_early", "updates/s",
+       "lock waits", "group size", "result");
+
+foreach $mode ("OFF","ON")
+{
+  my ($updates,$time,$start,%start,%end,$stock,$commits,$groups);
+
+  $dbh->do("delete from bench_hot_row");
+  for ($i=1 ; $i <= $opt_rows ; $i++)
+  {
+    $dbh->do("insert into bench_hot_row values ($i,1000000000)") ||
+      die $DBI::errstr;
+  }
+
+  %start=get_status();
+  $start=time();
+  $updates=run_sessions($mode);
+  $time=time() - $start;
+  %end=get_status();
+
+  ($stock)=$dbh->selectrow_array("select sum(1000000000 - stock) " .
+				 "from bench_hot_row");
+  $commits=$end{binlog_commits} - $start{binlog_commits};
+  $groups=$end{binlog_group_commits} - $start{binlog_group_commits};
+
+  printf("%-20s %12.1f %12d %12.2f %8s\n", $mode, $updates / $time,
+	 $end{innodb_row_lock_waits} - $start{innodb_row_lock_waits},
+	 $groups ? $commits / $groups : 0,
+	 $stock == $updates ? "ok" : "WRONG");
+}
+
+$dbh->do("drop table bench_hot_row");
+$dbh->disconnect;
+exit(0);
+
+sub get_status
+{
+  my (%status,$row);
+  foreach $row (@{$dbh->selectall_arrayref("show global status where " .
+	"variable_name in ('binlog_commits','binlog_group_commits'," .
+	"'innodb_row_lock_waits')")})
+  {
+    $status{lc($row->[0])}=$row->[1];
+  }
+  return %status;
+}
+
+#
+# Runs the updates in $opt_sessions processes for $opt_seconds seconds,
+# and returns the number of updates
+#
+
+sub run_sessions
+{
+  my ($mode)=@_;
+  my ($i,$pid,%pipes,$updates);
+
+  for ($i=0 ; $i < $opt_sessions ; $i++)
+  {
+    my ($reader,$writer);
+    pipe($reader,$writer) || die "pipe: $!";
+    if (($pid=fork()) == 0)
+    {
+      close($reader);
+      exit(test_session($writer,$mode));
+    }
+    die "fork: $!" if (!defined($pid));
+    close($writer);
+    $pipes{$pid}=$reader;
+  }
+
+  $updates=0;
+  foreach $pid (keys %pipes)
+  {
+    my $reader=$pipes{$pid};
+    my $line=<$reader>;
+    close($reader);
+    waitpid($pid,0);
+    if (!defined($line) || $?)
+    {
+      print "Session $pid failed\n";
+      next;
+    }
+    $updates+=$line;
+  }
+  return $updates;
+}
+
+sub test_session
+{
+  my ($writer,$mode)=@_;
+  my ($dbh,$sth,$end,$n);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+    return 1;
+  $dbh->{AutoCommit}=1;
+  $dbh->do("set session innodb_release_locks_early=$mode") || return 1;
+  $sth=$dbh->prepare("update bench_hot_row set stock=stock-1 " .
+		     "where id=? and stock > 0") || return 1;
+  srand($$);
+
+  $n=0;
+  $end=time() + $opt_seconds;
+  while (time() < $end)
+  {
+    # Deadlocks or lock wait timeouts are not expected, but do not
+    # count the update if one happens
+    my $rows=$sth->execute(int(rand($opt_rows)) + 1);
+    $n+=$rows if (defined($rows));
+  }
+  $dbh->disconnect;
+  print $writer "$n\n";
+  close($writer);
+  return 0;
+}
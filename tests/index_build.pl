@@ -0,0 +1,98 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures the time of ALTER TABLE ... ADD INDEX for different values of
+# innodb_sort_threads. A table with an integer key and a string key in
+# random order is created, and the secondary indexes are dropped and
+# created again with each number of threads.
+#
+# Example:  index_build.pl --socket=/tmp/mysql.sock --rows=5000000
+#
+# innodb_sort_buffer_size can only be set at server startup. A smaller
+# buffer makes more sorted runs and more merge passes.
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_rows=1000000;
+$opt_loops=3;
+$opt_threads="1,2,4,8";
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","rows=i",
+	   "loops=i","threads=s") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+print "Creating table bench_index with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_index");
+$dbh->do("create table bench_index (id int not null primary key, " .
+	 "k int not null, s char(32) not null) engine=InnoDB") ||
+  die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i+=1000)
+{
+  my (@rows,$j);
+  for ($j=$i ; $j < $i+1000 && $j <= $opt_rows ; $j++)
+  {
+    push(@rows,"($j," . int(rand(2**31)) . ",md5($j))");
+  }
+  $dbh->do("insert into bench_index values " . join(",",@rows)) ||
+    die $DBI::errstr;
+}
+$dbh->do("commit");
+
+($saved_threads)=$dbh->selectrow_array("select \@\@global.innodb_sort_threads");
+
+printf("%-8s %12s %12s %9s\n", "threads", "ms/build", "rows/s", "speedup");
+
+$base=0;
+foreach $threads (split(/,/,$opt_threads))
+{
+  my ($i,$start,$time);
+
+  $dbh->do("set global innodb_sort_threads=$threads") || die $DBI::errstr;
+
+  $time=0;
+  for ($i=0 ; $i < $opt_loops ; $i++)
+  {
+    $start=time();
+    $dbh->do("alter table bench_index add index k (k), add index s (s), " .
+	     "algorithm=inplace") || die $DBI::errstr;
+    $time+=time() - $start;
+    $dbh->do("alter table bench_index drop index k, drop index s") ||
+      die $DBI::errstr;
+  }
+  $time/=$opt_loops;
+  $base=$time if (!$base);
+
+  printf("%-8d %12.1f %12.0f %9.2f\n", $threads, $time * 1000,
+	 $opt_rows / $time, $base / $time);
+}
+
+$dbh->do("set global innodb_sort_threads=$saved_threads");
+$dbh->do("drop table bench_index");
+$dbh->disconnect;
+exit(0);
@@ -0,0 +1,173 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Stress test for the InnoDB lock system. Many sessions run small
+# transactions that lock and update rows through a secondary index, so
+# that most of the time is spent acquiring and releasing record locks.
+# Each transaction moves an amount between two rows, so the total must
+# stay unchanged; this is checked at the end.
+#
+# Example:  lock_concurrency.pl --socket=/tmp/mysql.sock --sessions=8,64,256
+#
+# Use --hot-rows to control the conflicts between the sessions: with a
+# small number most transactions wait for each other and some deadlock.
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_sessions="8,64,256";
+$opt_seconds=30;
+$opt_rows=100000;
+$opt_hot_rows=0;
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","sessions=s",
+	   "seconds=i","rows=i","hot-rows=i") || die "Aborted";
+
+$opt_hot_rows=$opt_rows if ($opt_hot_rows <= 0 || $opt_hot_rows > $opt_rows);
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+print "Creating table bench_lock with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_lock");
+$dbh->do("create table bench_lock (id int not null primary key, " .
+	 "k int not null, balance int not null, key(k)) engine=InnoDB") ||
+  die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i++)
+{
+  $dbh->do("insert into bench_lock values ($i,$i,1000)") || die $DBI::errstr;
+}
+$dbh->do("commit");
+
+printf("%10s %12s %12s %14s\n", "sessions", "trx/s", "deadlocks/s",
+       "lock_waits/s");
+
+foreach $sessions (split(/,/,$opt_sessions))
+{
+  run_test($sessions);
+}
+
+$row=$dbh->selectrow_arrayref("select count(*),sum(balance) from bench_lock");
+if ($row->[0] != $opt_rows || $row->[1] != $opt_rows * 1000)
+{
+  print "Error: the table has $row->[0] rows with balance $row->[1]\n";
+  exit(1);
+}
+
+$dbh->do("drop table bench_lock");
+$dbh->disconnect;
+exit(0);
+
+#
+# Runs the transfers in $sessions processes for $opt_seconds seconds,
+# and prints the totals reported by the processes
+#
+
+sub run_test
+{
+  my ($sessions)=@_;
+  my ($i,$pid,%pipes,$commits,$deadlocks,$waits);
+
+  $waits=-lock_waits();
+
+  for ($i=0 ; $i < $sessions ; $i++)
+  {
+    my ($reader,$writer);
+    pipe($reader,$writer) || die "pipe: $!";
+    if (($pid=fork()) == 0)
+    {
+      close($reader);
+      exit(test_session($writer));
+    }
+    die "fork: $!" if (!defined($pid));
+    close($writer);
+    $pipes{$pid}=$reader;
+  }
+
+  $commits=$deadlocks=0;
+  foreach $pid (keys %pipes)
+  {
+    my $reader=$pipes{$pid};
+    my $line=<$reader>;
+    close($reader);
+    waitpid($pid,0);
+    if (!defined($line) || $?)
+    {
+      print "Session $pid failed\n";
+      next;
+    }
+    my ($n,$d)=split(/ /,$line);
+    $commits+=$n;
+    $deadlocks+=$d;
+  }
+
+  $waits+=lock_waits();
+
+  printf("%10d %12.1f %12.1f %14.1f\n", $sessions,
+	 $commits / $opt_seconds, $deadlocks / $opt_seconds,
+	 $waits / $opt_seconds);
+}
+
+sub lock_waits
+{
+  my $row=$dbh->selectrow_arrayref("show global status like " .
+				   "'Innodb_row_lock_waits'");
+  return $row ? $row->[1] : 0;
+}
+
+sub test_session
+{
+  my ($writer)=@_;
+  my ($dbh,$sth,$end,$from,$to,$n,$deadlocks);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,
+		    { PrintError => 0, AutoCommit => 0}) || return 1;
+  $dbh->do("set session innodb_lock_wait_timeout=10");
+  $sth=$dbh->prepare("update bench_lock set balance=balance+? where k=?") ||
+    return 1;
+  srand($$);
+
+  $n=$deadlocks=0;
+  $end=time() + $opt_seconds;
+  while (time() < $end)
+  {
+    $from=int(rand($opt_hot_rows)) + 1;
+    $to=int(rand($opt_hot_rows)) + 1;
+    if ($sth->execute(-1,$from) && $sth->execute(1,$to) && $dbh->commit)
+    {
+      $n++;
+      next;
+    }
+    # 1213 is ER_LOCK_DEADLOCK and 1205 is ER_LOCK_WAIT_TIMEOUT
+    return 1 if ($dbh->err != 1213 && $dbh->err != 1205);
+    $deadlocks++ if ($dbh->err == 1213);
+    $dbh->rollback;
+  }
+  $dbh->disconnect;
+  print $writer "$n $deadlocks\n";
+  close($writer);
+  return 0;
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures SELECT COUNT(*) and CHECK TABLE on a large InnoDB table with
+# different values of innodb_parallel_read_threads, and prints the time
+# of one run and the speedup against a single thread.
+#
+# Example:  parallel_scan.pl --socket=/tmp/mysql.sock --rows=5000000 \
+#             --threads=1,2,4,8,16
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_rows=1000000;
+$opt_loops=3;
+$opt_threads="1,2,4,8";
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","rows=i",
+	   "loops=i","threads=s") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+print "Creating table bench_count with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_count");
+$dbh->do("create table bench_count (id int not null primary key, " .
+	 "k int not null, c char(120) not null, key(k)) engine=InnoDB") ||
+  die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i+=1000)
+{
+  my (@rows,$j);
+  for ($j=$i ; $j < $i+1000 && $j <= $opt_rows ; $j++)
+  {
+    push(@rows,"($j," . ($j % 1000) . ",'" . ("c" x 120) . "')");
+  }
+  $dbh->do("insert into bench_count values " . join(",",@rows)) ||
+    die $DBI::errstr;
+}
+$dbh->do("commit");
+
+printf("%-12s %8s %12s %8s\n", "test", "threads", "ms/run", "speedup");
+
+foreach $test ("count","check")
+{
+  my ($base);
+  foreach $threads (split(/,/,$opt_threads))
+  {
+    my $time=run_test($test,$threads);
+    $base=$time if (!defined($base));
+    printf("%-12s %8d %12.1f %8.2f\n", $test, $threads, $time * 1000,
+	   $base / $time);
+  }
+}
+
+$dbh->do("drop table bench_count");
+$dbh->disconnect;
+exit(0);
+
+#
+# Runs the test $opt_loops times after one warm-up run with the given
+# number of threads, and returns the average time of one run
+#
+
+sub run_test
+{
+  my ($test,$threads)=@_;
+  my ($query,$start,$i,$rows);
+
+  $dbh->do("set session innodb_parallel_read_threads=$threads") ||
+    die $DBI::errstr;
+  $query= $test eq "count" ? "select count(*) from bench_count" :
+    "check table bench_count";
+
+  for ($i=0 ; $i <= $opt_loops ; $i++)
+  {
+    $start=time() if ($i == 1);
+    $rows=$dbh->selectall_arrayref($query) || die $DBI::errstr;
+    die "Wrong count: $rows->[0][0]\n"
+      if ($test eq "count" && $rows->[0][0] != $opt_rows);
+  }
+  return (time() - $start) / $opt_loops;
+}
@@ -0,0 +1,118 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures the speed of long scans that return many rows to the server,
+# which is where InnoDB prefetches rows in batches. Full table scans and
+# range scans are run on a table with narrow rows and on a table with
+# wide rows, and the rows returned per second are printed.
+#
+# Example:  prefetch_scan.pl --socket=/tmp/mysql.sock --rows=1000000
+#
+# Use --read-buffer-size to see the effect of the size of the prefetch
+# cache on full table scans.
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_rows=1000000;
+$opt_loops=5;
+$opt_read_buffer_size=0;
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","rows=i",
+	   "loops=i","read-buffer-size=i") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+$dbh->do("set session read_buffer_size=$opt_read_buffer_size")
+  if ($opt_read_buffer_size);
+
+print "Creating tables bench_narrow and bench_wide with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_narrow,bench_wide");
+$dbh->do("create table bench_narrow (id int not null primary key, " .
+	 "k int not null) engine=InnoDB") || die $DBI::errstr;
+$dbh->do("create table bench_wide (id int not null primary key, " .
+	 "k int not null, c char(200) not null, pad varchar(500) not null) " .
+	 "engine=InnoDB") || die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i+=1000)
+{
+  my (@narrow,@wide,$j);
+  for ($j=$i ; $j < $i+1000 && $j <= $opt_rows ; $j++)
+  {
+    push(@narrow,"($j,$j)");
+    push(@wide,"($j,$j,'" . ("c" x 200) . "','" . ("p" x ($j % 500)) . "')");
+  }
+  $dbh->do("insert into bench_narrow values " . join(",",@narrow)) ||
+    die $DBI::errstr;
+  $dbh->do("insert into bench_wide values " . join(",",@wide)) ||
+    die $DBI::errstr;
+}
+$dbh->do("commit");
+
+printf("%-8s %-12s %12s %12s\n", "table", "scan", "rows/s", "ms/scan");
+
+foreach $table ("bench_narrow","bench_wide")
+{
+  # The rows are sent to the client, so that every row is fetched
+  run_test($table, "full", "select * from $table");
+  run_test($table, "range", "select * from $table where id between " .
+	   int($opt_rows / 4) . " and " . int($opt_rows * 3 / 4));
+  run_test($table, "range desc", "select * from $table where id > " .
+	   int($opt_rows / 2) . " order by id desc");
+}
+
+$dbh->do("drop table bench_narrow,bench_wide");
+$dbh->disconnect;
+exit(0);
+
+#
+# Runs the query $opt_loops times after one warm-up run, and prints the
+# rows returned per second and the average time of one run
+#
+
+sub run_test
+{
+  my ($table,$name,$query)=@_;
+  my ($sth,$start,$rows,$i,$time);
+
+  $sth=$dbh->prepare($query,{ mysql_use_result => 1}) || die $DBI::errstr;
+  $sth->execute || die $DBI::errstr;
+  while ($sth->fetchrow_arrayref) {}
+
+  $rows=0;
+  $start=time();
+  for ($i=0 ; $i < $opt_loops ; $i++)
+  {
+    $sth->execute || die $DBI::errstr;
+    while ($sth->fetchrow_arrayref)
+    {
+      $rows++;
+    }
+  }
+  $time=time() - $start;
+
+  printf("%-8s %-12s %12.0f %12.1f\n", substr($table,6), $name,
+	 $rows / $time, $time * 1000 / $opt_loops);
+}
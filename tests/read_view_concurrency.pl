@@ -0,0 +1,187 @@
+#!/usr/bin/perl -w
+
+# Copyright (c) 2017, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#
+# Measures the latency of autocommit point SELECTs while an increasing
+# number of sessions keep write transactions open. Every consistent read
+# opens a read view, whose cost depends on the number of active write
+# transactions and on how often they commit.
+#
+# Example:  read_view_concurrency.pl --socket=/tmp/mysql.sock --writers=0,100,1000
+#
+# Each writer updates a row, keeps its transaction open for --think-time
+# seconds and commits. With --think-time=0 the writers only keep their
+# transaction open and commit at the end of the test.
+#
+# Note that max_connections must be larger than writers + readers.
+#
+
+use DBI;
+use Getopt::Long;
+use Time::HiRes qw(time sleep);
+
+$opt_host=$opt_user=$opt_password=$opt_socket=""; $opt_db="test";
+$opt_writers="0,100,1000";
+$opt_readers=8;
+$opt_seconds=30;
+$opt_rows=10000;
+$opt_think_time=0.1;
+
+GetOptions("host=s","db=s","user=s","password=s","socket=s","writers=s",
+	   "readers=i","seconds=i","rows=i","think-time=f") || die "Aborted";
+
+$dsn="DBI:mysql:$opt_db:$opt_host";
+$dsn.=";mysql_socket=$opt_socket" if ($opt_socket);
+
+$dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+  die $DBI::errstr;
+
+print "Creating table bench_read_view with $opt_rows rows\n";
+$dbh->do("drop table if exists bench_read_view");
+$dbh->do("create table bench_read_view (id int not null primary key, " .
+	 "k int not null) engine=InnoDB") || die $DBI::errstr;
+
+$dbh->do("begin");
+for ($i=1 ; $i <= $opt_rows ; $i++)
+{
+  $dbh->do("insert into bench_read_view values ($i,0)") || die $DBI::errstr;
+}
+$dbh->do("commit");
+
+printf("%10s %12s %14s %14s %12s\n", "writers", "selects/s", "avg_lat_ms",
+       "max_lat_ms", "commits/s");
+
+foreach $writers (split(/,/,$opt_writers))
+{
+  run_test($writers);
+}
+
+$dbh->do("drop table bench_read_view");
+$dbh->disconnect;
+exit(0);
+
+#
+# Runs $writers writer sessions and $opt_readers reader sessions for
+# $opt_seconds seconds, and prints the totals reported by the processes
+#
+
+sub run_test
+{
+  my ($writers)=@_;
+  my ($i,$pid,%pipes,$selects,$total_lat,$max_lat,$commits);
+
+  for ($i=0 ; $i < $writers + $opt_readers ; $i++)
+  {
+    my ($reader,$writer);
+    pipe($reader,$writer) || die "pipe: $!";
+    if (($pid=fork()) == 0)
+    {
+      close($reader);
+      exit($i < $writers ? write_session($writer, $i) :
+	   read_session($writer));
+    }
+    die "fork: $!" if (!defined($pid));
+    close($writer);
+    $pipes{$pid}=$reader;
+  }
+
+  $selects=$total_lat=$max_lat=$commits=0;
+  foreach $pid (keys %pipes)
+  {
+    my $reader=$pipes{$pid};
+    my $line=<$reader>;
+    close($reader);
+    waitpid($pid,0);
+    if (!defined($line) || $?)
+    {
+      print "Session $pid failed\n";
+      next;
+    }
+    my ($type,$n,$lat,$max)=split(/ /,$line);
+    if ($type eq "w")
+    {
+      $commits+=$n;
+      next;
+    }
+    $selects+=$n;
+    $total_lat+=$lat;
+    $max_lat=$max if ($max > $max_lat);
+  }
+
+  printf("%10d %12.1f %14.3f %14.3f %12.1f\n", $writers,
+	 $selects / $opt_seconds,
+	 $selects ? $total_lat * 1000 / $selects : 0,
+	 $max_lat * 1000, $commits / $opt_seconds);
+}
+
+#
+# Updates rows of its own range, so that the writers never wait for
+# each other
+#
+
+sub write_session
+{
+  my ($writer,$num)=@_;
+  my ($dbh,$end,$wait,$n);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,
+		    { PrintError => 0, AutoCommit => 0}) || return 1;
+  $n=0;
+  $end=time() + $opt_seconds;
+  do
+  {
+    $dbh->do("update bench_read_view set k=k+1 where id=" .
+	     ($num % $opt_rows + 1)) || return 1;
+    $wait=$opt_think_time ? $opt_think_time : $end - time();
+    sleep($wait) if ($wait > 0);
+    $dbh->commit || return 1;
+    $n++;
+  } while (time() < $end);
+  $dbh->disconnect;
+  print $writer "w $n\n";
+  close($writer);
+  return 0;
+}
+
+sub read_session
+{
+  my ($writer)=@_;
+  my ($dbh,$sth,$end,$start,$lat,$n,$total_lat,$max_lat);
+
+  $dbh=DBI->connect($dsn,$opt_user,$opt_password,{ PrintError => 0}) ||
+    return 1;
+  $dbh->{AutoCommit}=1;
+  $sth=$dbh->prepare("select k from bench_read_view where id=?") ||
+    return 1;
+  srand($$);
+
+  $n=$total_lat=$max_lat=0;
+  $end=time() + $opt_seconds;
+  while (($start=time()) < $end)
+  {
+    $sth->execute(int(rand($opt_rows)) + 1) || return 1;
+    $sth->fetchrow_arrayref;
+    $lat=time() - $start;
+    $n++;
+    $total_lat+=$lat;
+    $max_lat=$lat if ($lat > $max_lat);
+  }
+  $dbh->disconnect;
+  print $writer "r $n $total_lat $max_lat\n";
+  close($writer);
+  return 0;
+}